@@ -0,0 +1,10 @@
+#version 330 core
+
+uniform sampler2D Light;
+
+out vec4 color;
+
+void main()
+{
+   color = vec4( texelFetch( Light, ivec2( gl_FragCoord.xy ), 0 ).rgb, 1.0f );
+}
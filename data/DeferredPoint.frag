@@ -0,0 +1,61 @@
+#version 330 core
+
+flat in vec4 PositionRadius;
+flat in vec3 Color;
+flat in vec3 Attenuation;
+
+#define Max_Point_Light 1
+
+//Per-frame data, ring buffer in Game::UploadFrameData(), binding point 0:
+layout ( std140 ) uniform FrameData{
+   mat4 view;
+   mat4 projection;
+   vec4 ViewPos;
+   vec4 SunPosition;
+   vec4 SunAmbient;
+   vec4 SunDiffuse;
+   vec4 SunSpecular;
+   vec4 PointPosition[Max_Point_Light];
+   //x = Constant, y = Linear, z = Quadratic:
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
+//G-buffer, DeferredRenderer::CreateTargets():
+uniform sampler2D GAlbedo;
+uniform sampler2D GSpecular;
+uniform sampler2D GNormal;
+uniform sampler2D GDepth;
+uniform mat4 InverseViewProjection;
+
+out vec4 color;
+
+void main()
+{
+   ivec2 pixel = ivec2( gl_FragCoord.xy );
+   float depth = texelFetch( GDepth, pixel, 0 ).r;
+   vec4 position = InverseViewProjection * vec4( gl_FragCoord.xy / vec2( textureSize( GDepth, 0 ) ) * 2.0f - 1.0f, depth * 2.0f - 1.0f, 1.0f );
+   vec3 fragPos = position.xyz / position.w;
+   float distance = length( PositionRadius.xyz - fragPos );
+   if( distance > PositionRadius.w ){
+      discard;
+   }
+   vec4 albedo = texelFetch( GAlbedo, pixel, 0 );
+   vec4 specularMap = texelFetch( GSpecular, pixel, 0 );
+   vec4 normalMap = texelFetch( GNormal, pixel, 0 );
+   vec3 normal = normalize( normalMap.xyz );
+   vec3 viewDir = normalize( ViewPos.xyz - fragPos );
+   //Same as CalculatePointLight() in Shader.frag:
+   vec3 lightDir = normalize( PositionRadius.xyz - fragPos );
+   float diff = max( dot( normal, lightDir ), 0.0 );
+   vec3 reflectDir = reflect( -lightDir, normal );
+   float spec = pow( max( dot( viewDir, reflectDir ), 0.0 ), specularMap.a * 256.0f );
+   float attenuation = 1.0 / ( Attenuation.x + Attenuation.y * distance + Attenuation.z * ( distance * distance ) );
+   //Smooth end of light volume:
+   float edge = distance / PositionRadius.w;
+   edge = clamp( 1.0f - edge * edge * edge * edge, 0.0f, 1.0f );
+   attenuation *= edge * edge;
+   vec3 ambient = albedo.a * albedo.rgb;
+   vec3 diffuse = normalMap.w * diff * albedo.rgb;
+   vec3 specular = spec * specularMap.rgb;
+   color = vec4( Color * ( ambient + diffuse + specular ) * attenuation, 1.0f );
+}
@@ -0,0 +1,34 @@
+#version 330 core
+layout ( location = 0 ) in vec3 position;
+//Instance, PointLightData:
+layout ( location = 1 ) in vec4 LightPositionRadius;
+layout ( location = 2 ) in vec4 LightColor;
+layout ( location = 3 ) in vec4 LightAttenuation;
+
+flat out vec4 PositionRadius;
+flat out vec3 Color;
+flat out vec3 Attenuation;
+
+#define Max_Point_Light 1
+
+//Per-frame data, ring buffer in Game::UploadFrameData(), binding point 0:
+layout ( std140 ) uniform FrameData{
+   mat4 view;
+   mat4 projection;
+   vec4 ViewPos;
+   vec4 SunPosition;
+   vec4 SunAmbient;
+   vec4 SunDiffuse;
+   vec4 SunSpecular;
+   vec4 PointPosition[Max_Point_Light];
+   //x = Constant, y = Linear, z = Quadratic:
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
+void main()
+{
+   PositionRadius = LightPositionRadius;
+   Color = LightColor.rgb;
+   Attenuation = LightAttenuation.xyz;
+   gl_Position = projection * view * vec4( LightPositionRadius.xyz + position * LightPositionRadius.w, 1.0f );
+}
@@ -0,0 +1,52 @@
+#version 330 core
+
+#define Max_Point_Light 1
+
+//Per-frame data, ring buffer in Game::UploadFrameData(), binding point 0:
+layout ( std140 ) uniform FrameData{
+   mat4 view;
+   mat4 projection;
+   vec4 ViewPos;
+   vec4 SunPosition;
+   vec4 SunAmbient;
+   vec4 SunDiffuse;
+   vec4 SunSpecular;
+   vec4 PointPosition[Max_Point_Light];
+   //x = Constant, y = Linear, z = Quadratic:
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
+//G-buffer, DeferredRenderer::CreateTargets():
+uniform sampler2D GAlbedo;
+uniform sampler2D GSpecular;
+uniform sampler2D GNormal;
+uniform sampler2D GDepth;
+uniform mat4 InverseViewProjection;
+
+out vec4 color;
+
+void main()
+{
+   ivec2 pixel = ivec2( gl_FragCoord.xy );
+   float depth = texelFetch( GDepth, pixel, 0 ).r;
+   if( depth == 1.0f ){
+      discard;
+   }
+   //World position from depth:
+   vec4 position = InverseViewProjection * vec4( gl_FragCoord.xy / vec2( textureSize( GDepth, 0 ) ) * 2.0f - 1.0f, depth * 2.0f - 1.0f, 1.0f );
+   vec3 fragPos = position.xyz / position.w;
+   vec4 albedo = texelFetch( GAlbedo, pixel, 0 );
+   vec4 specularMap = texelFetch( GSpecular, pixel, 0 );
+   vec4 normalMap = texelFetch( GNormal, pixel, 0 );
+   vec3 normal = normalize( normalMap.xyz );
+   vec3 viewDir = normalize( ViewPos.xyz - fragPos );
+   //Same as CalculateDirectionalLight() in Shader.frag:
+   vec3 lightDir = normalize( SunPosition.xyz - fragPos );
+   float diff = max( dot( normal, lightDir ), 0.0 );
+   vec3 reflectDir = reflect( -lightDir, normal );
+   float spec = pow( max( dot( viewDir, reflectDir ), 0.0 ), specularMap.a * 256.0f );
+   vec3 ambient = SunAmbient.xyz * albedo.a * albedo.rgb;
+   vec3 diffuse = SunDiffuse.xyz * normalMap.w * diff * albedo.rgb;
+   vec3 specular = SunSpecular.xyz * spec * specularMap.rgb;
+   color = vec4( ambient + diffuse + specular, 1.0f );
+}
@@ -0,0 +1,28 @@
+#version 330 core
+layout ( location = 0 ) in vec3 position;
+
+#define Max_Point_Light 1
+
+uniform mat4 model;
+
+//Per-frame data, ring buffer in Game::UploadFrameData(), binding point 0:
+layout ( std140 ) uniform FrameData{
+   mat4 view;
+   mat4 projection;
+   vec4 ViewPos;
+   vec4 SunPosition;
+   vec4 SunAmbient;
+   vec4 SunDiffuse;
+   vec4 SunSpecular;
+   vec4 PointPosition[Max_Point_Light];
+   //x = Constant, y = Linear, z = Quadratic:
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
+//Same depth as in Shader.vert, required by GL_EQUAL in main pass:
+invariant gl_Position;
+
+void main()
+{
+   gl_Position = projection * view * model * vec4( position, 1.0f );
+}
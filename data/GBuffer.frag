@@ -0,0 +1,29 @@
+#version 330 core
+
+struct Material_{
+   sampler2D Texture;
+   sampler2D Texture_specular;
+   vec3 Ambient;
+   vec3 Diffuse;
+   vec3 Specular;
+   float Shininess;
+};
+
+in vec2 UV;
+in vec3 Normal;
+in vec3 FragPos;
+
+//G-buffer, DeferredRenderer::CreateTargets():
+layout ( location = 0 ) out vec4 GAlbedo;
+layout ( location = 1 ) out vec4 GSpecular;
+layout ( location = 2 ) out vec4 GNormal;
+
+uniform Material_ Material;
+
+void main()
+{
+   //Materials are gray, ambient and diffuse as one value:
+   GAlbedo = vec4( vec3( texture( Material.Texture, UV ) ), dot( Material.Ambient, vec3( 1.0f / 3.0f ) ) );
+   GSpecular = vec4( Material.Specular * vec3( texture( Material.Texture_specular, UV ) ), Material.Shininess / 256.0f );
+   GNormal = vec4( normalize( Normal ), dot( Material.Diffuse, vec3( 1.0f / 3.0f ) ) );
+}
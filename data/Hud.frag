@@ -0,0 +1,12 @@
+#version 330 core
+in vec2 UV;
+in vec4 Color;
+
+uniform sampler2D Font;
+
+out vec4 color;
+
+void main()
+{
+   color = vec4( Color.rgb, Color.a * texture( Font, UV ).r );
+}
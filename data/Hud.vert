@@ -0,0 +1,22 @@
+#version 330 core
+//Per instance: xy = top left corner, zw = size, in window pixels:
+layout ( location = 0 ) in vec4 rect;
+//Per instance: xy = top left, zw = bottom right texture coordinates:
+layout ( location = 1 ) in vec4 uv;
+layout ( location = 2 ) in vec4 color;
+
+//Window size in pixels:
+uniform vec2 Screen;
+
+out vec2 UV;
+out vec4 Color;
+
+void main()
+{
+   //Triangle strip corners from vertex number:
+   vec2 corner = vec2( gl_VertexID & 1, gl_VertexID >> 1 );
+   vec2 pixel = rect.xy + corner * rect.zw;
+   gl_Position = vec4( pixel.x / Screen.x * 2.0f - 1.0f, 1.0f - pixel.y / Screen.y * 2.0f, 0.0f, 1.0f );
+   UV = mix( uv.xy, uv.zw, corner );
+   Color = color;
+}
@@ -0,0 +1,56 @@
+#version 330 core
+
+#define Max_Point_Light 1
+
+in vec3 UV;
+in vec3 FragPos;
+flat in vec3 Forward;
+flat in float Radius;
+
+out vec4 color;
+
+//Per-frame data, ring buffer in Game::UploadFrameData(), binding point 0:
+layout ( std140 ) uniform FrameData{
+   mat4 view;
+   mat4 projection;
+   vec4 ViewPos;
+   vec4 SunPosition;
+   vec4 SunAmbient;
+   vec4 SunDiffuse;
+   vec4 SunSpecular;
+   vec4 PointPosition[Max_Point_Light];
+   //x = Constant, y = Linear, z = Quadratic:
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
+uniform sampler2DArray Albedo;
+uniform sampler2DArray NormalDepth;
+
+//Default material of Model (no specular for far objects):
+const vec3 MaterialAmbient = vec3( 0.2f );
+const vec3 MaterialDiffuse = vec3( 0.5f );
+
+void main()
+{
+   vec4 albedo = texture( Albedo, UV );
+   if( albedo.a < 0.5f ){
+      discard;
+   }
+   vec4 normal_depth = texture( NormalDepth, UV );
+   //Baked depth 0.0 - 1.0 covers 4 radii, quad lies in the middle:
+   vec3 position = FragPos + Forward * ( normal_depth.w * 4.0f - 2.0f ) * Radius;
+   vec4 clip = projection * view * vec4( position, 1.0f );
+   gl_FragDepth = ( clip.z / clip.w ) * 0.5f + 0.5f;
+
+   vec3 normal = normalize( normal_depth.xyz );
+   vec3 lightDir = normalize( SunPosition.xyz - position );
+   vec3 result = SunAmbient.xyz * MaterialAmbient * albedo.rgb;
+   result += SunDiffuse.xyz * MaterialDiffuse * max( dot( normal, lightDir ), 0.0f ) * albedo.rgb;
+   for( int i = 0; i < Max_Point_Light; ++i ){
+      lightDir = normalize( PointPosition[i].xyz - position );
+      float distance = length( PointPosition[i].xyz - position );
+      float attenuation = 1.0 / ( PointAttenuation[i].x + PointAttenuation[i].y * distance + PointAttenuation[i].z * ( distance * distance ) );
+      result += ( MaterialAmbient + MaterialDiffuse * max( dot( normal, lightDir ), 0.0f ) ) * albedo.rgb * attenuation;
+   }
+   color = vec4( result, 1.0f );
+}
@@ -0,0 +1,68 @@
+#version 330 core
+//Per instance: xyz = center, w = radius:
+layout ( location = 0 ) in vec4 sphere;
+layout ( location = 1 ) in float layer;
+
+#define Max_Point_Light 1
+
+//Per-frame data, ring buffer in Game::UploadFrameData(), binding point 0:
+layout ( std140 ) uniform FrameData{
+   mat4 view;
+   mat4 projection;
+   vec4 ViewPos;
+   vec4 SunPosition;
+   vec4 SunAmbient;
+   vec4 SunDiffuse;
+   vec4 SunSpecular;
+   vec4 PointPosition[Max_Point_Light];
+   //x = Constant, y = Linear, z = Quadratic:
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
+//Frames in one row of atlas:
+uniform float Frames;
+
+out vec3 UV;
+out vec3 FragPos;
+flat out vec3 Forward;
+flat out float Radius;
+
+vec2 OctahedronEncode( vec3 dir_ );
+vec3 OctahedronDecode( vec2 uv_ );
+
+void main()
+{
+   //Nearest baked direction:
+   vec3 dir = normalize( ViewPos.xyz - sphere.xyz );
+   vec2 cell = clamp( floor( OctahedronEncode( dir ) * Frames ), vec2( 0.0f ), vec2( Frames - 1.0f ) );
+   vec3 frame_dir = OctahedronDecode( ( cell + 0.5f ) / Frames );
+   //Same basis as glm::lookAt() in Impostor::Bake():
+   vec3 up = abs( frame_dir.y ) > 0.999f ? vec3( 0.0f, 0.0f, 1.0f ) : vec3( 0.0f, 1.0f, 0.0f );
+   Forward = -frame_dir;
+   vec3 right = normalize( cross( Forward, up ) );
+   up = cross( right, Forward );
+   //Triangle strip corner:
+   vec2 corner = vec2( gl_VertexID & 1, gl_VertexID >> 1 ) * 2.0f - 1.0f;
+   FragPos = sphere.xyz + ( right * corner.x + up * corner.y ) * sphere.w;
+   Radius = sphere.w;
+   UV = vec3( ( cell + corner * 0.5f + 0.5f ) / Frames, layer );
+   gl_Position = projection * view * vec4( FragPos, 1.0f );
+}
+
+vec2 OctahedronEncode( vec3 dir_ ){
+   vec3 d = dir_ / ( abs( dir_.x ) + abs( dir_.y ) + abs( dir_.z ) );
+   vec2 p = d.xz;
+   if( d.y < 0.0f ){
+      p = ( 1.0f - abs( p.yx ) ) * vec2( p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f );
+   }
+   return p * 0.5f + 0.5f;
+}
+
+vec3 OctahedronDecode( vec2 uv_ ){
+   vec2 p = uv_ * 2.0f - 1.0f;
+   vec3 d = vec3( p.x, 1.0f - abs( p.x ) - abs( p.y ), p.y );
+   if( d.y < 0.0f ){
+      d.xz = ( 1.0f - abs( d.zx ) ) * vec2( d.x >= 0.0f ? 1.0f : -1.0f, d.z >= 0.0f ? 1.0f : -1.0f );
+   }
+   return normalize( d );
+}
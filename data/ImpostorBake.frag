@@ -0,0 +1,16 @@
+#version 330 core
+
+in vec2 UV;
+in vec3 Normal;
+
+layout ( location = 0 ) out vec4 albedo;
+layout ( location = 1 ) out vec4 normal_depth;
+
+uniform sampler2D Texture;
+
+void main()
+{
+   albedo = vec4( texture( Texture, UV ).rgb, 1.0f );
+   //Orthographic projection, depth is linear:
+   normal_depth = vec4( normalize( Normal ), gl_FragCoord.z );
+}
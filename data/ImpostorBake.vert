@@ -0,0 +1,17 @@
+#version 330 core
+layout ( location = 0 ) in vec3 position;
+layout ( location = 1 ) in vec2 uv;
+layout ( location = 2 ) in vec3 normal;
+
+out vec2 UV;
+out vec3 Normal;
+
+//Orthographic camera of one atlas frame, model space:
+uniform mat4 viewprojection;
+
+void main()
+{
+   gl_Position = viewprojection * vec4( position, 1.0f );
+   UV = uv;
+   Normal = normal;
+}
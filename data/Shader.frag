@@ -1,86 +1,175 @@
-#version 330 core
-
-struct Material_{
-   sampler2D Texture;
-   sampler2D Texture_specular;
-   vec3 Ambient;
-   vec3 Diffuse;
-   vec3 Specular;
-   float Shininess;
-};
-
-struct Directional_Light{
-   vec3 Position;
-   vec3 Ambient;
-   vec3 Diffuse;
-   vec3 Specular;
-};
-
-struct Point_Light{
-   vec3 Position;
-   float Constant;
-   float Linear;
-   float Quadratic;
-};
-
-#define Max_Point_Light 1
-
-in vec2 UV;
-in vec3 Normal;
-in vec3 FragPos;
-
-out vec4 color;
-
-uniform Material_ Material;
-uniform Directional_Light DirectionalLight;
-uniform Point_Light PointLight[Max_Point_Light];
-uniform vec3 ViewPos;
-
-vec3 CalculateDirectionalLight( Directional_Light DirectionalLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_ );
-vec3 CalculatePointLight( Point_Light PointLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_ );
-
-void main()
-{
-   vec3 normal = normalize( Normal );
-   vec3 viewDir = normalize( ViewPos - FragPos );
-   vec3 result = vec3( 0.0f );
-   result = CalculateDirectionalLight( DirectionalLight, normal, viewDir, FragPos  );
-   for( int i = 0; i < Max_Point_Light; ++i ){
-      result += CalculatePointLight( PointLight[i], normal, viewDir, FragPos );
-   }
-   color = vec4( result, 1.0f );
-}
-
-vec3 CalculateDirectionalLight( Directional_Light DirectionalLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_ ){
-   vec3 lightDir = normalize( DirectionalLight_.Position - fragPos_ );
-   // Diffuse shading
-   float diff = max( dot( normal_, lightDir ), 0.0 );
-   // Specular shading
-   vec3 reflectDir = reflect( -lightDir, normal_ );
-   float spec = pow( max( dot( viewDir_, reflectDir ), 0.0 ), Material.Shininess );
-   // Combine results
-   vec3 ambient = DirectionalLight_.Ambient * Material.Ambient * vec3( texture( Material.Texture, UV ) );
-   vec3 diffuse = DirectionalLight_.Diffuse * Material.Diffuse * diff * vec3( texture( Material.Texture, UV ) );
-   vec3 specular = DirectionalLight_.Specular * Material.Specular * spec * vec3( texture( Material.Texture_specular, UV ) );
-   return ( ambient + diffuse + specular );
-}
-
-vec3 CalculatePointLight( Point_Light PointLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_ ){
-   vec3 lightDir = normalize( PointLight_.Position  - fragPos_ );
-   // Diffuse shading
-   float diff = max( dot( normal_, lightDir ), 0.0 );
-   // Specular shading
-   vec3 reflectDir = reflect( -lightDir, normal_ );
-   float spec = pow( max( dot( viewDir_, reflectDir ), 0.0 ), Material.Shininess );
-   // Attenuation
-   float distance = length( PointLight_.Position - fragPos_ );
-   float attenuation = 1.0 / ( PointLight_.Constant + PointLight_.Linear * distance + PointLight_.Quadratic * ( distance * distance ) );
-   // Combine results
-   vec3 ambient = Material.Ambient * vec3( texture( Material.Texture, UV ) );
-   vec3 diffuse = Material.Diffuse * diff * vec3( texture( Material.Texture, UV ) );
-   vec3 specular = Material.Specular * spec * vec3( texture( Material.Texture_specular, UV ) );
-   ambient *= attenuation;
-   diffuse *= attenuation;
-   specular *= attenuation;
-   return( ambient + diffuse + specular );
-}
+#version 330 core
+
+struct Material_{
+   sampler2D Texture;
+   sampler2D Texture_specular;
+   vec3 Ambient;
+   vec3 Diffuse;
+   vec3 Specular;
+   float Shininess;
+};
+
+struct Directional_Light{
+   vec3 Position;
+   vec3 Ambient;
+   vec3 Diffuse;
+   vec3 Specular;
+};
+
+struct Point_Light{
+   vec3 Position;
+   float Constant;
+   float Linear;
+   float Quadratic;
+};
+
+#define Max_Point_Light 1
+
+//LightClusters, CLUSTER_X, CLUSTER_Y, CLUSTER_Z:
+#define Cluster_X 16
+#define Cluster_Y 9
+#define Cluster_Z 24
+
+in vec2 UV;
+in vec3 Normal;
+in vec3 FragPos;
+
+out vec4 color;
+
+uniform Material_ Material;
+
+//Clustered point lights, LightClusters::Upload():
+uniform bool Clustered;
+uniform usamplerBuffer ClusterGrid;
+uniform usamplerBuffer ClusterIndices;
+uniform samplerBuffer ClusterLights;
+//x, y = clusters per pixel, z = slice scale, w = slice bias:
+uniform vec4 ClusterParameters;
+
+//Shadows, ShadowMap::Bind():
+uniform bool SunShadows;
+uniform sampler2DShadow SunShadow;
+uniform mat4 SunShadowMatrix;
+uniform bool PointShadows;
+uniform samplerCubeShadow PointShadow;
+//xyz = light position, w = far:
+uniform vec4 PointShadowPosition;
+//NDC depth = x - y / distance along face axis:
+uniform vec2 PointShadowDepth;
+
+//Per-frame data, ring buffer in Game::UploadFrameData(), binding point 0:
+layout ( std140 ) uniform FrameData{
+   mat4 view;
+   mat4 projection;
+   vec4 ViewPos;
+   vec4 SunPosition;
+   vec4 SunAmbient;
+   vec4 SunDiffuse;
+   vec4 SunSpecular;
+   vec4 PointPosition[Max_Point_Light];
+   //x = Constant, y = Linear, z = Quadratic:
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
+vec3 CalculateDirectionalLight( Directional_Light DirectionalLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_, float shadow_ );
+vec3 CalculatePointLight( Point_Light PointLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_, float shadow_ );
+float CalculateSunShadow( vec3 fragPos_ );
+float CalculatePointShadow( vec3 fragPos_ );
+
+void main()
+{
+   vec3 normal = normalize( Normal );
+   vec3 viewDir = normalize( ViewPos.xyz - FragPos );
+   vec3 result = vec3( 0.0f );
+   Directional_Light DirectionalLight = Directional_Light( SunPosition.xyz, SunAmbient.xyz, SunDiffuse.xyz, SunSpecular.xyz );
+   result = CalculateDirectionalLight( DirectionalLight, normal, viewDir, FragPos, CalculateSunShadow( FragPos ) );
+   if( Clustered ){
+      //Only lights in cluster of this fragment:
+      float depth = -( view * vec4( FragPos, 1.0f ) ).z;
+      ivec2 tile = min( ivec2( gl_FragCoord.xy * ClusterParameters.xy ), ivec2( Cluster_X - 1, Cluster_Y - 1 ) );
+      int slice = clamp( int( log( depth ) * ClusterParameters.z + ClusterParameters.w ), 0, Cluster_Z - 1 );
+      uvec2 cluster = texelFetch( ClusterGrid, ( slice * Cluster_Y + tile.y ) * Cluster_X + tile.x ).xy;
+      for( uint i = cluster.x; i < cluster.x + cluster.y; ++i ){
+         int light = int( texelFetch( ClusterIndices, int( i ) ).x ) * 3;
+         vec4 positionRadius = texelFetch( ClusterLights, light );
+         vec3 lightColor = texelFetch( ClusterLights, light + 1 ).rgb;
+         vec4 attenuation = texelFetch( ClusterLights, light + 2 );
+         Point_Light PointLight = Point_Light( positionRadius.xyz, attenuation.x, attenuation.y, attenuation.z );
+         //Smooth end of light range, same as DeferredPoint.frag:
+         float edge = length( positionRadius.xyz - FragPos ) / positionRadius.w;
+         edge = clamp( 1.0f - edge * edge * edge * edge, 0.0f, 1.0f );
+         //Light 0 = second light with cube shadow map:
+         float shadow = light == 0 ? CalculatePointShadow( FragPos ) : 1.0f;
+         result += lightColor * edge * edge * CalculatePointLight( PointLight, normal, viewDir, FragPos, shadow );
+      }
+   }
+   else{
+      for( int i = 0; i < Max_Point_Light; ++i ){
+         Point_Light PointLight = Point_Light( PointPosition[i].xyz, PointAttenuation[i].x, PointAttenuation[i].y, PointAttenuation[i].z );
+         result += CalculatePointLight( PointLight, normal, viewDir, FragPos, i == 0 ? CalculatePointShadow( FragPos ) : 1.0f );
+      }
+   }
+   color = vec4( result, 1.0f );
+}
+
+vec3 CalculateDirectionalLight( Directional_Light DirectionalLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_, float shadow_ ){
+   vec3 lightDir = normalize( DirectionalLight_.Position - fragPos_ );
+   // Diffuse shading
+   float diff = max( dot( normal_, lightDir ), 0.0 );
+   // Specular shading
+   vec3 reflectDir = reflect( -lightDir, normal_ );
+   float spec = pow( max( dot( viewDir_, reflectDir ), 0.0 ), Material.Shininess );
+   // Combine results
+   vec3 ambient = DirectionalLight_.Ambient * Material.Ambient * vec3( texture( Material.Texture, UV ) );
+   vec3 diffuse = DirectionalLight_.Diffuse * Material.Diffuse * diff * vec3( texture( Material.Texture, UV ) );
+   vec3 specular = DirectionalLight_.Specular * Material.Specular * spec * vec3( texture( Material.Texture_specular, UV ) );
+   return ( ambient + shadow_ * ( diffuse + specular ) );
+}
+
+vec3 CalculatePointLight( Point_Light PointLight_, vec3 normal_, vec3 viewDir_, vec3 fragPos_, float shadow_ ){
+   vec3 lightDir = normalize( PointLight_.Position  - fragPos_ );
+   // Diffuse shading
+   float diff = max( dot( normal_, lightDir ), 0.0 );
+   // Specular shading
+   vec3 reflectDir = reflect( -lightDir, normal_ );
+   float spec = pow( max( dot( viewDir_, reflectDir ), 0.0 ), Material.Shininess );
+   // Attenuation
+   float distance = length( PointLight_.Position - fragPos_ );
+   float attenuation = 1.0 / ( PointLight_.Constant + PointLight_.Linear * distance + PointLight_.Quadratic * ( distance * distance ) );
+   // Combine results
+   vec3 ambient = Material.Ambient * vec3( texture( Material.Texture, UV ) );
+   vec3 diffuse = Material.Diffuse * diff * vec3( texture( Material.Texture, UV ) );
+   vec3 specular = Material.Specular * spec * vec3( texture( Material.Texture_specular, UV ) );
+   ambient *= attenuation;
+   diffuse *= attenuation * shadow_;
+   specular *= attenuation * shadow_;
+   return( ambient + diffuse + specular );
+}
+
+float CalculateSunShadow( vec3 fragPos_ ){
+   if( ! SunShadows ){
+      return 1.0f;
+   }
+   vec4 coord = SunShadowMatrix * vec4( fragPos_, 1.0f );
+   coord.xyz /= coord.w;
+   // 4 samples, each filtered 2x2 by hardware:
+   float shadow = textureOffset( SunShadow, coord.xyz, ivec2( -1, -1 ) );
+   shadow += textureOffset( SunShadow, coord.xyz, ivec2( 1, -1 ) );
+   shadow += textureOffset( SunShadow, coord.xyz, ivec2( -1, 1 ) );
+   shadow += textureOffset( SunShadow, coord.xyz, ivec2( 1, 1 ) );
+   return shadow * 0.25f;
+}
+
+float CalculatePointShadow( vec3 fragPos_ ){
+   if( ! PointShadows ){
+      return 1.0f;
+   }
+   vec3 toFrag = fragPos_ - PointShadowPosition.xyz;
+   vec3 axis = abs( toFrag );
+   float distance = max( axis.x, max( axis.y, axis.z ) );
+   if( distance >= PointShadowPosition.w ){
+      return 1.0f;
+   }
+   float depth = ( PointShadowDepth.x - PointShadowDepth.y / distance ) * 0.5f + 0.5f;
+   return texture( PointShadow, vec4( toFrag, depth - 0.0005f ) );
+}
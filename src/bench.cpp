@@ -0,0 +1,546 @@
+/*!
+   \file bench.cpp
+   \brief Mikrobenchmarki ładowania modeli i obliczeń wykonywanych co klatkę (make bench), bez kontekstu OpenGL.
+
+   Dane wejściowe są syntetyczne: siatka N x N kwadratów zapisywana do plików .obj i .mtl, świat M x M pól
+   i model z K macierzami, wielkości mnożone są przez --scale.\n
+   Dla każdego pomiaru wypisywany jest czas jednej operacji, przepustowość (elementy na sekundę)
+   oraz ilość i wielkość przydziałów pamięci na operację (zastąpione globalne operator new).\n
+   Czas na element (ns/item) pozwala porównać pomiary o różnej ilości elementów, np. ns na światło w LightClusters::Bin().\n
+   Użycie: bench.app [--scale N] [--time MS] [--filter NAZWA]\n
+*/
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <SDL2/SDL.h>
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "camera.hpp"
+#include "model.hpp"
+#include "worldgrid.hpp"
+#include "jobsystem.hpp"
+#include "lightclusters.hpp"
+
+using namespace std;
+
+/*!
+   \brief Domyślny najkrótszy czas jednego pomiaru w milisekundach.
+*/
+#define BENCH_TIME_MS 250
+/*!
+   \brief Nazwa plików syntetycznej siatki i materiału (bez rozszerzenia) w katalogu tymczasowym.
+*/
+#define BENCH_MESH_NAME "bench_mesh"
+
+/*!
+   \brief Plik syntetycznej siatki ( \link SetMeshPaths() \endlink ).
+*/
+static string BenchObjFile;
+/*!
+   \brief Plik syntetycznego materiału ( \link SetMeshPaths() \endlink ).
+*/
+static string BenchMtlFile;
+
+/*!
+   \brief Ilość przydziałów pamięci od uruchomienia.
+*/
+static SDL_atomic_t BenchAllocations;
+/*!
+   \brief Ilość przydzielonych bajtów od uruchomienia (mod 2^32, liczona jest różnica).
+*/
+static SDL_atomic_t BenchAllocatedBytes;
+
+/*!
+   \brief Zastąpione operatory bez rozwijania w miejscu wywołania (GCC po rozwinięciu zgłasza fałszywe -Wmismatched-new-delete dla malloc() i free()).
+*/
+#ifdef __GNUC__
+   #define BENCH_NOINLINE __attribute__(( noinline ))
+#else
+   #define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void * operator new( size_t size ){
+   SDL_AtomicIncRef( &BenchAllocations );
+   SDL_AtomicAdd( &BenchAllocatedBytes, int( size ) );
+   void *pointer = malloc( size > 0 ? size : 1 );
+   if( pointer == NULL ){
+      throw std::bad_alloc();
+   }
+   return pointer;
+}
+
+BENCH_NOINLINE void * operator new[]( size_t size ){
+   return operator new( size );
+}
+
+BENCH_NOINLINE void operator delete( void *pointer ) noexcept{
+   free( pointer );
+}
+
+BENCH_NOINLINE void operator delete[]( void *pointer ) noexcept{
+   free( pointer );
+}
+
+BENCH_NOINLINE void operator delete( void *pointer, size_t ) noexcept{
+   free( pointer );
+}
+
+BENCH_NOINLINE void operator delete[]( void *pointer, size_t ) noexcept{
+   free( pointer );
+}
+
+/*!
+   \brief Funkcja mierzonej operacji.
+
+   \param data - dane pomiaru
+*/
+typedef void (*BenchFunction)( void *data );
+
+/*!
+   \brief Ustawienia z linii poleceń.
+*/
+struct BenchSettings{
+   /*!
+      \brief Mnożnik wielkości danych wejściowych.
+   */
+   unsigned int Scale;
+   /*!
+      \brief Najkrótszy czas pomiaru w milisekundach.
+   */
+   unsigned int Time;
+   /*!
+      \brief Wykonywane są tylko pomiary zawierające ten tekst w nazwie, pusty = wszystkie.
+   */
+   string Filter;
+};
+
+/*!
+   \brief Wynik pomiaru, zapobiega usunięciu obliczeń przez kompilator.
+*/
+static volatile float BenchSink = 0.0f;
+
+/*!
+   \brief Wykonuje operację, aż minie \p time milisekund, i wypisuje wynik.
+
+   \param settings - ustawienia
+   \param name - nazwa pomiaru
+   \param function - mierzona operacja
+   \param data - dane operacji
+   \param items - ilość elementów przetwarzanych przez jedną operację (przepustowość)
+*/
+void RunBench( const BenchSettings &settings, const char *name, BenchFunction function, void *data, unsigned int items ){
+   if( ! settings.Filter.empty() and strstr( name, settings.Filter.c_str() ) == NULL ){
+      return;
+   }
+   const double frequency = double( SDL_GetPerformanceFrequency() );
+   //Warm up, caches and lazily allocated buffers:
+   function( data );
+   unsigned int operations = 0, batch = 1;
+   Uint64 elapsed = 0;
+   const int allocations = SDL_AtomicGet( &BenchAllocations );
+   const int bytes = SDL_AtomicGet( &BenchAllocatedBytes );
+   while( elapsed < Uint64( frequency * settings.Time / 1000.0 ) ){
+      const Uint64 begin = SDL_GetPerformanceCounter();
+      for( unsigned int i = 0; i < batch; ++i ){
+         function( data );
+      }
+      elapsed += SDL_GetPerformanceCounter() - begin;
+      operations += batch;
+      if( batch < 0x100000 ){
+         batch *= 2;
+      }
+   }
+   const double seconds = double( elapsed ) / frequency;
+   printf( "%-36s %8u items %14.1f ns/op %10.2f ns/item %14.0f items/s %10.1f allocs/op %12.0f B/op\n",
+      name,
+      items,
+      seconds * 1000000000.0 / operations,
+      seconds * 1000000000.0 / operations / std::max( items, 1u ),
+      double( items ) * operations / seconds,
+      double( SDL_AtomicGet( &BenchAllocations ) - allocations ) / operations,
+      double( (unsigned int)( SDL_AtomicGet( &BenchAllocatedBytes ) - bytes ) ) / operations
+   );
+   fflush( stdout );
+}
+
+/*!
+   \brief Ustala ścieżki plików siatki w katalogu tymczasowym (TMPDIR, TEMP, TMP lub /tmp), nie w katalogu roboczym.
+*/
+void SetMeshPaths(){
+   const char *directory = getenv( "TMPDIR" );
+   if( directory == NULL ){
+      directory = getenv( "TEMP" );
+   }
+   if( directory == NULL ){
+      directory = getenv( "TMP" );
+   }
+   if( directory == NULL ){
+      directory = "/tmp";
+   }
+   string path = directory;
+   if( ! path.empty() and path[path.size() - 1] != '/' and path[path.size() - 1] != '\\' ){
+      path += "/";
+   }
+   BenchObjFile = path + BENCH_MESH_NAME ".obj";
+   BenchMtlFile = path + BENCH_MESH_NAME ".mtl";
+}
+
+/*!
+   \brief Usuwa pliki siatki.
+*/
+void RemoveMesh(){
+   remove( BenchObjFile.c_str() );
+   remove( BenchMtlFile.c_str() );
+}
+
+/*!
+   \brief Zapisuje siatkę N x N kwadratów (2 trójkąty, pozycje, UV, normalne) i materiał.
+
+   \param size - ilość kwadratów w boku
+   \return - wartość logiczna, FALSE = błąd zapisu
+*/
+bool WriteMesh( unsigned int size ){
+   ofstream mtl( BenchMtlFile.c_str(), ios::out );
+   mtl<<"newmtl bench\nNs 32.0\nKa 0.2 0.2 0.2\nKd 0.5 0.5 0.5\nKs 0.5 0.5 0.5\n";
+   mtl.close();
+   ofstream obj( BenchObjFile.c_str(), ios::out );
+   if( ! obj.good() ){
+      return false;
+   }
+   obj<<"mtllib " BENCH_MESH_NAME ".mtl\no bench\n";
+   for( unsigned int z = 0; z <= size; ++z ){
+      for( unsigned int x = 0; x <= size; ++x ){
+         //Small waves, normals differ between vertices:
+         obj<<"v "<<x<<" "<<( ( x + z ) % 7 ) * 0.1f<<" "<<z<<"\n";
+         obj<<"vt "<<float( x ) / size<<" "<<float( z ) / size<<"\n";
+         obj<<"vn 0 1 "<<( ( x * 3 + z ) % 5 ) * 0.01f<<"\n";
+      }
+   }
+   obj<<"usemtl bench\n";
+   unsigned int a, b, c, d;
+   for( unsigned int z = 0; z < size; ++z ){
+      for( unsigned int x = 0; x < size; ++x ){
+         a = z * ( size + 1 ) + x + 1;
+         b = a + 1;
+         c = a + size + 1;
+         d = c + 1;
+         obj<<"f "<<a<<"/"<<a<<"/"<<a<<" "<<c<<"/"<<c<<"/"<<c<<" "<<b<<"/"<<b<<"/"<<b<<"\n";
+         obj<<"f "<<b<<"/"<<b<<"/"<<b<<" "<<c<<"/"<<c<<"/"<<c<<" "<<d<<"/"<<d<<"/"<<d<<"\n";
+      }
+   }
+   obj.close();
+   return ! obj.fail();
+}
+
+/*!
+   \brief Dane pomiarów ładowania i indeksowania.
+*/
+struct MeshData{
+   /*!
+      \brief Wierzchołki bez indeksów ( \link LoadOBJ() \endlink ).
+   */
+   vector <glm::vec3> Vertices;
+   /*!
+      \brief UV bez indeksów.
+   */
+   vector <glm::vec2> Uvs;
+   /*!
+      \brief Normalne bez indeksów.
+   */
+   vector <glm::vec3> Normals;
+   /*!
+      \brief Wierzchołki przeplecione.
+   */
+   vector <Packe> Packed;
+   /*!
+      \brief Indeksy.
+   */
+   vector <GLuint> Indices;
+   /*!
+      \brief Model z wczytaną siatką ( \link Model::SetCollision() \endlink ).
+   */
+   Model Mesh;
+};
+
+void BenchLoadOBJ( void *data ){
+   MeshData *mesh = static_cast <MeshData *>( data );
+   LoadOBJ( BenchObjFile.c_str(), mesh->Vertices, mesh->Uvs, mesh->Normals );
+}
+
+void BenchLoadAssimp( void *data ){
+   MeshData *mesh = static_cast <MeshData *>( data );
+   LoadAssimp( BenchObjFile.c_str(), mesh->Packed, mesh->Indices );
+}
+
+void BenchIndexVBO( void *data ){
+   MeshData *mesh = static_cast <MeshData *>( data );
+   mesh->Indices.clear();
+   mesh->Packed.clear();
+   IndexVBO( mesh->Vertices, mesh->Uvs, mesh->Normals, mesh->Indices, mesh->Packed );
+}
+
+void BenchLoadMTL( void * ){
+   glm::vec3 ambient, diffuse, specular;
+   //LoadMTL() doesn't read Ns:
+   GLfloat shininess = 0.0f;
+   LoadMTL( BenchMtlFile.c_str(), ambient, diffuse, specular, shininess );
+   BenchSink = BenchSink + shininess;
+}
+
+void BenchSetCollision( void *data ){
+   MeshData *mesh = static_cast <MeshData *>( data );
+   mesh->Mesh.SetCollision();
+}
+
+/*!
+   \brief Dane pomiaru kamery.
+*/
+struct CameraData{
+   /*!
+      \brief Kamera.
+   */
+   Camera View;
+   /*!
+      \brief Numer ruchu myszy.
+   */
+   unsigned int Step;
+};
+
+void BenchCamera( void *data ){
+   CameraData *camera = static_cast <CameraData *>( data );
+   //Back and forth, direction stays in range:
+   const float move = ( camera->Step++ & 1 ) ? 3.0f : -3.0f;
+   camera->View.MouseUpdate( glm::vec2( move, move * 0.5f ) );
+   BenchSink = BenchSink + camera->View.getViewMatrix()[3][2];
+}
+
+/*!
+   \brief Dane pomiaru zapytania o pola wokół kamery ( WorldGrid::QueryCells() ).
+*/
+struct GridData{
+   /*!
+      \brief Podział mapy.
+   */
+   WorldGrid Grid;
+   /*!
+      \brief Wynik zapytania.
+   */
+   vector <GridItem> Items;
+   /*!
+      \brief Wielkość mapy.
+   */
+   int MapMax;
+   /*!
+      \brief Numer zapytania.
+   */
+   unsigned int Step;
+};
+
+void BenchGridQuery( void *data ){
+   GridData *grid = static_cast <GridData *>( data );
+   //3 x 3 cells around camera, search for coin (model 1):
+   const int x = ( grid->Step * 7 ) % grid->MapMax;
+   const int z = ( grid->Step * 13 ) % grid->MapMax;
+   ++grid->Step;
+   grid->Items.clear();
+   grid->Grid.QueryCells( x - 1, z - 1, x + 1, z + 1, grid->Items );
+   vector <GridItem>::iterator it;
+   for( it = grid->Items.begin(); it != grid->Items.end(); ++it ){
+      if( it->Model == 1 ){
+         BenchSink = BenchSink + 1.0f;
+         return;
+      }
+   }
+}
+
+/*!
+   \brief Dane pomiaru zmiany wszystkich macierzy modelu.
+*/
+struct MatrixData{
+   /*!
+      \brief Model z wieloma macierzami.
+   */
+   Model Instances;
+   /*!
+      \brief Numer zmiany.
+   */
+   unsigned int Step;
+};
+
+void BenchMatrices( void *data ){
+   MatrixData *matrices = static_cast <MatrixData *>( data );
+   //Back and forth, matrices stay in range:
+   glm::vec3 move( ( matrices->Step++ & 1 ) ? 0.001f : -0.001f );
+   matrices->Instances.Translate( move );
+}
+
+/*!
+   \brief Dane pomiaru przypisania świateł do klastrów.
+*/
+struct ClusterData{
+   /*!
+      \brief Klastry (tylko CPU, bez buforów tekstur).
+   */
+   LightClusters Clusters;
+   /*!
+      \brief Światła punktowe.
+   */
+   vector <PointLightData> Lights;
+   /*!
+      \brief Macierz widoku.
+   */
+   glm::mat4 View;
+   /*!
+      \brief Macierz projekcji.
+   */
+   glm::mat4 Projection;
+};
+
+void BenchClusters( void *data ){
+   ClusterData *clusters = static_cast <ClusterData *>( data );
+   clusters->Clusters.Bin( clusters->View, clusters->Projection, clusters->Lights );
+   BenchSink = BenchSink + clusters->Clusters.ReturnVisible();
+}
+
+int main( int argc, char *argv[] ){
+   BenchSettings settings;
+   settings.Scale = 1;
+   settings.Time = BENCH_TIME_MS;
+   string argument;
+   for( int i = 1; i < argc; ++i ){
+      argument = argv[i];
+      if( argument == "--scale" and i + 1 < argc ){
+         if( atoi( argv[++i] ) > 0 ){
+            settings.Scale = atoi( argv[i] );
+         }
+      }
+      else if( argument == "--time" and i + 1 < argc ){
+         if( atoi( argv[++i] ) > 0 ){
+            settings.Time = atoi( argv[i] );
+         }
+      }
+      else if( argument == "--filter" and i + 1 < argc ){
+         settings.Filter = argv[++i];
+      }
+      else{
+         cout<<"Unknown argument: \""<<argument<<"\"\n";
+         cout<<"Usage: "<<argv[0]<<" [--scale N] [--time MS] [--filter NAME]\n";
+         return 1;
+      }
+   }
+   //Loaders log every file, only errors are shown:
+   SDL_LogSetAllPriority( SDL_LOG_PRIORITY_WARN );
+   SDL_AtomicSet( &BenchAllocations, 0 );
+   SDL_AtomicSet( &BenchAllocatedBytes, 0 );
+   printf( "Scale %u, %u ms per benchmark, %i CPUs\n", settings.Scale, settings.Time, SDL_GetCPUCount() );
+
+   //Loaders, mesh of 64 x 64 quads * scale:
+   const unsigned int mesh_size = 64 * settings.Scale;
+   SetMeshPaths();
+   if( ! WriteMesh( mesh_size ) ){
+      SDL_LogCritical( SDL_LOG_CATEGORY_APPLICATION, "Can't write %s\n", BenchObjFile.c_str() );
+      RemoveMesh();
+      return 1;
+   }
+   MeshData mesh;
+   mesh.Mesh.SetOBJPathFile( BenchObjFile );
+   mesh.Mesh.SetMTLPathFile( BenchMtlFile );
+   mesh.Mesh.Load_OBJ();
+   const unsigned int triangles = mesh_size * mesh_size * 2;
+   RunBench( settings, "LoadOBJ", BenchLoadOBJ, &mesh, triangles );
+   RunBench( settings, "LoadAssimp", BenchLoadAssimp, &mesh, triangles );
+   LoadOBJ( BenchObjFile.c_str(), mesh.Vertices, mesh.Uvs, mesh.Normals );
+   RunBench( settings, "IndexVBO", BenchIndexVBO, &mesh, mesh.Vertices.size() );
+   RunBench( settings, "LoadMTL", BenchLoadMTL, &mesh, 1 );
+   RunBench( settings, "Model::SetCollision", BenchSetCollision, &mesh, mesh.Mesh.ReturnVertices().size() );
+
+   //Camera:
+   CameraData camera;
+   camera.Step = 0;
+   RunBench( settings, "Camera::MouseUpdate+getViewMatrix", BenchCamera, &camera, 1 );
+
+   //Coin search, map of 30 x 30 * scale, every 4th cell taken:
+   GridData grid;
+   grid.MapMax = 30 * settings.Scale;
+   grid.Step = 0;
+   vector <Model> models( 3, mesh.Mesh );
+   for( int z = 0; z < grid.MapMax; ++z ){
+      for( int x = 0; x < grid.MapMax; ++x ){
+         if( ( x + z * 3 ) % 4 == 0 ){
+            glm::vec3 position( x, 0.0f, z );
+            models[( x + z ) % 7 == 0 ? 1 : 2].AddMatrix( position );
+         }
+      }
+   }
+   grid.Grid.Create( grid.MapMax, models.size() );
+   unsigned int counter[3] = { 0, 0, 0 };
+   for( int z = 0; z < grid.MapMax; ++z ){
+      for( int x = 0; x < grid.MapMax; ++x ){
+         if( ( x + z * 3 ) % 4 == 0 ){
+            const unsigned int model = ( x + z ) % 7 == 0 ? 1 : 2;
+            grid.Grid.Insert( x, z, model, counter[model]++, models[model] );
+         }
+      }
+   }
+   RunBench( settings, "WorldGrid::QueryCells (3 x 3 cells)", BenchGridQuery, &grid, 1 );
+
+   //Matrix batch updates, 16384 * scale matrices on 1 - all threads:
+   MatrixData matrices;
+   matrices.Step = 0;
+   const unsigned int count = 16384 * settings.Scale;
+   for( unsigned int i = 0; i < count; ++i ){
+      glm::vec3 position( i % 256, 0.0f, i / 256 );
+      matrices.Instances.AddMatrix( position );
+   }
+   Model::Jobs = NULL;
+   RunBench( settings, "Model::Translate (1 thread)", BenchMatrices, &matrices, count );
+   //Worker threads 1, 2, 4, ... and all CPUs - 1:
+   vector <int> workers;
+   const int cpus = std::min( SDL_GetCPUCount() - 1, JOBS_MAX_WORKERS );
+   for( int i = 1; i < cpus; i *= 2 ){
+      workers.push_back( i );
+   }
+   if( cpus > 0 ){
+      workers.push_back( cpus );
+   }
+   JobSystem jobs;
+   char name[64];
+   for( unsigned int i = 0; i < workers.size(); ++i ){
+      if( ! jobs.Create( workers[i] ) ){
+         break;
+      }
+      Model::Jobs = &jobs;
+      snprintf( name, sizeof( name ), "Model::Translate (%u threads)", jobs.ReturnThreads() );
+      RunBench( settings, name, BenchMatrices, &matrices, count );
+      Model::Jobs = NULL;
+      jobs.Destroy();
+   }
+
+   //Light binning, 256 - CLUSTER_MAX_LIGHTS lights spread over map of 100 x 100 in front of camera:
+   ClusterData clusters;
+   clusters.View = glm::lookAt( glm::vec3( 50.0f, 2.0f, 100.0f ), glm::vec3( 50.0f, 0.0f, 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+   clusters.Projection = glm::perspective( glm::radians( 45.0f ), 16.0f / 9.0f, 0.1f, 100.0f );
+   const unsigned int light_counts[3] = { 256, 1024, 4096 };
+   for( unsigned int i = 0; i < 3 and light_counts[i] <= CLUSTER_MAX_LIGHTS; ++i ){
+      clusters.Lights.resize( light_counts[i] );
+      for( unsigned int j = 0; j < light_counts[i]; ++j ){
+         PointLightData &light = clusters.Lights[j];
+         //Deterministic pseudo random positions, radius 1 - 4:
+         light.PositionRadius = glm::vec4( ( j * 37 ) % 100, 0.5f + ( j % 3 ), ( j * 61 ) % 100, 1.0f + ( j % 4 ) );
+         light.Color = glm::vec4( 1.0f );
+         light.Attenuation = glm::vec4( 1.0f, 0.7f, 1.8f, 0.0f );
+      }
+      snprintf( name, sizeof( name ), "LightClusters::Bin (%u lights)", light_counts[i] );
+      RunBench( settings, name, BenchClusters, &clusters, light_counts[i] );
+   }
+
+   RemoveMesh();
+   return 0;
+}
@@ -0,0 +1,200 @@
+/*!
+   \file benchmark.cpp
+   \brief Plik źródłowy dla benchmark.hpp.
+*/
+#include "benchmark.hpp"
+#include <cstdio>
+#include <algorithm>
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Nazwy pomiarów w raporcie.
+*/
+static const char *BenchmarkNames[BENCHMARK_METRICS] = { "frame_ms", "cpu_ms", "gpu_ms", "draw_calls", "triangles", "gpu_memory_mb", "cpu_tracked_mb", "gpu_tracked_mb" };
+/*!
+   \brief Punkty ścieżki kamery: x i z w połowach mapy, y w jednostkach świata.
+*/
+static const float BenchmarkPath[][3] = {
+   { -0.8f, 1.0f, -0.8f },
+   { 0.0f, 0.8f, -0.6f },
+   { 0.8f, 2.0f, -0.8f },
+   { 0.6f, 6.0f, 0.0f },
+   { 0.8f, 1.5f, 0.8f },
+   { 0.0f, 0.8f, 0.3f },
+   { -0.8f, 3.0f, 0.8f },
+   { -0.5f, 10.0f, 0.0f }
+};
+
+Benchmark::Benchmark(){
+}
+
+void Benchmark::Clear(){
+   this->Settings.clear();
+   this->Info.clear();
+   this->Memory.clear();
+   for( unsigned int i = 0; i < BENCHMARK_METRICS; ++i ){
+      this->Values[i].clear();
+   }
+}
+
+void Benchmark::AddSetting( const std::string &name, double value ){
+   this->Settings.push_back( std::make_pair( name, value ) );
+}
+
+void Benchmark::AddInfo( const std::string &name, const std::string &value ){
+   this->Info.push_back( std::make_pair( name, value ) );
+}
+
+void Benchmark::AddMemory( const std::string &name, const MemoryStats &cpu, const MemoryStats &gpu ){
+   this->Memory.push_back( std::make_pair( name, std::make_pair( cpu, gpu ) ) );
+}
+
+void Benchmark::Add( unsigned int metric, float value ){
+   if( metric < BENCHMARK_METRICS ){
+      this->Values[metric].push_back( value );
+   }
+}
+
+BenchmarkStats Benchmark::ReturnStats( unsigned int metric ) const{
+   return Benchmark::Stats( this->Values[metric < BENCHMARK_METRICS ? metric : 0] );
+}
+
+bool Benchmark::Save( const std::string &path ) const{
+   FILE *file = fopen( path.c_str(), "w" );
+   if( file == NULL ){
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Benchmark: can not open %s\n", path.c_str() );
+      return false;
+   }
+   fprintf( file, "{\n" );
+   for( unsigned int i = 0; i < this->Info.size(); ++i ){
+      //Strings from driver, quotes and backslashes replaced:
+      std::string value = this->Info[i].second;
+      std::replace( value.begin(), value.end(), '"', '\'' );
+      std::replace( value.begin(), value.end(), '\\', '/' );
+      fprintf( file, "  \"%s\": \"%s\",\n", this->Info[i].first.c_str(), value.c_str() );
+   }
+   fprintf( file, "  \"settings\": {" );
+   for( unsigned int i = 0; i < this->Settings.size(); ++i ){
+      fprintf( file, "%s\n    \"%s\": %g", i > 0 ? "," : "", this->Settings[i].first.c_str(), this->Settings[i].second );
+   }
+   fprintf( file, "\n  }" );
+   fprintf( file, ",\n  \"memory\": {" );
+   for( unsigned int i = 0; i < this->Memory.size(); ++i ){
+      const MemoryStats &cpu = this->Memory[i].second.first;
+      const MemoryStats &gpu = this->Memory[i].second.second;
+      fprintf( file, "%s\n    \"%s\": { \"cpu_bytes\": %lld, \"cpu_peak\": %lld, \"cpu_steady\": %lld, \"cpu_blocks\": %lld, \"cpu_allocs\": %lld, \"cpu_allocs_after_steady\": %lld, \"gpu_bytes\": %lld, \"gpu_peak\": %lld, \"gpu_steady\": %lld, \"gpu_objects\": %lld, \"gpu_allocs\": %lld, \"gpu_allocs_after_steady\": %lld }",
+         i > 0 ? "," : "",
+         this->Memory[i].first.c_str(),
+         (long long)cpu.Bytes,
+         (long long)cpu.Peak,
+         (long long)cpu.Steady,
+         (long long)cpu.Blocks,
+         (long long)cpu.Allocations,
+         (long long)( cpu.Allocations - cpu.SteadyAllocations ),
+         (long long)gpu.Bytes,
+         (long long)gpu.Peak,
+         (long long)gpu.Steady,
+         (long long)gpu.Blocks,
+         (long long)gpu.Allocations,
+         (long long)( gpu.Allocations - gpu.SteadyAllocations )
+      );
+   }
+   fprintf( file, "\n  }" );
+   BenchmarkStats stats;
+   for( unsigned int i = 0; i < BENCHMARK_METRICS; ++i ){
+      stats = this->ReturnStats( i );
+      if( stats.Samples == 0 ){
+         fprintf( file, ",\n  \"%s\": null", BenchmarkNames[i] );
+         continue;
+      }
+      fprintf( file, ",\n  \"%s\": { \"samples\": %u, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"worst\": %.4f, \"worst_frame\": %u }",
+         BenchmarkNames[i],
+         stats.Samples,
+         stats.Mean,
+         stats.P50,
+         stats.P95,
+         stats.P99,
+         stats.Worst,
+         stats.WorstIndex
+      );
+   }
+   fprintf( file, "\n}\n" );
+   const bool result = ferror( file ) == 0;
+   fclose( file );
+   if( result ){
+      SDL_Log( "\rBenchmark: report saved to %s\n", path.c_str() );
+   }
+   else{
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Benchmark: can not write %s\n", path.c_str() );
+   }
+   return result;
+}
+
+void Benchmark::Log() const{
+   BenchmarkStats stats;
+   for( unsigned int i = 0; i < BENCHMARK_METRICS; ++i ){
+      stats = this->ReturnStats( i );
+      if( stats.Samples == 0 ){
+         continue;
+      }
+      SDL_Log( "\r  %-14s mean %10.3f  p50 %10.3f  p95 %10.3f  p99 %10.3f  worst %10.3f (frame %u)",
+         BenchmarkNames[i],
+         stats.Mean,
+         stats.P50,
+         stats.P95,
+         stats.P99,
+         stats.Worst,
+         stats.WorstIndex
+      );
+   }
+}
+
+glm::vec3 Benchmark::ReturnPath( float t, float radius ){
+   const int count = sizeof( BenchmarkPath ) / sizeof( BenchmarkPath[0] );
+   t -= float( int( t ) );
+   if( t < 0.0f ){
+      t += 1.0f;
+   }
+   const float position = t * count;
+   const int segment = int( position ) % count;
+   const float s = position - float( int( position ) );
+   glm::vec3 points[4];
+   for( int i = 0; i < 4; ++i ){
+      const float *point = BenchmarkPath[( segment + count - 1 + i ) % count];
+      points[i] = glm::vec3( point[0] * radius, point[1], point[2] * radius );
+   }
+   //Catmull-Rom between points[1] and points[2]:
+   const float s2 = s * s, s3 = s2 * s;
+   return 0.5f * (
+      2.0f * points[1]
+      + ( points[2] - points[0] ) * s
+      + ( 2.0f * points[0] - 5.0f * points[1] + 4.0f * points[2] - points[3] ) * s2
+      + ( 3.0f * points[1] - points[0] - 3.0f * points[2] + points[3] ) * s3
+   );
+}
+
+BenchmarkStats Benchmark::Stats( const std::vector <float> &values ){
+   BenchmarkStats stats;
+   stats.Mean = stats.P50 = stats.P95 = stats.P99 = stats.Worst = 0.0f;
+   stats.WorstIndex = 0;
+   stats.Samples = values.size();
+   if( values.empty() ){
+      return stats;
+   }
+   double sum = 0.0;
+   for( unsigned int i = 0; i < values.size(); ++i ){
+      sum += values[i];
+      if( values[i] > stats.Worst or i == 0 ){
+         stats.Worst = values[i];
+         stats.WorstIndex = i;
+      }
+   }
+   stats.Mean = float( sum / values.size() );
+   //Nearest rank:
+   std::vector <float> sorted( values );
+   std::sort( sorted.begin(), sorted.end() );
+   stats.P50 = sorted[( sorted.size() * 50 + 99 ) / 100 - 1];
+   stats.P95 = sorted[( sorted.size() * 95 + 99 ) / 100 - 1];
+   stats.P99 = sorted[( sorted.size() * 99 + 99 ) / 100 - 1];
+   return stats;
+}
@@ -0,0 +1,193 @@
+/*!
+   \file benchmark.hpp
+   \brief Plik odpowiedzialny za pomiary trybu benchmark: ścieżkę kamery, statystyki klatek i raport JSON.
+*/
+#ifndef benchmark_hpp
+#define benchmark_hpp
+#include <string>
+#include <vector>
+#include <utility>
+#include <glm/glm.hpp>
+#include "memorytracker.hpp"
+
+/*!
+   \brief Domyślny plik raportu.
+*/
+#define BENCHMARK_FILE "./benchmark.json"
+/*!
+   \brief Domyślna ilość mierzonych klatek (jedno okrążenie ścieżki kamery).
+*/
+#define BENCHMARK_FRAMES 1000
+/*!
+   \brief Ilość klatek rysowanych przed pomiarem (wypełnienie pamięci podręcznych, cieni, zapytań GPU).
+*/
+#define BENCHMARK_WARMUP 30
+/*!
+   \brief Pomiar: czas klatki od poprzedniej klatki w milisekundach.
+*/
+#define BENCHMARK_FRAME 0
+/*!
+   \brief Pomiar: czas CPU wysyłania poleceń klatki w milisekundach.
+*/
+#define BENCHMARK_CPU 1
+/*!
+   \brief Pomiar: czas GPU klatki w milisekundach (wyniki z opóźnieniem kilku klatek).
+*/
+#define BENCHMARK_GPU 2
+/*!
+   \brief Pomiar: ilość poleceń rysowania.
+*/
+#define BENCHMARK_DRAWS 3
+/*!
+   \brief Pomiar: ilość trójkątów.
+*/
+#define BENCHMARK_TRIANGLES 4
+/*!
+   \brief Pomiar: zajęta pamięć GPU w MB (tylko GL_NVX_gpu_memory_info).
+*/
+#define BENCHMARK_MEMORY 5
+/*!
+   \brief Pomiar: pamięć CPU zgłoszona do \link MemoryTracker \endlink w MB.
+*/
+#define BENCHMARK_CPU_TRACKED 6
+/*!
+   \brief Pomiar: pamięć GPU zgłoszona do \link MemoryTracker \endlink w MB (wielkości liczone z formatów, bez sterownika).
+*/
+#define BENCHMARK_GPU_TRACKED 7
+/*!
+   \brief Ilość rodzajów pomiarów.
+*/
+#define BENCHMARK_METRICS 8
+
+/*!
+   \brief Statystyki jednego rodzaju pomiaru.
+*/
+struct BenchmarkStats{
+   /*!
+      \brief Średnia.
+   */
+   float Mean;
+   /*!
+      \brief Mediana.
+   */
+   float P50;
+   /*!
+      \brief 95. percentyl.
+   */
+   float P95;
+   /*!
+      \brief 99. percentyl.
+   */
+   float P99;
+   /*!
+      \brief Największa wartość.
+   */
+   float Worst;
+   /*!
+      \brief Numer pomiaru z największą wartością.
+   */
+   unsigned int WorstIndex;
+   /*!
+      \brief Ilość pomiarów.
+   */
+   unsigned int Samples;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za zbieranie pomiarów trybu benchmark i zapis raportu.
+
+   Pomiary dodawane są co klatkę ( \link Add() \endlink ), a \link Save() \endlink zapisuje ustawienia, pamięć podsystemów
+   i dla każdego rodzaju pomiaru średnią, medianę, 95. i 99. percentyl oraz najgorszą klatkę w formacie JSON.\n
+   Ścieżka kamery ( \link ReturnPath() \endlink ) jest zamkniętą krzywą Catmulla-Roma przez stałe punkty,
+   skalowaną do wielkości mapy, więc przelot jest taki sam przy każdym uruchomieniu.\n
+*/
+class Benchmark{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   Benchmark();
+   /*!
+      \brief Usuwa pomiary i ustawienia.
+   */
+   void Clear();
+   /*!
+      \brief Dodaje liczbową wartość ustawienia do raportu.
+
+      \param name - nazwa ustawienia
+      \param value - wartość
+   */
+   void AddSetting( const std::string &name, double value );
+   /*!
+      \brief Dodaje tekstową informację do raportu (np. nazwa sterownika).
+
+      \param name - nazwa
+      \param value - tekst
+   */
+   void AddInfo( const std::string &name, const std::string &value );
+   /*!
+      \brief Dodaje pamięć podsystemu do raportu (aktualna, największa i w stanie ustalonym).
+
+      \param name - nazwa podsystemu
+      \param cpu - pamięć CPU
+      \param gpu - pamięć GPU
+   */
+   void AddMemory( const std::string &name, const MemoryStats &cpu, const MemoryStats &gpu );
+   /*!
+      \brief Dodaje pomiar.
+
+      \param metric - rodzaj pomiaru ( BENCHMARK_* )
+      \param value - wartość
+   */
+   void Add( unsigned int metric, float value );
+   /*!
+      \brief Zwraca statystyki rodzaju pomiaru.
+
+      \param metric - rodzaj pomiaru ( BENCHMARK_* )
+   */
+   BenchmarkStats ReturnStats( unsigned int metric ) const;
+   /*!
+      \brief Zapisuje raport JSON.
+
+      \param path - ścieżka do pliku
+      \return - wartość logiczna, FALSE = błąd zapisu
+   */
+   bool Save( const std::string &path ) const;
+   /*!
+      \brief Wypisuje statystyki wszystkich pomiarów.
+   */
+   void Log() const;
+   /*!
+      \brief Zwraca punkt ścieżki kamery.
+
+      \param t - położenie na ścieżce (0-1, ścieżka jest zamknięta)
+      \param radius - połowa wielkości mapy, skala współrzędnych x i z
+      \return - pozycja kamery
+   */
+   static glm::vec3 ReturnPath( float t, float radius );
+   /*!
+      \brief Liczy statystyki pomiarów.
+
+      \param values - pomiary
+   */
+   static BenchmarkStats Stats( const std::vector <float> &values );
+private:
+   /*!
+      \brief Ustawienia liczbowe.
+   */
+   std::vector < std::pair <std::string, double> > Settings;
+   /*!
+      \brief Informacje tekstowe.
+   */
+   std::vector < std::pair <std::string, std::string> > Info;
+   /*!
+      \brief Pamięć podsystemów: nazwa, CPU i GPU.
+   */
+   std::vector < std::pair <std::string, std::pair <MemoryStats, MemoryStats> > > Memory;
+   /*!
+      \brief Pomiary każdego rodzaju.
+   */
+   std::vector <float> Values[BENCHMARK_METRICS];
+};
+
+#endif
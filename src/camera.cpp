@@ -14,6 +14,8 @@ Camera::Camera(){
 
 Camera::Camera( const Camera &camera ){
    this->Position = camera.Position;
+   this->StepPosition = camera.StepPosition;
+   this->RenderPosition = camera.RenderPosition;
    this->ViewDirection = camera.ViewDirection;
    this->Up = camera.Up;
 
@@ -37,6 +39,8 @@ Camera::~Camera(){
 
 Camera & Camera::operator=( const Camera &camera ){
    this->Position = camera.Position;
+   this->StepPosition = camera.StepPosition;
+   this->RenderPosition = camera.RenderPosition;
    this->ViewDirection = camera.ViewDirection;
    this->Up = camera.Up;
 
@@ -57,13 +61,17 @@ Camera & Camera::operator=( const Camera &camera ){
 }
 
 mat4 Camera::getViewMatrix() const{
-   return lookAt( this->Position, this->Position + this->ViewDirection, this->Up );
+   return lookAt( this->RenderPosition, this->RenderPosition + this->ViewDirection, this->Up );
 }
 
 mat4 Camera::getProjectionMatrix() const{
    return this->ProjectionMatrix;
 }
 
+Frustum Camera::getFrustum() const{
+   return Frustum( this->getProjectionMatrix() * this->getViewMatrix() );
+}
+
 void Camera::SetVOF( vec1 &vof ){
    this->VOF = vof;
    this->UpdateProjectionMatrix();
@@ -124,10 +132,10 @@ void Camera::MouseUpdate( const vec2 &Mouse ){
    this->ViewDirection = mat3( this->Rotation ) * this->ViewDirection;
 }
 
-void Camera::MoveUp(){
+void Camera::MoveUp( GLfloat scale ){
    if( this->FreeCamera ){
       this->PreviousPosition = this->Position;
-      this->Position += this->MovementSpeed.x * this->Up;
+      this->Position += scale * this->MovementSpeed.x * this->Up;
       if( any( greaterThanEqual( this->Position, this->PositionMax ) ) or
           any( lessThanEqual( this->Position, this->PositionMin ) )
         ){
@@ -136,10 +144,10 @@ void Camera::MoveUp(){
    }
 }
 
-void Camera::MoveDown(){
+void Camera::MoveDown( GLfloat scale ){
    if( this->FreeCamera ){
       this->PreviousPosition = this->Position;
-      this->Position -= this->MovementSpeed.x * this->Up;
+      this->Position -= scale * this->MovementSpeed.x * this->Up;
       if( any( greaterThanEqual( this->Position, this->PositionMax ) ) or
           any( lessThanEqual( this->Position, this->PositionMin ) )
         ){
@@ -148,12 +156,12 @@ void Camera::MoveDown(){
    }
 }
 
-void Camera::MoveForward(){
+void Camera::MoveForward( GLfloat scale ){
    this->PreviousPosition = this->Position;
-   this->Position.x += this->MovementSpeed.x * this->ViewDirection.x;
-   this->Position.z += this->MovementSpeed.x * this->ViewDirection.z;
+   this->Position.x += scale * this->MovementSpeed.x * this->ViewDirection.x;
+   this->Position.z += scale * this->MovementSpeed.x * this->ViewDirection.z;
    if( this->FreeCamera ){
-      this->Position.y += this->MovementSpeed.x * this->ViewDirection.y;
+      this->Position.y += scale * this->MovementSpeed.x * this->ViewDirection.y;
    }
    if( any( greaterThanEqual( this->Position, this->PositionMax ) ) or
        any( lessThanEqual( this->Position, this->PositionMin ) )
@@ -162,12 +170,12 @@ void Camera::MoveForward(){
    }
 }
 
-void Camera::MoveBackward(){
+void Camera::MoveBackward( GLfloat scale ){
    this->PreviousPosition = this->Position;
-   this->Position.x -= this->MovementSpeed.x * this->ViewDirection.x;
-   this->Position.z -= this->MovementSpeed.x * this->ViewDirection.z;
+   this->Position.x -= scale * this->MovementSpeed.x * this->ViewDirection.x;
+   this->Position.z -= scale * this->MovementSpeed.x * this->ViewDirection.z;
    if( this->FreeCamera ){
-      this->Position.y -= this->MovementSpeed.x * this->ViewDirection.y;
+      this->Position.y -= scale * this->MovementSpeed.x * this->ViewDirection.y;
    }
    if( any( greaterThanEqual( this->Position, this->PositionMax ) ) or
        any( lessThanEqual( this->Position, this->PositionMin ) )
@@ -176,10 +184,10 @@ void Camera::MoveBackward(){
    }
 }
 
-void Camera::MoveLeft(){
+void Camera::MoveLeft( GLfloat scale ){
    this->PreviousPosition = this->Position;
    this->MovementDirection = cross( this->ViewDirection, this->Up );//normalize( cross( this->ViewDirection, this->Up ) );
-   this->Position -= this->MovementSpeed.x * this->MovementDirection;
+   this->Position -= scale * this->MovementSpeed.x * this->MovementDirection;
    if( any( greaterThanEqual( this->Position, this->PositionMax ) ) or
        any( lessThanEqual( this->Position, this->PositionMin ) )
      ){
@@ -189,10 +197,10 @@ void Camera::MoveLeft(){
 
 //normalize( ) or fastNormalize( )
 
-void Camera::MoveRight(){
+void Camera::MoveRight( GLfloat scale ){
    this->PreviousPosition = this->Position;
    this->MovementDirection = cross( this->ViewDirection, this->Up );//normalize( cross( this->ViewDirection, this->Up ) );
-   this->Position += this->MovementSpeed.x * this->MovementDirection;
+   this->Position += scale * this->MovementSpeed.x * this->MovementDirection;
    if( any( greaterThanEqual( this->Position, this->PositionMax ) ) or
        any( lessThanEqual( this->Position, this->PositionMin ) )
      ){
@@ -214,13 +222,39 @@ void Camera::TurnFreeCamera(){
 void Camera::SetPositionDefault(){
    SDL_Log( "Set position default\n" );
    this->Position = vec3( 0.0f, 1.0f, 0.0f );
+   this->StepPosition = this->Position;
+   this->RenderPosition = this->Position;
    this->ViewDirection = vec3( 0.0f, 0.0f, -1.0f );
 }
 
+void Camera::SetView( const vec3 &position, const vec3 &direction ){
+   this->PreviousPosition = this->Position;
+   this->Position = position;
+   this->StepPosition = position;
+   this->RenderPosition = position;
+   this->ViewDirection = normalize( direction );
+}
+
+void Camera::BeginStep(){
+   this->StepPosition = this->Position;
+}
+
+void Camera::SetInterpolation( GLfloat alpha ){
+   this->RenderPosition = mix( this->StepPosition, this->Position, alpha );
+}
+
 vec3 Camera::ReturnPosition() const{
    return this->Position;
 }
 
+vec3 Camera::ReturnRenderPosition() const{
+   return this->RenderPosition;
+}
+
+vec1 Camera::ReturnFar() const{
+   return this->Far;
+}
+
 void Camera::Log() const{
    SDL_Log( "Camera:\n\tPosition: %f %f %f\n\tTarger  : %f %f %f\n\tUp      : %f %f %f\n\tVOF   : %f\tAspect: %f\tNear  : %f\tFar   : %f\n\tRotationSpeed: %f\tMovementSpeed: %f\n",
             this->Position.x, this->Position.y, this->Position.z,
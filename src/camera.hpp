@@ -12,6 +12,7 @@
 #else
 #include <glm/gtx/vec1.hpp>
 #endif
+#include "frustum.hpp"
 
 using namespace glm;
 
@@ -44,6 +45,10 @@ public:
       \brief Zwraca macierz projekcji.
    */
    mat4 getProjectionMatrix() const;
+   /*!
+      \brief Zwraca bryłę widzenia wyznaczoną z macierzy projekcji * widoku.
+   */
+   Frustum getFrustum() const;
    /*!
       \brief Ustala wartość \link VOF \endlink.
 
@@ -104,39 +109,51 @@ public:
    /*!
       \brief Porusza kamerę w góry.
 
+      \param scale - wielokrotność \link MovementSpeed \endlink, np. czas kroku symulacji * ilość ruchów na sekundę
+
       Szybkość poruszania uzależniona jest od wielkości \link MovementSpeed \endlink.
    */
-   void MoveUp();
+   void MoveUp( GLfloat scale = 1.0f );
    /*!
       \brief Porusza kamerę w dół.
 
+      \param scale - wielokrotność \link MovementSpeed \endlink, np. czas kroku symulacji * ilość ruchów na sekundę
+
       Szybkość poruszania uzależniona jest od wielkości \link MovementSpeed \endlink.
    */
-   void MoveDown();
+   void MoveDown( GLfloat scale = 1.0f );
    /*!
       \brief Porusza kamerę do przodu (przed siebie).
 
+      \param scale - wielokrotność \link MovementSpeed \endlink, np. czas kroku symulacji * ilość ruchów na sekundę
+
       Szybkość poruszania uzależniona jest od wielkości \link MovementSpeed \endlink.
    */
-   void MoveForward();
+   void MoveForward( GLfloat scale = 1.0f );
    /*!
       \brief Porusza kamerę do tyłu.
 
+      \param scale - wielokrotność \link MovementSpeed \endlink, np. czas kroku symulacji * ilość ruchów na sekundę
+
       Szybkość poruszania uzależniona jest od wielkości \link MovementSpeed \endlink.
    */
-   void MoveBackward();
+   void MoveBackward( GLfloat scale = 1.0f );
    /*!
       \brief Porusza kamerę w lewo.
 
+      \param scale - wielokrotność \link MovementSpeed \endlink, np. czas kroku symulacji * ilość ruchów na sekundę
+
       Szybkość poruszania uzależniona jest od wielkości \link MovementSpeed \endlink.
    */
-   void MoveLeft();
+   void MoveLeft( GLfloat scale = 1.0f );
    /*!
       \brief Porusza kamerę w prawo.
 
+      \param scale - wielokrotność \link MovementSpeed \endlink, np. czas kroku symulacji * ilość ruchów na sekundę
+
       Szybkość poruszania uzależniona jest od wielkości \link MovementSpeed \endlink.
    */
-   void MoveRight();
+   void MoveRight( GLfloat scale = 1.0f );
    /*!
       \brief Włącza lub wyłącza tryb wolnej kamery.
    */
@@ -148,9 +165,36 @@ public:
    */
    void SetPositionDefault();
    /*!
-      \brief Zwraca aktualną pozycję kamery.
+      \brief Ustawia pozycję i kierunek patrzenia kamery (bez sprawdzania granic ruchu).
+
+      \param position - nowa pozycja kamery
+      \param direction - nowy kierunek patrzenia
+   */
+   void SetView( const vec3 &position, const vec3 &direction );
+   /*!
+      \brief Zapamiętuje pozycję kamery przed krokiem symulacji ( \link StepPosition \endlink ).
+   */
+   void BeginStep();
+   /*!
+      \brief Ustala pozycję rysowania pomiędzy pozycją przed i po ostatnim kroku symulacji.
+
+      \param alpha - 0 = \link StepPosition \endlink, 1 = \link Position \endlink
+
+      Macierz widoku ( \link getViewMatrix() \endlink ) używa pozycji rysowania.
+   */
+   void SetInterpolation( GLfloat alpha );
+   /*!
+      \brief Zwraca aktualną pozycję kamery (po ostatnim kroku symulacji).
    */
    vec3 ReturnPosition() const;
+   /*!
+      \brief Zwraca pozycję rysowania kamery ( \link SetInterpolation() \endlink ).
+   */
+   vec3 ReturnRenderPosition() const;
+   /*!
+      \brief Zwraca odległość, do jakiej rysowane są obiekty ( \link Far \endlink ).
+   */
+   vec1 ReturnFar() const;
    /*!
       \brief Wyświetla informacje o kamerze.
    */
@@ -176,6 +220,14 @@ private:
       \brief Poprzednia pozycja kamery.
    */
    vec3 PreviousPosition = vec3( 0.0f, 1.0f, 0.0f );
+   /*!
+      \brief Pozycja kamery przed ostatnim krokiem symulacji.
+   */
+   vec3 StepPosition = vec3( 0.0f, 1.0f, 0.0f );
+   /*!
+      \brief Pozycja kamery w rysowanej klatce, pomiędzy \link StepPosition \endlink a \link Position \endlink.
+   */
+   vec3 RenderPosition = vec3( 0.0f, 1.0f, 0.0f );
    /*!
       \brief Maksymalna pozycja kamery.
    */
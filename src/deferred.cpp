@@ -0,0 +1,337 @@
+/*!
+   \file deferred.cpp
+   \brief Plik źródłowy dla deferred.hpp.
+*/
+#include "deferred.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <SDL2/SDL.h>
+#include <glm/gtc/type_ptr.hpp>
+#include "shader.hpp"
+#include "memorytracker.hpp"
+
+DeferredRenderer::DeferredRenderer(){
+   this->GBufferID = 0;
+   this->SunID = 0;
+   this->PointID = 0;
+   this->ComposeID = 0;
+   this->InverseUniformSun = -1;
+   this->InverseUniformPoint = -1;
+   this->Framebuffer = 0;
+   for( unsigned int i = 0; i < 4; ++i ){
+      this->Targets[i] = 0;
+   }
+   this->Depth = 0;
+   this->PreviousFramebuffer = 0;
+   this->ScreenVAO = 0;
+   this->SphereVAO = 0;
+   this->SphereBuffer = 0;
+   this->SphereVertices = 0;
+   this->MaxLights = 0;
+   this->Lights = 0;
+   this->Width = 0;
+   this->Height = 0;
+}
+
+DeferredRenderer::~DeferredRenderer(){
+   this->Destroy();
+}
+
+bool DeferredRenderer::Create( GLsizei width, GLsizei height, unsigned int max_lights ){
+   this->Destroy();
+   this->Width = width;
+   this->Height = height;
+   this->MaxLights = max_lights > 0 ? max_lights : 1;
+   //Shaders:
+   this->GBufferID = LoadShader( "./data/Shader.vert", "./data/GBuffer.frag" );
+   this->SunID = LoadShader( "./data/Deferred.vert", "./data/DeferredSun.frag" );
+   this->PointID = LoadShader( "./data/DeferredPoint.vert", "./data/DeferredPoint.frag" );
+   this->ComposeID = LoadShader( "./data/Deferred.vert", "./data/DeferredCompose.frag" );
+   if( this->GBufferID == 0 or this->SunID == 0 or this->PointID == 0 or this->ComposeID == 0 ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Deferred: something wrong with deferred shaders!\n" );
+      this->Destroy();
+      return false;
+   }
+   this->InverseUniformSun = glGetUniformLocation( this->SunID, "InverseViewProjection" );
+   this->InverseUniformPoint = glGetUniformLocation( this->PointID, "InverseViewProjection" );
+   //G-buffer texture units are fixed:
+   const char *samplers[4] = { "GAlbedo", "GSpecular", "GNormal", "GDepth" };
+   for( GLint i = 0; i < 4; ++i ){
+      glUseProgram( this->SunID );
+      glUniform1i( glGetUniformLocation( this->SunID, samplers[i] ), i );
+      glUseProgram( this->PointID );
+      glUniform1i( glGetUniformLocation( this->PointID, samplers[i] ), i );
+   }
+   glUseProgram( this->ComposeID );
+   glUniform1i( glGetUniformLocation( this->ComposeID, "Light" ), 0 );
+   glUseProgram( 0 );
+   if( ! this->CreateTargets() ){
+      this->Destroy();
+      return false;
+   }
+   //Light volumes:
+   if( ! this->Instances.Create( GL_ARRAY_BUFFER, this->MaxLights * sizeof( PointLightData ) ) ){
+      this->Destroy();
+      return false;
+   }
+   glGenVertexArrays( 1, &this->ScreenVAO );
+   this->CreateSphere();
+   SDL_Log( "Deferred: G-buffer %i x %i, max %u point lights, light volume %i vertices\n", (int)this->Width, (int)this->Height, this->MaxLights, (int)this->SphereVertices );
+   return true;
+}
+
+bool DeferredRenderer::Resize( GLsizei width, GLsizei height ){
+   if( this->Framebuffer == 0 or ( width == this->Width and height == this->Height ) ){
+      return true;
+   }
+   this->Width = width;
+   this->Height = height;
+   this->ReleaseTargets();
+   return this->CreateTargets();
+}
+
+void DeferredRenderer::Destroy(){
+   this->ReleaseTargets();
+   this->Instances.Destroy();
+   if( this->ScreenVAO != 0 ){
+      glDeleteVertexArrays( 1, &this->ScreenVAO );
+      this->ScreenVAO = 0;
+   }
+   if( this->SphereVAO != 0 ){
+      glDeleteVertexArrays( 1, &this->SphereVAO );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &this->SphereBuffer );
+      glDeleteBuffers( 1, &this->SphereBuffer );
+      this->SphereVAO = 0;
+      this->SphereBuffer = 0;
+   }
+   const GLuint programs[4] = { this->GBufferID, this->SunID, this->PointID, this->ComposeID };
+   MemoryTracker::RemoveObject( MEMORY_OBJECT_PROGRAM, 4, programs );
+   glDeleteProgram( this->GBufferID );
+   glDeleteProgram( this->SunID );
+   glDeleteProgram( this->PointID );
+   glDeleteProgram( this->ComposeID );
+   this->GBufferID = 0;
+   this->SunID = 0;
+   this->PointID = 0;
+   this->ComposeID = 0;
+}
+
+bool DeferredRenderer::CreateTargets(){
+   //Albedo + ambient, specular + shininess, normal + diffuse, light accumulation:
+   const GLint formats[4] = { GL_RGBA8, GL_RGBA8, GL_RGBA16F, GL_RGBA16F };
+   const GLenum types[4] = { GL_UNSIGNED_BYTE, GL_UNSIGNED_BYTE, GL_FLOAT, GL_FLOAT };
+   GLint previous_framebuffer;
+   glGetIntegerv( GL_FRAMEBUFFER_BINDING, &previous_framebuffer );
+   glGenFramebuffers( 1, &this->Framebuffer );
+   glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffer );
+   glGenTextures( 4, this->Targets );
+   for( unsigned int i = 0; i < 4; ++i ){
+      glBindTexture( GL_TEXTURE_2D, this->Targets[i] );
+      glTexImage2D( GL_TEXTURE_2D, 0, formats[i], this->Width, this->Height, 0, GL_RGBA, types[i], NULL );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, this->Targets[i], 0 );
+      MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_TEXTURE, this->Targets[i], MemoryTracker::TextureBytes( this->Width, this->Height, 1, formats[i] == GL_RGBA8 ? 4 : 8 ) );
+   }
+   glGenTextures( 1, &this->Depth );
+   glBindTexture( GL_TEXTURE_2D, this->Depth );
+   glTexImage2D( GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, this->Width, this->Height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, this->Depth, 0 );
+   //24 bit depth padded to 32 bits:
+   MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_TEXTURE, this->Depth, MemoryTracker::TextureBytes( this->Width, this->Height, 1, 4 ) );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   const bool complete = glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE;
+   glBindFramebuffer( GL_FRAMEBUFFER, previous_framebuffer );
+   if( ! complete ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Deferred: incomplete G-buffer\n" );
+      return false;
+   }
+   return true;
+}
+
+void DeferredRenderer::ReleaseTargets(){
+   if( this->Framebuffer != 0 ){
+      glDeleteFramebuffers( 1, &this->Framebuffer );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 4, this->Targets );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 1, &this->Depth );
+      glDeleteTextures( 4, this->Targets );
+      glDeleteTextures( 1, &this->Depth );
+   }
+   this->Framebuffer = 0;
+   for( unsigned int i = 0; i < 4; ++i ){
+      this->Targets[i] = 0;
+   }
+   this->Depth = 0;
+}
+
+void DeferredRenderer::CreateSphere(){
+   //Icosahedron:
+   const GLfloat t = ( 1.0f + std::sqrt( 5.0f ) ) * 0.5f;
+   const glm::vec3 corners[12] = {
+      glm::vec3( -1.0f, t, 0.0f ), glm::vec3( 1.0f, t, 0.0f ), glm::vec3( -1.0f, -t, 0.0f ), glm::vec3( 1.0f, -t, 0.0f ),
+      glm::vec3( 0.0f, -1.0f, t ), glm::vec3( 0.0f, 1.0f, t ), glm::vec3( 0.0f, -1.0f, -t ), glm::vec3( 0.0f, 1.0f, -t ),
+      glm::vec3( t, 0.0f, -1.0f ), glm::vec3( t, 0.0f, 1.0f ), glm::vec3( -t, 0.0f, -1.0f ), glm::vec3( -t, 0.0f, 1.0f )
+   };
+   const unsigned char faces[20][3] = {
+      { 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+      { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+      { 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+      { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 }
+   };
+   //Every face divided into 4 triangles, counter-clockwise from outside:
+   std::vector <glm::vec3> vertices;
+   vertices.reserve( 20 * 4 * 3 );
+   glm::vec3 a, b, c, ab, bc, ca;
+   for( unsigned int i = 0; i < 20; ++i ){
+      a = glm::normalize( corners[faces[i][0]] );
+      b = glm::normalize( corners[faces[i][1]] );
+      c = glm::normalize( corners[faces[i][2]] );
+      if( glm::dot( glm::cross( b - a, c - a ), a + b + c ) < 0.0f ){
+         std::swap( b, c );
+      }
+      ab = glm::normalize( a + b );
+      bc = glm::normalize( b + c );
+      ca = glm::normalize( c + a );
+      const glm::vec3 triangles[12] = { a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca };
+      vertices.insert( vertices.end(), triangles, triangles + 12 );
+   }
+   //Scale so the unit sphere lies inside every face:
+   GLfloat inner = 1.0f;
+   for( unsigned int i = 0; i < vertices.size(); i += 3 ){
+      const glm::vec3 normal = glm::normalize( glm::cross( vertices[i + 1] - vertices[i], vertices[i + 2] - vertices[i] ) );
+      inner = std::min( inner, glm::dot( normal, vertices[i] ) );
+   }
+   for( unsigned int i = 0; i < vertices.size(); ++i ){
+      vertices[i] /= inner;
+   }
+   this->SphereVertices = vertices.size();
+   glGenVertexArrays( 1, &this->SphereVAO );
+   glGenBuffers( 1, &this->SphereBuffer );
+   glBindVertexArray( this->SphereVAO );
+   glBindBuffer( GL_ARRAY_BUFFER, this->SphereBuffer );
+   glBufferData( GL_ARRAY_BUFFER, vertices.size() * sizeof( glm::vec3 ), &vertices[0], GL_STATIC_DRAW );
+   MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_BUFFER, this->SphereBuffer, vertices.size() * sizeof( glm::vec3 ) );
+   glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( glm::vec3 ), (GLvoid *)0 );
+   glEnableVertexAttribArray( 0 );
+   for( GLuint i = 1; i <= 3; ++i ){
+      glEnableVertexAttribArray( i );
+      glVertexAttribDivisor( i, 1 );
+   }
+   glBindBuffer( GL_ARRAY_BUFFER, 0 );
+   glBindVertexArray( 0 );
+}
+
+void DeferredRenderer::BeginGeometry(){
+   glGetIntegerv( GL_FRAMEBUFFER_BINDING, &this->PreviousFramebuffer );
+   glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffer );
+   const GLenum buffers[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
+   glDrawBuffers( 4, buffers );
+   glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+   glDrawBuffers( 3, buffers );
+}
+
+void DeferredRenderer::Shade( const glm::mat4 &view_projection, const std::vector <PointLightData> &lights ){
+   const glm::mat4 inverse = glm::inverse( view_projection );
+   glDrawBuffer( GL_COLOR_ATTACHMENT3 );
+   for( unsigned int i = 0; i < 4; ++i ){
+      glActiveTexture( GL_TEXTURE0 + i );
+      glBindTexture( GL_TEXTURE_2D, i < 3 ? this->Targets[i] : this->Depth );
+   }
+   //Depth texture is only read (depth writes off), it stays attached for light volume depth test:
+   glDepthMask( GL_FALSE );
+   glDisable( GL_DEPTH_TEST );
+   //Directional light, whole screen:
+   glUseProgram( this->SunID );
+   glUniformMatrix4fv( this->InverseUniformSun, 1, GL_FALSE, glm::value_ptr( inverse ) );
+   glBindVertexArray( this->ScreenVAO );
+   glDrawArrays( GL_TRIANGLES, 0, 3 );
+   //Point lights, back faces of light volumes in front of the farthest surface:
+   this->Lights = std::min( (unsigned int)lights.size(), this->MaxLights );
+   if( this->Lights > 0 ){
+      void *pointer = NULL;
+      const GLsizeiptr size = this->Lights * sizeof( PointLightData );
+      this->Instances.BeginFrame();
+      const GLintptr offset = this->Instances.Allocate( size, sizeof( GLfloat ), &pointer );
+      if( offset >= 0 ){
+         memcpy( pointer, &lights[0], size );
+         this->Instances.Flush();
+         glEnable( GL_BLEND );
+         glBlendFunc( GL_ONE, GL_ONE );
+         glEnable( GL_DEPTH_TEST );
+         glDepthFunc( GL_GEQUAL );
+         glEnable( GL_CULL_FACE );
+         glCullFace( GL_FRONT );
+         glUseProgram( this->PointID );
+         glUniformMatrix4fv( this->InverseUniformPoint, 1, GL_FALSE, glm::value_ptr( inverse ) );
+         glBindVertexArray( this->SphereVAO );
+         glBindBuffer( GL_ARRAY_BUFFER, this->Instances.ReturnBuffer() );
+         glVertexAttribPointer( 1, 4, GL_FLOAT, GL_FALSE, sizeof( PointLightData ), (GLvoid *)( offset + offsetof( PointLightData, PositionRadius ) ) );
+         glVertexAttribPointer( 2, 4, GL_FLOAT, GL_FALSE, sizeof( PointLightData ), (GLvoid *)( offset + offsetof( PointLightData, Color ) ) );
+         glVertexAttribPointer( 3, 4, GL_FLOAT, GL_FALSE, sizeof( PointLightData ), (GLvoid *)( offset + offsetof( PointLightData, Attenuation ) ) );
+         glBindBuffer( GL_ARRAY_BUFFER, 0 );
+         glDrawArraysInstanced( GL_TRIANGLES, 0, this->SphereVertices, this->Lights );
+         glCullFace( GL_BACK );
+         glDisable( GL_CULL_FACE );
+         glDisable( GL_BLEND );
+      }
+      this->Instances.EndFrame();
+   }
+   glBindVertexArray( 0 );
+   for( int i = 3; i >= 0; --i ){
+      glActiveTexture( GL_TEXTURE0 + i );
+      glBindTexture( GL_TEXTURE_2D, 0 );
+   }
+   glEnable( GL_DEPTH_TEST );
+   glDepthFunc( GL_LESS );
+   glDepthMask( GL_TRUE );
+}
+
+void DeferredRenderer::Compose(){
+   glBindFramebuffer( GL_FRAMEBUFFER, this->PreviousFramebuffer );
+   glDisable( GL_DEPTH_TEST );
+   glUseProgram( this->ComposeID );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, this->Targets[3] );
+   glBindVertexArray( this->ScreenVAO );
+   glDrawArrays( GL_TRIANGLES, 0, 3 );
+   glBindVertexArray( 0 );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   glEnable( GL_DEPTH_TEST );
+}
+
+GLuint DeferredRenderer::ReturnGBufferProgram() const{
+   return this->GBufferID;
+}
+
+GLuint DeferredRenderer::ReturnSunProgram() const{
+   return this->SunID;
+}
+
+GLuint DeferredRenderer::ReturnPointProgram() const{
+   return this->PointID;
+}
+
+unsigned int DeferredRenderer::ReturnLights() const{
+   return this->Lights;
+}
+
+GLfloat DeferredRenderer::LightRadius( const glm::vec3 &attenuation, const glm::vec3 &color ){
+   //constant + linear * d + quadratic * d^2 = brightness / cutoff
+   const GLfloat brightness = std::max( std::max( color.x, color.y ), color.z );
+   const GLfloat c = attenuation.x - brightness / DEFERRED_LIGHT_CUTOFF;
+   if( attenuation.z > 0.0f ){
+      return ( -attenuation.y + std::sqrt( attenuation.y * attenuation.y - 4.0f * attenuation.z * c ) ) / ( 2.0f * attenuation.z );
+   }
+   if( attenuation.y > 0.0f ){
+      return -c / attenuation.y;
+   }
+   return 1000.0f;
+}
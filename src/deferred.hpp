@@ -0,0 +1,210 @@
+/*!
+   \file deferred.hpp
+   \brief Plik odpowiedzialny za oświetlenie odroczone (deferred shading): G-bufor i bryły świateł punktowych.
+*/
+#ifndef deferred_hpp
+#define deferred_hpp
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "light.hpp"
+#include "ringbuffer.hpp"
+
+/*!
+   \brief Maksymalna ilość świateł punktowych w jednej klatce.
+*/
+#define DEFERRED_MAX_LIGHTS 1024
+/*!
+   \brief Jasność światła na granicy zasięgu, od której liczony jest promień bryły światła ( \link DeferredRenderer::LightRadius() \endlink ).
+*/
+#define DEFERRED_LIGHT_CUTOFF ( 1.0f / 64.0f )
+
+/*!
+   \brief Klasa odpowiedzialna za oświetlenie odroczone.
+
+   Obiekty nieprzezroczyste rysowane są do G-bufora ( \link BeginGeometry() \endlink ):\n
+   <ul>
+   <li>kolor tekstury (rgb) i współczynnik Ambient materiału (a), RGBA8</li>
+   <li>kolor odbłysku (rgb) i połysk / 256 (a), RGBA8</li>
+   <li>normalna (xyz) i współczynnik Diffuse materiału (w), RGBA16F</li>
+   <li>głębokość, 24 bity</li>
+   </ul>
+   Materiały modeli są szare, więc Ambient i Diffuse zapisywane są jako jedna wartość.\n
+   Następnie ( \link Shade() \endlink ) światło kierunkowe liczone jest jednym trójkątem na cały ekran,
+   a światła punktowe dodawane są jako instancje sfer o promieniu zasięgu światła (tylne ściany, test głębokości GL_GEQUAL),
+   więc koszt cieniowania zależy od ilości widocznych pikseli oświetlonych przez każde światło, a nie od ilości rysowanych fragmentów.\n
+   Kolejne przebiegi (impostory, obiekty świateł) rysowane są do bufora światła z głębokością G-bufora,
+   który na końcu kopiowany jest do poprzednio aktywnego bufora ramki ( \link Compose() \endlink ).\n
+*/
+class DeferredRenderer{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   DeferredRenderer();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia G-bufor, shadery i bufory ( \link Destroy() \endlink ).
+   */
+   ~DeferredRenderer();
+   /*!
+      \brief Wczytuje shadery, tworzy G-bufor i sferę bryły światła.
+
+      \param width - szerokość obrazu
+      \param height - wysokość obrazu
+      \param max_lights - maksymalna ilość świateł punktowych w jednej klatce
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create( GLsizei width, GLsizei height, unsigned int max_lights = DEFERRED_MAX_LIGHTS );
+   /*!
+      \brief Zmienia wielkość G-bufora.
+
+      \param width - szerokość obrazu
+      \param height - wysokość obrazu
+      \return - wartość logiczna, FALSE = niekompletny bufor ramki
+   */
+   bool Resize( GLsizei width, GLsizei height );
+   /*!
+      \brief Zwalnia G-bufor, shadery i bufory.
+   */
+   void Destroy();
+   /*!
+      \brief Aktywuje i czyści G-bufor.
+
+      Zapamiętuje aktualny bufor ramki (okno lub tryb headless) dla \link Compose() \endlink.
+   */
+   void BeginGeometry();
+   /*!
+      \brief Liczy oświetlenie do bufora światła.
+
+      \param view_projection - macierz projekcji * macierz widoku
+      \param lights - światła punktowe
+
+      Blok uniformów FrameData musi być przypisany ( \link ReturnSunProgram() \endlink, \link ReturnPointProgram() \endlink ).\n
+      Po powrocie aktywny jest bufor światła z głębokością G-bufora.
+   */
+   void Shade( const glm::mat4 &view_projection, const std::vector <PointLightData> &lights );
+   /*!
+      \brief Kopiuje bufor światła do bufora ramki aktywnego przed \link BeginGeometry() \endlink.
+   */
+   void Compose();
+   /*!
+      \brief Zwraca identyfikator shadera G-bufora (uniformy jak w głównym shaderze).
+   */
+   GLuint ReturnGBufferProgram() const;
+   /*!
+      \brief Zwraca identyfikator shadera światła kierunkowego.
+   */
+   GLuint ReturnSunProgram() const;
+   /*!
+      \brief Zwraca identyfikator shadera świateł punktowych.
+   */
+   GLuint ReturnPointProgram() const;
+   /*!
+      \brief Zwraca ilość świateł punktowych narysowanych w ostatniej klatce.
+   */
+   unsigned int ReturnLights() const;
+   /*!
+      \brief Zwraca promień zasięgu światła punktowego.
+
+      \param attenuation - tłumienie światła: x = stałe, y = liniowe, z = kwadratowe
+      \param color - kolor światła
+
+      Odległość, w której jasność najjaśniejszej składowej koloru spada do \link DEFERRED_LIGHT_CUTOFF \endlink.
+   */
+   static GLfloat LightRadius( const glm::vec3 &attenuation, const glm::vec3 &color );
+private:
+   /*!
+      \brief Tworzy tekstury i bufor ramki G-bufora.
+
+      \return - wartość logiczna, FALSE = niekompletny bufor ramki
+   */
+   bool CreateTargets();
+   /*!
+      \brief Zwalnia tekstury i bufor ramki G-bufora.
+   */
+   void ReleaseTargets();
+   /*!
+      \brief Tworzy sferę (podzielony dwudziestościan) opisaną na sferze jednostkowej.
+   */
+   void CreateSphere();
+   /*!
+      \brief Identyfikator shadera G-bufora.
+   */
+   GLuint GBufferID;
+   /*!
+      \brief Identyfikator shadera światła kierunkowego.
+   */
+   GLuint SunID;
+   /*!
+      \brief Identyfikator shadera świateł punktowych.
+   */
+   GLuint PointID;
+   /*!
+      \brief Identyfikator shadera kopiowania bufora światła.
+   */
+   GLuint ComposeID;
+   /*!
+      \brief Uniform odwrotności macierzy projekcji * widoku w shaderze światła kierunkowego.
+   */
+   GLint InverseUniformSun;
+   /*!
+      \brief Uniform odwrotności macierzy projekcji * widoku w shaderze świateł punktowych.
+   */
+   GLint InverseUniformPoint;
+   /*!
+      \brief Bufor ramki G-bufora.
+   */
+   GLuint Framebuffer;
+   /*!
+      \brief Tekstury G-bufora: kolor, odbłysk, normalne, bufor światła.
+   */
+   GLuint Targets[4];
+   /*!
+      \brief Tekstura głębokości G-bufora.
+   */
+   GLuint Depth;
+   /*!
+      \brief Bufor ramki aktywny przed \link BeginGeometry() \endlink.
+   */
+   GLint PreviousFramebuffer;
+   /*!
+      \brief Pusty VAO dla trójkąta na cały ekran.
+   */
+   GLuint ScreenVAO;
+   /*!
+      \brief VAO sfery z atrybutami instancji.
+   */
+   GLuint SphereVAO;
+   /*!
+      \brief Wierzchołki sfery.
+   */
+   GLuint SphereBuffer;
+   /*!
+      \brief Ilość wierzchołków sfery.
+   */
+   GLsizei SphereVertices;
+   /*!
+      \brief Bufor atrybutów instancji świateł, zapisywany co klatkę.
+   */
+   RingBuffer Instances;
+   /*!
+      \brief Maksymalna ilość świateł w jednej klatce.
+   */
+   unsigned int MaxLights;
+   /*!
+      \brief Ilość świateł narysowanych w ostatniej klatce.
+   */
+   unsigned int Lights;
+   /*!
+      \brief Szerokość G-bufora.
+   */
+   GLsizei Width;
+   /*!
+      \brief Wysokość G-bufora.
+   */
+   GLsizei Height;
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*!
+   \file framepacer.cpp
+   \brief Plik źródłowy dla framepacer.hpp.
+*/
+#include "framepacer.hpp"
+#include <cmath>
+
+FramePacer::FramePacer(){
+   this->Frequency = SDL_GetPerformanceFrequency();
+   this->Period = 0;
+   this->RefreshPeriod = 0;
+   this->Deadline = 0;
+   this->Previous = 0;
+   this->Last = 0.0;
+   this->Reset();
+}
+
+void FramePacer::SetLimit( int fps ){
+   this->Period = fps > 0 ? this->Frequency / fps : 0;
+   this->Deadline = 0;
+}
+
+void FramePacer::SetRefresh( int fps ){
+   this->RefreshPeriod = fps > 0 ? this->Frequency / fps : 0;
+}
+
+void FramePacer::Wait(){
+   if( this->Period == 0 ){
+      return;
+   }
+   const Uint64 now = SDL_GetPerformanceCounter();
+   if( this->Deadline == 0 or now > this->Deadline + this->Period ){
+      //First frame or more than one frame late, no catching up:
+      this->Deadline = now + this->Period;
+      return;
+   }
+   const Uint64 spin = Uint64( PACER_SPIN_MS * this->Frequency / 1000.0 );
+   if( this->Deadline > now + spin ){
+      SDL_Delay( Uint32( ( this->Deadline - now - spin ) * 1000 / this->Frequency ) );
+   }
+   while( SDL_GetPerformanceCounter() < this->Deadline ){
+   }
+   this->Deadline += this->Period;
+}
+
+void FramePacer::EndFrame(){
+   const Uint64 now = SDL_GetPerformanceCounter();
+   if( this->Previous != 0 ){
+      const double time = double( now - this->Previous ) * 1000.0 / double( this->Frequency );
+      this->Last = time;
+      ++this->Frames;
+      const double delta = time - this->Mean;
+      this->Mean += delta / this->Frames;
+      this->Squares += delta * ( time - this->Mean );
+      if( time > this->Max ){
+         this->Max = time;
+      }
+      const double target = this->ReturnTarget();
+      if( target > 0.0 and time > target * PACER_LATE ){
+         ++this->Late;
+      }
+   }
+   this->Previous = now;
+}
+
+double FramePacer::ReturnLast() const{
+   return this->Last;
+}
+
+double FramePacer::ReturnAverage() const{
+   return this->Mean;
+}
+
+double FramePacer::ReturnDeviation() const{
+   return this->Frames > 1 ? sqrt( this->Squares / ( this->Frames - 1 ) ) : 0.0;
+}
+
+double FramePacer::ReturnMax() const{
+   return this->Max;
+}
+
+unsigned int FramePacer::ReturnLate() const{
+   return this->Late;
+}
+
+unsigned int FramePacer::ReturnFrames() const{
+   return this->Frames;
+}
+
+double FramePacer::ReturnTarget() const{
+   const Uint64 period = this->Period > this->RefreshPeriod ? this->Period : this->RefreshPeriod;
+   return double( period ) * 1000.0 / double( this->Frequency );
+}
+
+void FramePacer::Reset(){
+   this->Frames = 0;
+   this->Late = 0;
+   this->Mean = 0.0;
+   this->Squares = 0.0;
+   this->Max = 0.0;
+}
@@ -0,0 +1,144 @@
+/*!
+   \file framepacer.hpp
+   \brief Plik odpowiedzialny za ograniczanie ilości klatek i pomiar równomierności klatek.
+*/
+#ifndef framepacer_hpp
+#define framepacer_hpp
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Tryb wyświetlania: bez synchronizacji pionowej.
+*/
+#define PRESENT_UNCAPPED 0
+/*!
+   \brief Tryb wyświetlania: synchronizacja pionowa.
+*/
+#define PRESENT_VSYNC 1
+/*!
+   \brief Tryb wyświetlania: adaptacyjna synchronizacja pionowa (spóźniona klatka wyświetlana od razu).
+*/
+#define PRESENT_ADAPTIVE 2
+/*!
+   \brief Czas przed terminem klatki (w milisekundach), od którego \link FramePacer::Wait() \endlink czeka aktywnie zamiast spać.
+*/
+#define PACER_SPIN_MS 2.0
+/*!
+   \brief Klatka jest spóźniona, jeśli trwała dłużej niż oczekiwany czas * \link PACER_LATE \endlink.
+*/
+#define PACER_LATE 1.5
+
+/*!
+   \brief Klasa odpowiedzialna za ograniczanie ilości klatek i pomiar równomierności klatek.
+
+   \link Wait() \endlink przed zamianą buforów śpi (SDL_Delay) do \link PACER_SPIN_MS \endlink przed terminem klatki,
+   a resztę czasu czeka aktywnie, dzięki czemu klatki są równe bez zajmowania procesora przez cały czas.\n
+   Terminy kolejnych klatek liczone są od poprzedniego terminu, nie od końca klatki, więc błędy nie kumulują się.\n
+   \link EndFrame() \endlink po zamianie buforów zapisuje czas od poprzedniej klatki: średnią, odchylenie standardowe,
+   najdłuższą klatkę i ilość klatek spóźnionych ( \link PACER_LATE \endlink ).\n
+*/
+class FramePacer{
+public:
+   /*!
+      \brief Konstruktor domyślny, bez ograniczenia.
+   */
+   FramePacer();
+   /*!
+      \brief Ustala ograniczenie ilości klatek.
+
+      \param fps - ilość klatek na sekundę, 0 = bez ograniczenia
+   */
+   void SetLimit( int fps );
+   /*!
+      \brief Ustala oczekiwany czas klatki dla klatek spóźnionych.
+
+      \param fps - częstotliwość odświeżania ekranu, 0 = tylko ograniczenie z \link SetLimit() \endlink
+   */
+   void SetRefresh( int fps );
+   /*!
+      \brief Czeka do terminu klatki, jeśli ustalono ograniczenie.
+   */
+   void Wait();
+   /*!
+      \brief Zapisuje czas od poprzedniej klatki.
+   */
+   void EndFrame();
+   /*!
+      \brief Zwraca czas ostatniej klatki w milisekundach.
+   */
+   double ReturnLast() const;
+   /*!
+      \brief Zwraca średni czas klatki w milisekundach od \link Reset() \endlink.
+   */
+   double ReturnAverage() const;
+   /*!
+      \brief Zwraca odchylenie standardowe czasu klatki w milisekundach.
+   */
+   double ReturnDeviation() const;
+   /*!
+      \brief Zwraca najdłuższy czas klatki w milisekundach.
+   */
+   double ReturnMax() const;
+   /*!
+      \brief Zwraca ilość klatek spóźnionych.
+   */
+   unsigned int ReturnLate() const;
+   /*!
+      \brief Zwraca ilość klatek od \link Reset() \endlink.
+   */
+   unsigned int ReturnFrames() const;
+   /*!
+      \brief Zwraca oczekiwany czas klatki w milisekundach, 0 = brak.
+   */
+   double ReturnTarget() const;
+   /*!
+      \brief Zeruje statystyki.
+   */
+   void Reset();
+private:
+   /*!
+      \brief Częstotliwość SDL_GetPerformanceCounter().
+   */
+   Uint64 Frequency;
+   /*!
+      \brief Czas klatki z ograniczenia, 0 = bez ograniczenia.
+   */
+   Uint64 Period;
+   /*!
+      \brief Oczekiwany czas klatki z częstotliwości odświeżania, 0 = brak.
+   */
+   Uint64 RefreshPeriod;
+   /*!
+      \brief Termin następnej klatki, 0 = nie ustalony.
+   */
+   Uint64 Deadline;
+   /*!
+      \brief Koniec poprzedniej klatki, 0 = brak.
+   */
+   Uint64 Previous;
+   /*!
+      \brief Czas ostatniej klatki.
+   */
+   double Last;
+   /*!
+      \brief Ilość klatek.
+   */
+   unsigned int Frames;
+   /*!
+      \brief Ilość klatek spóźnionych.
+   */
+   unsigned int Late;
+   /*!
+      \brief Średni czas klatki (algorytm Welforda).
+   */
+   double Mean;
+   /*!
+      \brief Suma kwadratów różnic od średniej (algorytm Welforda).
+   */
+   double Squares;
+   /*!
+      \brief Najdłuższy czas klatki.
+   */
+   double Max;
+};
+
+#endif
@@ -0,0 +1,201 @@
+/*!
+   \file frustum.cpp
+   \brief Plik źródłowy dla frustum.hpp.
+*/
+#include "frustum.hpp"
+#include <cmath>
+#include <glm/gtc/type_ptr.hpp>
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+Frustum::Frustum(){
+   for( int i = 0; i < 6; ++i ){
+      this->Planes[i] = glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
+   }
+   for( int i = 0; i < 8; ++i ){
+      this->PlaneX[i] = 0.0f;
+      this->PlaneY[i] = 0.0f;
+      this->PlaneZ[i] = 0.0f;
+      this->PlaneW[i] = 1.0f;
+   }
+}
+
+Frustum::Frustum( const glm::mat4 &matrix ){
+   this->Update( matrix );
+}
+
+void Frustum::Update( const glm::mat4 &matrix ){
+   //Rows of matrix (glm is column-major):
+   glm::vec4 row[4];
+   for( int i = 0; i < 4; ++i ){
+      row[i] = glm::vec4( matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i] );
+   }
+   this->Planes[0] = row[3] + row[0]; //left
+   this->Planes[1] = row[3] - row[0]; //right
+   this->Planes[2] = row[3] + row[1]; //bottom
+   this->Planes[3] = row[3] - row[1]; //top
+   this->Planes[4] = row[3] + row[2]; //near
+   this->Planes[5] = row[3] - row[2]; //far
+   float length;
+   for( int i = 0; i < 6; ++i ){
+      length = std::sqrt( this->Planes[i].x * this->Planes[i].x +
+                          this->Planes[i].y * this->Planes[i].y +
+                          this->Planes[i].z * this->Planes[i].z );
+      if( length > 0.0f ){
+         this->Planes[i] /= length;
+      }
+   }
+   //SoA, last two slots repeat left and right plane:
+   for( int i = 0; i < 8; ++i ){
+      this->PlaneX[i] = this->Planes[i % 6].x;
+      this->PlaneY[i] = this->Planes[i % 6].y;
+      this->PlaneZ[i] = this->Planes[i % 6].z;
+      this->PlaneW[i] = this->Planes[i % 6].w;
+   }
+}
+
+int Frustum::TestBox( const glm::vec3 &min, const glm::vec3 &max ) const{
+   const glm::vec3 center = ( min + max ) * 0.5f;
+   const glm::vec3 extent = ( max - min ) * 0.5f;
+   int result = FRUSTUM_INSIDE;
+   float d, r;
+   for( int i = 0; i < 6; ++i ){
+      d = this->Planes[i].x * center.x + this->Planes[i].y * center.y + this->Planes[i].z * center.z + this->Planes[i].w;
+      r = std::fabs( this->Planes[i].x ) * extent.x + std::fabs( this->Planes[i].y ) * extent.y + std::fabs( this->Planes[i].z ) * extent.z;
+      if( d + r < 0.0f ){
+         return FRUSTUM_OUTSIDE;
+      }
+      if( d - r < 0.0f ){
+         result = FRUSTUM_INTERSECT;
+      }
+   }
+   return result;
+}
+
+#ifdef FRUSTUM_SSE
+/*!
+   \brief Test jednego prostopadłościanu względem 8 płaszczyzn (SSE).
+
+   Środek i połowa rozmiaru prostopadłościanu są transformowane macierzą modelu
+   ( |M| * extent ), następnie liczona jest odległość od płaszczyzn po 4 naraz.
+*/
+static inline bool BoxOutsideSSE( const float *m,
+   const __m128 &cx, const __m128 &cy, const __m128 &cz,
+   const __m128 &ex, const __m128 &ey, const __m128 &ez,
+   const __m128 *px, const __m128 *py, const __m128 *pz, const __m128 *pw,
+   const __m128 *ax, const __m128 *ay, const __m128 *az
+){
+   const __m128 sign = _mm_set1_ps( -0.0f );
+   const __m128 c0 = _mm_loadu_ps( m );
+   const __m128 c1 = _mm_loadu_ps( m + 4 );
+   const __m128 c2 = _mm_loadu_ps( m + 8 );
+   const __m128 c3 = _mm_loadu_ps( m + 12 );
+   //World center and extent:
+   __m128 wc = _mm_add_ps( _mm_add_ps( _mm_mul_ps( c0, cx ), _mm_mul_ps( c1, cy ) ), _mm_add_ps( _mm_mul_ps( c2, cz ), c3 ) );
+   __m128 we = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_andnot_ps( sign, c0 ), ex ), _mm_mul_ps( _mm_andnot_ps( sign, c1 ), ey ) ),
+                           _mm_mul_ps( _mm_andnot_ps( sign, c2 ), ez ) );
+   const __m128 wcx = _mm_shuffle_ps( wc, wc, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+   const __m128 wcy = _mm_shuffle_ps( wc, wc, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+   const __m128 wcz = _mm_shuffle_ps( wc, wc, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+   const __m128 wex = _mm_shuffle_ps( we, we, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+   const __m128 wey = _mm_shuffle_ps( we, we, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+   const __m128 wez = _mm_shuffle_ps( we, we, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+   int outside = 0;
+   __m128 d, r;
+   for( int i = 0; i < 2; ++i ){
+      d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( px[i], wcx ), _mm_mul_ps( py[i], wcy ) ), _mm_add_ps( _mm_mul_ps( pz[i], wcz ), pw[i] ) );
+      r = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax[i], wex ), _mm_mul_ps( ay[i], wey ) ), _mm_mul_ps( az[i], wez ) );
+      outside |= _mm_movemask_ps( _mm_cmplt_ps( _mm_add_ps( d, r ), _mm_setzero_ps() ) );
+   }
+   return outside != 0;
+}
+#else
+/*!
+   \brief Test jednego prostopadłościanu względem 6 płaszczyzn (bez SSE).
+*/
+static inline bool BoxOutsideScalar( const glm::mat4 &m, const glm::vec3 &center, const glm::vec3 &extent, const glm::vec4 *planes ){
+   glm::vec3 wc = glm::vec3( m * glm::vec4( center, 1.0f ) );
+   glm::vec3 we;
+   for( int i = 0; i < 3; ++i ){
+      we[i] = std::fabs( m[0][i] ) * extent.x + std::fabs( m[1][i] ) * extent.y + std::fabs( m[2][i] ) * extent.z;
+   }
+   for( int i = 0; i < 6; ++i ){
+      if( planes[i].x * wc.x + planes[i].y * wc.y + planes[i].z * wc.z + planes[i].w +
+          std::fabs( planes[i].x ) * we.x + std::fabs( planes[i].y ) * we.y + std::fabs( planes[i].z ) * we.z < 0.0f ){
+         return true;
+      }
+   }
+   return false;
+}
+#endif
+
+bool Frustum::TestBox( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max ) const{
+   const glm::vec3 center = ( min + max ) * 0.5f;
+   const glm::vec3 extent = ( max - min ) * 0.5f;
+#ifdef FRUSTUM_SSE
+   const __m128 sign = _mm_set1_ps( -0.0f );
+   __m128 px[2], py[2], pz[2], pw[2], ax[2], ay[2], az[2];
+   for( int i = 0; i < 2; ++i ){
+      px[i] = _mm_loadu_ps( this->PlaneX + 4 * i );
+      py[i] = _mm_loadu_ps( this->PlaneY + 4 * i );
+      pz[i] = _mm_loadu_ps( this->PlaneZ + 4 * i );
+      pw[i] = _mm_loadu_ps( this->PlaneW + 4 * i );
+      ax[i] = _mm_andnot_ps( sign, px[i] );
+      ay[i] = _mm_andnot_ps( sign, py[i] );
+      az[i] = _mm_andnot_ps( sign, pz[i] );
+   }
+   return ! BoxOutsideSSE( glm::value_ptr( matrix ),
+      _mm_set1_ps( center.x ), _mm_set1_ps( center.y ), _mm_set1_ps( center.z ),
+      _mm_set1_ps( extent.x ), _mm_set1_ps( extent.y ), _mm_set1_ps( extent.z ),
+      px, py, pz, pw, ax, ay, az
+   );
+#else
+   return ! BoxOutsideScalar( matrix, center, extent, this->Planes );
+#endif
+}
+
+unsigned int Frustum::TestBoxes( const std::vector <glm::mat4> &matrices,
+   const glm::vec3 &min,
+   const glm::vec3 &max,
+   std::vector <GLuint> &visible
+) const{
+   const glm::vec3 center = ( min + max ) * 0.5f;
+   const glm::vec3 extent = ( max - min ) * 0.5f;
+   const unsigned int size = matrices.size();
+   unsigned int counter = 0;
+#ifdef FRUSTUM_SSE
+   const __m128 sign = _mm_set1_ps( -0.0f );
+   __m128 px[2], py[2], pz[2], pw[2], ax[2], ay[2], az[2];
+   for( int i = 0; i < 2; ++i ){
+      px[i] = _mm_loadu_ps( this->PlaneX + 4 * i );
+      py[i] = _mm_loadu_ps( this->PlaneY + 4 * i );
+      pz[i] = _mm_loadu_ps( this->PlaneZ + 4 * i );
+      pw[i] = _mm_loadu_ps( this->PlaneW + 4 * i );
+      ax[i] = _mm_andnot_ps( sign, px[i] );
+      ay[i] = _mm_andnot_ps( sign, py[i] );
+      az[i] = _mm_andnot_ps( sign, pz[i] );
+   }
+   const __m128 cx = _mm_set1_ps( center.x ), cy = _mm_set1_ps( center.y ), cz = _mm_set1_ps( center.z );
+   const __m128 ex = _mm_set1_ps( extent.x ), ey = _mm_set1_ps( extent.y ), ez = _mm_set1_ps( extent.z );
+   for( unsigned int i = 0; i < size; ++i ){
+      if( ! BoxOutsideSSE( glm::value_ptr( matrices[i] ), cx, cy, cz, ex, ey, ez, px, py, pz, pw, ax, ay, az ) ){
+         visible.push_back( i );
+         ++counter;
+      }
+   }
+#else
+   for( unsigned int i = 0; i < size; ++i ){
+      if( ! BoxOutsideScalar( matrices[i], center, extent, this->Planes ) ){
+         visible.push_back( i );
+         ++counter;
+      }
+   }
+#endif
+   return counter;
+}
+
+glm::vec4 Frustum::ReturnPlane( unsigned int i ) const{
+   return this->Planes[i % 6];
+}
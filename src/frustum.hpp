@@ -0,0 +1,111 @@
+/*!
+   \file frustum.hpp
+   \brief Plik odpowiedzialny za bryłę widzenia kamery (frustum culling).
+*/
+#ifndef frustum_hpp
+#define frustum_hpp
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/*!
+   \brief Obiekt znajduje się całkowicie poza bryłą widzenia.
+*/
+#define FRUSTUM_OUTSIDE 0
+/*!
+   \brief Obiekt przecina bryłę widzenia.
+*/
+#define FRUSTUM_INTERSECT 1
+/*!
+   \brief Obiekt znajduje się całkowicie wewnątrz bryły widzenia.
+*/
+#define FRUSTUM_INSIDE 2
+
+/*!
+   \brief Klasa odpowiedzialna za bryłę widzenia kamery.
+
+   Płaszczyzny wyznaczane są z macierzy projekcji * widoku (metoda Gribb/Hartmann).\n
+   Test prostopadłościanów wykorzystuje instrukcje SSE (jeśli są dostępne).\n
+*/
+class Frustum{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+
+      Ustala płaszczyzny, które nie odrzucają żadnego obiektu.
+   */
+   Frustum();
+   /*!
+      \brief Konstruktor.
+
+      \param matrix - macierz projekcji * widoku, z której zostaną wyznaczone płaszczyzny
+   */
+   Frustum( const glm::mat4 &matrix );
+   /*!
+      \brief Wyznacza płaszczyzny bryły widzenia.
+
+      \param matrix - macierz projekcji * widoku
+   */
+   void Update( const glm::mat4 &matrix );
+   /*!
+      \brief Sprawdza położenie prostopadłościanu (w przestrzeni świata) względem bryły widzenia.
+
+      \param min - minimalny punkt prostopadłościanu
+      \param max - maksymalny punkt prostopadłościanu
+      \return - \link FRUSTUM_OUTSIDE \endlink, \link FRUSTUM_INTERSECT \endlink lub \link FRUSTUM_INSIDE \endlink
+   */
+   int TestBox( const glm::vec3 &min, const glm::vec3 &max ) const;
+   /*!
+      \brief Sprawdza czy prostopadłościan obiektu po transformacji macierzą modelu jest widoczny.
+
+      \param matrix - macierz modelu
+      \param min - minimalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \param max - maksymalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \return - wartość logiczna, FALSE = obiekt poza bryłą widzenia
+   */
+   bool TestBox( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max ) const;
+   /*!
+      \brief Sprawdza widoczność wielu obiektów o tym samym prostopadłościanie.
+
+      \param matrices - wektor macierzy modelu
+      \param min - minimalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \param max - maksymalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \param visible - wektor, do którego zostaną dodane numery widocznych macierzy
+      \return - ilość widocznych obiektów
+   */
+   unsigned int TestBoxes( const std::vector <glm::mat4> &matrices,
+      const glm::vec3 &min,
+      const glm::vec3 &max,
+      std::vector <GLuint> &visible
+   ) const;
+   /*!
+      \brief Zwraca i-tą płaszczyznę (a, b, c, d), gdzie a*x + b*y + c*z + d >= 0 oznacza wnętrze bryły.
+
+      \param i - numer płaszczyzny (0 - lewa, 1 - prawa, 2 - dolna, 3 - górna, 4 - bliska, 5 - daleka)
+   */
+   glm::vec4 ReturnPlane( unsigned int i ) const;
+private:
+   /*!
+      \brief Płaszczyzny bryły widzenia.
+   */
+   glm::vec4 Planes[6];
+   /*!
+      \var PlaneX
+      \brief Składowe x płaszczyzn (układ SoA dla SSE, 6 płaszczyzn uzupełnione do 8).
+   */
+   /*!
+      \var PlaneY
+      \brief Składowe y płaszczyzn (układ SoA dla SSE, 6 płaszczyzn uzupełnione do 8).
+   */
+   /*!
+      \var PlaneZ
+      \brief Składowe z płaszczyzn (układ SoA dla SSE, 6 płaszczyzn uzupełnione do 8).
+   */
+   /*!
+      \var PlaneW
+      \brief Składowe w płaszczyzn (układ SoA dla SSE, 6 płaszczyzn uzupełnione do 8).
+   */
+   float PlaneX[8], PlaneY[8], PlaneZ[8], PlaneW[8];
+};
+
+#endif
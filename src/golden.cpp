@@ -0,0 +1,113 @@
+/*!
+   \file golden.cpp
+   \brief Plik źródłowy dla golden.hpp.
+*/
+#include "golden.hpp"
+#include <cstring>
+#include <SDL2/SDL.h>
+#include <IL/il.h>
+#include <IL/ilu.h>
+
+GoldenImage::GoldenImage(){
+   this->Width = 0;
+   this->Height = 0;
+}
+
+void GoldenImage::Capture( GLsizei width, GLsizei height ){
+   this->Width = width;
+   this->Height = height;
+   this->Pixels.resize( this->Width * this->Height * 4 );
+   glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+   glReadPixels( 0, 0, this->Width, this->Height, GL_RGBA, GL_UNSIGNED_BYTE, &this->Pixels[0] );
+}
+
+bool GoldenImage::Load( const std::string &path ){
+   ILuint image_id;
+   ilGenImages( 1, &image_id );
+   ilBindImage( image_id );
+   //Same row order as glReadPixels:
+   ilEnable( IL_ORIGIN_SET );
+   ilOriginFunc( IL_ORIGIN_LOWER_LEFT );
+   const bool success = ilLoadImage( path.c_str() ) and ilConvertImage( IL_RGBA, IL_UNSIGNED_BYTE );
+   ilDisable( IL_ORIGIN_SET );
+   if( ! success ){
+      SDL_LogError( SDL_LOG_CATEGORY_INPUT, "GoldenImage: can't load %s: %s\n", path.c_str(), iluErrorString( ilGetError() ) );
+      ilDeleteImages( 1, &image_id );
+      return false;
+   }
+   this->Width = ilGetInteger( IL_IMAGE_WIDTH );
+   this->Height = ilGetInteger( IL_IMAGE_HEIGHT );
+   this->Pixels.resize( this->Width * this->Height * 4 );
+   memcpy( &this->Pixels[0], ilGetData(), this->Pixels.size() );
+   ilDeleteImages( 1, &image_id );
+   return true;
+}
+
+bool GoldenImage::Save( const std::string &path ) const{
+   if( this->Pixels.empty() ){
+      return false;
+   }
+   ILuint image_id;
+   ilGenImages( 1, &image_id );
+   ilBindImage( image_id );
+   bool success = ilTexImage( this->Width, this->Height, 1, 4, IL_RGBA, IL_UNSIGNED_BYTE, (void *)&this->Pixels[0] );
+   if( success ){
+      ilEnable( IL_FILE_OVERWRITE );
+      success = ilSaveImage( path.c_str() );
+   }
+   if( ! success ){
+      SDL_LogError( SDL_LOG_CATEGORY_INPUT, "GoldenImage: can't save %s: %s\n", path.c_str(), iluErrorString( ilGetError() ) );
+   }
+   ilDeleteImages( 1, &image_id );
+   return success;
+}
+
+float GoldenImage::Compare( const GoldenImage &reference, float threshold, GoldenImage *diff ) const{
+   if( this->Width != reference.Width or this->Height != reference.Height or this->Pixels.empty() ){
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "GoldenImage: size %i x %i, reference %i x %i\n",
+         this->Width, this->Height, reference.Width, reference.Height
+      );
+      return 1.0f;
+   }
+   if( diff != NULL ){
+      diff->Width = this->Width;
+      diff->Height = this->Height;
+      diff->Pixels.resize( this->Pixels.size() );
+   }
+   const float max_delta = 35215.0f * threshold * threshold;
+   unsigned int different = 0;
+   unsigned char gray;
+   for( unsigned int i = 0; i < this->Pixels.size(); i += 4 ){
+      const bool differ = GoldenImage::ColorDelta( &this->Pixels[i], &reference.Pixels[i] ) > max_delta;
+      if( differ ){
+         ++different;
+      }
+      if( diff != NULL ){
+         //Faded reference with different pixels in red:
+         gray = ( reference.Pixels[i] + reference.Pixels[i + 1] + reference.Pixels[i + 2] ) / 12;
+         diff->Pixels[i] = differ ? 255 : gray;
+         diff->Pixels[i + 1] = differ ? 0 : gray;
+         diff->Pixels[i + 2] = differ ? 0 : gray;
+         diff->Pixels[i + 3] = 255;
+      }
+   }
+   return float( different ) / float( this->Width * this->Height );
+}
+
+float GoldenImage::ColorDelta( const unsigned char *a, const unsigned char *b ){
+   const float red = float( a[0] ) - float( b[0] );
+   const float green = float( a[1] ) - float( b[1] );
+   const float blue = float( a[2] ) - float( b[2] );
+   const float y = red * 0.29889531f + green * 0.58662247f + blue * 0.11448223f;
+   const float i = red * 0.59597799f - green * 0.27417610f - blue * 0.32180189f;
+   const float q = red * 0.21147017f - green * 0.52261711f + blue * 0.31114694f;
+   return 0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q;
+}
+
+int GoldenImage::ReturnWidth() const{
+   return this->Width;
+}
+
+int GoldenImage::ReturnHeight() const{
+   return this->Height;
+}
@@ -0,0 +1,117 @@
+/*!
+   \file golden.hpp
+   \brief Plik odpowiedzialny za obrazy wzorcowe (golden image): odczyt klatki, zapis i wczytanie PNG oraz porównanie percepcyjne.
+*/
+#ifndef golden_hpp
+#define golden_hpp
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+/*!
+   \brief Ziarno generatora liczb losowych dla świata rysowanego przy porównaniu z obrazami wzorcowymi.
+*/
+#define GOLDEN_SEED 1
+/*!
+   \brief Szerokość obrazów wzorcowych, niezależna od settings.init.
+*/
+#define GOLDEN_WIDTH 640
+/*!
+   \brief Wysokość obrazów wzorcowych, niezależna od settings.init.
+*/
+#define GOLDEN_HEIGHT 480
+/*!
+   \brief Plik z opcjami rysowania zapisanymi razem z obrazami wzorcowymi (w katalogu obrazów).
+*/
+#define GOLDEN_OPTIONS_FILE "options.txt"
+/*!
+   \brief Ilość mierzonych klatek dla jednej sceny.
+*/
+#define GOLDEN_FRAMES 30
+/*!
+   \brief Próg różnicy koloru piksela (0.0 - 1.0) w przestrzeni YIQ, poniżej którego piksele są uznawane za takie same.
+*/
+#define GOLDEN_THRESHOLD 0.1f
+/*!
+   \brief Dopuszczalna część różnych pikseli obrazu (0.0 - 1.0).
+*/
+#define GOLDEN_TOLERANCE 0.001f
+/*!
+   \brief Dopuszczalny stosunek czasu klatki do czasu wzorcowego, powyżej zgłaszany jest spadek wydajności.
+*/
+#define GOLDEN_TIME_TOLERANCE 1.25f
+
+/*!
+   \brief Klasa przechowująca obraz RGBA (8 bitów na kanał, pierwszy wiersz = dół obrazu, jak w glReadPixels).
+
+   Obrazy zapisywane i wczytywane są przez DevIL ( \link Save() \endlink, \link Load() \endlink ).\n
+   Porównanie ( \link Compare() \endlink ) liczy różnicę jasności i chrominancji (YIQ) każdego piksela,
+   więc niewielkie różnice rasteryzacji między sterownikami nie są zgłaszane jako błąd.\n
+*/
+class GoldenImage{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   GoldenImage();
+   /*!
+      \brief Odczytuje obraz z aktualnego bufora ramki (glReadPixels).
+
+      \param width - szerokość obrazu
+      \param height - wysokość obrazu
+   */
+   void Capture( GLsizei width, GLsizei height );
+   /*!
+      \brief Wczytuje obraz z pliku.
+
+      \param path - ścieżka do pliku
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Load( const std::string &path );
+   /*!
+      \brief Zapisuje obraz do pliku (format wg rozszerzenia, np. .png).
+
+      \param path - ścieżka do pliku
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Save( const std::string &path ) const;
+   /*!
+      \brief Porównuje obraz z obrazem wzorcowym.
+
+      \param reference - obraz wzorcowy
+      \param threshold - próg różnicy koloru piksela ( \link GOLDEN_THRESHOLD \endlink )
+      \param diff - obraz różnic (różne piksele na czerwono) lub NULL
+      \return - część różnych pikseli (0.0 - 1.0), 1.0 dla obrazów o różnej wielkości
+   */
+   float Compare( const GoldenImage &reference, float threshold, GoldenImage *diff ) const;
+   /*!
+      \brief Zwraca szerokość obrazu.
+   */
+   int ReturnWidth() const;
+   /*!
+      \brief Zwraca wysokość obrazu.
+   */
+   int ReturnHeight() const;
+private:
+   /*!
+      \brief Różnica kolorów dwóch pikseli w przestrzeni YIQ (0 - 35215).
+
+      \param a - piksel RGBA
+      \param b - piksel RGBA
+   */
+   static float ColorDelta( const unsigned char *a, const unsigned char *b );
+   /*!
+      \brief Piksele RGBA.
+   */
+   std::vector <unsigned char> Pixels;
+   /*!
+      \brief Szerokość obrazu.
+   */
+   int Width;
+   /*!
+      \brief Wysokość obrazu.
+   */
+   int Height;
+};
+
+#endif
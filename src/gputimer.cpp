@@ -0,0 +1,157 @@
+/*!
+   \file gputimer.cpp
+   \brief Plik źródłowy dla gputimer.hpp.
+*/
+#include "gputimer.hpp"
+#include <algorithm>
+
+GpuTimer::GpuTimer(){
+   this->Frames = 0;
+   this->Frame = 0;
+   this->Dropped = 0;
+   this->CpuFrequency = 1.0;
+}
+
+GpuTimer::~GpuTimer(){
+   this->Destroy();
+}
+
+bool GpuTimer::Create( const std::vector <std::string> &names, unsigned int frames ){
+   this->Destroy();
+   if( ! GLEW_VERSION_3_3 and ! GLEW_ARB_timer_query ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "GpuTimer: GL_ARB_timer_query not supported\n" );
+      return false;
+   }
+   this->Names = names;
+   this->Frames = frames > 0 ? frames : GPUTIMER_FRAMES;
+   this->Frame = 0;
+   this->Dropped = 0;
+   this->CpuFrequency = double( SDL_GetPerformanceFrequency() ) / 1000.0;
+   const unsigned int scopes = this->Names.size();
+   this->Queries.assign( this->Frames * scopes * 2, 0 );
+   glGenQueries( this->Queries.size(), &this->Queries[0] );
+   this->Issued.assign( this->Frames * scopes, false );
+   this->CpuBegin.assign( scopes, 0 );
+   this->GpuHistory.assign( scopes * GPUTIMER_HISTORY, 0.0f );
+   this->CpuHistory.assign( scopes * GPUTIMER_HISTORY, 0.0f );
+   this->GpuCount.assign( scopes, 0 );
+   this->CpuCount.assign( scopes, 0 );
+   return true;
+}
+
+void GpuTimer::Destroy(){
+   if( ! this->Queries.empty() ){
+      glDeleteQueries( this->Queries.size(), &this->Queries[0] );
+   }
+   this->Queries.clear();
+   this->Issued.clear();
+   this->Names.clear();
+}
+
+void GpuTimer::BeginFrame(){
+   if( this->Queries.empty() ){
+      return;
+   }
+   this->Frame = ( this->Frame + 1 ) % this->Frames;
+   const unsigned int scopes = this->Names.size();
+   GLint available;
+   GLuint64 begin, end;
+   for( unsigned int scope = 0; scope < scopes; ++scope ){
+      const unsigned int slot = this->Frame * scopes + scope;
+      if( ! this->Issued[slot] ){
+         continue;
+      }
+      this->Issued[slot] = false;
+      //End query is the last one, begin query is ready too:
+      glGetQueryObjectiv( this->Queries[slot * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available );
+      if( available == GL_FALSE ){
+         ++this->Dropped;
+         continue;
+      }
+      glGetQueryObjectui64v( this->Queries[slot * 2], GL_QUERY_RESULT, &begin );
+      glGetQueryObjectui64v( this->Queries[slot * 2 + 1], GL_QUERY_RESULT, &end );
+      this->Push( this->GpuHistory, this->GpuCount, scope, float( double( end - begin ) / 1000000.0 ) );
+   }
+}
+
+void GpuTimer::Begin( GLuint scope ){
+   if( scope >= this->Names.size() ){
+      return;
+   }
+   glQueryCounter( this->Queries[( this->Frame * this->Names.size() + scope ) * 2], GL_TIMESTAMP );
+   this->CpuBegin[scope] = SDL_GetPerformanceCounter();
+}
+
+void GpuTimer::End( GLuint scope ){
+   if( scope >= this->Names.size() ){
+      return;
+   }
+   const unsigned int slot = this->Frame * this->Names.size() + scope;
+   glQueryCounter( this->Queries[slot * 2 + 1], GL_TIMESTAMP );
+   this->Issued[slot] = true;
+   this->Push( this->CpuHistory, this->CpuCount, scope, float( double( SDL_GetPerformanceCounter() - this->CpuBegin[scope] ) / this->CpuFrequency ) );
+}
+
+TimerStats GpuTimer::ReturnGpu( GLuint scope ) const{
+   return this->Stats( this->GpuHistory, this->GpuCount, scope );
+}
+
+TimerStats GpuTimer::ReturnCpu( GLuint scope ) const{
+   return this->Stats( this->CpuHistory, this->CpuCount, scope );
+}
+
+unsigned int GpuTimer::ReturnScopes() const{
+   return this->Names.size();
+}
+
+const std::string & GpuTimer::ReturnName( GLuint scope ) const{
+   return this->Names.at( scope );
+}
+
+unsigned int GpuTimer::ReturnDropped() const{
+   return this->Dropped;
+}
+
+void GpuTimer::Log() const{
+   TimerStats gpu, cpu;
+   for( unsigned int scope = 0; scope < this->Names.size(); ++scope ){
+      gpu = this->ReturnGpu( scope );
+      cpu = this->ReturnCpu( scope );
+      if( cpu.Samples == 0 ){
+         continue;
+      }
+      SDL_Log( "\r  %-10s GPU min %7.3f  avg %7.3f  p99 %7.3f ms   CPU min %7.3f  avg %7.3f  p99 %7.3f ms",
+         this->Names[scope].c_str(),
+         gpu.Min, gpu.Average, gpu.P99,
+         cpu.Min, cpu.Average, cpu.P99
+      );
+   }
+   if( this->Dropped > 0 ){
+      SDL_Log( "\r  GPU results not ready: %u", this->Dropped );
+   }
+}
+
+void GpuTimer::Push( std::vector <float> &history, std::vector <unsigned int> &count, GLuint scope, float time ){
+   history[scope * GPUTIMER_HISTORY + count[scope] % GPUTIMER_HISTORY] = time;
+   ++count[scope];
+}
+
+TimerStats GpuTimer::Stats( const std::vector <float> &history, const std::vector <unsigned int> &count, GLuint scope ) const{
+   TimerStats stats;
+   stats.Min = stats.Average = stats.P99 = stats.Last = 0.0f;
+   stats.Count = scope < count.size() ? count[scope] : 0;
+   stats.Samples = std::min( stats.Count, (unsigned int)GPUTIMER_HISTORY );
+   if( stats.Samples == 0 ){
+      return stats;
+   }
+   stats.Last = history[scope * GPUTIMER_HISTORY + ( stats.Count - 1 ) % GPUTIMER_HISTORY];
+   std::vector <float> sorted( history.begin() + scope * GPUTIMER_HISTORY, history.begin() + scope * GPUTIMER_HISTORY + stats.Samples );
+   std::sort( sorted.begin(), sorted.end() );
+   stats.Min = sorted.front();
+   for( unsigned int i = 0; i < sorted.size(); ++i ){
+      stats.Average += sorted[i];
+   }
+   stats.Average /= sorted.size();
+   stats.P99 = sorted[( sorted.size() * 99 + 99 ) / 100 - 1];
+   return stats;
+}
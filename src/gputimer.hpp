@@ -0,0 +1,198 @@
+/*!
+   \file gputimer.hpp
+   \brief Plik odpowiedzialny za pomiar czasu GPU i CPU nazwanych fragmentów klatki (przebiegów rysowania).
+*/
+#ifndef gputimer_hpp
+#define gputimer_hpp
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Domyślna ilość klatek w pierścieniu zapytań (opóźnienie odczytu wyników).
+*/
+#define GPUTIMER_FRAMES 4
+/*!
+   \brief Ilość ostatnich pomiarów, z których liczone są statystyki.
+*/
+#define GPUTIMER_HISTORY 128
+
+/*!
+   \brief Statystyki czasu z ostatnich \link GPUTIMER_HISTORY \endlink pomiarów (w milisekundach).
+*/
+struct TimerStats{
+   /*!
+      \brief Najkrótszy czas.
+   */
+   float Min;
+   /*!
+      \brief Średni czas.
+   */
+   float Average;
+   /*!
+      \brief 99. percentyl czasu.
+   */
+   float P99;
+   /*!
+      \brief Ostatni pomiar.
+   */
+   float Last;
+   /*!
+      \brief Ilość pomiarów w historii.
+   */
+   unsigned int Samples;
+   /*!
+      \brief Ilość wszystkich pomiarów od utworzenia, zmiana = nowy pomiar.
+   */
+   unsigned int Count;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za pomiar czasu fragmentów klatki na GPU i CPU.
+
+   Początek i koniec fragmentu zapisywane są zapytaniami GL_TIMESTAMP (glQueryCounter),
+   więc fragmenty mogą się zagnieżdżać ( \link Begin() \endlink, \link End() \endlink ).\n
+   Zapytania tworzą pierścień \link GPUTIMER_FRAMES \endlink klatek, wyniki odczytywane są dopiero przy ponownym
+   użyciu zapytań ( \link BeginFrame() \endlink ), a niegotowe wyniki są pomijane, więc odczyt nigdy nie czeka na GPU.\n
+   Czas CPU to czas wysyłania poleceń między \link Begin() \endlink i \link End() \endlink.\n
+*/
+class GpuTimer{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   GpuTimer();
+   /*!
+      \brief Destruktor.
+
+      Usuwa zapytania ( \link Destroy() \endlink ).
+   */
+   ~GpuTimer();
+   /*!
+      \brief Tworzy zapytania dla nazwanych fragmentów.
+
+      \param names - nazwy fragmentów, numer fragmentu = indeks nazwy
+      \param frames - ilość klatek w pierścieniu zapytań
+      \return - wartość logiczna, FALSE = brak GL_ARB_timer_query
+   */
+   bool Create( const std::vector <std::string> &names, unsigned int frames = GPUTIMER_FRAMES );
+   /*!
+      \brief Usuwa zapytania.
+   */
+   void Destroy();
+   /*!
+      \brief Rozpoczyna klatkę: odczytuje gotowe wyniki najstarszej klatki pierścienia.
+   */
+   void BeginFrame();
+   /*!
+      \brief Rozpoczyna pomiar fragmentu.
+
+      \param scope - numer fragmentu
+   */
+   void Begin( GLuint scope );
+   /*!
+      \brief Kończy pomiar fragmentu.
+
+      \param scope - numer fragmentu
+   */
+   void End( GLuint scope );
+   /*!
+      \brief Zwraca statystyki czasu GPU fragmentu.
+
+      \param scope - numer fragmentu
+   */
+   TimerStats ReturnGpu( GLuint scope ) const;
+   /*!
+      \brief Zwraca statystyki czasu CPU fragmentu.
+
+      \param scope - numer fragmentu
+   */
+   TimerStats ReturnCpu( GLuint scope ) const;
+   /*!
+      \brief Zwraca ilość fragmentów.
+   */
+   unsigned int ReturnScopes() const;
+   /*!
+      \brief Zwraca nazwę fragmentu.
+
+      \param scope - numer fragmentu
+   */
+   const std::string & ReturnName( GLuint scope ) const;
+   /*!
+      \brief Zwraca ilość pominiętych, niegotowych wyników.
+   */
+   unsigned int ReturnDropped() const;
+   /*!
+      \brief Wypisuje statystyki GPU i CPU wszystkich zmierzonych fragmentów.
+   */
+   void Log() const;
+private:
+   /*!
+      \brief Dodaje pomiar do historii.
+
+      \param history - historia pomiarów wszystkich fragmentów
+      \param count - ilość pomiarów każdego fragmentu
+      \param scope - numer fragmentu
+      \param time - czas w milisekundach
+   */
+   void Push( std::vector <float> &history, std::vector <unsigned int> &count, GLuint scope, float time );
+   /*!
+      \brief Liczy statystyki fragmentu.
+
+      \param history - historia pomiarów wszystkich fragmentów
+      \param count - ilość pomiarów każdego fragmentu
+      \param scope - numer fragmentu
+   */
+   TimerStats Stats( const std::vector <float> &history, const std::vector <unsigned int> &count, GLuint scope ) const;
+   /*!
+      \brief Nazwy fragmentów.
+   */
+   std::vector <std::string> Names;
+   /*!
+      \brief Zapytania: ( klatka * ilość fragmentów + fragment ) * 2, +0 = początek, +1 = koniec.
+   */
+   std::vector <GLuint> Queries;
+   /*!
+      \brief Fragmenty zmierzone w klatce pierścienia (oba zapytania wysłane).
+   */
+   std::vector <bool> Issued;
+   /*!
+      \brief Czas CPU rozpoczęcia każdego fragmentu.
+   */
+   std::vector <Uint64> CpuBegin;
+   /*!
+      \brief Historia czasów GPU: fragment * \link GPUTIMER_HISTORY \endlink + pomiar.
+   */
+   std::vector <float> GpuHistory;
+   /*!
+      \brief Historia czasów CPU: fragment * \link GPUTIMER_HISTORY \endlink + pomiar.
+   */
+   std::vector <float> CpuHistory;
+   /*!
+      \brief Ilość pomiarów GPU każdego fragmentu.
+   */
+   std::vector <unsigned int> GpuCount;
+   /*!
+      \brief Ilość pomiarów CPU każdego fragmentu.
+   */
+   std::vector <unsigned int> CpuCount;
+   /*!
+      \brief Ilość klatek w pierścieniu.
+   */
+   unsigned int Frames;
+   /*!
+      \brief Aktualna klatka pierścienia.
+   */
+   unsigned int Frame;
+   /*!
+      \brief Ilość pominiętych wyników.
+   */
+   unsigned int Dropped;
+   /*!
+      \brief Ilość taktów licznika CPU na milisekundę.
+   */
+   double CpuFrequency;
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*!
+   \file headless.cpp
+   \brief Plik źródłowy dla headless.hpp.
+*/
+#include "headless.hpp"
+#include <SDL2/SDL.h>
+#include "memorytracker.hpp"
+
+HeadlessContext::HeadlessContext(){
+   #if !defined( _WIN32 ) && !defined( __MINGW32__ )
+   this->Display = EGL_NO_DISPLAY;
+   this->Context = EGL_NO_CONTEXT;
+   #endif
+   this->Framebuffer = 0;
+   this->ColorBuffer = 0;
+   this->DepthBuffer = 0;
+   this->Width = HEADLESS_WIDTH;
+   this->Height = HEADLESS_HEIGHT;
+}
+
+HeadlessContext::~HeadlessContext(){
+   this->Destroy();
+}
+
+#if !defined( _WIN32 ) && !defined( __MINGW32__ )
+bool HeadlessContext::Create(){
+   this->Destroy();
+   //Surfaceless platform does not need X server or GPU device:
+   PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+   #ifdef EGL_PLATFORM_SURFACELESS_MESA
+   if( get_platform_display != NULL ){
+      this->Display = get_platform_display( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL );
+   }
+   #endif
+   if( this->Display == EGL_NO_DISPLAY ){
+      this->Display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+   }
+   EGLint major, minor;
+   if( this->Display == EGL_NO_DISPLAY or ! eglInitialize( this->Display, &major, &minor ) ){
+      SDL_LogError( SDL_LOG_CATEGORY_VIDEO, "Headless: can't initialize EGL display\n" );
+      this->Display = EGL_NO_DISPLAY;
+      return false;
+   }
+   if( ! eglBindAPI( EGL_OPENGL_API ) ){
+      SDL_LogError( SDL_LOG_CATEGORY_VIDEO, "Headless: EGL doesn't support OpenGL\n" );
+      this->Destroy();
+      return false;
+   }
+   const EGLint config_attributes[] = {
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_NONE
+   };
+   EGLConfig config = NULL;
+   EGLint configs = 0;
+   eglChooseConfig( this->Display, config_attributes, &config, 1, &configs );
+   const EGLint context_attributes[] = {
+      EGL_CONTEXT_MAJOR_VERSION, 3,
+      EGL_CONTEXT_MINOR_VERSION, 3,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+      EGL_NONE
+   };
+   //Without EGL_KHR_no_config_context the first config is used:
+   this->Context = eglCreateContext( this->Display, configs > 0 ? config : (EGLConfig)0, EGL_NO_CONTEXT, context_attributes );
+   if( this->Context == EGL_NO_CONTEXT ){
+      SDL_LogError( SDL_LOG_CATEGORY_VIDEO, "Headless: can't create OpenGL 3.3 context: 0x%x\n", eglGetError() );
+      this->Destroy();
+      return false;
+   }
+   if( ! eglMakeCurrent( this->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, this->Context ) ){
+      SDL_LogError( SDL_LOG_CATEGORY_VIDEO, "Headless: can't make context current: 0x%x\n", eglGetError() );
+      this->Destroy();
+      return false;
+   }
+   SDL_Log( "Headless: EGL %i.%i, %s\n", major, minor, eglQueryString( this->Display, EGL_VENDOR ) );
+   return true;
+}
+#else
+bool HeadlessContext::Create(){
+   SDL_LogError( SDL_LOG_CATEGORY_VIDEO, "Headless: not supported on this platform\n" );
+   return false;
+}
+#endif
+
+bool HeadlessContext::CreateFramebuffer( GLsizei width, GLsizei height ){
+   this->Width = width;
+   this->Height = height;
+   glGenRenderbuffers( 1, &this->ColorBuffer );
+   glBindRenderbuffer( GL_RENDERBUFFER, this->ColorBuffer );
+   glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, this->Width, this->Height );
+   glGenRenderbuffers( 1, &this->DepthBuffer );
+   glBindRenderbuffer( GL_RENDERBUFFER, this->DepthBuffer );
+   glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, this->Width, this->Height );
+   MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_RENDERBUFFER, this->ColorBuffer, MemoryTracker::TextureBytes( this->Width, this->Height, 1, 4 ) );
+   MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_RENDERBUFFER, this->DepthBuffer, MemoryTracker::TextureBytes( this->Width, this->Height, 1, 4 ) );
+   glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+   glGenFramebuffers( 1, &this->Framebuffer );
+   glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffer );
+   glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->ColorBuffer );
+   glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, this->DepthBuffer );
+   if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Headless: incomplete framebuffer\n" );
+      return false;
+   }
+   glDrawBuffer( GL_COLOR_ATTACHMENT0 );
+   glReadBuffer( GL_COLOR_ATTACHMENT0 );
+   glViewport( 0, 0, this->Width, this->Height );
+   SDL_Log( "Headless: framebuffer %i x %i\n", (int)this->Width, (int)this->Height );
+   return true;
+}
+
+void HeadlessContext::Destroy(){
+   #if !defined( _WIN32 ) && !defined( __MINGW32__ )
+   if( this->Context != EGL_NO_CONTEXT ){
+      if( this->Framebuffer != 0 ){
+         glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+         glDeleteFramebuffers( 1, &this->Framebuffer );
+         MemoryTracker::RemoveObject( MEMORY_OBJECT_RENDERBUFFER, 1, &this->ColorBuffer );
+         MemoryTracker::RemoveObject( MEMORY_OBJECT_RENDERBUFFER, 1, &this->DepthBuffer );
+         glDeleteRenderbuffers( 1, &this->ColorBuffer );
+         glDeleteRenderbuffers( 1, &this->DepthBuffer );
+      }
+      eglMakeCurrent( this->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+      eglDestroyContext( this->Display, this->Context );
+      this->Context = EGL_NO_CONTEXT;
+   }
+   if( this->Display != EGL_NO_DISPLAY ){
+      eglTerminate( this->Display );
+      this->Display = EGL_NO_DISPLAY;
+   }
+   #endif
+   this->Framebuffer = 0;
+   this->ColorBuffer = 0;
+   this->DepthBuffer = 0;
+}
+
+void HeadlessContext::Present(){
+   glFinish();
+}
+
+GLuint HeadlessContext::ReturnFramebuffer() const{
+   return this->Framebuffer;
+}
+
+GLsizei HeadlessContext::ReturnWidth() const{
+   return this->Width;
+}
+
+GLsizei HeadlessContext::ReturnHeight() const{
+   return this->Height;
+}
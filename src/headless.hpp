@@ -0,0 +1,117 @@
+/*!
+   \file headless.hpp
+   \brief Plik odpowiedzialny za kontekst OpenGL bez okna (tryb headless) i bufor ramki, do którego rysowana jest gra.
+*/
+#ifndef headless_hpp
+#define headless_hpp
+#include <GL/glew.h>
+#if !defined( _WIN32 ) && !defined( __MINGW32__ )
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+/*!
+   \brief Domyślna szerokość obrazu w trybie headless.
+*/
+#define HEADLESS_WIDTH 640
+/*!
+   \brief Domyślna wysokość obrazu w trybie headless.
+*/
+#define HEADLESS_HEIGHT 480
+/*!
+   \brief Domyślna ilość klatek rysowanych w trybie headless.
+*/
+#define HEADLESS_FRAMES 600
+
+/*!
+   \brief Klasa odpowiedzialna za kontekst OpenGL bez okna.
+
+   Kontekst OpenGL 3.3 (Core Profile) tworzony jest przez EGL bez powierzchni (EGL_MESA_platform_surfaceless),
+   więc nie wymaga serwera X ani okna SDL2 ( \link Create() \endlink ).\n
+   Obraz rysowany jest do bufora ramki (FBO) o wybranej wielkości ( \link CreateFramebuffer() \endlink ).\n
+   Dostępne tylko w systemie Linux.\n
+*/
+class HeadlessContext{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   HeadlessContext();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia bufor ramki i kontekst ( \link Destroy() \endlink ).
+   */
+   ~HeadlessContext();
+   /*!
+      \brief Tworzy kontekst OpenGL 3.3 i ustawia go jako aktualny.
+
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create();
+   /*!
+      \brief Tworzy bufor ramki (kolor RGBA8 i głębokość 24 bity) i ustawia go jako aktualny.
+
+      \param width - szerokość obrazu
+      \param height - wysokość obrazu
+      \return - wartość logiczna, FALSE = błąd
+
+      Wywoływane po inicjalizacji GLEW.
+   */
+   bool CreateFramebuffer( GLsizei width, GLsizei height );
+   /*!
+      \brief Zwalnia bufor ramki i kontekst.
+   */
+   void Destroy();
+   /*!
+      \brief Kończy klatkę, zamiennik SDL_GL_SwapWindow().
+
+      Czeka na zakończenie rysowania, aby czas klatki obejmował pracę GPU.
+   */
+   void Present();
+   /*!
+      \brief Zwraca identyfikator bufora ramki.
+   */
+   GLuint ReturnFramebuffer() const;
+   /*!
+      \brief Zwraca szerokość obrazu.
+   */
+   GLsizei ReturnWidth() const;
+   /*!
+      \brief Zwraca wysokość obrazu.
+   */
+   GLsizei ReturnHeight() const;
+private:
+   #if !defined( _WIN32 ) && !defined( __MINGW32__ )
+   /*!
+      \brief Połączenie EGL.
+   */
+   EGLDisplay Display;
+   /*!
+      \brief Kontekst EGL.
+   */
+   EGLContext Context;
+   #endif
+   /*!
+      \brief Identyfikator bufora ramki.
+   */
+   GLuint Framebuffer;
+   /*!
+      \brief Bufor koloru.
+   */
+   GLuint ColorBuffer;
+   /*!
+      \brief Bufor głębokości.
+   */
+   GLuint DepthBuffer;
+   /*!
+      \brief Szerokość obrazu.
+   */
+   GLsizei Width;
+   /*!
+      \brief Wysokość obrazu.
+   */
+   GLsizei Height;
+};
+
+#endif
@@ -0,0 +1,341 @@
+/*!
+   \file hud.cpp
+   \brief Plik źródłowy dla hud.hpp.
+*/
+#include "hud.hpp"
+#include <cstddef>
+#include <cstring>
+#include <SDL2/SDL.h>
+#include "shader.hpp"
+#include "memorytracker.hpp"
+
+/*!
+   \brief Ilość pól tekstury czcionki w wierszu.
+*/
+#define HUD_ATLAS_COLUMNS 16
+/*!
+   \brief Ilość wierszy pól tekstury czcionki (znaki 32-126 i pełne pole).
+*/
+#define HUD_ATLAS_ROWS 6
+
+/*!
+   \brief Czcionka: znaki ASCII 32-126, wiersze od góry, bit 7 = lewy piksel.
+
+   Source Code Pro Regular (SIL Open Font License) 13 px, renderowana przez FreeType bez wygładzania.
+*/
+static const unsigned char HudFont[95][HUD_FONT_HEIGHT] = {
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, //space
+   { 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00 }, //!
+   { 0x00, 0x24, 0x24, 0x24, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, //"
+   { 0x00, 0x00, 0x14, 0x24, 0x7E, 0x28, 0x7C, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00 }, //#
+   { 0x10, 0x10, 0x3C, 0x24, 0x60, 0x18, 0x06, 0x46, 0x3C, 0x10, 0x10, 0x00, 0x00, 0x00 }, //$
+   { 0x00, 0x00, 0x62, 0x92, 0x94, 0x60, 0x0E, 0x2A, 0x4A, 0x8E, 0x00, 0x00, 0x00, 0x00 }, //%
+   { 0x00, 0x38, 0x28, 0x28, 0x30, 0x22, 0x52, 0x4E, 0x44, 0x7B, 0x00, 0x00, 0x00, 0x00 }, //&
+   { 0x00, 0x18, 0x18, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, //'
+   { 0x04, 0x08, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x04, 0x00, 0x00 }, //(
+   { 0x20, 0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00 }, //)
+   { 0x00, 0x00, 0x00, 0x10, 0x10, 0x7E, 0x18, 0x28, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 }, //*
+   { 0x00, 0x00, 0x10, 0x10, 0x10, 0x7E, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00 }, //+
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x08, 0x08, 0x10, 0x00 }, //,
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, //-
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00 }, //.
+   { 0x00, 0x06, 0x04, 0x04, 0x08, 0x08, 0x10, 0x10, 0x10, 0x20, 0x20, 0x40, 0x00, 0x00 }, ///
+   { 0x00, 0x00, 0x3C, 0x64, 0x42, 0x5A, 0x5A, 0x42, 0x64, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //0
+   { 0x00, 0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x7E, 0x00, 0x00, 0x00, 0x00 }, //1
+   { 0x00, 0x00, 0x38, 0x44, 0x04, 0x04, 0x08, 0x10, 0x20, 0x7E, 0x00, 0x00, 0x00, 0x00 }, //2
+   { 0x00, 0x00, 0x3C, 0x44, 0x04, 0x18, 0x04, 0x02, 0x46, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //3
+   { 0x00, 0x00, 0x0C, 0x14, 0x14, 0x24, 0x44, 0xFE, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00 }, //4
+   { 0x00, 0x00, 0x3C, 0x20, 0x40, 0x7C, 0x06, 0x02, 0x46, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //5
+   { 0x00, 0x00, 0x1C, 0x26, 0x40, 0x5C, 0x62, 0x42, 0x22, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //6
+   { 0x00, 0x00, 0x7E, 0x04, 0x04, 0x08, 0x08, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00 }, //7
+   { 0x00, 0x00, 0x3C, 0x44, 0x26, 0x3C, 0x44, 0x42, 0x42, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //8
+   { 0x00, 0x00, 0x38, 0x44, 0x42, 0x46, 0x3A, 0x02, 0x44, 0x38, 0x00, 0x00, 0x00, 0x00 }, //9
+   { 0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00 }, //:
+   { 0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x18, 0x18, 0x08, 0x08, 0x10, 0x00 }, //;
+   { 0x00, 0x00, 0x04, 0x0C, 0x30, 0x20, 0x30, 0x0C, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, //<
+   { 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, //=
+   { 0x00, 0x00, 0x40, 0x30, 0x08, 0x04, 0x08, 0x30, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00 }, //>
+   { 0x00, 0x38, 0x44, 0x04, 0x0C, 0x08, 0x10, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00 }, //?
+   { 0x00, 0x00, 0x1C, 0x22, 0x42, 0x4E, 0x52, 0x52, 0x5E, 0x40, 0x24, 0x1E, 0x00, 0x00 }, //@
+   { 0x00, 0x18, 0x18, 0x28, 0x24, 0x24, 0x3C, 0x42, 0x42, 0xC2, 0x00, 0x00, 0x00, 0x00 }, //A
+   { 0x00, 0x7C, 0x44, 0x42, 0x44, 0x78, 0x46, 0x42, 0x42, 0x7C, 0x00, 0x00, 0x00, 0x00 }, //B
+   { 0x00, 0x1C, 0x22, 0x40, 0x40, 0x40, 0x40, 0x40, 0x22, 0x1C, 0x00, 0x00, 0x00, 0x00 }, //C
+   { 0x00, 0x78, 0x44, 0x42, 0x42, 0x42, 0x42, 0x42, 0x44, 0x78, 0x00, 0x00, 0x00, 0x00 }, //D
+   { 0x00, 0x7E, 0x60, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x60, 0x7E, 0x00, 0x00, 0x00, 0x00 }, //E
+   { 0x00, 0x3E, 0x20, 0x20, 0x20, 0x3C, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00 }, //F
+   { 0x00, 0x1C, 0x26, 0x40, 0x40, 0x4E, 0x42, 0x42, 0x62, 0x1C, 0x00, 0x00, 0x00, 0x00 }, //G
+   { 0x00, 0x42, 0x42, 0x42, 0x42, 0x7E, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00, 0x00 }, //H
+   { 0x00, 0x7E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7E, 0x00, 0x00, 0x00, 0x00 }, //I
+   { 0x00, 0x3C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00, 0x00 }, //J
+   { 0x00, 0x42, 0x44, 0x48, 0x58, 0x78, 0x6C, 0x44, 0x42, 0x43, 0x00, 0x00, 0x00, 0x00 }, //K
+   { 0x00, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3E, 0x00, 0x00, 0x00, 0x00 }, //L
+   { 0x00, 0x46, 0x66, 0x66, 0x6A, 0x6A, 0x5A, 0x52, 0x42, 0x42, 0x00, 0x00, 0x00, 0x00 }, //M
+   { 0x00, 0x42, 0x62, 0x62, 0x52, 0x52, 0x4A, 0x4A, 0x46, 0x46, 0x00, 0x00, 0x00, 0x00 }, //N
+   { 0x00, 0x3C, 0x64, 0x42, 0x42, 0x42, 0x42, 0x42, 0x64, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //O
+   { 0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00, 0x00 }, //P
+   { 0x00, 0x3C, 0x64, 0x42, 0x42, 0x42, 0x42, 0x42, 0x64, 0x3C, 0x08, 0x0E, 0x00, 0x00 }, //Q
+   { 0x00, 0x7C, 0x42, 0x42, 0x46, 0x7C, 0x48, 0x44, 0x44, 0x42, 0x00, 0x00, 0x00, 0x00 }, //R
+   { 0x00, 0x3C, 0x66, 0x40, 0x20, 0x1C, 0x06, 0x02, 0x42, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //S
+   { 0x00, 0x7E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00 }, //T
+   { 0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x64, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //U
+   { 0x00, 0x42, 0x42, 0x44, 0x24, 0x24, 0x24, 0x28, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00 }, //V
+   { 0x00, 0x81, 0x82, 0xC2, 0x52, 0x5A, 0x5A, 0x6A, 0x66, 0x64, 0x00, 0x00, 0x00, 0x00 }, //W
+   { 0x00, 0x42, 0x24, 0x24, 0x18, 0x18, 0x18, 0x24, 0x24, 0x42, 0x00, 0x00, 0x00, 0x00 }, //X
+   { 0x00, 0xC2, 0x46, 0x24, 0x24, 0x18, 0x18, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00 }, //Y
+   { 0x00, 0x7E, 0x04, 0x04, 0x08, 0x10, 0x10, 0x20, 0x40, 0x7E, 0x00, 0x00, 0x00, 0x00 }, //Z
+   { 0x00, 0x1E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1E, 0x00, 0x00 }, //[
+   { 0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x10, 0x08, 0x08, 0x04, 0x04, 0x06, 0x00, 0x00 }, //backslash
+   { 0x00, 0x78, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x78, 0x00, 0x00 }, //]
+   { 0x00, 0x18, 0x18, 0x28, 0x24, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, //^
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x00 }, //_
+   { 0x00, 0x30, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, //`
+   { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x46, 0x1E, 0x62, 0x46, 0x3A, 0x00, 0x00, 0x00, 0x00 }, //a
+   { 0x00, 0x40, 0x40, 0x40, 0x5C, 0x66, 0x42, 0x42, 0x66, 0x5C, 0x00, 0x00, 0x00, 0x00 }, //b
+   { 0x00, 0x00, 0x00, 0x00, 0x1C, 0x62, 0x40, 0x40, 0x62, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //c
+   { 0x00, 0x02, 0x02, 0x02, 0x3A, 0x66, 0x42, 0x42, 0x46, 0x3A, 0x00, 0x00, 0x00, 0x00 }, //d
+   { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x42, 0x7E, 0x40, 0x64, 0x3E, 0x00, 0x00, 0x00, 0x00 }, //e
+   { 0x00, 0x0F, 0x10, 0x10, 0x7E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00 }, //f
+   { 0x00, 0x00, 0x00, 0x00, 0x3E, 0x64, 0x44, 0x3C, 0x40, 0x3E, 0x42, 0x42, 0x3C, 0x00 }, //g
+   { 0x00, 0x40, 0x40, 0x40, 0x5C, 0x66, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00, 0x00 }, //h
+   { 0x00, 0x08, 0x08, 0x00, 0x78, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00 }, //i
+   { 0x00, 0x08, 0x08, 0x00, 0x78, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x70, 0x00 }, //j
+   { 0x00, 0x40, 0x40, 0x40, 0x46, 0x48, 0x58, 0x6C, 0x44, 0x42, 0x00, 0x00, 0x00, 0x00 }, //k
+   { 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0E, 0x00, 0x00, 0x00, 0x00 }, //l
+   { 0x00, 0x00, 0x00, 0x00, 0x76, 0x4A, 0x52, 0x52, 0x52, 0x52, 0x00, 0x00, 0x00, 0x00 }, //m
+   { 0x00, 0x00, 0x00, 0x00, 0x5C, 0x66, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00, 0x00 }, //n
+   { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x46, 0x42, 0x42, 0x46, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //o
+   { 0x00, 0x00, 0x00, 0x00, 0x5C, 0x66, 0x42, 0x42, 0x66, 0x5C, 0x40, 0x40, 0x40, 0x00 }, //p
+   { 0x00, 0x00, 0x00, 0x00, 0x3A, 0x66, 0x42, 0x42, 0x46, 0x3A, 0x02, 0x02, 0x02, 0x00 }, //q
+   { 0x00, 0x00, 0x00, 0x00, 0x2E, 0x30, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00 }, //r
+   { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x44, 0x30, 0x0E, 0x42, 0x3C, 0x00, 0x00, 0x00, 0x00 }, //s
+   { 0x00, 0x00, 0x10, 0x10, 0x7E, 0x10, 0x10, 0x10, 0x10, 0x1E, 0x00, 0x00, 0x00, 0x00 }, //t
+   { 0x00, 0x00, 0x00, 0x00, 0x46, 0x46, 0x46, 0x46, 0x46, 0x3A, 0x00, 0x00, 0x00, 0x00 }, //u
+   { 0x00, 0x00, 0x00, 0x00, 0x42, 0x44, 0x24, 0x24, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00 }, //v
+   { 0x00, 0x00, 0x00, 0x00, 0x91, 0xDA, 0x5A, 0x6A, 0x6A, 0x64, 0x00, 0x00, 0x00, 0x00 }, //w
+   { 0x00, 0x00, 0x00, 0x00, 0x66, 0x24, 0x18, 0x18, 0x24, 0x46, 0x00, 0x00, 0x00, 0x00 }, //x
+   { 0x00, 0x00, 0x00, 0x00, 0x42, 0x42, 0x24, 0x24, 0x18, 0x18, 0x18, 0x10, 0x60, 0x00 }, //y
+   { 0x00, 0x00, 0x00, 0x00, 0x7E, 0x04, 0x08, 0x10, 0x20, 0x7E, 0x00, 0x00, 0x00, 0x00 }, //z
+   { 0x00, 0x0E, 0x10, 0x10, 0x10, 0x10, 0x20, 0x10, 0x10, 0x10, 0x10, 0x0E, 0x00, 0x00 }, //{
+   { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00 }, //|
+   { 0x00, 0x70, 0x10, 0x10, 0x10, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x70, 0x00, 0x00 }, //}
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x4C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } //~
+};
+
+Hud::Hud(){
+   this->ProgramID = 0;
+   this->ScreenUniform = -1;
+   this->FontUniform = -1;
+   this->Font = 0;
+   this->VAO = 0;
+   this->Drawn = 0;
+   this->Width = 1.0f;
+   this->Height = 1.0f;
+   for( unsigned int i = 0; i < HUD_HISTORY; ++i ){
+      this->History[i] = 0.0f;
+   }
+   this->HistoryIndex = 0;
+}
+
+Hud::~Hud(){
+   this->Destroy();
+}
+
+bool Hud::Create(){
+   this->Destroy();
+   this->ProgramID = LoadShader( "./data/Hud.vert", "./data/Hud.frag" );
+   if( this->ProgramID == 0 ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Hud: something wrong with HUD shaders!\n" );
+      return false;
+   }
+   this->ScreenUniform = glGetUniformLocation( this->ProgramID, "Screen" );
+   this->FontUniform = glGetUniformLocation( this->ProgramID, "Font" );
+   //Font bits to texture, last cell full:
+   const GLsizei width = HUD_ATLAS_COLUMNS * HUD_FONT_WIDTH;
+   const GLsizei height = HUD_ATLAS_ROWS * HUD_FONT_HEIGHT;
+   std::vector <unsigned char> pixels( width * height, 0 );
+   unsigned int x, y;
+   for( unsigned int c = 0; c < HUD_ATLAS_COLUMNS * HUD_ATLAS_ROWS; ++c ){
+      x = ( c % HUD_ATLAS_COLUMNS ) * HUD_FONT_WIDTH;
+      y = ( c / HUD_ATLAS_COLUMNS ) * HUD_FONT_HEIGHT;
+      for( unsigned int row = 0; row < HUD_FONT_HEIGHT; ++row ){
+         for( unsigned int bit = 0; bit < HUD_FONT_WIDTH; ++bit ){
+            if( c >= 95 or ( HudFont[c][row] & ( 0x80 >> bit ) ) ){
+               pixels[( y + row ) * width + x + bit] = 0xFF;
+            }
+         }
+      }
+   }
+   glGenTextures( 1, &this->Font );
+   glBindTexture( GL_TEXTURE_2D, this->Font );
+   glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+   glTexImage2D( GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, &pixels[0] );
+   glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+   MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_TEXTURE, this->Font, pixels.size() );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   //Instance attributes:
+   if( ! this->Instances.Create( GL_ARRAY_BUFFER, HUD_MAX_QUADS * sizeof( HudQuad ) ) ){
+      this->Destroy();
+      return false;
+   }
+   glGenVertexArrays( 1, &this->VAO );
+   glBindVertexArray( this->VAO );
+   for( GLuint i = 0; i < 3; ++i ){
+      glEnableVertexAttribArray( i );
+      glVertexAttribDivisor( i, 1 );
+   }
+   glBindVertexArray( 0 );
+   this->Quads.reserve( HUD_MAX_QUADS );
+   SDL_Log( "Hud: font %i x %i\n", width, height );
+   return true;
+}
+
+void Hud::Destroy(){
+   if( this->VAO != 0 ){
+      glDeleteVertexArrays( 1, &this->VAO );
+      this->VAO = 0;
+   }
+   this->Instances.Destroy();
+   if( this->Font != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 1, &this->Font );
+      glDeleteTextures( 1, &this->Font );
+      this->Font = 0;
+   }
+   if( this->ProgramID != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_PROGRAM, 1, &this->ProgramID );
+      glDeleteProgram( this->ProgramID );
+      this->ProgramID = 0;
+   }
+   this->Quads.clear();
+}
+
+bool Hud::IsCreated() const{
+   return this->VAO != 0;
+}
+
+void Hud::AddFrame( float time ){
+   this->History[this->HistoryIndex] = time;
+   this->HistoryIndex = ( this->HistoryIndex + 1 ) % HUD_HISTORY;
+}
+
+void Hud::Begin( int width, int height ){
+   this->Width = width > 0 ? width : 1;
+   this->Height = height > 0 ? height : 1;
+   this->Quads.clear();
+}
+
+void Hud::Rect( GLfloat x, GLfloat y, GLfloat width, GLfloat height, GLuint color ){
+   if( this->Quads.size() >= HUD_MAX_QUADS ){
+      return;
+   }
+   //Centre of full cell, every pixel samples the same texel:
+   const GLfloat u = ( ( 95 % HUD_ATLAS_COLUMNS ) + 0.5f ) / HUD_ATLAS_COLUMNS;
+   const GLfloat v = ( ( 95 / HUD_ATLAS_COLUMNS ) + 0.5f ) / HUD_ATLAS_ROWS;
+   const HudQuad quad = { { x, y, width, height }, { u, v, u, v }, color };
+   this->Quads.push_back( quad );
+}
+
+void Hud::Text( GLfloat x, GLfloat y, const char *text, GLuint color ){
+   const GLfloat cell_u = 1.0f / HUD_ATLAS_COLUMNS;
+   const GLfloat cell_v = 1.0f / HUD_ATLAS_ROWS;
+   GLfloat left = x;
+   unsigned int c;
+   for( ; *text != '\0' and this->Quads.size() < HUD_MAX_QUADS; ++text ){
+      if( *text == '\n' ){
+         left = x;
+         y += HUD_FONT_HEIGHT;
+         continue;
+      }
+      c = (unsigned char)*text;
+      if( c > 32 and c < 127 ){
+         c -= 32;
+         const GLfloat u = ( c % HUD_ATLAS_COLUMNS ) * cell_u;
+         const GLfloat v = ( c / HUD_ATLAS_COLUMNS ) * cell_v;
+         const HudQuad quad = { { left, y, HUD_FONT_WIDTH, HUD_FONT_HEIGHT }, { u, v, u + cell_u, v + cell_v }, color };
+         this->Quads.push_back( quad );
+      }
+      left += HUD_FONT_WIDTH;
+   }
+}
+
+void Hud::Graph( GLfloat x, GLfloat y, GLfloat height, float target ){
+   if( target <= 0.0f ){
+      target = 1000.0f / 60.0f;
+   }
+   this->Rect( x, y, HUD_HISTORY, height, HUD_BACKGROUND );
+   //Oldest frame on the left:
+   const GLfloat scale = height / ( target * 2.0f );
+   GLfloat time, bar;
+   GLuint color;
+   for( unsigned int i = 0; i < HUD_HISTORY; ++i ){
+      time = this->History[( this->HistoryIndex + i ) % HUD_HISTORY];
+      if( time <= 0.0f ){
+         continue;
+      }
+      bar = time * scale < height ? time * scale : height;
+      color = time <= target ? HUD_GREEN : time <= target * 1.5f ? HUD_YELLOW : HUD_RED;
+      this->Rect( x + i, y + height - bar, 1.0f, bar, color );
+   }
+   this->Rect( x, y + height - target * scale, HUD_HISTORY, 1.0f, HUD_WHITE );
+}
+
+void Hud::Draw(){
+   this->Drawn = this->Quads.size();
+   if( this->Quads.empty() ){
+      return;
+   }
+   void *pointer = NULL;
+   const GLsizeiptr size = this->Quads.size() * sizeof( HudQuad );
+   this->Instances.BeginFrame();
+   const GLintptr offset = this->Instances.Allocate( size, sizeof( GLfloat ), &pointer );
+   if( offset < 0 ){
+      this->Instances.EndFrame();
+      return;
+   }
+   memcpy( pointer, &this->Quads[0], size );
+   this->Instances.Flush();
+   const GLboolean depth = glIsEnabled( GL_DEPTH_TEST );
+   const GLboolean blend = glIsEnabled( GL_BLEND );
+   glDisable( GL_DEPTH_TEST );
+   glEnable( GL_BLEND );
+   glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+   glUseProgram( this->ProgramID );
+   glUniform2f( this->ScreenUniform, this->Width, this->Height );
+   glUniform1i( this->FontUniform, 0 );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, this->Font );
+   glBindVertexArray( this->VAO );
+   glBindBuffer( GL_ARRAY_BUFFER, this->Instances.ReturnBuffer() );
+   glVertexAttribPointer( 0, 4, GL_FLOAT, GL_FALSE, sizeof( HudQuad ), (GLvoid *)( offset + offsetof( HudQuad, Rect ) ) );
+   glVertexAttribPointer( 1, 4, GL_FLOAT, GL_FALSE, sizeof( HudQuad ), (GLvoid *)( offset + offsetof( HudQuad, UV ) ) );
+   glVertexAttribPointer( 2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( HudQuad ), (GLvoid *)( offset + offsetof( HudQuad, Color ) ) );
+   glBindBuffer( GL_ARRAY_BUFFER, 0 );
+   glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, this->Quads.size() );
+   glBindVertexArray( 0 );
+   this->Instances.EndFrame();
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   glUseProgram( 0 );
+   if( ! blend ){
+      glDisable( GL_BLEND );
+   }
+   if( depth ){
+      glEnable( GL_DEPTH_TEST );
+   }
+}
+
+float Hud::ReturnMax() const{
+   float max = 0.0f;
+   for( unsigned int i = 0; i < HUD_HISTORY; ++i ){
+      if( this->History[i] > max ){
+         max = this->History[i];
+      }
+   }
+   return max;
+}
+
+unsigned int Hud::ReturnQuads() const{
+   return this->Drawn;
+}
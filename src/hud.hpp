@@ -0,0 +1,203 @@
+/*!
+   \file hud.hpp
+   \brief Plik odpowiedzialny za nakładkę z wykresem czasu klatek i licznikami (HUD).
+*/
+#ifndef hud_hpp
+#define hud_hpp
+#include <vector>
+#include <GL/glew.h>
+#include "ringbuffer.hpp"
+
+/*!
+   \brief Szerokość znaku czcionki w pikselach.
+*/
+#define HUD_FONT_WIDTH 8
+/*!
+   \brief Wysokość znaku czcionki (wiersza tekstu) w pikselach.
+*/
+#define HUD_FONT_HEIGHT 14
+/*!
+   \brief Największa ilość prostokątów (znaków, słupków wykresu) w jednej klatce.
+*/
+#define HUD_MAX_QUADS 4096
+/*!
+   \brief Ilość ostatnich klatek na wykresie ( \link Hud::AddFrame() \endlink ).
+*/
+#define HUD_HISTORY 240
+/*!
+   \brief Kolor RGBA (bajt R najmłodszy): biały.
+*/
+#define HUD_WHITE 0xFFFFFFFF
+/*!
+   \brief Kolor RGBA: zielony, klatki w terminie.
+*/
+#define HUD_GREEN 0xFF40E040
+/*!
+   \brief Kolor RGBA: żółty, klatki do 1.5 x terminu.
+*/
+#define HUD_YELLOW 0xFF20D0F0
+/*!
+   \brief Kolor RGBA: czerwony, klatki spóźnione.
+*/
+#define HUD_RED 0xFF3030F0
+/*!
+   \brief Kolor RGBA: półprzezroczyste tło.
+*/
+#define HUD_BACKGROUND 0xB0000000
+
+/*!
+   \brief Pojedynczy prostokąt nakładki, atrybuty instancji.
+*/
+struct HudQuad{
+   /*!
+      \brief Lewy górny róg (xy) i wielkość (zw) w pikselach okna.
+   */
+   GLfloat Rect[4];
+   /*!
+      \brief Współrzędne tekstury czcionki: lewy górny róg (xy) i prawy dolny (zw).
+   */
+   GLfloat UV[4];
+   /*!
+      \brief Kolor RGBA, po bajcie na składową.
+   */
+   GLuint Color;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za nakładkę z wykresem czasu klatek i licznikami.
+
+   Tekst, tło i słupki wykresu zbierane są w klatce jako prostokąty ( \link HudQuad \endlink ),
+   a \link Draw() \endlink rysuje je wszystkie jednym poleceniem glDrawArraysInstanced z bufora pierścieniowego.\n
+   Czcionka o stałej szerokości ( \link HUD_FONT_WIDTH \endlink x \link HUD_FONT_HEIGHT \endlink, znaki ASCII 32-126)
+   zapisana jest w kodzie jako bitmapa 1 bit na piksel i przy \link Create() \endlink kopiowana do tekstury GL_R8,
+   ostatnie pole tekstury jest pełne i służy do rysowania prostokątów bez tekstu.\n
+*/
+class Hud{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   Hud();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia teksturę i bufory ( \link Destroy() \endlink ).
+   */
+   ~Hud();
+   /*!
+      \brief Tworzy shader, teksturę czcionki i bufor prostokątów.
+
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create();
+   /*!
+      \brief Zwalnia shader, teksturę i bufory.
+   */
+   void Destroy();
+   /*!
+      \brief Zwraca TRUE, jeśli \link Create() \endlink się powiódł.
+   */
+   bool IsCreated() const;
+   /*!
+      \brief Dodaje czas klatki do wykresu.
+
+      \param time - czas klatki w milisekundach
+   */
+   void AddFrame( float time );
+   /*!
+      \brief Rozpoczyna zbieranie prostokątów klatki.
+
+      \param width - szerokość okna w pikselach
+      \param height - wysokość okna w pikselach
+   */
+   void Begin( int width, int height );
+   /*!
+      \brief Dodaje prostokąt w jednym kolorze.
+
+      \param x - lewa krawędź w pikselach
+      \param y - górna krawędź w pikselach
+      \param width - szerokość w pikselach
+      \param height - wysokość w pikselach
+      \param color - kolor RGBA
+   */
+   void Rect( GLfloat x, GLfloat y, GLfloat width, GLfloat height, GLuint color );
+   /*!
+      \brief Dodaje wiersz tekstu, znak '\\n' przechodzi do następnego wiersza.
+
+      \param x - lewa krawędź w pikselach
+      \param y - górna krawędź w pikselach
+      \param text - tekst ASCII
+      \param color - kolor RGBA
+   */
+   void Text( GLfloat x, GLfloat y, const char *text, GLuint color = HUD_WHITE );
+   /*!
+      \brief Dodaje wykres ostatnich \link HUD_HISTORY \endlink czasów klatek, jeden słupek na klatkę.
+
+      \param x - lewa krawędź w pikselach
+      \param y - górna krawędź w pikselach
+      \param height - wysokość w pikselach, odpowiada 2 x target
+      \param target - oczekiwany czas klatki w milisekundach (linia na wykresie, kolory słupków)
+   */
+   void Graph( GLfloat x, GLfloat y, GLfloat height, float target );
+   /*!
+      \brief Rysuje zebrane prostokąty na wierzchu klatki.
+
+      Wyłącza test głębokości i włącza mieszanie kolorów na czas rysowania.\n
+   */
+   void Draw();
+   /*!
+      \brief Zwraca najdłuższy czas klatki na wykresie w milisekundach.
+   */
+   float ReturnMax() const;
+   /*!
+      \brief Zwraca ilość prostokątów narysowanych w ostatniej klatce.
+   */
+   unsigned int ReturnQuads() const;
+private:
+   /*!
+      \brief Identyfikator shadera.
+   */
+   GLuint ProgramID;
+   /*!
+      \brief Identyfikator uniform wielkości okna.
+   */
+   GLint ScreenUniform;
+   /*!
+      \brief Identyfikator uniform tekstury czcionki.
+   */
+   GLint FontUniform;
+   /*!
+      \brief Tekstura czcionki (GL_R8).
+   */
+   GLuint Font;
+   /*!
+      \brief Identyfikator VAO.
+   */
+   GLuint VAO;
+   /*!
+      \brief Bufor pierścieniowy prostokątów.
+   */
+   RingBuffer Instances;
+   /*!
+      \brief Prostokąty aktualnej klatki.
+   */
+   std::vector <HudQuad> Quads;
+   /*!
+      \brief Ilość prostokątów narysowanych w ostatniej klatce.
+   */
+   unsigned int Drawn;
+   /*!
+      \brief Wielkość okna w pikselach.
+   */
+   GLfloat Width, Height;
+   /*!
+      \brief Czasy ostatnich klatek (pierścień).
+   */
+   float History[HUD_HISTORY];
+   /*!
+      \brief Pozycja następnego czasu w \link History \endlink.
+   */
+   unsigned int HistoryIndex;
+};
+
+#endif
@@ -5,6 +5,8 @@
 #include "imgloader.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
+#include "profiler.hpp"
+#include "memorytracker.hpp"
 #include <IL/il.h>
 #include <IL/ilu.h>
 /* for include ilut.h:
@@ -15,6 +17,7 @@
 */
 
 bool LoadImg( const char *img_path_file, GLuint &image ){
+   PROFILE_SCOPE( "LoadImg" );
    SDL_Log( "Loading image: %s", img_path_file );
    ILenum error;
    GLenum error_gl;
@@ -42,6 +45,8 @@ bool LoadImg( const char *img_path_file, GLuint &image ){
    GLint height = ilGetInteger( IL_IMAGE_HEIGHT );
    GLint type = ilGetInteger( IL_IMAGE_TYPE );
    GLint format = ilGetInteger( IL_IMAGE_FORMAT );
+   //Decoded image kept by DevIL until ilDeleteImages():
+   MemoryScope decoded( MEMORY_LOADER, ilGetInteger( IL_IMAGE_SIZE_OF_DATA ) );
 
    glGenTextures( 1, &image );
    glBindTexture( GL_TEXTURE_2D, image );
@@ -54,6 +59,7 @@ bool LoadImg( const char *img_path_file, GLuint &image ){
    }
 
    glGenerateMipmap( GL_TEXTURE_2D );
+   MemoryTracker::AddObject( MEMORY_TEXTURE, MEMORY_OBJECT_TEXTURE, image, MemoryTracker::TextureBytes( width, height, 1, ilGetInteger( IL_IMAGE_BYTES_PER_PIXEL ), true ) );
 
    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
@@ -68,6 +74,7 @@ bool LoadImg( const char *img_path_file, GLuint &image ){
 }
 
 GLuint LoadImg( const char *img_path_file ){
+   PROFILE_SCOPE( "LoadImg" );
    SDL_Log( "Loading image: %s", img_path_file );
    ILenum error;
    GLenum error_gl;
@@ -93,6 +100,8 @@ GLuint LoadImg( const char *img_path_file ){
    GLint height = ilGetInteger( IL_IMAGE_HEIGHT );
    GLint type = ilGetInteger( IL_IMAGE_TYPE );
    GLint format = ilGetInteger( IL_IMAGE_FORMAT );
+   //Decoded image kept by DevIL until ilDeleteImages():
+   MemoryScope decoded( MEMORY_LOADER, ilGetInteger( IL_IMAGE_SIZE_OF_DATA ) );
 
    GLuint image;
    glGenTextures( 1, &image );
@@ -106,6 +115,7 @@ GLuint LoadImg( const char *img_path_file ){
    }
 
    glGenerateMipmap( GL_TEXTURE_2D );
+   MemoryTracker::AddObject( MEMORY_TEXTURE, MEMORY_OBJECT_TEXTURE, image, MemoryTracker::TextureBytes( width, height, 1, ilGetInteger( IL_IMAGE_BYTES_PER_PIXEL ), true ) );
 
    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
@@ -0,0 +1,302 @@
+/*!
+   \file impostor.cpp
+   \brief Plik źródłowy dla impostor.hpp.
+*/
+#include "impostor.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <SDL2/SDL.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "shader.hpp"
+#include "memorytracker.hpp"
+
+Impostor::Impostor(){
+   this->BakeID = 0;
+   this->ViewProjectionUniformBake = -1;
+   this->TextureUniformBake = -1;
+   this->DrawID = 0;
+   this->FramesUniform = -1;
+   this->AlbedoUniform = -1;
+   this->NormalDepthUniform = -1;
+   this->Albedo = 0;
+   this->NormalDepth = 0;
+   this->VAO = 0;
+   this->Layers = 0;
+   this->Frames = IMPOSTOR_FRAMES;
+   this->FrameSize = IMPOSTOR_FRAME_SIZE;
+   this->MaxInstances = 0;
+}
+
+Impostor::~Impostor(){
+   this->Destroy();
+}
+
+bool Impostor::Create( std::vector <Model> &models, const std::vector <bool> &impostor_models, unsigned int max_instances, GLuint frames, GLuint frame_size ){
+   this->Destroy();
+   this->Frames = frames > 0 ? frames : IMPOSTOR_FRAMES;
+   this->FrameSize = frame_size > 0 ? frame_size : IMPOSTOR_FRAME_SIZE;
+   this->MaxInstances = max_instances > 0 ? max_instances : 1;
+   //Layers and bounding spheres:
+   this->Layers = 0;
+   this->Layer.assign( models.size(), -1 );
+   this->Bounds.assign( models.size(), glm::vec4( 0.0f ) );
+   for( unsigned int i = 0; i < models.size() and i < impostor_models.size(); ++i ){
+      if( impostor_models[i] and ! models[i].ReturnIndices().empty() ){
+         const glm::vec3 min = models[i].ReturnCollisionMin();
+         const glm::vec3 max = models[i].ReturnCollisionMax();
+         this->Bounds[i] = glm::vec4( ( min + max ) * 0.5f, glm::length( max - min ) * 0.5f );
+         this->Layer[i] = this->Layers++;
+      }
+   }
+   if( this->Layers == 0 ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Impostor: no models\n" );
+      return false;
+   }
+   //Shaders:
+   this->BakeID = LoadShader( "./data/ImpostorBake.vert", "./data/ImpostorBake.frag" );
+   this->DrawID = LoadShader( "./data/Impostor.vert", "./data/Impostor.frag" );
+   if( this->BakeID == 0 or this->DrawID == 0 ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Impostor: something wrong with impostor shaders!\n" );
+      this->Destroy();
+      return false;
+   }
+   this->ViewProjectionUniformBake = glGetUniformLocation( this->BakeID, "viewprojection" );
+   this->TextureUniformBake = glGetUniformLocation( this->BakeID, "Texture" );
+   this->FramesUniform = glGetUniformLocation( this->DrawID, "Frames" );
+   this->AlbedoUniform = glGetUniformLocation( this->DrawID, "Albedo" );
+   this->NormalDepthUniform = glGetUniformLocation( this->DrawID, "NormalDepth" );
+   //Atlas:
+   const GLsizei size = this->ReturnAtlasSize();
+   glGenTextures( 1, &this->Albedo );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, this->Albedo );
+   glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, size, size, this->Layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+   MemoryTracker::AddObject( MEMORY_WORLD, MEMORY_OBJECT_TEXTURE, this->Albedo, MemoryTracker::TextureBytes( size, size, this->Layers, 4 ) );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glGenTextures( 1, &this->NormalDepth );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, this->NormalDepth );
+   glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA16F, size, size, this->Layers, 0, GL_RGBA, GL_FLOAT, NULL );
+   MemoryTracker::AddObject( MEMORY_WORLD, MEMORY_OBJECT_TEXTURE, this->NormalDepth, MemoryTracker::TextureBytes( size, size, this->Layers, 8 ) );
+   //Normals and depth are not interpolated between neighbouring frames:
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+   if( ! this->Bake( models ) ){
+      this->Destroy();
+      return false;
+   }
+   //Instance attributes:
+   if( ! this->Instances.Create( GL_ARRAY_BUFFER, this->MaxInstances * sizeof( ImpostorInstance ) ) ){
+      this->Destroy();
+      return false;
+   }
+   glGenVertexArrays( 1, &this->VAO );
+   glBindVertexArray( this->VAO );
+   glEnableVertexAttribArray( 0 );
+   glVertexAttribDivisor( 0, 1 );
+   glEnableVertexAttribArray( 1 );
+   glVertexAttribDivisor( 1, 1 );
+   glBindVertexArray( 0 );
+   this->Pending.reserve( this->MaxInstances );
+   SDL_Log( "Impostor: %u models, atlas %i x %i, %u x %u frames\n", this->Layers, size, size, this->Frames, this->Frames );
+   return true;
+}
+
+bool Impostor::Bake( std::vector <Model> &models ){
+   const GLsizei size = this->ReturnAtlasSize();
+   GLint viewport[4];
+   glGetIntegerv( GL_VIEWPORT, viewport );
+   //Window or headless framebuffer:
+   GLint previous_framebuffer;
+   glGetIntegerv( GL_FRAMEBUFFER_BINDING, &previous_framebuffer );
+   GLuint framebuffer, depth;
+   glGenFramebuffers( 1, &framebuffer );
+   glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+   glGenRenderbuffers( 1, &depth );
+   glBindRenderbuffer( GL_RENDERBUFFER, depth );
+   glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size );
+   MemoryTracker::AddObject( MEMORY_WORLD, MEMORY_OBJECT_RENDERBUFFER, depth, MemoryTracker::TextureBytes( size, size, 1, 4 ) );
+   glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth );
+   const GLenum buffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+   glDrawBuffers( 2, buffers );
+   glUseProgram( this->BakeID );
+   glUniform1i( this->TextureUniformBake, 0 );
+   glActiveTexture( GL_TEXTURE0 );
+   glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+   glEnable( GL_DEPTH_TEST );
+   bool result = true;
+   GLuint x, y;
+   glm::vec3 dir, center, up;
+   glm::mat4 view, projection;
+   for( unsigned int i = 0; i < models.size() and result; ++i ){
+      if( this->Layer[i] < 0 ){
+         continue;
+      }
+      glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->Albedo, 0, this->Layer[i] );
+      glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, this->NormalDepth, 0, this->Layer[i] );
+      if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE ){
+         SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Impostor: incomplete framebuffer\n" );
+         result = false;
+         break;
+      }
+      glViewport( 0, 0, size, size );
+      glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+      center = glm::vec3( this->Bounds[i] );
+      const GLfloat radius = this->Bounds[i].w;
+      projection = glm::ortho( -radius, radius, -radius, radius, 0.0f, radius * 4.0f );
+      glBindTexture( GL_TEXTURE_2D, models[i].ReturnTexture() );
+      models[i].BindMesh();
+      for( y = 0; y < this->Frames; ++y ){
+         for( x = 0; x < this->Frames; ++x ){
+            dir = Impostor::OctahedronDecode( glm::vec2( x + 0.5f, y + 0.5f ) / GLfloat( this->Frames ) );
+            //Same basis as in Impostor.vert:
+            up = std::fabs( dir.y ) > 0.999f ? glm::vec3( 0.0f, 0.0f, 1.0f ) : glm::vec3( 0.0f, 1.0f, 0.0f );
+            view = glm::lookAt( center + dir * radius * 2.0f, center, up );
+            glUniformMatrix4fv( this->ViewProjectionUniformBake, 1, GL_FALSE, glm::value_ptr( projection * view ) );
+            glViewport( x * this->FrameSize, y * this->FrameSize, this->FrameSize, this->FrameSize );
+            glDrawElements( GL_TRIANGLES, models[i].ReturnIndices().size(), GL_UNSIGNED_INT, (GLvoid *)0 );
+         }
+      }
+   }
+   glBindVertexArray( 0 );
+   glBindTexture( GL_TEXTURE_2D, 0 );
+   glUseProgram( 0 );
+   glBindFramebuffer( GL_FRAMEBUFFER, previous_framebuffer );
+   glDeleteFramebuffers( 1, &framebuffer );
+   MemoryTracker::RemoveObject( MEMORY_OBJECT_RENDERBUFFER, 1, &depth );
+   glDeleteRenderbuffers( 1, &depth );
+   glViewport( viewport[0], viewport[1], viewport[2], viewport[3] );
+   return result;
+}
+
+void Impostor::Destroy(){
+   if( this->VAO != 0 ){
+      glDeleteVertexArrays( 1, &this->VAO );
+      this->VAO = 0;
+   }
+   if( this->Albedo != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 1, &this->Albedo );
+      glDeleteTextures( 1, &this->Albedo );
+      this->Albedo = 0;
+   }
+   if( this->NormalDepth != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 1, &this->NormalDepth );
+      glDeleteTextures( 1, &this->NormalDepth );
+      this->NormalDepth = 0;
+   }
+   if( this->BakeID != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_PROGRAM, 1, &this->BakeID );
+      glDeleteProgram( this->BakeID );
+      this->BakeID = 0;
+   }
+   if( this->DrawID != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_PROGRAM, 1, &this->DrawID );
+      glDeleteProgram( this->DrawID );
+      this->DrawID = 0;
+   }
+   this->Instances.Destroy();
+   this->Pending.clear();
+   this->Layer.clear();
+   this->Bounds.clear();
+   this->Layers = 0;
+}
+
+bool Impostor::Has( GLuint model ) const{
+   return this->VAO != 0 and model < this->Layer.size() and this->Layer[model] >= 0;
+}
+
+void Impostor::Clear(){
+   this->Pending.clear();
+}
+
+void Impostor::Add( GLuint model, const glm::mat4 &matrix ){
+   if( ! this->Has( model ) or this->Pending.size() >= this->MaxInstances ){
+      return;
+   }
+   ImpostorInstance instance;
+   const GLfloat scale = glm::max( glm::length( glm::vec3( matrix[0] ) ), glm::max( glm::length( glm::vec3( matrix[1] ) ), glm::length( glm::vec3( matrix[2] ) ) ) );
+   instance.Sphere = glm::vec4( glm::vec3( matrix * glm::vec4( glm::vec3( this->Bounds[model] ), 1.0f ) ), this->Bounds[model].w * scale );
+   instance.Layer = this->Layer[model];
+   this->Pending.push_back( instance );
+}
+
+unsigned int Impostor::ReturnCount() const{
+   return this->Pending.size();
+}
+
+void Impostor::Draw(){
+   if( this->Pending.empty() ){
+      return;
+   }
+   void *pointer = NULL;
+   const GLsizeiptr size = this->Pending.size() * sizeof( ImpostorInstance );
+   this->Instances.BeginFrame();
+   const GLintptr offset = this->Instances.Allocate( size, sizeof( GLfloat ), &pointer );
+   if( offset < 0 ){
+      this->Instances.EndFrame();
+      return;
+   }
+   memcpy( pointer, &this->Pending[0], size );
+   this->Instances.Flush();
+   glUniform1f( this->FramesUniform, this->Frames );
+   glUniform1i( this->AlbedoUniform, 0 );
+   glUniform1i( this->NormalDepthUniform, 1 );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, this->Albedo );
+   glActiveTexture( GL_TEXTURE1 );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, this->NormalDepth );
+   glBindVertexArray( this->VAO );
+   glBindBuffer( GL_ARRAY_BUFFER, this->Instances.ReturnBuffer() );
+   glVertexAttribPointer( 0, 4, GL_FLOAT, GL_FALSE, sizeof( ImpostorInstance ), (GLvoid *)( offset + offsetof( ImpostorInstance, Sphere ) ) );
+   glVertexAttribPointer( 1, 1, GL_FLOAT, GL_FALSE, sizeof( ImpostorInstance ), (GLvoid *)( offset + offsetof( ImpostorInstance, Layer ) ) );
+   glBindBuffer( GL_ARRAY_BUFFER, 0 );
+   glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, this->Pending.size() );
+   glBindVertexArray( 0 );
+   this->Instances.EndFrame();
+   glActiveTexture( GL_TEXTURE1 );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+}
+
+GLuint Impostor::ReturnProgram() const{
+   return this->DrawID;
+}
+
+GLuint Impostor::ReturnAlbedo() const{
+   return this->Albedo;
+}
+
+GLuint Impostor::ReturnNormalDepth() const{
+   return this->NormalDepth;
+}
+
+GLuint Impostor::ReturnAtlasSize() const{
+   return this->Frames * this->FrameSize;
+}
+
+glm::vec3 Impostor::OctahedronDecode( const glm::vec2 &uv ){
+   const glm::vec2 p = uv * 2.0f - glm::vec2( 1.0f );
+   glm::vec3 d( p.x, 1.0f - std::fabs( p.x ) - std::fabs( p.y ), p.y );
+   if( d.y < 0.0f ){
+      const GLfloat x = d.x, z = d.z;
+      d.x = ( 1.0f - std::fabs( z ) ) * ( x >= 0.0f ? 1.0f : -1.0f );
+      d.z = ( 1.0f - std::fabs( x ) ) * ( z >= 0.0f ? 1.0f : -1.0f );
+   }
+   return glm::normalize( d );
+}
+
+glm::vec2 Impostor::OctahedronEncode( const glm::vec3 &dir ){
+   const glm::vec3 d = dir / ( std::fabs( dir.x ) + std::fabs( dir.y ) + std::fabs( dir.z ) );
+   glm::vec2 p( d.x, d.z );
+   if( d.y < 0.0f ){
+      p = glm::vec2( ( 1.0f - std::fabs( d.z ) ) * ( d.x >= 0.0f ? 1.0f : -1.0f ), ( 1.0f - std::fabs( d.x ) ) * ( d.z >= 0.0f ? 1.0f : -1.0f ) );
+   }
+   return p * 0.5f + glm::vec2( 0.5f );
+}
@@ -0,0 +1,216 @@
+/*!
+   \file impostor.hpp
+   \brief Plik odpowiedzialny za zastępowanie odległych obiektów prostokątami z wcześniej narysowanymi widokami (impostor).
+*/
+#ifndef impostor_hpp
+#define impostor_hpp
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "model.hpp"
+#include "ringbuffer.hpp"
+
+/*!
+   \brief Domyślna ilość widoków w jednym wierszu atlasu (widoków jest IMPOSTOR_FRAMES x IMPOSTOR_FRAMES).
+*/
+#define IMPOSTOR_FRAMES 8
+/*!
+   \brief Domyślna wielkość jednego widoku w pikselach.
+*/
+#define IMPOSTOR_FRAME_SIZE 64
+/*!
+   \brief Domyślna odległość od kamery, od której obiekty rysowane są jako impostor.
+*/
+#define IMPOSTOR_DISTANCE 20.0f
+
+/*!
+   \brief Pojedynczy impostor, atrybuty instancji.
+*/
+struct ImpostorInstance{
+   /*!
+      \brief Środek (xyz) i promień (w) obiektu w przestrzeni świata.
+   */
+   glm::vec4 Sphere;
+   /*!
+      \brief Warstwa atlasu (model).
+   */
+   GLfloat Layer;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za impostory odległych obiektów.
+
+   Podczas ładowania każdy model rysowany jest z IMPOSTOR_FRAMES x IMPOSTOR_FRAMES kierunków rozłożonych na ośmiościanie
+   (kierunek = dekodowanie oktaedryczne pozycji widoku w atlasie) do atlasu koloru oraz normalnej i głębokości ( \link Bake() \endlink ).\n
+   Atlas tworzony jest w osobnym buforze ramki (FBO), więc nie wymaga okna.\n
+   Odległe obiekty rysowane są jednym poleceniem jako prostokąty zwrócone do kamery,
+   z widokiem najbliższym kierunkowi kamery i głębokością odtworzoną z atlasu.\n
+   Macierze modelu obiektów zastępowanych nie mogą zawierać obrotu (normalne zapisane są w przestrzeni modelu).\n
+*/
+class Impostor{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   Impostor();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia atlas i bufory ( \link Destroy() \endlink ).
+   */
+   ~Impostor();
+   /*!
+      \brief Wczytuje shadery i tworzy atlas dla wybranych modeli.
+
+      \param models - wektor wszystkich modeli (wczytanych)
+      \param impostor_models - TRUE dla modeli zastępowanych impostorami
+      \param max_instances - maksymalna ilość impostorów w jednej klatce
+      \param frames - ilość widoków w jednym wierszu atlasu
+      \param frame_size - wielkość jednego widoku w pikselach
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create( std::vector <Model> &models, const std::vector <bool> &impostor_models, unsigned int max_instances,
+      GLuint frames = IMPOSTOR_FRAMES, GLuint frame_size = IMPOSTOR_FRAME_SIZE
+   );
+   /*!
+      \brief Zwalnia atlas, shadery i bufory.
+   */
+   void Destroy();
+   /*!
+      \brief Sprawdza czy model posiada impostor.
+
+      \param model - numer modelu
+   */
+   bool Has( GLuint model ) const;
+   /*!
+      \brief Usuwa wszystkie impostory dodane w klatce.
+   */
+   void Clear();
+   /*!
+      \brief Dodaje obiekt do narysowania jako impostor.
+
+      \param model - numer modelu ( \link Has() \endlink )
+      \param matrix - macierz modelu obiektu
+   */
+   void Add( GLuint model, const glm::mat4 &matrix );
+   /*!
+      \brief Zwraca ilość impostorów dodanych w klatce.
+   */
+   unsigned int ReturnCount() const;
+   /*!
+      \brief Rysuje wszystkie dodane impostory jednym poleceniem.
+
+      Shader ( \link ReturnProgram() \endlink ) musi być aktywny.
+   */
+   void Draw();
+   /*!
+      \brief Zwraca identyfikator shadera rysowania.
+   */
+   GLuint ReturnProgram() const;
+   /*!
+      \brief Zwraca identyfikator atlasu koloru (GL_TEXTURE_2D_ARRAY, warstwa = model).
+   */
+   GLuint ReturnAlbedo() const;
+   /*!
+      \brief Zwraca identyfikator atlasu normalnych i głębokości (GL_TEXTURE_2D_ARRAY, warstwa = model).
+   */
+   GLuint ReturnNormalDepth() const;
+   /*!
+      \brief Zwraca wielkość atlasu w pikselach.
+   */
+   GLuint ReturnAtlasSize() const;
+   /*!
+      \brief Zwraca kierunek widoku dla pozycji w atlasie (dekodowanie oktaedryczne).
+
+      \param uv - pozycja w atlasie (0.0 - 1.0)
+   */
+   static glm::vec3 OctahedronDecode( const glm::vec2 &uv );
+   /*!
+      \brief Zwraca pozycję w atlasie dla kierunku widoku (kodowanie oktaedryczne).
+
+      \param dir - kierunek od obiektu do kamery
+   */
+   static glm::vec2 OctahedronEncode( const glm::vec3 &dir );
+private:
+   /*!
+      \brief Rysuje widoki wszystkich modeli do atlasu.
+
+      \param models - wektor wszystkich modeli
+      \return - wartość logiczna, FALSE = błąd bufora ramki
+   */
+   bool Bake( std::vector <Model> &models );
+   /*!
+      \brief Identyfikator shadera tworzenia atlasu.
+   */
+   GLuint BakeID;
+   /*!
+      \brief Uniform dla macierzy widoku i projekcji widoku atlasu.
+   */
+   GLint ViewProjectionUniformBake;
+   /*!
+      \brief Uniform dla tekstury modelu.
+   */
+   GLint TextureUniformBake;
+   /*!
+      \brief Identyfikator shadera rysowania.
+   */
+   GLuint DrawID;
+   /*!
+      \brief Uniform dla ilości widoków w wierszu atlasu.
+   */
+   GLint FramesUniform;
+   /*!
+      \brief Uniform dla atlasu koloru.
+   */
+   GLint AlbedoUniform;
+   /*!
+      \brief Uniform dla atlasu normalnych i głębokości.
+   */
+   GLint NormalDepthUniform;
+   /*!
+      \brief Atlas koloru, kanał alpha = pokrycie.
+   */
+   GLuint Albedo;
+   /*!
+      \brief Atlas normalnych (xyz, przestrzeń modelu) i głębokości (w).
+   */
+   GLuint NormalDepth;
+   /*!
+      \brief Identyfikator VAO (Vertex Array Object) dla atrybutów instancji.
+   */
+   GLuint VAO;
+   /*!
+      \brief Bufor atrybutów instancji, zapisywany co klatkę.
+   */
+   RingBuffer Instances;
+   /*!
+      \brief Impostory dodane w klatce.
+   */
+   std::vector <ImpostorInstance> Pending;
+   /*!
+      \brief Warstwa atlasu dla każdego modelu, -1 = brak impostora.
+   */
+   std::vector <int> Layer;
+   /*!
+      \brief Środek (xyz) i promień (w) każdego modelu w przestrzeni modelu.
+   */
+   std::vector <glm::vec4> Bounds;
+   /*!
+      \brief Ilość warstw atlasu.
+   */
+   GLuint Layers;
+   /*!
+      \brief Ilość widoków w jednym wierszu atlasu.
+   */
+   GLuint Frames;
+   /*!
+      \brief Wielkość jednego widoku w pikselach.
+   */
+   GLuint FrameSize;
+   /*!
+      \brief Maksymalna ilość impostorów w jednej klatce.
+   */
+   unsigned int MaxInstances;
+};
+
+#endif
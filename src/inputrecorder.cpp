@@ -0,0 +1,272 @@
+/*!
+   \file inputrecorder.cpp
+   \brief Plik źródłowy dla inputrecorder.hpp.
+*/
+#include "inputrecorder.hpp"
+#include <cstring>
+
+/*!
+   \brief Początek pliku nagrania.
+*/
+static const char InputMagic[4] = { 'S', 'O', 'G', 'I' };
+
+InputRecorder::InputRecorder(){
+   this->File = NULL;
+   this->Writing = false;
+   this->Start = 0;
+   this->Ticks = 0;
+   this->Records = 0;
+}
+
+InputRecorder::~InputRecorder(){
+   this->Close();
+}
+
+bool InputRecorder::Create( const std::string &path, const InputHeader &header ){
+   this->Close();
+   this->File = fopen( path.c_str(), "wb" );
+   if( this->File == NULL ){
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "InputRecorder: can not create %s\n", path.c_str() );
+      return false;
+   }
+   this->Writing = true;
+   fwrite( InputMagic, 1, sizeof( InputMagic ), this->File );
+   this->Put( INPUT_VERSION );
+   this->Put( header.Seed );
+   this->Put( header.Step );
+   this->Put( header.Width );
+   this->Put( header.Height );
+   this->Start = SDL_GetTicks();
+   this->Ticks = 0;
+   this->Records = 0;
+   SDL_Log( "InputRecorder: recording to %s, seed %u\n", path.c_str(), header.Seed );
+   return true;
+}
+
+bool InputRecorder::Open( const std::string &path, InputHeader &header ){
+   this->Close();
+   this->File = fopen( path.c_str(), "rb" );
+   if( this->File == NULL ){
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "InputRecorder: can not open %s\n", path.c_str() );
+      return false;
+   }
+   this->Writing = false;
+   char magic[4];
+   Uint32 version, seed, step, width, height;
+   if( fread( magic, 1, sizeof( magic ), this->File ) != sizeof( magic ) or memcmp( magic, InputMagic, sizeof( magic ) ) != 0
+      or not this->Get( version ) or version != INPUT_VERSION
+      or not this->Get( seed ) or not this->Get( step ) or not this->Get( width ) or not this->Get( height )
+   ){
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "InputRecorder: %s is not a recording (version %i)\n", path.c_str(), INPUT_VERSION );
+      this->Close();
+      return false;
+   }
+   header.Seed = seed;
+   header.Step = step;
+   header.Width = width;
+   header.Height = height;
+   this->Records = 0;
+   SDL_Log( "InputRecorder: replaying %s, seed %u\n", path.c_str(), header.Seed );
+   return true;
+}
+
+void InputRecorder::Close(){
+   if( this->File != NULL ){
+      fclose( this->File );
+      this->File = NULL;
+   }
+   this->Writing = false;
+}
+
+bool InputRecorder::IsRecording() const{
+   return this->File != NULL and this->Writing;
+}
+
+bool InputRecorder::IsReplaying() const{
+   return this->File != NULL and not this->Writing;
+}
+
+void InputRecorder::Write( InputRecord &record ){
+   if( not this->IsRecording() ){
+      return;
+   }
+   record.Tick = this->Ticks;
+   record.Time = SDL_GetTicks() - this->Start;
+   fputc( record.Type, this->File );
+   this->Put( record.Tick );
+   this->Put( record.Time );
+   Uint32 value;
+   switch( record.Type ){
+      case INPUT_EVENT:
+         this->Put( record.Event );
+         this->Put( record.Code );
+         this->Put( record.X );
+         this->Put( record.Y );
+         break;
+      case INPUT_STEP:
+         fputc( record.Keys, this->File );
+         ++this->Ticks;
+         break;
+      case INPUT_FRAME:
+         memcpy( &value, &record.Alpha, sizeof( value ) );
+         this->Put( value );
+         break;
+      case INPUT_END:
+         this->Put( record.Code );
+         for( unsigned int i = 0; i < 3; ++i ){
+            memcpy( &value, &record.Position[i], sizeof( value ) );
+            this->Put( value );
+         }
+         break;
+      default:
+         break;
+   }
+   ++this->Records;
+}
+
+void InputRecorder::WriteStep( Uint8 keys ){
+   InputRecord record;
+   record.Type = INPUT_STEP;
+   record.Keys = keys;
+   this->Write( record );
+}
+
+bool InputRecorder::Read( InputRecord &record ){
+   if( not this->IsReplaying() ){
+      return false;
+   }
+   const int type = fgetc( this->File );
+   if( type == EOF or not this->Get( record.Tick ) or not this->Get( record.Time ) ){
+      return false;
+   }
+   record.Type = type;
+   Uint32 value;
+   bool result = true;
+   switch( record.Type ){
+      case INPUT_EVENT:
+         result = this->Get( record.Event );
+         result = result and this->Get( value );
+         record.Code = value;
+         result = result and this->Get( value );
+         record.X = value;
+         result = result and this->Get( value );
+         record.Y = value;
+         break;
+      case INPUT_STEP:
+         value = fgetc( this->File );
+         result = value != Uint32( EOF );
+         record.Keys = value;
+         break;
+      case INPUT_FRAME:
+         result = this->Get( value );
+         memcpy( &record.Alpha, &value, sizeof( value ) );
+         break;
+      case INPUT_END:
+         result = this->Get( value );
+         record.Code = value;
+         for( unsigned int i = 0; i < 3 and result; ++i ){
+            result = this->Get( value );
+            memcpy( &record.Position[i], &value, sizeof( value ) );
+         }
+         break;
+      default:
+         SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "InputRecorder: unknown record %i\n", type );
+         return false;
+   }
+   if( result ){
+      ++this->Records;
+   }
+   return result;
+}
+
+unsigned int InputRecorder::ReturnRecords() const{
+   return this->Records;
+}
+
+bool InputRecorder::FromEvent( const SDL_Event &event, InputRecord &record ){
+   record.Type = INPUT_EVENT;
+   record.Event = event.type;
+   record.Code = 0;
+   record.X = 0;
+   record.Y = 0;
+   switch( event.type ){
+      case SDL_QUIT:
+         return true;
+      case SDL_MOUSEMOTION:
+         record.X = event.motion.xrel;
+         record.Y = event.motion.yrel;
+         return true;
+      case SDL_KEYDOWN:
+         record.Code = event.key.keysym.sym;
+         return true;
+      case SDL_MOUSEBUTTONDOWN:
+      case SDL_MOUSEBUTTONUP:
+         record.Code = event.button.button;
+         record.X = event.button.x;
+         record.Y = event.button.y;
+         return true;
+      case SDL_MOUSEWHEEL:
+         record.X = event.wheel.x;
+         record.Y = event.wheel.y;
+         return true;
+      case SDL_WINDOWEVENT:
+         record.Code = event.window.event;
+         record.X = event.window.data1;
+         record.Y = event.window.data2;
+         return true;
+      default:
+         return false;
+   }
+}
+
+void InputRecorder::ToEvent( const InputRecord &record, SDL_Event &event ){
+   memset( &event, 0, sizeof( event ) );
+   event.type = record.Event;
+   switch( record.Event ){
+      case SDL_MOUSEMOTION:
+         event.motion.xrel = record.X;
+         event.motion.yrel = record.Y;
+         break;
+      case SDL_KEYDOWN:
+         event.key.state = SDL_PRESSED;
+         event.key.keysym.sym = record.Code;
+         break;
+      case SDL_MOUSEBUTTONDOWN:
+      case SDL_MOUSEBUTTONUP:
+         event.button.button = record.Code;
+         event.button.state = record.Event == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+         event.button.x = record.X;
+         event.button.y = record.Y;
+         break;
+      case SDL_MOUSEWHEEL:
+         event.wheel.x = record.X;
+         event.wheel.y = record.Y;
+         break;
+      case SDL_WINDOWEVENT:
+         event.window.event = record.Code;
+         event.window.data1 = record.X;
+         event.window.data2 = record.Y;
+         break;
+      default:
+         break;
+   }
+}
+
+void InputRecorder::Put( Uint32 value ){
+   const unsigned char bytes[4] = {
+      (unsigned char)( value & 0xFF ),
+      (unsigned char)( ( value >> 8 ) & 0xFF ),
+      (unsigned char)( ( value >> 16 ) & 0xFF ),
+      (unsigned char)( ( value >> 24 ) & 0xFF )
+   };
+   fwrite( bytes, 1, sizeof( bytes ), this->File );
+}
+
+bool InputRecorder::Get( Uint32 &value ){
+   unsigned char bytes[4];
+   if( fread( bytes, 1, sizeof( bytes ), this->File ) != sizeof( bytes ) ){
+      return false;
+   }
+   value = Uint32( bytes[0] ) | ( Uint32( bytes[1] ) << 8 ) | ( Uint32( bytes[2] ) << 16 ) | ( Uint32( bytes[3] ) << 24 );
+   return true;
+}
@@ -0,0 +1,237 @@
+/*!
+   \file inputrecorder.hpp
+   \brief Plik odpowiedzialny za nagrywanie i odtwarzanie wejścia (zdarzeń, kroków symulacji i klatek).
+*/
+#ifndef inputrecorder_hpp
+#define inputrecorder_hpp
+#include <string>
+#include <cstdio>
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Wersja formatu pliku nagrania.
+*/
+#define INPUT_VERSION 1
+/*!
+   \brief Rekord: zdarzenie SDL obsłużone w \link Game::HandleEvent() \endlink.
+*/
+#define INPUT_EVENT 1
+/*!
+   \brief Rekord: krok symulacji z wciśniętymi klawiszami ruchu ( \link Game::Simulate() \endlink ).
+*/
+#define INPUT_STEP 2
+/*!
+   \brief Rekord: klatka narysowana z interpolacją między krokami ( \link Game::BuildSnapshot() \endlink ).
+*/
+#define INPUT_FRAME 3
+/*!
+   \brief Rekord: koniec nagrania z wynikiem i pozycją kamery do sprawdzenia odtworzenia.
+*/
+#define INPUT_END 4
+/*!
+   \brief Klawisz ruchu: do przodu (W, strzałka w górę).
+*/
+#define INPUT_MOVE_FORWARD 0x01
+/*!
+   \brief Klawisz ruchu: do tyłu (S, strzałka w dół).
+*/
+#define INPUT_MOVE_BACKWARD 0x02
+/*!
+   \brief Klawisz ruchu: w lewo (A, strzałka w lewo).
+*/
+#define INPUT_MOVE_LEFT 0x04
+/*!
+   \brief Klawisz ruchu: w prawo (D, strzałka w prawo).
+*/
+#define INPUT_MOVE_RIGHT 0x08
+/*!
+   \brief Klawisz ruchu: w górę (spacja).
+*/
+#define INPUT_MOVE_UP 0x10
+/*!
+   \brief Klawisz ruchu: w dół (C, lewy Ctrl).
+*/
+#define INPUT_MOVE_DOWN 0x20
+
+/*!
+   \brief Nagłówek pliku nagrania: wszystko, od czego zależy świat i symulacja poza ustawieniami.
+*/
+struct InputHeader{
+   /*!
+      \brief Ziarno generatora liczb losowych (srand).
+   */
+   Uint32 Seed;
+   /*!
+      \brief Długość kroku symulacji w milisekundach.
+   */
+   Uint32 Step;
+   /*!
+      \brief Szerokość okna.
+   */
+   Sint32 Width;
+   /*!
+      \brief Wysokość okna.
+   */
+   Sint32 Height;
+};
+
+/*!
+   \brief Pojedynczy rekord nagrania, zapisywane są tylko pola używane przez typ rekordu.
+*/
+struct InputRecord{
+   /*!
+      \brief Typ rekordu: \link INPUT_EVENT \endlink, \link INPUT_STEP \endlink, \link INPUT_FRAME \endlink lub \link INPUT_END \endlink.
+   */
+   Uint8 Type;
+   /*!
+      \brief Ilość kroków symulacji przed rekordem.
+   */
+   Uint32 Tick;
+   /*!
+      \brief Czas od początku nagrania w milisekundach.
+   */
+   Uint32 Time;
+   /*!
+      \brief INPUT_EVENT: typ zdarzenia SDL.
+   */
+   Uint32 Event;
+   /*!
+      \brief INPUT_EVENT: klawisz, przycisk myszy lub rodzaj zdarzenia okna, INPUT_END: wynik.
+   */
+   Sint32 Code;
+   /*!
+      \brief INPUT_EVENT: przesunięcie lub pozycja myszy, wielkość okna.
+   */
+   Sint32 X, Y;
+   /*!
+      \brief INPUT_STEP: wciśnięte klawisze ruchu ( INPUT_MOVE_* ).
+   */
+   Uint8 Keys;
+   /*!
+      \brief INPUT_FRAME: położenie klatki między krokami (0-1).
+   */
+   float Alpha;
+   /*!
+      \brief INPUT_END: pozycja kamery po ostatnim kroku.
+   */
+   float Position[3];
+};
+
+/*!
+   \brief Klasa odpowiedzialna za zapis i odczyt pliku nagrania.
+
+   Plik zaczyna się od "SOGI", wersji i \link InputHeader \endlink, dalej są rekordy o długości zależnej od typu
+   (9 bajtów nagłówka rekordu i od 1 do 16 bajtów danych), wszystkie liczby zapisane są w kolejności little-endian.\n
+   Zdarzenia zapisywane są w kolejności obsługi, razem z krokami symulacji i klatkami, więc odtworzenie
+   wykonuje dokładnie te same operacje niezależnie od czasu rzeczywistego.\n
+*/
+class InputRecorder{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   InputRecorder();
+   /*!
+      \brief Destruktor.
+
+      Zamyka plik ( \link Close() \endlink ).
+   */
+   ~InputRecorder();
+   /*!
+      \brief Tworzy plik nagrania i zapisuje nagłówek.
+
+      \param path - ścieżka do pliku
+      \param header - nagłówek
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create( const std::string &path, const InputHeader &header );
+   /*!
+      \brief Otwiera plik nagrania do odtworzenia i odczytuje nagłówek.
+
+      \param path - ścieżka do pliku
+      \param header - odczytany nagłówek
+      \return - wartość logiczna, FALSE = błąd lub nieznany format
+   */
+   bool Open( const std::string &path, InputHeader &header );
+   /*!
+      \brief Zamyka plik.
+   */
+   void Close();
+   /*!
+      \brief Zwraca TRUE, jeśli plik jest otwarty do zapisu.
+   */
+   bool IsRecording() const;
+   /*!
+      \brief Zwraca TRUE, jeśli plik jest otwarty do odczytu.
+   */
+   bool IsReplaying() const;
+   /*!
+      \brief Zapisuje rekord, czas i numer kroku uzupełniane są automatycznie.
+
+      \param record - rekord
+   */
+   void Write( InputRecord &record );
+   /*!
+      \brief Zapisuje krok symulacji.
+
+      \param keys - wciśnięte klawisze ruchu ( INPUT_MOVE_* )
+   */
+   void WriteStep( Uint8 keys );
+   /*!
+      \brief Odczytuje następny rekord.
+
+      \param record - odczytany rekord
+      \return - wartość logiczna, FALSE = koniec pliku lub błąd
+   */
+   bool Read( InputRecord &record );
+   /*!
+      \brief Zwraca ilość zapisanych lub odczytanych rekordów.
+   */
+   unsigned int ReturnRecords() const;
+   /*!
+      \brief Zamienia zdarzenie SDL na rekord.
+
+      \param event - zdarzenie
+      \param record - rekord \link INPUT_EVENT \endlink
+      \return - wartość logiczna, FALSE = zdarzenie nie jest nagrywane
+   */
+   static bool FromEvent( const SDL_Event &event, InputRecord &record );
+   /*!
+      \brief Zamienia rekord \link INPUT_EVENT \endlink na zdarzenie SDL.
+
+      \param record - rekord
+      \param event - zdarzenie
+   */
+   static void ToEvent( const InputRecord &record, SDL_Event &event );
+private:
+   /*!
+      \brief Zapisuje liczbę 32-bitową (little-endian).
+   */
+   void Put( Uint32 value );
+   /*!
+      \brief Odczytuje liczbę 32-bitową (little-endian).
+   */
+   bool Get( Uint32 &value );
+   /*!
+      \brief Plik nagrania, NULL = zamknięty.
+   */
+   FILE *File;
+   /*!
+      \brief TRUE = plik otwarty do zapisu.
+   */
+   bool Writing;
+   /*!
+      \brief Czas rozpoczęcia nagrania (SDL_GetTicks()).
+   */
+   Uint32 Start;
+   /*!
+      \brief Ilość zapisanych kroków symulacji.
+   */
+   Uint32 Ticks;
+   /*!
+      \brief Ilość rekordów.
+   */
+   unsigned int Records;
+};
+
+#endif
@@ -0,0 +1,206 @@
+/*!
+   \file jobsystem.cpp
+   \brief Plik źródłowy dla jobsystem.hpp.
+*/
+#include "jobsystem.hpp"
+#include "profiler.hpp"
+
+/*!
+   \brief Numer kolejki wątku, 0 = wątek spoza \link JobSystem \endlink.
+*/
+static thread_local unsigned int JobQueueIndex = 0;
+
+JobSystem::JobSystem(){
+   this->Available = NULL;
+   SDL_AtomicSet( &this->Running, 0 );
+   SDL_AtomicSet( &this->Steals, 0 );
+}
+
+JobSystem::~JobSystem(){
+   this->Destroy();
+}
+
+bool JobSystem::Create( int workers ){
+   this->Destroy();
+   if( workers < 0 ){
+      workers = SDL_GetCPUCount() - 1;
+   }
+   if( workers > JOBS_MAX_WORKERS ){
+      workers = JOBS_MAX_WORKERS;
+   }
+   if( workers <= 0 ){
+      SDL_Log( "JobSystem: no worker threads\n" );
+      return true;
+   }
+   this->Available = SDL_CreateSemaphore( 0 );
+   if( this->Available == NULL ){
+      SDL_LogError( SDL_LOG_CATEGORY_SYSTEM, "JobSystem: %s\n", SDL_GetError() );
+      return false;
+   }
+   //Never resized while threads run:
+   this->Queues.resize( workers + 1 );
+   for( unsigned int i = 0; i < this->Queues.size(); ++i ){
+      this->Queues[i].Lock = 0;
+      this->Queues[i].System = this;
+      this->Queues[i].Index = i;
+   }
+   SDL_AtomicSet( &this->Running, 1 );
+   SDL_AtomicSet( &this->Steals, 0 );
+   SDL_Thread *thread;
+   for( int i = 1; i <= workers; ++i ){
+      thread = SDL_CreateThread( JobSystem::Worker, "job", &this->Queues[i] );
+      if( thread == NULL ){
+         SDL_LogError( SDL_LOG_CATEGORY_SYSTEM, "JobSystem: SDL_CreateThread: %s\n", SDL_GetError() );
+         this->Destroy();
+         return false;
+      }
+      this->Threads.push_back( thread );
+   }
+   SDL_Log( "JobSystem: %i worker threads\n", workers );
+   return true;
+}
+
+void JobSystem::Destroy(){
+   SDL_AtomicSet( &this->Running, 0 );
+   for( unsigned int i = 0; i < this->Threads.size(); ++i ){
+      SDL_SemPost( this->Available );
+   }
+   for( unsigned int i = 0; i < this->Threads.size(); ++i ){
+      SDL_WaitThread( this->Threads[i], NULL );
+   }
+   this->Threads.clear();
+   this->Queues.clear();
+   if( this->Available != NULL ){
+      SDL_DestroySemaphore( this->Available );
+      this->Available = NULL;
+   }
+}
+
+unsigned int JobSystem::ReturnThreads() const{
+   return this->Threads.size() + 1;
+}
+
+void JobSystem::Run( JobFunction function, void *data, unsigned int begin, unsigned int end, unsigned int grain, SDL_atomic_t *counter ){
+   Job job;
+   job.Function = function;
+   job.Data = data;
+   job.Begin = begin;
+   job.End = end;
+   job.Grain = grain > 0 ? grain : end - begin;
+   job.Counter = counter;
+   SDL_AtomicIncRef( counter );
+   if( this->Threads.empty() ){
+      this->Execute( 0, job );
+      return;
+   }
+   this->Push( JobQueueIndex, job );
+}
+
+void JobSystem::Wait( SDL_atomic_t *counter ){
+   Job job;
+   while( SDL_AtomicGet( counter ) > 0 ){
+      if( this->Threads.empty() ){
+         //Jobs already executed in Run():
+         break;
+      }
+      if( this->Pop( JobQueueIndex, job ) ){
+         this->Execute( JobQueueIndex, job );
+      }
+   }
+}
+
+void JobSystem::ParallelFor( JobFunction function, void *data, unsigned int count, unsigned int grain ){
+   if( count == 0 ){
+      return;
+   }
+   if( this->Threads.empty() ){
+      function( data, 0, count );
+      return;
+   }
+   if( grain == 0 ){
+      //Few ranges per thread, enough for stealing to even out the load:
+      grain = count / ( this->ReturnThreads() * 4 );
+      if( grain == 0 ){
+         grain = 1;
+      }
+   }
+   SDL_atomic_t counter;
+   SDL_AtomicSet( &counter, 0 );
+   this->Run( function, data, 0, count, grain, &counter );
+   this->Wait( &counter );
+}
+
+unsigned int JobSystem::ReturnSteals(){
+   return SDL_AtomicGet( &this->Steals );
+}
+
+int JobSystem::Worker( void *queue ){
+   JobQueue *own = static_cast <JobQueue *>( queue );
+   JobSystem *system = own->System;
+   JobQueueIndex = own->Index;
+   Profiler::SetThreadName( "job" );
+   Job job;
+   while( SDL_AtomicGet( &system->Running ) ){
+      SDL_SemWait( system->Available );
+      while( system->Pop( own->Index, job ) ){
+         system->Execute( own->Index, job );
+      }
+   }
+   return 0;
+}
+
+void JobSystem::Push( unsigned int index, const Job &job ){
+   JobQueue &queue = this->Queues[index];
+   SDL_AtomicLock( &queue.Lock );
+   queue.Jobs.push_back( job );
+   SDL_AtomicUnlock( &queue.Lock );
+   SDL_SemPost( this->Available );
+}
+
+bool JobSystem::Pop( unsigned int index, Job &job ){
+   //Newest own job first, still in cache:
+   JobQueue &own = this->Queues[index];
+   SDL_AtomicLock( &own.Lock );
+   if( ! own.Jobs.empty() ){
+      job = own.Jobs.back();
+      own.Jobs.pop_back();
+      SDL_AtomicUnlock( &own.Lock );
+      return true;
+   }
+   SDL_AtomicUnlock( &own.Lock );
+   //Oldest job of other thread, largest remaining range:
+   const unsigned int count = this->Queues.size();
+   for( unsigned int i = 1; i < count; ++i ){
+      JobQueue &other = this->Queues[( index + i ) % count];
+      if( ! SDL_AtomicTryLock( &other.Lock ) ){
+         continue;
+      }
+      if( ! other.Jobs.empty() ){
+         job = other.Jobs.front();
+         other.Jobs.pop_front();
+         SDL_AtomicUnlock( &other.Lock );
+         SDL_AtomicIncRef( &this->Steals );
+         return true;
+      }
+      SDL_AtomicUnlock( &other.Lock );
+   }
+   return false;
+}
+
+void JobSystem::Execute( unsigned int index, Job job ){
+   Job child;
+   while( job.End - job.Begin > job.Grain ){
+      child = job;
+      child.Begin = job.Begin + ( job.End - job.Begin ) / 2;
+      job.End = child.Begin;
+      SDL_AtomicIncRef( job.Counter );
+      if( this->Threads.empty() ){
+         this->Execute( index, child );
+      }
+      else{
+         this->Push( index, child );
+      }
+   }
+   job.Function( job.Data, job.Begin, job.End );
+   SDL_AtomicAdd( job.Counter, -1 );
+}
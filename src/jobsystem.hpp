@@ -0,0 +1,198 @@
+/*!
+   \file jobsystem.hpp
+   \brief Plik odpowiedzialny za wykonywanie zadań na wielu wątkach (work stealing).
+*/
+#ifndef jobsystem_hpp
+#define jobsystem_hpp
+#include <vector>
+#include <deque>
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Maksymalna ilość wątków roboczych.
+*/
+#define JOBS_MAX_WORKERS 63
+
+/*!
+   \brief Funkcja zadania, wykonywana dla przedziału [ begin, end ).
+
+   \param data - dane przekazane do \link JobSystem::Run() \endlink
+   \param begin - początek przedziału
+   \param end - koniec przedziału (bez niego)
+*/
+typedef void (*JobFunction)( void *data, unsigned int begin, unsigned int end );
+
+/*!
+   \brief Pojedyncze zadanie w kolejce wątku.
+*/
+struct Job{
+   /*!
+      \brief Funkcja zadania.
+   */
+   JobFunction Function;
+   /*!
+      \brief Dane dla funkcji zadania.
+   */
+   void *Data;
+   /*!
+      \brief Początek przedziału.
+   */
+   unsigned int Begin;
+   /*!
+      \brief Koniec przedziału (bez niego).
+   */
+   unsigned int End;
+   /*!
+      \brief Największy przedział wykonywany bez dzielenia.
+   */
+   unsigned int Grain;
+   /*!
+      \brief Licznik niezakończonych zadań rodzica, zmniejszany po wykonaniu.
+   */
+   SDL_atomic_t *Counter;
+};
+
+class JobSystem;
+
+/*!
+   \brief Kolejka zadań jednego wątku.
+*/
+struct JobQueue{
+   /*!
+      \brief Zadania: właściciel bierze z końca, inne wątki kradną z początku.
+   */
+   std::deque <Job> Jobs;
+   /*!
+      \brief Blokada kolejki.
+   */
+   SDL_SpinLock Lock;
+   /*!
+      \brief System zadań, do którego należy kolejka.
+   */
+   JobSystem *System;
+   /*!
+      \brief Numer kolejki, 0 = wątki spoza systemu (np. główny).
+   */
+   unsigned int Index;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za wykonywanie zadań na wielu wątkach.
+
+   Każdy wątek roboczy ma własną kolejkę ( \link JobQueue \endlink ), wątki spoza systemu (główny, rysowania) używają kolejki 0.\n
+   Wątek wykonuje najpierw najnowsze zadania z własnej kolejki, a gdy jest pusta, kradnie najstarsze z kolejek innych wątków.\n
+   Zależności: każde zadanie zwiększa licznik rodzica, a po wykonaniu go zmniejsza,
+   \link Wait() \endlink wykonuje zadania do wyzerowania licznika, więc zadanie może czekać na własne zadania podrzędne.\n
+   Przedział większy niż ziarno dzielony jest na połowy, druga połowa trafia do kolejki jako zadanie podrzędne ( \link ParallelFor() \endlink ).\n
+   Bez wątków roboczych ( \link Create() \endlink nie wywołane lub 0 wątków) zadania wykonywane są od razu w wątku wywołującym.\n
+*/
+class JobSystem{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   JobSystem();
+   /*!
+      \brief Destruktor.
+
+      Zatrzymuje wątki ( \link Destroy() \endlink ).
+   */
+   ~JobSystem();
+   /*!
+      \brief Uruchamia wątki robocze.
+
+      \param workers - ilość wątków roboczych, -1 = ilość procesorów - 1
+      \return - wartość logiczna, FALSE = błąd, zadania wykonywane w wątku wywołującym
+   */
+   bool Create( int workers = -1 );
+   /*!
+      \brief Zatrzymuje wątki robocze, wcześniej należy zaczekać na wszystkie zadania.
+   */
+   void Destroy();
+   /*!
+      \brief Zwraca ilość wątków wykonujących zadania (robocze + wywołujący).
+   */
+   unsigned int ReturnThreads() const;
+   /*!
+      \brief Dodaje zadanie dla przedziału [ begin, end ).
+
+      \param function - funkcja zadania
+      \param data - dane dla funkcji
+      \param begin - początek przedziału
+      \param end - koniec przedziału (bez niego)
+      \param grain - największy przedział wykonywany bez dzielenia, 0 = bez dzielenia
+      \param counter - licznik rodzica, zwiększany teraz i zmniejszany po wykonaniu całego przedziału
+   */
+   void Run( JobFunction function, void *data, unsigned int begin, unsigned int end, unsigned int grain, SDL_atomic_t *counter );
+   /*!
+      \brief Wykonuje zadania, dopóki licznik nie spadnie do zera.
+
+      \param counter - licznik przekazany do \link Run() \endlink
+   */
+   void Wait( SDL_atomic_t *counter );
+   /*!
+      \brief Wykonuje funkcję dla przedziału [ 0, count ) na wszystkich wątkach i czeka na zakończenie.
+
+      \param function - funkcja zadania
+      \param data - dane dla funkcji
+      \param count - wielkość przedziału
+      \param grain - największy przedział wykonywany bez dzielenia, 0 = dobierany do ilości wątków
+   */
+   void ParallelFor( JobFunction function, void *data, unsigned int count, unsigned int grain = 0 );
+   /*!
+      \brief Zwraca ilość zadań skradzionych z kolejek innych wątków.
+   */
+   unsigned int ReturnSteals();
+private:
+   /*!
+      \brief Funkcja wątku roboczego.
+
+      \param queue - wskaźnik na \link JobQueue \endlink wątku
+      \return - 0
+   */
+   static int Worker( void *queue );
+   /*!
+      \brief Dodaje zadanie do kolejki i budzi jeden wątek.
+
+      \param index - numer kolejki
+      \param job - zadanie
+   */
+   void Push( unsigned int index, const Job &job );
+   /*!
+      \brief Pobiera zadanie z własnej kolejki lub kradnie z innej.
+
+      \param index - numer kolejki wątku
+      \param job - pobrane zadanie
+      \return - wartość logiczna, FALSE = brak zadań
+   */
+   bool Pop( unsigned int index, Job &job );
+   /*!
+      \brief Wykonuje zadanie, dzieląc przedział większy niż ziarno.
+
+      \param index - numer kolejki wątku
+      \param job - zadanie
+   */
+   void Execute( unsigned int index, Job job );
+   /*!
+      \brief Kolejki zadań, 0 = wątki spoza systemu.
+   */
+   std::vector <JobQueue> Queues;
+   /*!
+      \brief Wątki robocze.
+   */
+   std::vector <SDL_Thread *> Threads;
+   /*!
+      \brief Ilość zadań w kolejkach, na którą czekają wątki robocze.
+   */
+   SDL_sem *Available;
+   /*!
+      \brief 1 = wątki robocze działają.
+   */
+   SDL_atomic_t Running;
+   /*!
+      \brief Ilość skradzionych zadań.
+   */
+   SDL_atomic_t Steals;
+};
+
+#endif
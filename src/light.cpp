@@ -8,6 +8,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "objloader.hpp"
+#include "memorytracker.hpp"
 
 GLuint * Light::ModelUniformLight = NULL;
 GLuint * Light::UniformColorLight = NULL;
@@ -34,8 +35,6 @@ Light::Light( const Light &light ){
    this->VAO = light.VAO;
 
    this->Vertices = light.Vertices;
-   this->Uvs = light.Uvs;
-   this->Normals = light.Normals;
    this->Indices = light.Indices;
 
    this->VertexBuffer = light.VertexBuffer;
@@ -50,9 +49,15 @@ Light::Light( const Light &light ){
    this->Color = light.Color;
 
    this->Init = light.Init;
+
+   this->CpuMemory = 0;
+   this->UpdateMemory();
 }
 
 Light::~Light(){
+   MemoryTracker::Resize( MEMORY_MODEL, MEMORY_CPU, this->CpuMemory, 0 );
+   MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &this->VertexBuffer );
+   MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &this->IndicesBuffer );
    glDeleteBuffers( 1, &this->VertexBuffer );
    glDeleteBuffers( 1, &this->IndicesBuffer );
    glDeleteVertexArrays( 1, &this->VAO );
@@ -62,8 +67,6 @@ Light & Light::operator=( const Light &light ){
    this->VAO = light.VAO;
 
    this->Vertices = light.Vertices;
-   this->Uvs = light.Uvs;
-   this->Normals = light.Normals;
    this->Indices = light.Indices;
 
    this->VertexBuffer = light.VertexBuffer;
@@ -78,6 +81,8 @@ Light & Light::operator=( const Light &light ){
    this->Color = light.Color;
 
    this->Init = light.Init;
+
+   this->UpdateMemory();
 }
 
 void Light::SetOBJPathFile( std::string path ){
@@ -114,7 +119,8 @@ void Light::SetSpecular( glm::vec3 &in ){
 
 void Light::Load(){
    SDL_Log( "\n" );
-   this->Init = LoadAssimp( this->OBJPathFile.c_str(), this->Vertices, this->Uvs, this->Normals, this->Indices );
+   this->Init = LoadAssimp( this->OBJPathFile.c_str(), this->Vertices, this->Indices );
+   this->UpdateMemory();
    this->BindVAO();
 }
 
@@ -125,20 +131,19 @@ void Light::BindVAO(){
       glGenBuffers( 1, &this->VertexBuffer );
       glGenBuffers( 1, &this->IndicesBuffer );
 
-      //Vertex:
-      glBindBuffer( GL_ARRAY_BUFFER, this->VertexBuffer );
-      glBufferData( GL_ARRAY_BUFFER, this->Vertices.size() * sizeof( glm::vec3 ), &this->Vertices[0], GL_STATIC_DRAW );
-
       //VAO:
       glBindVertexArray( this->VAO );
 
-      //Vertex:
+      //Vertex (position only):
       glBindBuffer( GL_ARRAY_BUFFER, this->VertexBuffer );
-      glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0 );
+      BufferStaticData( GL_ARRAY_BUFFER, this->Vertices.size() * sizeof( glm::vec3 ), &this->Vertices[0] );
+      MemoryTracker::AddObject( MEMORY_MODEL, MEMORY_OBJECT_BUFFER, this->VertexBuffer, this->Vertices.size() * sizeof( glm::vec3 ) );
+      glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( glm::vec3 ), (GLvoid *)0 );
       glEnableVertexAttribArray( 0 );
       //Indicies:
       glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, this->IndicesBuffer );
-      glBufferData( GL_ELEMENT_ARRAY_BUFFER, this->Indices.size() * sizeof(GLuint), &this->Indices[0], GL_STATIC_DRAW );
+      BufferStaticData( GL_ELEMENT_ARRAY_BUFFER, this->Indices.size() * sizeof(GLuint), &this->Indices[0] );
+      MemoryTracker::AddObject( MEMORY_MODEL, MEMORY_OBJECT_BUFFER, this->IndicesBuffer, this->Indices.size() * sizeof(GLuint) );
 
       glBindVertexArray( 0 );
 
@@ -205,3 +210,9 @@ void Light::Log() const{
             this->Color.z
    );
 }
+
+void Light::UpdateMemory(){
+   const Sint64 bytes = this->Vertices.capacity() * sizeof( glm::vec3 ) + this->Indices.capacity() * sizeof( GLuint );
+   MemoryTracker::Resize( MEMORY_MODEL, MEMORY_CPU, this->CpuMemory, bytes );
+   this->CpuMemory = bytes;
+}
@@ -8,6 +8,25 @@
 #include <vector>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Światło punktowe rysowane jako bryła światła (deferred shading, \link DeferredRenderer \endlink ), atrybuty instancji.
+*/
+struct PointLightData{
+   /*!
+      \brief Pozycja (xyz) i promień zasięgu (w) światła.
+   */
+   glm::vec4 PositionRadius;
+   /*!
+      \brief Kolor (rgb) światła.
+   */
+   glm::vec4 Color;
+   /*!
+      \brief Tłumienie światła: x = stałe, y = liniowe, z = kwadratowe.
+   */
+   glm::vec4 Attenuation;
+};
 
 /*!
    \brief Klasa odpowiedzialna za zarządzaniem obiektem oświetlenia.
@@ -161,6 +180,10 @@ public:
    */
    static GLuint * UniformColorLight;
 private:
+   /*!
+      \brief Zgłasza zmianę pamięci CPU wierzchołków i indeksów ( \link MemoryTracker \endlink ).
+   */
+   void UpdateMemory();
    //VAO:
    /*!
       \brief Identyfikator VAO (Vertex Array Object).
@@ -168,17 +191,9 @@ private:
    GLuint VAO;
    //Data file:
    /*!
-      \brief Wektor Wierzchołków.
+      \brief Wektor pozycji Wierzchołków (shader światła korzysta tylko z pozycji).
    */
    std::vector <glm::vec3> Vertices;
-   /*!
-      \brief Wektor UV Map.
-   */
-   std::vector <glm::vec2> Uvs;
-   /*!
-      \brief Wektor Normalnych.
-   */
-   std::vector <glm::vec3> Normals;
    /*!
       \brief Wektor Indeksów Wierzchołków.
    */
@@ -225,6 +240,11 @@ private:
       \brief Poprawność zainicjalizowanych wszystkich elementów. FALSE = Błąd.
    */
    bool Init = false;
+   //Memory:
+   /*!
+      \brief Pamięć CPU zgłoszona do \link MemoryTracker \endlink w bajtach.
+   */
+   Sint64 CpuMemory = 0;
 };
 
 #endif
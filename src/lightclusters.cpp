@@ -0,0 +1,315 @@
+/*!
+   \file lightclusters.cpp
+   \brief Plik źródłowy dla lightclusters.hpp.
+*/
+#include "lightclusters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <SDL2/SDL.h>
+#include "memorytracker.hpp"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#include <xmmintrin.h>
+#define LIGHTCLUSTERS_SSE
+#endif
+
+LightClusters::LightClusters(){
+   this->Projection = glm::mat4( 0.0f );
+   this->Near = 0.1f;
+   this->Far = 100.0f;
+   this->SliceScale = 0.0f;
+   this->SliceBias = 0.0f;
+   this->Visible = 0;
+   this->Overflow = 0;
+   this->MaxIndices = CLUSTER_MAX_INDICES;
+   for( unsigned int i = 0; i < 3; ++i ){
+      this->Buffers[i] = 0;
+      this->Textures[i] = 0;
+   }
+}
+
+LightClusters::~LightClusters(){
+   this->Destroy();
+}
+
+bool LightClusters::Create(){
+   this->Destroy();
+   GLint max_texels = 0;
+   glGetIntegerv( GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels );
+   this->MaxIndices = std::min( (GLuint)std::max( max_texels, 65536 ), (GLuint)CLUSTER_MAX_INDICES );
+   const GLsizeiptr sizes[3] = {
+      GLsizeiptr( CLUSTER_X * CLUSTER_Y * CLUSTER_Z * 2 * sizeof( GLuint ) ),
+      GLsizeiptr( this->MaxIndices * sizeof( GLuint ) ),
+      GLsizeiptr( CLUSTER_MAX_LIGHTS * sizeof( PointLightData ) )
+   };
+   const GLenum formats[3] = { GL_RG32UI, GL_R32UI, GL_RGBA32F };
+   glGenBuffers( 3, this->Buffers );
+   glGenTextures( 3, this->Textures );
+   for( unsigned int i = 0; i < 3; ++i ){
+      glBindBuffer( GL_TEXTURE_BUFFER, this->Buffers[i] );
+      glBufferData( GL_TEXTURE_BUFFER, sizes[i], NULL, GL_STREAM_DRAW );
+      MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_BUFFER, this->Buffers[i], sizes[i] );
+      glBindTexture( GL_TEXTURE_BUFFER, this->Textures[i] );
+      glTexBuffer( GL_TEXTURE_BUFFER, formats[i], this->Buffers[i] );
+   }
+   glBindTexture( GL_TEXTURE_BUFFER, 0 );
+   glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+   if( glGetError() != GL_NO_ERROR ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "LightClusters: can't create texture buffers\n" );
+      this->Destroy();
+      return false;
+   }
+   return true;
+}
+
+void LightClusters::Destroy(){
+   if( this->Textures[0] != 0 ){
+      glDeleteTextures( 3, this->Textures );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 3, this->Buffers );
+      glDeleteBuffers( 3, this->Buffers );
+   }
+   for( unsigned int i = 0; i < 3; ++i ){
+      this->Buffers[i] = 0;
+      this->Textures[i] = 0;
+   }
+}
+
+bool LightClusters::IsCreated() const{
+   return this->Textures[0] != 0;
+}
+
+void LightClusters::Bin( const glm::mat4 &view, const glm::mat4 &projection, const std::vector <PointLightData> &lights ){
+   if( projection != this->Projection ){
+      this->SetProjection( projection );
+   }
+   this->TransformLights( view, lights );
+   this->Pairs.clear();
+   this->Visible = 0;
+   this->Overflow = 0;
+   const GLuint count = std::min( (GLuint)lights.size(), (GLuint)CLUSTER_MAX_LIGHTS );
+   float depth, radius;
+   int first, last;
+   bool visible;
+   for( GLuint light = 0; light < count; ++light ){
+      depth = -this->ViewLights[2][light];
+      radius = this->ViewLights[3][light];
+      if( depth + radius < this->Near or depth - radius > this->Far ){
+         continue;
+      }
+      first = depth - radius <= this->Near ? 0 : int( std::log( depth - radius ) * this->SliceScale + this->SliceBias );
+      last = int( std::log( depth + radius ) * this->SliceScale + this->SliceBias );
+      first = std::max( first, 0 );
+      last = std::min( last, CLUSTER_Z - 1 );
+      visible = false;
+      for( int slice = first; slice <= last; ++slice ){
+         if( this->BinSlice( slice, light ) ){
+            visible = true;
+         }
+      }
+      if( visible ){
+         ++this->Visible;
+      }
+   }
+
+   //Counting sort by cluster, Grid[ cluster * 2 ] = end of cluster, then filled backwards to the beginning:
+   const unsigned int clusters = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+   this->Grid.assign( clusters * 2, 0 );
+   std::vector <GLuint>::const_iterator it;
+   for( it = this->Pairs.begin(); it != this->Pairs.end(); ++it ){
+      ++this->Grid[( *it / CLUSTER_MAX_LIGHTS ) * 2 + 1];
+   }
+   GLuint offset = 0;
+   for( unsigned int cluster = 0; cluster < clusters; ++cluster ){
+      offset += this->Grid[cluster * 2 + 1];
+      this->Grid[cluster * 2] = offset;
+   }
+   this->Indices.resize( this->Pairs.size() );
+   std::vector <GLuint>::const_reverse_iterator rit;
+   for( rit = this->Pairs.rbegin(); rit != this->Pairs.rend(); ++rit ){
+      this->Indices[--this->Grid[( *rit / CLUSTER_MAX_LIGHTS ) * 2]] = *rit % CLUSTER_MAX_LIGHTS;
+   }
+}
+
+void LightClusters::Upload( const std::vector <PointLightData> &lights ){
+   if( this->Buffers[0] == 0 or this->Grid.empty() ){
+      return;
+   }
+   const GLsizeiptr sizes[3] = {
+      GLsizeiptr( CLUSTER_X * CLUSTER_Y * CLUSTER_Z * 2 * sizeof( GLuint ) ),
+      GLsizeiptr( this->MaxIndices * sizeof( GLuint ) ),
+      GLsizeiptr( CLUSTER_MAX_LIGHTS * sizeof( PointLightData ) )
+   };
+   const GLsizeiptr used[3] = {
+      GLsizeiptr( this->Grid.size() * sizeof( GLuint ) ),
+      GLsizeiptr( this->Indices.size() * sizeof( GLuint ) ),
+      GLsizeiptr( std::min( lights.size(), (size_t)CLUSTER_MAX_LIGHTS ) * sizeof( PointLightData ) )
+   };
+   const void *data[3] = {
+      &this->Grid[0],
+      this->Indices.empty() ? NULL : &this->Indices[0],
+      lights.empty() ? NULL : &lights[0]
+   };
+   for( unsigned int i = 0; i < 3; ++i ){
+      glBindBuffer( GL_TEXTURE_BUFFER, this->Buffers[i] );
+      //Orphan previous frame, GPU may still read it:
+      glBufferData( GL_TEXTURE_BUFFER, sizes[i], NULL, GL_STREAM_DRAW );
+      if( used[i] > 0 ){
+         glBufferSubData( GL_TEXTURE_BUFFER, 0, used[i], data[i] );
+      }
+   }
+   glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+}
+
+void LightClusters::Bind() const{
+   for( unsigned int i = 0; i < 3; ++i ){
+      glActiveTexture( GL_TEXTURE0 + CLUSTER_TEXTURE_UNIT + i );
+      glBindTexture( GL_TEXTURE_BUFFER, this->Textures[i] );
+   }
+   glActiveTexture( GL_TEXTURE0 );
+}
+
+glm::vec4 LightClusters::ReturnParameters( GLsizei width, GLsizei height ) const{
+   return glm::vec4( float( CLUSTER_X ) / float( width ), float( CLUSTER_Y ) / float( height ), this->SliceScale, this->SliceBias );
+}
+
+const std::vector <GLuint> & LightClusters::ReturnGrid() const{
+   return this->Grid;
+}
+
+const std::vector <GLuint> & LightClusters::ReturnIndices() const{
+   return this->Indices;
+}
+
+unsigned int LightClusters::ReturnVisible() const{
+   return this->Visible;
+}
+
+unsigned int LightClusters::ReturnOverflow() const{
+   return this->Overflow;
+}
+
+void LightClusters::SetProjection( const glm::mat4 &projection ){
+   this->Projection = projection;
+   //glm::perspective: [2][2] = -( far + near ) / ( far - near ), [3][2] = -2 * far * near / ( far - near ):
+   this->Near = projection[3][2] / ( projection[2][2] - 1.0f );
+   this->Far = projection[3][2] / ( projection[2][2] + 1.0f );
+   this->SliceScale = float( CLUSTER_Z ) / std::log( this->Far / this->Near );
+   this->SliceBias = -std::log( this->Near ) * this->SliceScale;
+   const unsigned int clusters = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+   for( unsigned int i = 0; i < 6; ++i ){
+      this->Bounds[i].resize( clusters );
+   }
+   //View space x = ndc * depth / projection[0][0], tile edges are planes through the camera:
+   float depth0, depth1, x0, x1, y0, y1;
+   unsigned int cluster;
+   for( unsigned int slice = 0; slice < CLUSTER_Z; ++slice ){
+      depth0 = this->Near * std::pow( this->Far / this->Near, float( slice ) / CLUSTER_Z );
+      depth1 = this->Near * std::pow( this->Far / this->Near, float( slice + 1 ) / CLUSTER_Z );
+      for( unsigned int row = 0; row < CLUSTER_Y; ++row ){
+         y0 = ( -1.0f + 2.0f * row / CLUSTER_Y ) / projection[1][1];
+         y1 = ( -1.0f + 2.0f * ( row + 1 ) / CLUSTER_Y ) / projection[1][1];
+         for( unsigned int column = 0; column < CLUSTER_X; ++column ){
+            x0 = ( -1.0f + 2.0f * column / CLUSTER_X ) / projection[0][0];
+            x1 = ( -1.0f + 2.0f * ( column + 1 ) / CLUSTER_X ) / projection[0][0];
+            cluster = ( slice * CLUSTER_Y + row ) * CLUSTER_X + column;
+            this->Bounds[0][cluster] = std::min( x0 * depth0, x0 * depth1 );
+            this->Bounds[1][cluster] = std::min( y0 * depth0, y0 * depth1 );
+            this->Bounds[2][cluster] = -depth1;
+            this->Bounds[3][cluster] = std::max( x1 * depth0, x1 * depth1 );
+            this->Bounds[4][cluster] = std::max( y1 * depth0, y1 * depth1 );
+            this->Bounds[5][cluster] = -depth0;
+         }
+      }
+   }
+}
+
+void LightClusters::TransformLights( const glm::mat4 &view, const std::vector <PointLightData> &lights ){
+   const unsigned int count = std::min( (unsigned int)lights.size(), (unsigned int)CLUSTER_MAX_LIGHTS );
+   for( unsigned int i = 0; i < 4; ++i ){
+      this->ViewLights[i].resize( count );
+   }
+   unsigned int light = 0;
+#ifdef LIGHTCLUSTERS_SSE
+   //4 lights: transpose PositionRadius to x, y, z, radius:
+   __m128 x, y, z, radius;
+   const __m128 m[12] = {
+      _mm_set1_ps( view[0][0] ), _mm_set1_ps( view[1][0] ), _mm_set1_ps( view[2][0] ),
+      _mm_set1_ps( view[0][1] ), _mm_set1_ps( view[1][1] ), _mm_set1_ps( view[2][1] ),
+      _mm_set1_ps( view[0][2] ), _mm_set1_ps( view[1][2] ), _mm_set1_ps( view[2][2] ),
+      _mm_set1_ps( view[3][0] ), _mm_set1_ps( view[3][1] ), _mm_set1_ps( view[3][2] )
+   };
+   for( ; light + 4 <= count; light += 4 ){
+      x = _mm_loadu_ps( &lights[light].PositionRadius.x );
+      y = _mm_loadu_ps( &lights[light + 1].PositionRadius.x );
+      z = _mm_loadu_ps( &lights[light + 2].PositionRadius.x );
+      radius = _mm_loadu_ps( &lights[light + 3].PositionRadius.x );
+      _MM_TRANSPOSE4_PS( x, y, z, radius );
+      _mm_storeu_ps( &this->ViewLights[0][light], _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[0], x ), _mm_mul_ps( m[1], y ) ), _mm_add_ps( _mm_mul_ps( m[2], z ), m[9] ) ) );
+      _mm_storeu_ps( &this->ViewLights[1][light], _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[3], x ), _mm_mul_ps( m[4], y ) ), _mm_add_ps( _mm_mul_ps( m[5], z ), m[10] ) ) );
+      _mm_storeu_ps( &this->ViewLights[2][light], _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[6], x ), _mm_mul_ps( m[7], y ) ), _mm_add_ps( _mm_mul_ps( m[8], z ), m[11] ) ) );
+      _mm_storeu_ps( &this->ViewLights[3][light], radius );
+   }
+#endif
+   glm::vec4 position;
+   for( ; light < count; ++light ){
+      position = view * glm::vec4( glm::vec3( lights[light].PositionRadius ), 1.0f );
+      this->ViewLights[0][light] = position.x;
+      this->ViewLights[1][light] = position.y;
+      this->ViewLights[2][light] = position.z;
+      this->ViewLights[3][light] = lights[light].PositionRadius.w;
+   }
+}
+
+bool LightClusters::BinSlice( unsigned int slice, GLuint light ){
+   const unsigned int first = slice * CLUSTER_X * CLUSTER_Y;
+   const unsigned int last = first + CLUSTER_X * CLUSTER_Y;
+   const float *bounds[6];
+   for( unsigned int i = 0; i < 6; ++i ){
+      bounds[i] = &this->Bounds[i][0];
+   }
+   bool found = false;
+   unsigned int cluster = first;
+#ifdef LIGHTCLUSTERS_SSE
+   //Squared distance from sphere center to 4 boxes:
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 x = _mm_set1_ps( this->ViewLights[0][light] );
+   const __m128 y = _mm_set1_ps( this->ViewLights[1][light] );
+   const __m128 z = _mm_set1_ps( this->ViewLights[2][light] );
+   const __m128 radius = _mm_set1_ps( this->ViewLights[3][light] * this->ViewLights[3][light] );
+   __m128 dx, dy, dz;
+   int mask;
+   for( ; cluster + 4 <= last; cluster += 4 ){
+      dx = _mm_max_ps( _mm_max_ps( _mm_sub_ps( _mm_loadu_ps( bounds[0] + cluster ), x ), _mm_sub_ps( x, _mm_loadu_ps( bounds[3] + cluster ) ) ), zero );
+      dy = _mm_max_ps( _mm_max_ps( _mm_sub_ps( _mm_loadu_ps( bounds[1] + cluster ), y ), _mm_sub_ps( y, _mm_loadu_ps( bounds[4] + cluster ) ) ), zero );
+      dz = _mm_max_ps( _mm_max_ps( _mm_sub_ps( _mm_loadu_ps( bounds[2] + cluster ), z ), _mm_sub_ps( z, _mm_loadu_ps( bounds[5] + cluster ) ) ), zero );
+      mask = _mm_movemask_ps( _mm_cmple_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) ), radius ) );
+      for( unsigned int i = 0; mask != 0; ++i, mask >>= 1 ){
+         if( ( mask & 1 ) == 0 ){
+            continue;
+         }
+         found = true;
+         if( this->Pairs.size() >= this->MaxIndices ){
+            ++this->Overflow;
+            continue;
+         }
+         this->Pairs.push_back( ( cluster + i ) * CLUSTER_MAX_LIGHTS + light );
+      }
+   }
+#endif
+   float dx_, dy_, dz_;
+   for( ; cluster < last; ++cluster ){
+      dx_ = std::max( std::max( bounds[0][cluster] - this->ViewLights[0][light], this->ViewLights[0][light] - bounds[3][cluster] ), 0.0f );
+      dy_ = std::max( std::max( bounds[1][cluster] - this->ViewLights[1][light], this->ViewLights[1][light] - bounds[4][cluster] ), 0.0f );
+      dz_ = std::max( std::max( bounds[2][cluster] - this->ViewLights[2][light], this->ViewLights[2][light] - bounds[5][cluster] ), 0.0f );
+      if( dx_ * dx_ + dy_ * dy_ + dz_ * dz_ > this->ViewLights[3][light] * this->ViewLights[3][light] ){
+         continue;
+      }
+      found = true;
+      if( this->Pairs.size() >= this->MaxIndices ){
+         ++this->Overflow;
+         continue;
+      }
+      this->Pairs.push_back( cluster * CLUSTER_MAX_LIGHTS + light );
+   }
+   return found;
+}
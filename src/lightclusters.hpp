@@ -0,0 +1,208 @@
+/*!
+   \file lightclusters.hpp
+   \brief Plik odpowiedzialny za podział widoku kamery na klastry i przypisanie do nich świateł punktowych (clustered forward).
+*/
+#ifndef lightclusters_hpp
+#define lightclusters_hpp
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "light.hpp"
+
+/*!
+   \brief Ilość klastrów w poziomie ekranu.
+*/
+#define CLUSTER_X 16
+/*!
+   \brief Ilość klastrów w pionie ekranu.
+*/
+#define CLUSTER_Y 9
+/*!
+   \brief Ilość warstw klastrów w głąb widoku (podział logarytmiczny).
+*/
+#define CLUSTER_Z 24
+/*!
+   \brief Maksymalna ilość świateł wysyłanych do GPU.
+*/
+#define CLUSTER_MAX_LIGHTS 4096
+/*!
+   \brief Maksymalna ilość indeksów świateł we wszystkich klastrach, ograniczana przez GL_MAX_TEXTURE_BUFFER_SIZE ( \link LightClusters::Create() \endlink ).
+*/
+#define CLUSTER_MAX_INDICES 1048576
+/*!
+   \brief Pierwsza jednostka tekstur dla buforów klastrów (kolejno: klastry, indeksy, światła).
+*/
+#define CLUSTER_TEXTURE_UNIT 4
+
+/*!
+   \brief Klasa odpowiedzialna za przypisanie świateł punktowych do klastrów widoku.
+
+   Ostrosłup widzenia dzielony jest na \link CLUSTER_X \endlink x \link CLUSTER_Y \endlink x \link CLUSTER_Z \endlink klastrów,
+   warstwy w głąb rosną logarytmicznie od bliskiej do dalekiej płaszczyzny projekcji.\n
+   \link Bin() \endlink działa tylko na CPU (bez OpenGL): przelicza światła do przestrzeni widoku po 4 naraz (SSE)
+   i testuje kulę zasięgu światła z prostopadłościanami otaczającymi 4 klastry naraz.\n
+   \link Upload() \endlink wysyła wynik do buforów tekstur (GL_TEXTURE_BUFFER):\n
+   <ul>
+   <li>klastry: przesunięcie i ilość indeksów (RG32UI)</li>
+   <li>indeksy świateł (R32UI)</li>
+   <li>światła: \link PointLightData \endlink, 3 teksele na światło (RGBA32F)</li>
+   </ul>
+   Shader.frag wybiera klaster fragmentu z gl_FragCoord i głębokości w przestrzeni widoku ( \link ReturnParameters() \endlink ).\n
+*/
+class LightClusters{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   LightClusters();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia bufory ( \link Destroy() \endlink ).
+   */
+   ~LightClusters();
+   /*!
+      \brief Tworzy bufory tekstur.
+
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create();
+   /*!
+      \brief Zwalnia bufory tekstur.
+   */
+   void Destroy();
+   /*!
+      \brief Zwraca TRUE, jeśli bufory tekstur zostały utworzone.
+   */
+   bool IsCreated() const;
+   /*!
+      \brief Przypisuje światła do klastrów.
+
+      \param view - macierz widoku
+      \param projection - macierz projekcji perspektywicznej
+      \param lights - światła punktowe (pozycja w przestrzeni świata)
+
+      Nie wywołuje funkcji OpenGL.
+   */
+   void Bin( const glm::mat4 &view, const glm::mat4 &projection, const std::vector <PointLightData> &lights );
+   /*!
+      \brief Wysyła klastry, indeksy i światła do buforów tekstur.
+
+      \param lights - światła punktowe przekazane do \link Bin() \endlink
+   */
+   void Upload( const std::vector <PointLightData> &lights );
+   /*!
+      \brief Przypina bufory tekstur do jednostek od \link CLUSTER_TEXTURE_UNIT \endlink.
+
+      Po powrocie aktywna jest jednostka GL_TEXTURE0.
+   */
+   void Bind() const;
+   /*!
+      \brief Zwraca parametry dla shadera.
+
+      \param width - szerokość obrazu
+      \param height - wysokość obrazu
+      \return - x, y = ilość klastrów na piksel, z, w = skala i przesunięcie warstwy: log( głębokość ) * z + w
+   */
+   glm::vec4 ReturnParameters( GLsizei width, GLsizei height ) const;
+   /*!
+      \brief Zwraca przesunięcie i ilość indeksów każdego klastra: [ klaster * 2 ], [ klaster * 2 + 1 ].
+   */
+   const std::vector <GLuint> & ReturnGrid() const;
+   /*!
+      \brief Zwraca indeksy świateł wszystkich klastrów.
+   */
+   const std::vector <GLuint> & ReturnIndices() const;
+   /*!
+      \brief Zwraca ilość świateł w widoku (przypisanych do co najmniej jednego klastra).
+   */
+   unsigned int ReturnVisible() const;
+   /*!
+      \brief Zwraca ilość pominiętych przypisań po przekroczeniu \link MaxIndices \endlink.
+   */
+   unsigned int ReturnOverflow() const;
+private:
+   /*!
+      \brief Liczy prostopadłościany otaczające klastry w przestrzeni widoku dla nowej macierzy projekcji.
+
+      \param projection - macierz projekcji perspektywicznej
+   */
+   void SetProjection( const glm::mat4 &projection );
+   /*!
+      \brief Przelicza pozycje świateł do przestrzeni widoku.
+
+      \param view - macierz widoku
+      \param lights - światła punktowe
+   */
+   void TransformLights( const glm::mat4 &view, const std::vector <PointLightData> &lights );
+   /*!
+      \brief Testuje światło z klastrami jednej warstwy i zapisuje przypisania.
+
+      \param slice - numer warstwy
+      \param light - indeks światła
+      \return - wartość logiczna, TRUE = światło przypisane do co najmniej jednego klastra
+   */
+   bool BinSlice( unsigned int slice, GLuint light );
+   /*!
+      \brief Macierz projekcji, dla której policzone są klastry.
+   */
+   glm::mat4 Projection;
+   /*!
+      \brief Odległość bliskiej płaszczyzny projekcji.
+   */
+   float Near;
+   /*!
+      \brief Odległość dalekiej płaszczyzny projekcji.
+   */
+   float Far;
+   /*!
+      \brief Skala warstwy: \link CLUSTER_Z \endlink / log( \link Far \endlink / \link Near \endlink ).
+   */
+   float SliceScale;
+   /*!
+      \brief Przesunięcie warstwy: -log( \link Near \endlink ) * \link SliceScale \endlink.
+   */
+   float SliceBias;
+   /*!
+      \brief Prostopadłościany klastrów w przestrzeni widoku (SoA): minimum x, y, z i maksimum x, y, z, klaster = ( warstwa * \link CLUSTER_Y \endlink + wiersz ) * \link CLUSTER_X \endlink + kolumna.
+   */
+   std::vector <float> Bounds[6];
+   /*!
+      \brief Pozycje świateł w przestrzeni widoku (SoA): x, y, z, promień.
+   */
+   std::vector <float> ViewLights[4];
+   /*!
+      \brief Przypisania: klaster * \link CLUSTER_MAX_LIGHTS \endlink + światło, sortowane przez zliczanie.
+   */
+   std::vector <GLuint> Pairs;
+   /*!
+      \brief Przesunięcie i ilość indeksów każdego klastra.
+   */
+   std::vector <GLuint> Grid;
+   /*!
+      \brief Indeksy świateł wszystkich klastrów.
+   */
+   std::vector <GLuint> Indices;
+   /*!
+      \brief Ilość świateł w widoku.
+   */
+   unsigned int Visible;
+   /*!
+      \brief Ilość pominiętych przypisań.
+   */
+   unsigned int Overflow;
+   /*!
+      \brief Maksymalna ilość indeksów świateł we wszystkich klastrach.
+   */
+   GLuint MaxIndices;
+   /*!
+      \brief Bufory: klastry, indeksy, światła.
+   */
+   GLuint Buffers[3];
+   /*!
+      \brief Tekstury buforów: klastry, indeksy, światła.
+   */
+   GLuint Textures[3];
+};
+
+#endif
@@ -10,9 +10,14 @@
 */
 #include <iostream>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
+#include <cmath>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <map>
+#include <atomic>
 //OpenGL:
 
 #define GLEW_STATIC
@@ -42,6 +47,26 @@
 #include "camera.hpp"
 #include "model.hpp"
 #include "light.hpp"
+#include "worldgrid.hpp"
+#include "occlusion.hpp"
+#include "renderqueue.hpp"
+#include "ringbuffer.hpp"
+#include "staticbatch.hpp"
+#include "impostor.hpp"
+#include "headless.hpp"
+#include "golden.hpp"
+#include "gputimer.hpp"
+#include "deferred.hpp"
+#include "lightclusters.hpp"
+#include "shadowmap.hpp"
+#include "snapshotbuffer.hpp"
+#include "jobsystem.hpp"
+#include "framepacer.hpp"
+#include "profiler.hpp"
+#include "hud.hpp"
+#include "inputrecorder.hpp"
+#include "benchmark.hpp"
+#include "memorytracker.hpp"
 
 using namespace std;
 
@@ -56,6 +81,99 @@ void CaughtSignal( int signal );
    #define Max_Point_Light 1
 #endif
 
+/*!
+   \brief Punkt wiązania bloku uniformów FrameData we wszystkich shaderach.
+*/
+#define FRAME_DATA_BINDING 0
+
+/*!
+   \brief Domyślna długość kroku symulacji w milisekundach ( \link Game::Simulate() \endlink ).
+*/
+#define SIMULATION_STEP 10
+/*!
+   \brief Maksymalna ilość kroków symulacji na klatkę, pozostały czas jest pomijany.
+*/
+#define SIMULATION_MAX_STEPS 8
+
+/*!
+   \brief Domyślna wielkość świata, równa wielkości modelu trawy ( \link Game::MapMax \endlink ).
+*/
+#define MAP_SIZE 30
+/*!
+   \brief Domyślna gęstość obiektów: część pól mapy zajęta przez drzewa i kamienie ( \link Game::MapDensity \endlink ).
+*/
+#define MAP_DENSITY 0.125f
+
+/*!
+   \brief Fragment pomiaru czasu ( \link Game::Timers \endlink ): cała klatka.
+*/
+#define TIMER_FRAME 0
+/*!
+   \brief Fragment pomiaru czasu: przebieg głębokości ( \link Game::DrawDepthPrePass() \endlink ).
+*/
+#define TIMER_DEPTH 1
+/*!
+   \brief Fragment pomiaru czasu: oświetlenie odroczone ( \link DeferredRenderer::Shade() \endlink ).
+*/
+#define TIMER_DEFERRED 2
+/*!
+   \brief Fragment pomiaru czasu: przypisanie świateł do klastrów i wysłanie ich do GPU ( \link Game::UpdateClusters() \endlink ).
+*/
+#define TIMER_CLUSTERS 3
+/*!
+   \brief Fragment pomiaru czasu: mapy cieni ( \link Game::DrawShadows() \endlink ).
+*/
+#define TIMER_SHADOWS 4
+/*!
+   \brief Fragment pomiaru czasu: pierwszy przebieg rysowania, numer fragmentu = TIMER_PASS + RENDER_PASS_*.
+*/
+#define TIMER_PASS 5
+
+/*!
+   \brief Dane zmieniające się co klatkę, blok uniformów FrameData (układ std140).
+
+   Zapisywane do \link Game::FrameRing \endlink, wspólne dla wszystkich shaderów.\n
+   Wektory vec3 zapisane są jako vec4 (wyrównanie std140).\n
+*/
+struct FrameData{
+   /*!
+      \brief Macierz widoku.
+   */
+   mat4 View;
+   /*!
+      \brief Macierz projekcji.
+   */
+   mat4 Projection;
+   /*!
+      \brief Pozycja kamery.
+   */
+   vec4 ViewPos;
+   /*!
+      \brief Pozycja głównego oświetlenia.
+   */
+   vec4 SunPosition;
+   /*!
+      \brief Główne oświetlenie (Ambient).
+   */
+   vec4 SunAmbient;
+   /*!
+      \brief Główne oświetlenie (Diffuse).
+   */
+   vec4 SunDiffuse;
+   /*!
+      \brief Główne oświetlenie (Specular).
+   */
+   vec4 SunSpecular;
+   /*!
+      \brief Pozycje oświetlenia punktowego.
+   */
+   vec4 PointPosition[Max_Point_Light];
+   /*!
+      \brief Współczynniki oświetlenia punktowego: x = stały, y = liniowy, z = kwadratowy.
+   */
+   vec4 PointAttenuation[Max_Point_Light];
+};
+
 /*!
    \brief Główna klasa, w której gromadzone są wszystkich informacje potrzebne do uruchomienia gry.
 */
@@ -76,15 +194,20 @@ public:
       Tworzy okno ( \link InitWindow() \endlink  ),
       kontekst dla OpenGL 3.3 ( \link InitContent() \endlink )
       oraz tworzy ikonkę dla okna ( \link SetIcon() \endlink ).\n
+      W trybie headless ( \link ParseArguments() \endlink ) okno nie jest tworzone,
+      a kontekst OpenGL i bufor ramki tworzy \link HeadlessContext \endlink.\n
+
+      \param argc - ilość argumentów linii poleceń
+      \param argv - argumenty linii poleceń
    */
-   Game();
+   Game( int argc, char *argv[] );
    /*!
    \brief Czyści zaalokowaną pamięć.
 
    <b>Więcej:</b>\n
    Usuwa niepotrzebnie zaalokowaną pamięć po shaderach, wskaźnikach.\n
    Deaktywuje aktywne biblioteki.\n
-   Zapisuje ustawienia do plik settings.init.\n
+   Zapisuje ustawienia do plik settings.init (poza trybem headless).\n
    */
    ~Game();
    /*!
@@ -93,7 +216,7 @@ public:
       <b>Więcej:</b>\n
       Wczytuje i tworzy shadery ( \link InitShaders() \endlink ).\n
       Wczytuje pliki .obj (obiekty 3D), tekstury dla obiektów oraz tworzy losowy świat( \link LoadData() \endlink ).\n
-      Uruchamia grę ( \link Loop() \endlink ).\n
+      Uruchamia grę ( \link Loop() \endlink lub \link LoopHeadless() \endlink ).\n
    */
    void Start();
    /*!
@@ -103,6 +226,13 @@ public:
       Gra zostanie zatrzymana po zakończeniu rysowania pojedyńczej sceny (jedna klatka).\n
    */
    void Stop();
+   /*!
+      \brief Zwraca kod wyjścia aplikacji.
+
+      <b>Więcej:</b>\n
+      0 = sukces, 1 = obrazy różnią się od wzorcowych ( \link RunGolden() \endlink ).\n
+   */
+   int ReturnResult() const;
 private:
    //Init:
    /*!
@@ -112,6 +242,40 @@ private:
       Wczytywanie ustawień z pliku settings.init w przeciwnym przypadku ustalenie domyślnych.\n
    */
    void LoadSettings();
+   /*!
+      \brief Zapamiętuje wartość ustawienia przed jednorazową zmianą (linia poleceń, nagranie).
+
+      \param key - klucz w settings.init
+      \param value - wartość z settings.init lub domyślna
+
+      Do settings.init zapisywana jest zapamiętana wartość ( \link ReturnSetting() \endlink ), nie zmieniona.
+   */
+   void KeepSetting( const string &key, int value );
+   /*!
+      \brief Zwraca wartość ustawienia do zapisania w settings.init.
+
+      \param key - klucz w settings.init
+      \param value - aktualna wartość
+      \return - wartość zapamiętana przez \link KeepSetting() \endlink lub \p value
+   */
+   int ReturnSetting( const string &key, int value ) const;
+   /*!
+      \brief Odczytanie argumentów linii poleceń.
+
+      <b>Więcej:</b>\n
+      Argumenty nadpisują ustawienia z pliku settings.init:\n
+      <ul>
+      <li>--headless - rysowanie bez okna ( \link Headless \endlink )</li>
+      <li>--frames N - ilość klatek w trybie headless</li>
+      <li>--width N, --height N - wielkość obrazu</li>
+      <li>--golden DIR - porównanie scen z obrazami wzorcowymi z katalogu DIR ( \link RunGolden() \endlink ), włącza tryb headless</li>
+      <li>--golden-update - zapisanie obrazów i czasów wzorcowych zamiast porównania</li>
+      </ul>
+
+      \param argc - ilość argumentów linii poleceń
+      \param argv - argumenty linii poleceń
+   */
+   void ParseArguments( int argc, char *argv[] );
    /*!
       \brief Załadowanie biblioteki SDL2.
 
@@ -175,14 +339,40 @@ private:
       \brief Losowanie nowej pozycji dla monety.
 
       <b>Więcej:</b>\n
-      Losowanie nowej pozycji dla monety.\n
+      Losowanie nowej pozycji dla monety, tylko w \link Simulate() \endlink.\n
+      Zmienia \link Map \endlink, \link CoinX \endlink, \link CoinZ \endlink i \link Score \endlink,
+      \link Grid \endlink i macierz monety zmienia \link MoveCoin() \endlink podczas rysowania.\n
    */
    inline void RandNewCoin();
+   /*!
+      \brief Przeniesienie narysowanej monety na pole z \link FrameSnapshot \endlink.
+
+      \param x - pozycja x monety na mapie
+      \param z - pozycja z monety na mapie
+
+      <b>Więcej:</b>\n
+      Wywoływane tylko w \link Render() \endlink, zmienia \link Grid \endlink i macierz modelu monety.\n
+   */
+   inline void MoveCoin( int x, int z );
+   /*!
+      \brief Unieważnia dane zależne od nieruchomych obiektów po zmianie mapy.
+
+      \param x - pozycja x na mapie
+      \param z - pozycja z na mapie
+      \param model - numer modelu dodanego lub usuniętego obiektu
+
+      <b>Więcej:</b>\n
+      Wywoływać po każdym \link WorldGrid::Insert() \endlink lub \link WorldGrid::Remove() \endlink obiektu.\n
+      Dla drzew i kamieni oznacza blok do przebudowy ( \link StaticBatch::Invalidate() \endlink ) i rysuje ponownie
+      statyczną mapę cieni ( \link ShadowMap::Invalidate() \endlink ), dla pozostałych modeli nie robi nic.
+   */
+   void InvalidateStatic( int x, int z, GLuint model );
    /*!
       \brief Sprawdzenie czy w pobliżu znajdują się monety.
 
       <b>Więcej:</b>\n
-      prawdzenie czy w pobliżu znajdują się monety i wylosowania nowej pozycji w przypadku znalezienia.\n
+      Sprawdzenie czy w pobliżu pozycji kamery po kroku symulacji znajduje się moneta i wylosowanie nowej pozycji w przypadku znalezienia.\n
+      Wywoływane w \link Simulate() \endlink po wciśnięciu E lub lewego przycisku myszy ( \link CollectCoin \endlink ).\n
    */
    inline void CheckCoin();
    //Min/Max resolution:
@@ -282,336 +472,988 @@ private:
       \brief Skupienie się na oknie, czy myszka jest w okno. FALSE = okno jest nie aktywne.
    */
    bool Focus = true;
-   //Timer:
    /*!
-      \brief Czas uruchomienia aplikacji potrzebny do przeliczania \link FPS \endlink ( czas przed rysowaniem ).
+      \brief Rysowanie bez okna do bufora ramki o wielkości \link WindowWidth \endlink x \link WindowHeight \endlink, po \link HeadlessFrames \endlink klatkach gra jest kończona.
    */
-   Uint32 TimerBegin = 0;
+   bool Headless = false;
    /*!
-      \brief Czas uruchomienia aplikacji potrzebny do przeliczania \link FPS \endlink ( czas po rysowaniu ).
+      \brief Ilość klatek rysowanych w trybie headless.
    */
-   Uint32 TimerEnd = 0;
+   unsigned int HeadlessFrames = HEADLESS_FRAMES;
    /*!
-      \brief Czas uruchomienia aplikacji potrzebny do aktualizacji obiektów.
+      \brief Kontekst OpenGL i bufor ramki w trybie headless.
    */
-   Uint32 TimerUpdate = 0;
+   HeadlessContext HeadlessGL;
    /*!
-      \brief Różnica czasu, po jakiej jednostce czasu ma nastąpić aktualizacja obiektów, domyślnie.
+      \brief Katalog obrazów wzorcowych, pusty = brak porównania.
    */
-   Uint32 TimerUpdateTime = 50;
+   string GoldenDirectory;
    /*!
-      \brief Liczba klatek na sekundę.
+      \brief TRUE = zapisanie nowych obrazów i czasów wzorcowych.
    */
-   int FPS = 0;
-   //Game:
+   bool GoldenUpdate = false;
    /*!
-      \brief Obsługa zdarzeń.
-
-      <b>Więcej:</b>\n
-      Obługa myszy, klawiatury, zdarzeń okna.
+      \brief Ziarno generatora liczb losowych (srand), z \link RandomSeed \endlink = czas uruchomienia.
    */
-   inline void Loop();
+   unsigned int Seed = 0;
    /*!
-      \brief Rysowanie wszystkich obiektów świata.
-
-      <b>Więcej:</b>\n
-      Przekazanie wszystkich wartości do shaderów.\n
-      Rysowanie wszystkich obiektów świata.\n
-      Aktualizacja obiektów i FPS.\n
+      \brief TRUE = ziarno z czasu uruchomienia, FALSE = podane (--seed) lub z nagrania.
    */
-   inline void Update();
+   bool RandomSeed = true;
    /*!
-      \brief Wyjście z gry. FALSE = koniec gry.
+      \brief Plik nagrania wejścia (--record), pusty = bez nagrywania.
    */
-   bool Exit = true;
+   string RecordPath;
    /*!
-      \brief Typ zdarzenia (SDL2).
+      \brief Plik odtwarzanego nagrania (--replay), pusty = wejście z SDL.
    */
-   SDL_Event Event;
+   string ReplayPath;
    /*!
-      \brief Wielkość świata liczony według kwadratu 1.0f x 1.0f ( w szerokości i długości ).
+      \brief Nagrywanie i odtwarzanie wejścia.
    */
-   const int MapMax = 30;
+   InputRecorder Recorder;
    /*!
-      \brief Połowa wielkości świata.
+      \brief Tymczasowy rekord nagrania.
    */
-   const int MapMaxHalf = MapMax / 2;
+   InputRecord Record;
    /*!
-      \brief Wektor obiektów w świecie/mapa świata.
+      \brief Klawisze ruchu wciśnięte w aktualnej klatce ( INPUT_MOVE_* ), używane przez \link Simulate() \endlink.
    */
-   vector < vector <int> > Map;
+   Uint8 MoveKeys = 0;
    /*!
-      \brief Wektor dla identyfikatora obiektu w świecie.
+      \brief Plik zapisu pomiarów ( \link Profiler::Save() \endlink ) przy wyjściu, pusty = zapis tylko klawiszem P do \link PROFILER_FILE \endlink.
    */
-   vector < vector <int> > MapIndex;
+   string ProfilePath;
    /*!
-      \brief Ilość zebranych monet podczas gry.
+      \brief Plik raportu trybu benchmark (--benchmark), pusty = bez trybu benchmark.
    */
-   int Score = 0;
-   //Other:
+   string BenchmarkPath;
    /*!
-      \brief Identyfikator dla pliku setting.init.
+      \brief Ilość mierzonych klatek trybu benchmark (--frames).
    */
-   fstream SettingsFile;
+   unsigned int BenchmarkFrames = BENCHMARK_FRAMES;
    /*!
-      \var i
-      \brief Tymczasowe zmienna dla pętli for.
+      \brief Pomiary trybu benchmark.
    */
+   Benchmark Bench;
    /*!
-      \var j
-      \brief Tymczasowe zmienna dla pętli for.
+      \brief Obracanie monety i ruch drugiego światła. FALSE = każda klatka sceny jest taka sama.
    */
-   int i,j;
+   bool Animation = true;
    /*!
-      \brief Kod błędu dla OpenGL.
+      \brief Kod wyjścia aplikacji ( \link ReturnResult() \endlink ).
    */
-   GLenum GL_Error;
+   int Result = 0;
+   //Timer:
    /*!
-      \brief Kod błędu dla DevIL.
+      \brief Czas uruchomienia aplikacji potrzebny do przeliczania \link FPS \endlink ( czas przed rysowaniem ).
    */
-   ILenum IL_Error;
-   //Camera:
+   Uint32 TimerBegin = 0;
    /*!
-      \brief Aktualne poruszenie myszki, różnica pomiędzy poprzednią, a aktualną pozycją myszki.
+      \brief Czas uruchomienia aplikacji potrzebny do przeliczania \link FPS \endlink ( czas po rysowaniu ).
    */
-   vec2 Mouse;
+   Uint32 TimerEnd = 0;
+   //Simulation:
    /*!
-      \brief Aktualne poruszenie dla kółka myszki (góra/dół), różnica pomiędzy poprzednią, a aktualną pozycją kółka myszki.
+      \brief Długość kroku symulacji w milisekundach, domyślnie \link SIMULATION_STEP \endlink.
    */
-   vec1 MouseWheel;
+   int SimulationStep = SIMULATION_STEP;
    /*!
-      \brief Kamera, miejsce z którego będzie przetwarzana cała scena OpenGL.
+      \brief Ilość kroków symulacji od ostatniego wypisania FPS.
    */
-   Camera camera;
-   //For change settings camera:
+   unsigned int SimulationSteps = 0;
    /*!
-      \brief Współczynnik szerokości do wysokości, obliczany jako szerokość/wysokość.
+      \brief Ilość pominiętych kroków symulacji (powyżej \link SIMULATION_MAX_STEPS \endlink na klatkę) od ostatniego wypisania FPS.
    */
-   vec1 Aspect;
+   unsigned int SimulationDropped = 0;
    /*!
-      \brief Kąt widzenia dla kamery, wyrażony w stopniach.
+      \brief Czas symulacji od ostatniego wypisania FPS (w jednostkach SDL_GetPerformanceCounter()).
    */
-   vec1 VOF;
+   Uint64 SimulationTime = 0;
    /*!
-      \brief Odległość od jakiej rysowane są obiekty.
+      \brief Suma opóźnień od odczytu wejścia do zamiany buforów od ostatniego wypisania FPS (w jednostkach SDL_GetPerformanceCounter()).
    */
-   vec1 Near;
+   Uint64 Latency = 0;
+   //Frame pacing:
    /*!
-      \brief Odległość do jakiej rysowane są obiekty.
+      \brief Tryb wyświetlania: \link PRESENT_UNCAPPED \endlink, \link PRESENT_VSYNC \endlink lub \link PRESENT_ADAPTIVE \endlink.
    */
-   vec1 Far;
-   //Shaders:
+   int PresentMode = PRESENT_VSYNC;
    /*!
-      \brief Identyfikator głównego shadera.
+      \brief Ograniczenie ilości klatek na sekundę, 0 = bez ograniczenia.
    */
-   GLuint ProgramID = 0;
-   //Uniforms:
+   int FrameLimit = 0;
    /*!
-      \brief Uniform dla macierzy modelu.
+      \brief Ograniczenie ilości klatek i pomiar równomierności klatek.
    */
-   GLuint ModelUniformId = 0;
+   FramePacer Pacer;
+   //Jobs:
    /*!
-      \brief Uniform dla macierzy widoku.
+      \brief Wątki wykonujące zadania (wczytywanie modeli, zmiany macierzy modeli).
    */
-   GLuint ViewUniformId = 0;
+   JobSystem Jobs;
    /*!
-      \brief Uniform dla macierzy projekcji.
+      \brief Ilość wątków roboczych \link Jobs \endlink, -1 = ilość procesorów - 1, 0 = bez wątków.
    */
-   GLuint ProjectionUniformId = 0;
+   int JobWorkers = -1;
+   //Render thread:
    /*!
-      \brief Uniform dla tekstury głównej obiektu.
+      \brief Rysowanie w osobnym wątku, równolegle z symulacją. TRUE = włączone (tylko z oknem).
    */
-   GLuint TextureUniformId = 0;
+   bool Threaded = false;
    /*!
-      \brief Uniform dla tekstury spektralnej obiektu.
+      \brief Stany klatek przekazywane do rysowania.
    */
-   GLuint TextureSpecularUniformId = 0;
+   SnapshotBuffer Snapshots;
    /*!
-      \brief Uniform dla materiału obiektu (Ambient).
+      \brief Pozycja kamery w rysowanej klatce.
    */
-   GLuint AmbientUniformId = 0;
+   vec3 ViewPosition;
    /*!
-      \brief Uniform dla materiału obiektu (Diffuse).
+      \brief Odległość, do jakiej rysowane są obiekty w rysowanej klatce.
    */
-   GLuint DiffuseUniformId = 0;
+   GLfloat ViewFar = 0.0f;
    /*!
-      \brief Uniform dla materiału obiektu (Specular).
+      \brief Liczba klatek na sekundę.
    */
-   GLuint SpecularUniformId = 0;
+   int FPS = 0;
+   //Culling:
    /*!
-      \brief Uniform dla materiału obiektu (jakość odbicia).
+      \brief Bryła widzenia kamery dla aktualnej klatki.
    */
-   GLuint ShininessUniformId = 0;
-   //Directional Light:
+   Frustum ViewFrustum;
    /*!
-      \brief Uniform dla głównego oświetlenia (pozycja).
+      \brief Ilość widocznych obiektów w ostatniej klatce (bez zasłoniętych), przy \link StaticBatching \endlink nieruchome obiekty liczone są jako połączone siatki.
    */
-   GLuint LightPositionUniformId = 0;
+   unsigned int FrameVisible = 0;
    /*!
-      \brief Uniform dla głównego oświetlenia (Ambient).
+      \brief Ilość odrzuconych obiektów (poza bryłą widzenia) w ostatniej klatce, przy \link StaticBatching \endlink nieruchome obiekty liczone są jako połączone siatki.
    */
-   GLuint LightAmbientUniformId = 0;
+   unsigned int FrameCulled = 0;
    /*!
-      \brief Uniform dla głównego oświetlenia (Diffuse).
+      \brief Programowe odrzucanie obiektów zasłoniętych przez drzewa i kamienie.
    */
-   GLuint LightDiffuseUniformId = 0;
+   OcclusionCuller Occlusion;
    /*!
-      \brief Uniform dla głównego oświetlenia (Specular).
+      \brief Odrzucanie zasłoniętych obiektów. TRUE = włączone.
    */
-   GLuint LightSpecularUniformId = 0;
-   //Camera Position:
+   bool OcclusionCulling = true;
    /*!
-      \brief Uniform dla pozycji kamery.
+      \brief Odległość od kamery, w jakiej szukane są obiekty zasłaniające.
    */
-   GLuint ViewPosUniformId = 0;
-   //Point Light:
+   GLfloat OcclusionDistance = 10.0f;
    /*!
-      \brief Uniform dla oświetlenia punktowego (pozycja).
+      \brief Maksymalna ilość obiektów zasłaniających (najbliższych kamerze).
    */
-   GLuint PointLight_Position_Uniform[Max_Point_Light];
+   unsigned int OcclusionMaxOccluders = 16;
    /*!
-      \brief Uniform dla oświetlenia punktowego (współczynnik stały).
+      \brief Obiekty zasłaniające posortowane według odległości od kamery ( odległość, numer w \link GridItems \endlink ).
    */
-   GLuint PointLight_Constant_Uniform[Max_Point_Light];
+   vector < pair <GLfloat, unsigned int> > Occluders;
    /*!
-      \brief Uniform dla oświetlenia punktowego (współczynnik liniowy).
+      \brief Ilość zasłoniętych obiektów w ostatniej klatce (w bryle widzenia, nie wliczane do \link FrameCulled \endlink).
    */
-   GLuint PointLight_Linear_Uniform[Max_Point_Light];
+   unsigned int FrameOccluded = 0;
+   //Static batching:
    /*!
-      \brief Uniform dla oświetlenia punktowego (współczynnik kwadratowy).
+      \brief Połączone siatki nieruchomych drzew i kamieni.
    */
-   GLuint PointLight_Quadratic_Uniform[Max_Point_Light];
-
-   //second for drawing light object:
+   StaticBatch StaticWorld;
    /*!
-      \brief Identyfikator shadera do rysowania światła.
+      \brief Rysowanie nieruchomych obiektów z połączonych siatek. TRUE = włączone.
    */
-   GLuint LightID = 0;
-   //Uniforms:
+   bool StaticBatching = true;
    /*!
-      \brief Uniform dla macierzy widoku dla światła.
+      \brief Ilość widocznych połączonych siatek w ostatniej klatce.
    */
-   GLuint ViewUniformLight = 0;
+   unsigned int FrameBatches = 0;
+   //Impostors:
    /*!
-      \brief Uniform dla macierzy projekcji dla światła.
+      \brief Impostory odległych drzew i kamieni.
    */
-   GLuint ProjectionUniformLight = 0;
+   Impostor Impostors;
    /*!
-      \brief Uniform dla macierzy modelu dla światła.
+      \brief Rysowanie odległych obiektów jako impostory. TRUE = włączone.
    */
-   GLuint ModelUniformLight = 0;
+   bool ImpostorRendering = true;
    /*!
-      \brief Uniform dla koloru obiektu światła.
+      \brief Odległość od kamery, od której obiekty rysowane są jako impostory.
    */
-   GLuint UniformColorLight = 0;
-   //Matrix:
+   GLfloat ImpostorDistance = IMPOSTOR_DISTANCE;
    /*!
-      \brief Macierz projekcji.
+      \brief Ilość impostorów w ostatniej klatce.
    */
-   mat4 ProjectionMatrix;
+   unsigned int FrameImpostors = 0;
+   //Render queue:
    /*!
-      \brief Macierz widoku.
+      \brief Kolejka rysowania wszystkich widocznych obiektów.
    */
-   mat4 ViewMatrix;
-   //Models:
+   RenderQueue Queue;
    /*!
-      \brief Wektor wszystkich obiektów świata.
+      \brief Tymczasowe polecenie rysowania.
    */
-   vector <Model> Models;
+   RenderCommand Command;
    /*!
-      \brief Iterator dla wektora wszystkich obiektów świata.
+      \brief Ilość zmian stanu OpenGL (shader, tekstura, VAO) w ostatniej klatce.
    */
-   vector <Model>::iterator It;
-   //Light:
+   unsigned int FrameStateChanges = 0;
    /*!
-      \brief Główne światło, słońce.
+      \brief Ilość poleceń rysowania w ostatniej klatce (bez \link Overlay \endlink).
    */
-   Light Sun;
+   unsigned int FrameDrawCalls = 0;
    /*!
-      \brief Drugie światło, poruszające się po okręgu.
+      \brief Ilość trójkątów w ostatniej klatce (bez świateł i \link Overlay \endlink).
    */
-   Light SunMoving;
+   unsigned int FrameTriangles = 0;
    /*!
-      \brief Początkowa pozycja światła poruszające się po okręgu.
+      \brief Czas sortowania kolejki rysowania w ostatniej klatce (w milisekundach).
    */
-   vec3 SunMovingPosition = vec3( 0.0f, 15.0f, 0.0f );
+   float FrameSortTime = 0.0f;
+   //Depth pre-pass:
    /*!
-      \brief Kąt w stopniach pomiędzy początkową a końcową/docelową pozycją oświetlenia.
+      \brief Przebieg wstępny zapisujący tylko głębokość. TRUE = włączony.
+
+      Główny przebieg rysuje wtedy tylko widoczne fragmenty ( GL_EQUAL, bez zapisu głębokości ).
    */
-   GLfloat SunMovingDegreese = 0.0f;
+   bool DepthPrePass = false;
    /*!
-      \brief Kąt w radianach pomiędzy początkową a końcową/docelową pozycją oświetlenia.
+      \brief Licznik przerysowań (ilość cieniowanych fragmentów na piksel). TRUE = włączony.
    */
-   GLfloat SunMovingRadian = 0.0f;
+   bool OverdrawCounter = false;
    /*!
-      \brief Promień okręgu po jakim porusza się oświetlenie.
+      \brief Zapytanie OpenGL ( GL_SAMPLES_PASSED ) dla licznika przerysowań.
    */
-   GLfloat SunMovingRadius = 15.0f;
-   //tmp:
+   GLuint OverdrawQuery = 0;
    /*!
-      \brief Tymczasowy wektor typu vec3.
+      \brief Oczekiwanie na wynik \link OverdrawQuery \endlink. TRUE = wynik jeszcze niedostępny.
    */
-   vec3 tmp_vector;
+   bool OverdrawQueryPending = false;
    /*!
-      \brief Tymczasowy float typu GLfloat.
+      \brief Ilość próbek na piksel (multisampling).
    */
-   GLfloat tmp_float;
+   GLint Samples = 1;
    /*!
-      \brief Wektor rotacji dla monety.
+      \brief Średnia ilość cieniowanych fragmentów na piksel z ostatniego wyniku \link OverdrawQuery \endlink.
    */
-   vec3 RotateVec = vec3( 0.0f, 1.0f, 0.0f );
+   GLfloat FrameOverdraw = 0.0f;
+   //Game:
    /*!
-      \brief Ilość stopni dla rotacji monety.
+      \brief Obsługa zdarzeń.
+
+      <b>Więcej:</b>\n
+      Obługa myszy, klawiatury, zdarzeń okna.\n
+      Czas od poprzedniej klatki jest dzielony na kroki symulacji o długości \link SimulationStep \endlink ( \link Simulate() \endlink ),
+      najwyżej \link SIMULATION_MAX_STEPS \endlink na klatkę, reszta kroku przekazywana jest do \link BuildSnapshot() \endlink.\n
+      Z \link Threaded \endlink stan klatki oddawany jest wątkowi rysowania ( \link RenderLoop() \endlink ),
+      który ma kontekst OpenGL, w przeciwnym przypadku rysowany od razu ( \link Render() \endlink ).\n
+      Z --record zdarzenia, kroki symulacji i klatki zapisywane są do \link Recorder \endlink ( \link LoopReplay() \endlink ).\n
    */
-   GLfloat RotateFloat = 5;
+   inline void Loop();
    /*!
-      \var tmp_x
-      \brief Tymczasowe zmienne typu int.
+      \brief Rysowanie bez okna i obsługi zdarzeń.
+
+      <b>Więcej:</b>\n
+      Rysuje \link HeadlessFrames \endlink klatek z kamerą poruszającą się po stałej ścieżce ( \link SetHeadlessCamera() \endlink ),
+      a następnie wypisuje całkowity i średni czas klatki.\n
    */
+   void LoopHeadless();
    /*!
-      \var tmp_y
-      \brief Tymczasowe zmienne typu int.
+      \brief Odtwarzanie nagrania wejścia ( \link Recorder \endlink ) tak szybko, jak to możliwe.
+
+      <b>Więcej:</b>\n
+      Zdarzenia, kroki symulacji i klatki wykonywane są w nagranej kolejności, bez zależności od czasu rzeczywistego,
+      a na końcu wynik i pozycja kamery porównywane są z nagranymi.\n
+      Działa z oknem (bez synchronizacji pionowej) i w trybie headless.\n
    */
+   void LoopReplay();
    /*!
-      \var tmp_z
-      \brief Tymczasowe zmienne typu int.
+      \brief Obsługa zdarzenia SDL wątku głównego: kamera, okno, zdarzenia przekazywane do \link Render() \endlink.
+
+      \param event - zdarzenie z SDL_PollEvent() lub z nagrania
    */
-   int tmp_x, tmp_y, tmp_z;
-};
+   void HandleEvent( const SDL_Event &event );
+   /*!
+      \brief Zwraca wciśnięte klawisze ruchu ( INPUT_MOVE_* ), bez okna 0.
+   */
+   Uint8 ReturnMoveKeys() const;
+   /*!
+      \brief Zapisuje koniec nagrania: wynik i pozycję kamery.
+   */
+   void WriteRecordEnd();
+   /*!
+      \brief Ustawienie kamery na stałej ścieżce trybu headless.
 
-/*!
-   \brief Wskaźnik na klasę typu \link Game \endlink służący to zatrzymania rozgrywki po otrzymaniu kodu przerwania aplikacji.
-*/
-Game * PointerGame = NULL;
-/*!
-   \brief Zatrzymanie gry przy pomocy wskaźnika \link PointerGame \endlink.
-*/
-void GlobalStop();
+      <b>Więcej:</b>\n
+      Kamera okrąża środek mapy, patrząc na niego.\n
 
-/*!
-   \brief Główna funkcja uruchamiająca całą aplikację.
-*/
-int main( int argc, char* argv[] ){
-   #ifdef SIGTSTP
-   signal( SIGTSTP, CaughtSignal );
-   #endif
-   signal( SIGINT, CaughtSignal );
-   Game game;
-   PointerGame = &game;
-   game.Start();
-   PointerGame = NULL;
-   return 0;
-}
+      \param frame - numer klatki
+   */
+   inline void SetHeadlessCamera( unsigned int frame );
+   /*!
+      \brief Porównanie scen z obrazami wzorcowymi.
 
-void CaughtSignal( int signal ){
-   #ifdef SIGTSTP
-   //Linux:
-   //CTRL+Z
-   if( signal == SIGTSTP ){
-      cout<<"\n\nCaught signal SIGTSTP\n\n";
-      GlobalStop();
-   }
-   //CTRL+C
+      <b>Więcej:</b>\n
+      Świat tworzony jest z ziarnem \link GOLDEN_SEED \endlink, a animacje są zatrzymane.\n
+      Dla każdej stałej pozycji kamery rysowana jest klatka rozgrzewająca i \link GOLDEN_FRAMES \endlink mierzonych klatek.\n
+      Ostatnia klatka jest porównywana z DIR/sceneN.png ( \link GoldenImage::Compare() \endlink ),
+      przy różnicy zapisywane są DIR/sceneN_actual.png i DIR/sceneN_diff.png.\n
+      Średni czas klatki porównywany jest z czasem zapisanym w DIR/timing.txt.\n
+      Z --golden-update obrazy i czasy są zapisywane jako nowe wzorce, a opcje rysowania ( \link ReturnGoldenOptions() \endlink )
+      do DIR/\link GOLDEN_OPTIONS_FILE \endlink, wzorce zapisane z innymi opcjami nie są porównywane.\n
+      Obrazy wzorcowe nie są częścią repozytorium (zależą od sterownika i karty), przed pierwszym porównaniem należy je utworzyć z --golden-update.\n
+   */
+   void RunGolden();
+   /*!
+      \brief Ustala stałe opcje rysowania dla porównania z obrazami wzorcowymi.
+
+      <b>Więcej:</b>\n
+      Opcje z settings.init i argumentów (rozdzielczość, mapa, forward/deferred, klastry, cienie, impostory, łączenie obiektów,
+      odrzucanie zasłoniętych obiektów, światła) są zastępowane domyślnymi, dzięki czemu każdy komputer rysuje tę samą ścieżkę.\n
+   */
+   void SetGoldenOptions();
+   /*!
+      \brief Zwraca opcje rysowania w jednym wierszu ( klucz wartość ... ), zapisywane z obrazami wzorcowymi.
+   */
+   string ReturnGoldenOptions() const;
+   /*!
+      \brief Przelot kamery po stałej ścieżce z pomiarem klatek i zapisem raportu do \link BenchmarkPath \endlink.
+
+      <b>Więcej:</b>\n
+      Świat tworzony jest z ziarnem \link GOLDEN_SEED \endlink (lub z --seed), o wielkości --map i gęstości --density.\n
+      Kamera przelatuje po ścieżce \link Benchmark::ReturnPath() \endlink, po \link BENCHMARK_WARMUP \endlink klatkach
+      przez \link BenchmarkFrames \endlink klatek mierzony jest czas klatki, czas CPU i GPU, polecenia rysowania, trójkąty i pamięć GPU.\n
+      Działa z oknem (bez synchronizacji pionowej i ograniczenia klatek) i w trybie headless.\n
+   */
+   void RunBenchmark();
+   /*!
+      \brief Zakończenie klatki: zamiana buforów okna lub \link HeadlessContext::Present() \endlink.
+
+      <b>Więcej:</b>\n
+      Z oknem przed zamianą buforów czeka do terminu klatki ( \link FramePacer::Wait() \endlink ).\n
+   */
+   inline void Present();
+   /*!
+      \brief Ustalenie synchronizacji pionowej ( \link PresentMode \endlink ) i ograniczenia klatek ( \link FrameLimit \endlink ).
+
+      <b>Więcej:</b>\n
+      Bez obsługi adaptacyjnej synchronizacji pionowej używana jest zwykła.\n
+   */
+   void SetPresentMode();
+   /*!
+      \brief Rysowanie \link Overlay \endlink: czas klatki, CPU i GPU, polecenia rysowania, trójkąty, pamięć, wykres i statystyki odrzucania.
+   */
+   void DrawHud();
+   /*!
+      \brief Odczyt pamięci GPU do \link HudMemory \endlink (GL_NVX_gpu_memory_info lub GL_ATI_meminfo).
+   */
+   void UpdateHudMemory();
+   /*!
+      \brief Zwraca pamięć CPU \link Map \endlink i \link MapIndex \endlink w bajtach ( \link MemoryTracker \endlink ).
+   */
+   Sint64 ReturnMapMemory() const;
+   /*!
+      \brief Ustawienie wskaźników uniformów klasy \link Model \endlink na główny shader lub shader G-bufora.
+
+      \param gbuffer - TRUE = shader G-bufora ( \link Deferred \endlink )
+   */
+   inline void SetModelUniforms( bool gbuffer );
+   /*!
+      \brief Oświetlenie odroczone: aktualizacja \link PointLights \endlink i \link DeferredRenderer::Shade() \endlink.
+   */
+   inline void ShadeDeferred();
+   /*!
+      \brief Aktualizacja \link PointLights \endlink, 0 = \link SunMoving \endlink.
+   */
+   inline void UpdatePointLights();
+   /*!
+      \brief Włącza lub wyłącza światła z klastrów w głównym shaderze, przypisuje światła do klastrów i wysyła je do GPU.
+   */
+   inline void UpdateClusters();
+   /*!
+      \brief Jeden krok symulacji o stałej długości.
+
+      <b>Więcej:</b>\n
+      Zapamiętuje poprzedni stan (kamera, kąt monety, kąt drugiego światła) dla \link Render() \endlink.\n
+      Porusza kamerę według stanu klawiatury, zbiera monetę ( \link CollectCoin \endlink ), obraca monetę i przesuwa drugie światło.\n
+      Wynik zależy tylko od ilości kroków, nie od ilości klatek.\n
+
+      \param dt - długość kroku w sekundach
+   */
+   inline void Simulate( GLfloat dt );
+   /*!
+      \brief Zapisanie stanu klatki dla \link Render() \endlink.
+
+      <b>Więcej:</b>\n
+      Kamera, moneta i drugie światło ustawiane są pomiędzy dwoma ostatnimi krokami symulacji, pole monety i wynik po ostatnim kroku.\n
+      Ilość kroków i czasy ustawia wywołujący, domyślnie 0 i chwila wywołania.\n
+
+      \param snapshot - zapisywany stan klatki
+      \param alpha - część kroku symulacji, która upłynęła od ostatniego kroku (0 - 1)
+   */
+   inline void BuildSnapshot( FrameSnapshot &snapshot, GLfloat alpha );
+   /*!
+      \brief Funkcja wątku rysowania ( \link Threaded \endlink ).
+
+      \param game - wskaźnik na \link Game \endlink
+      \return - 0
+   */
+   static int RenderThread( void *game );
+   /*!
+      \brief Zadanie wczytania plików .obj i .mtl modeli ( \link Model::Load_OBJ() \endlink ).
+
+      \param models - wskaźnik na \link Models \endlink
+      \param begin - pierwszy model
+      \param end - koniec przedziału modeli
+   */
+   static void LoadModelJob( void *models, unsigned int begin, unsigned int end );
+   /*!
+      \brief Pętla wątku rysowania: przejęcie kontekstu OpenGL i rysowanie kolejnych stanów z \link Snapshots \endlink.
+
+      <b>Więcej:</b>\n
+      Stan symulacji ( \link Map \endlink, \link Score \endlink, kamera, \link CoinX \endlink ) zna tylko ze stanu klatki,
+      zmienia wyłącznie stan rysowania ( \link Grid \endlink, macierze modeli, przełączniki) i \link Exit \endlink.\n
+   */
+   void RenderLoop();
+   /*!
+      \brief Obsługa zdarzeń zmieniających rysowanie lub świat (przełączniki F*, zbieranie monet, wielkość okna).
+
+      \param event - zdarzenie przekazane w stanie klatki
+   */
+   void HandleRenderEvent( const SDL_Event &event );
+   /*!
+      \brief Rysowanie wszystkich obiektów świata.
+
+      <b>Więcej:</b>\n
+      Obsługa zdarzeń ze stanu klatki ( \link HandleRenderEvent() \endlink ).\n
+      Ustawienie kamery, monety, wyniku i drugiego światła ze stanu klatki ( \link BuildSnapshot() \endlink ).\n
+      Przekazanie wszystkich wartości do shaderów.\n
+      Rysowanie wszystkich obiektów świata.\n
+      Aktualizacja FPS i opóźnienia od odczytu wejścia.\n
+
+      \param snapshot - stan klatki, nie jest zmieniany
+   */
+   inline void Render( const FrameSnapshot &snapshot );
+   /*!
+      \brief Odrzucanie obiektów zasłoniętych.
+
+      <b>Więcej:</b>\n
+      Rysuje najbliższe kamerze drzewa i kamienie do programowego bufora głębokości ( \link Occlusion \endlink ),
+      a następnie usuwa zasłonięte obiekty z list widocznych obiektów modeli umieszczonych na mapie.\n
+   */
+   inline void CullOccluded();
+   /*!
+      \brief Wypełnienie i sortowanie kolejki rysowania.
+
+      <b>Więcej:</b>\n
+      Dodaje do \link Queue \endlink wszystkie widoczne obiekty modeli oraz oba światła, a następnie sortuje kolejkę.\n
+   */
+   inline void FillQueue();
+   /*!
+      \brief Rysowanie obiektów z kolejki rysowania.
+
+      <b>Więcej:</b>\n
+      Zmienia shader, teksturę i VAO tylko wtedy, gdy różnią się od poprzedniego polecenia.\n
+   */
+   inline void DrawQueue();
+   /*!
+      \brief Przebieg wstępny zapisujący tylko głębokość.
+
+      <b>Więcej:</b>\n
+      Rysuje wszystkie nieprzezroczyste obiekty z kolejki rysowania shaderem głębokości ( \link DepthID \endlink ), bez zapisu koloru.\n
+   */
+   inline void DrawDepthPrePass();
+   /*!
+      \brief Rysuje mapy cieni i ustawia uniformy cieni głównego shadera.
+
+      <b>Więcej:</b>\n
+      Drzewa i kamienie rysowane są do mapy głównego światła tylko po jej unieważnieniu,
+      co klatkę kopia tej mapy uzupełniana jest o monety ( \link Shadow \endlink ).\n
+      Mapa sześcienna drugiego światła rysowana jest co \link PointShadowRate \endlink klatek.\n
+   */
+   inline void DrawShadows();
+   /*!
+      \brief Rysuje obiekty rzucające cień shaderem głębokości ( \link DepthID \endlink ).
+
+      \param static_models - TRUE = drzewa i kamienie
+      \param dynamic_models - TRUE = obiekty ruchome (monety)
+   */
+   inline void DrawShadowCasters( bool static_models, bool dynamic_models );
+   /*!
+      \brief Ustala stan bufora głębokości i licznika przerysowań dla przebiegu rysowania.
+
+      \param pass - przebieg rysowania ( \link RENDER_PASS_OPAQUE \endlink, \link RENDER_PASS_IMPOSTOR \endlink lub \link RENDER_PASS_LIGHT \endlink )
+   */
+   inline void BeginPass( GLuint pass );
+   /*!
+      \brief Ustawia blok uniformów FrameData na punkt wiązania \link FRAME_DATA_BINDING \endlink.
+
+      \param program - identyfikator shadera
+      \return - wartość logiczna, FALSE = shader nie posiada bloku FrameData
+   */
+   bool BindFrameData( GLuint program );
+   /*!
+      \brief Zapisuje dane klatki ( \link FrameData \endlink ) do \link FrameRing \endlink i wiąże je z punktem \link FRAME_DATA_BINDING \endlink.
+
+      \param view - macierz widoku (kamera lub światło)
+      \param projection - macierz projekcji (kamera lub światło)
+   */
+   inline void UploadFrameData( const mat4 &view, const mat4 &projection );
+   /*!
+      \brief Wyjście z gry. FALSE = koniec gry.
+
+      <b>Więcej:</b>\n
+      Zapisywane także przez wątek rysowania ( \link RenderLoop() \endlink ) i \link Stop() \endlink, dlatego atomowe.\n
+   */
+   atomic <bool> Exit{ true };
+   /*!
+      \brief Typ zdarzenia (SDL2).
+   */
+   SDL_Event Event;
+   /*!
+      \brief Wielkość świata liczony według kwadratu 1.0f x 1.0f ( w szerokości i długości ), z --map.
+   */
+   int MapMax = MAP_SIZE;
+   /*!
+      \brief Połowa wielkości świata.
+   */
+   int MapMaxHalf = MAP_SIZE / 2;
+   /*!
+      \brief Gęstość obiektów na mapie (0-0.5), z --density.
+
+      Ilość drzew i kamieni = round( \link MapMax \endlink * \link MapMax \endlink * gęstość ), dla każdej gęstości.
+   */
+   float MapDensity = MAP_DENSITY;
+   /*!
+      \brief Ilość drzew i kamieni na mapie.
+   */
+   int MapItems = 0;
+   /*!
+      \brief Wektor obiektów w świecie/mapa świata.
+   */
+   vector < vector <int> > Map;
+   /*!
+      \brief Wektor dla identyfikatora obiektu w świecie.
+   */
+   vector < vector <int> > MapIndex;
+   /*!
+      \brief Podział mapy na bloki, wykorzystywany do odrzucania obiektów oraz zapytań o obszar.
+   */
+   WorldGrid Grid;
+   /*!
+      \brief Wynik zapytania o obszar w \link Grid \endlink.
+   */
+   vector <GridItem> GridItems;
+   /*!
+      \brief Ilość zebranych monet podczas gry.
+   */
+   int Score = 0;
+   //Other:
+   /*!
+      \brief Identyfikator dla pliku setting.init.
+   */
+   fstream SettingsFile;
+   /*!
+      \brief Ustawienia zmienione tylko jednorazowo ( klucz, wartość do zapisania ), \link KeepSetting() \endlink.
+   */
+   map <string, int> KeptSettings;
+   /*!
+      \var i
+      \brief Tymczasowe zmienna dla pętli for.
+   */
+   /*!
+      \var j
+      \brief Tymczasowe zmienna dla pętli for.
+   */
+   int i,j;
+   /*!
+      \brief Kod błędu dla OpenGL.
+   */
+   GLenum GL_Error;
+   /*!
+      \brief Kod błędu dla DevIL.
+   */
+   ILenum IL_Error;
+   //Camera:
+   /*!
+      \brief Aktualne poruszenie myszki, różnica pomiędzy poprzednią, a aktualną pozycją myszki.
+   */
+   vec2 Mouse;
+   /*!
+      \brief Aktualne poruszenie dla kółka myszki (góra/dół), różnica pomiędzy poprzednią, a aktualną pozycją kółka myszki.
+   */
+   vec1 MouseWheel;
+   /*!
+      \brief Kamera, miejsce z którego będzie przetwarzana cała scena OpenGL.
+   */
+   Camera camera;
+   //For change settings camera:
+   /*!
+      \brief Współczynnik szerokości do wysokości, obliczany jako szerokość/wysokość.
+   */
+   vec1 Aspect;
+   /*!
+      \brief Kąt widzenia dla kamery, wyrażony w stopniach.
+   */
+   vec1 VOF;
+   /*!
+      \brief Odległość od jakiej rysowane są obiekty.
+   */
+   vec1 Near;
+   /*!
+      \brief Odległość do jakiej rysowane są obiekty.
+   */
+   vec1 Far;
+   //Shaders:
+   /*!
+      \brief Identyfikator głównego shadera.
+   */
+   GLuint ProgramID = 0;
+   //Uniforms:
+   /*!
+      \brief Uniform dla macierzy modelu.
+   */
+   GLuint ModelUniformId = 0;
+   /*!
+      \brief Uniform dla tekstury głównej obiektu.
+   */
+   GLuint TextureUniformId = 0;
+   /*!
+      \brief Uniform dla tekstury spektralnej obiektu.
+   */
+   GLuint TextureSpecularUniformId = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (Ambient).
+   */
+   GLuint AmbientUniformId = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (Diffuse).
+   */
+   GLuint DiffuseUniformId = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (Specular).
+   */
+   GLuint SpecularUniformId = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (jakość odbicia).
+   */
+   GLuint ShininessUniformId = 0;
+
+   //second for drawing light object:
+   /*!
+      \brief Identyfikator shadera do rysowania światła.
+   */
+   GLuint LightID = 0;
+   //Uniforms:
+   /*!
+      \brief Uniform dla macierzy modelu dla światła.
+   */
+   GLuint ModelUniformLight = 0;
+   /*!
+      \brief Uniform dla koloru obiektu światła.
+   */
+   GLuint UniformColorLight = 0;
+   //Depth pre-pass:
+   /*!
+      \brief Identyfikator shadera głębokości.
+   */
+   GLuint DepthID = 0;
+   /*!
+      \brief Uniform dla macierzy modelu dla shadera głębokości.
+   */
+   GLuint ModelUniformDepth = 0;
+   //Deferred shading:
+   /*!
+      \brief Oświetlenie odroczone: G-bufor i bryły świateł punktowych.
+   */
+   DeferredRenderer Deferred;
+   /*!
+      \brief Rysowanie z oświetleniem odroczonym ( \link Deferred \endlink ). FALSE = główny shader liczy wszystkie światła.
+   */
+   bool DeferredShading = false;
+   /*!
+      \brief Ilość dodatkowych, losowo rozmieszczonych świateł punktowych (oświetlenie odroczone i klastry).
+   */
+   int PointLightCount = 0;
+   /*!
+      \brief Światła punktowe oświetlenia odroczonego i klastrów, 0 = \link SunMoving \endlink.
+   */
+   vector <PointLightData> PointLights;
+   //Shadows:
+   /*!
+      \brief Mapy cieni głównego i drugiego światła.
+   */
+   ShadowMap Shadow;
+   /*!
+      \brief Rysowanie cieni ( \link Shadow \endlink ).
+   */
+   bool ShadowMapping = true;
+   /*!
+      \brief Wielkość mapy cieni głównego światła.
+   */
+   int ShadowSize = SHADOW_SIZE;
+   /*!
+      \brief Wielkość ściany mapy sześciennej drugiego światła, 0 = bez cieni drugiego światła.
+   */
+   int PointShadowSize = SHADOW_POINT_SIZE;
+   /*!
+      \brief Ilość klatek między aktualizacjami mapy sześciennej drugiego światła, 0 = bez aktualizacji.
+   */
+   int PointShadowRate = SHADOW_POINT_RATE;
+   /*!
+      \brief Uniform włączający cienie głównego światła w głównym shaderze.
+   */
+   GLuint SunShadowsUniform = 0;
+   /*!
+      \brief Uniform macierzy mapy cieni głównego światła ( \link ShadowMap::ReturnSunMatrix() \endlink ).
+   */
+   GLuint SunShadowMatrixUniform = 0;
+   /*!
+      \brief Uniform włączający cienie drugiego światła w głównym shaderze.
+   */
+   GLuint PointShadowsUniform = 0;
+   /*!
+      \brief Uniform pozycji i zasięgu mapy sześciennej ( \link ShadowMap::ReturnPointPosition() \endlink ).
+   */
+   GLuint PointShadowPositionUniform = 0;
+   /*!
+      \brief Uniform współczynników głębokości mapy sześciennej ( \link ShadowMap::ReturnPointDepth() \endlink ).
+   */
+   GLuint PointShadowDepthUniform = 0;
+   //Clustered forward shading:
+   /*!
+      \brief Przypisanie świateł punktowych do klastrów widoku dla głównego shadera.
+   */
+   LightClusters Clusters;
+   /*!
+      \brief Główny shader liczy tylko światła z klastra fragmentu ( \link Clusters \endlink ). FALSE = stała tablica świateł w FrameData.
+   */
+   bool ClusteredShading = false;
+   /*!
+      \brief Uniform włączający światła z klastrów w głównym shaderze.
+   */
+   GLuint ClusteredUniform = 0;
+   /*!
+      \brief Uniform parametrów klastrów w głównym shaderze ( \link LightClusters::ReturnParameters() \endlink ).
+   */
+   GLuint ClusterParametersUniform = 0;
+   /*!
+      \brief Uniform dla macierzy modelu dla shadera G-bufora.
+   */
+   GLuint ModelUniformGBuffer = 0;
+   /*!
+      \brief Uniform dla tekstury głównej obiektu dla shadera G-bufora.
+   */
+   GLuint TextureUniformGBuffer = 0;
+   /*!
+      \brief Uniform dla tekstury spektralnej obiektu dla shadera G-bufora.
+   */
+   GLuint TextureSpecularUniformGBuffer = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (Ambient) dla shadera G-bufora.
+   */
+   GLuint AmbientUniformGBuffer = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (Diffuse) dla shadera G-bufora.
+   */
+   GLuint DiffuseUniformGBuffer = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (Specular) dla shadera G-bufora.
+   */
+   GLuint SpecularUniformGBuffer = 0;
+   /*!
+      \brief Uniform dla materiału obiektu (jakość odbicia) dla shadera G-bufora.
+   */
+   GLuint ShininessUniformGBuffer = 0;
+   //Per-frame data:
+   /*!
+      \brief Bufor pierścieniowy dla danych zmieniających się co klatkę.
+   */
+   RingBuffer FrameRing;
+   /*!
+      \brief Wymagane wyrównanie przesunięcia bloku uniformów (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT).
+   */
+   GLint UniformAlignment = 256;
+   /*!
+      \brief Pomiar czasu GPU i CPU klatki i przebiegów rysowania ( \link TIMER_FRAME \endlink, \link TIMER_DEPTH \endlink, \link TIMER_DEFERRED \endlink, \link TIMER_CLUSTERS \endlink, \link TIMER_SHADOWS \endlink, \link TIMER_PASS \endlink ).
+   */
+   GpuTimer Timers;
+   /*!
+      \brief Wypisywanie statystyk \link Timers \endlink razem z FPS.
+   */
+   bool TimerLog = false;
+   //HUD:
+   /*!
+      \brief Nakładka z wykresem czasu klatek i licznikami ( \link DrawHud() \endlink ).
+   */
+   Hud Overlay;
+   /*!
+      \brief Wyświetlanie \link Overlay \endlink. TRUE = włączone.
+   */
+   bool ShowHud = false;
+   /*!
+      \brief Wiersz pamięci GPU podanej przez sterownik, pusty = do odczytania ( \link UpdateHudMemory() \endlink ).
+   */
+   string HudMemory;
+   /*!
+      \brief Czas CPU zbudowania i narysowania \link Overlay \endlink w ostatniej klatce (w milisekundach).
+   */
+   float HudTime = 0.0f;
+   //Matrix:
+   /*!
+      \brief Macierz projekcji.
+   */
+   mat4 ProjectionMatrix;
+   /*!
+      \brief Macierz widoku.
+   */
+   mat4 ViewMatrix;
+   //Models:
+   /*!
+      \brief Wektor wszystkich obiektów świata.
+   */
+   vector <Model> Models;
+   /*!
+      \brief Iterator dla wektora wszystkich obiektów świata.
+   */
+   vector <Model>::iterator It;
+   //Light:
+   /*!
+      \brief Główne światło, słońce.
+   */
+   Light Sun;
+   /*!
+      \brief Drugie światło, poruszające się po okręgu.
+   */
+   Light SunMoving;
+   /*!
+      \brief Początkowa pozycja światła poruszające się po okręgu.
+   */
+   vec3 SunMovingPosition = vec3( 0.0f, 15.0f, 0.0f );
+   /*!
+      \brief Kąt w stopniach pomiędzy początkową a końcową/docelową pozycją oświetlenia.
+   */
+   GLfloat SunMovingDegreese = 0.0f;
+   /*!
+      \brief Kąt \link SunMovingDegreese \endlink przed ostatnim krokiem symulacji.
+   */
+   GLfloat SunMovingDegreesePrevious = 0.0f;
+   /*!
+      \brief Szybkość ruchu drugiego światła w stopniach na sekundę.
+   */
+   GLfloat SunMovingSpeed = 5.0f;
+   /*!
+      \brief Kąt w radianach pomiędzy początkową a końcową/docelową pozycją oświetlenia.
+   */
+   GLfloat SunMovingRadian = 0.0f;
+   /*!
+      \brief Promień okręgu po jakim porusza się oświetlenie.
+   */
+   GLfloat SunMovingRadius = 15.0f;
+   //tmp:
+   /*!
+      \brief Tymczasowy wektor typu vec3.
+   */
+   vec3 tmp_vector;
+   /*!
+      \brief Tymczasowy float typu GLfloat.
+   */
+   GLfloat tmp_float;
+   /*!
+      \brief Wektor rotacji dla monety.
+   */
+   vec3 RotateVec = vec3( 0.0f, 1.0f, 0.0f );
+   /*!
+      \brief Szybkość rotacji monety w stopniach na sekundę.
+   */
+   GLfloat RotateFloat = 100.0f;
+   /*!
+      \brief Kąt obrotu monety po ostatnim kroku symulacji.
+   */
+   GLfloat CoinAngle = 0.0f;
+   /*!
+      \brief Kąt obrotu monety przed ostatnim krokiem symulacji.
+   */
+   GLfloat CoinAnglePrevious = 0.0f;
+   /*!
+      \brief Kąt obrotu monety zapisany w jej macierzy modelu (ostatnio narysowany).
+   */
+   GLfloat CoinAngleRendered = 0.0f;
+   /*!
+      \brief Pozycja x monety na mapie (symulacja).
+   */
+   int CoinX = 0;
+   /*!
+      \brief Pozycja z monety na mapie (symulacja).
+   */
+   int CoinZ = 0;
+   /*!
+      \brief Pozycja x monety w \link Grid \endlink i jej macierzy modelu (ostatnio narysowana).
+   */
+   int CoinRenderedX = 0;
+   /*!
+      \brief Pozycja z monety w \link Grid \endlink i jej macierzy modelu (ostatnio narysowana).
+   */
+   int CoinRenderedZ = 0;
+   /*!
+      \brief Ilość zebranych monet z ostatniego stanu klatki (nakładka).
+   */
+   int ScoreRendered = 0;
+   /*!
+      \brief Zebranie monety w następnym kroku symulacji (E lub lewy przycisk myszy).
+   */
+   bool CollectCoin = false;
+   /*!
+      \brief Ilość ruchów kamery o \link Camera::MovementSpeed \endlink na sekundę przy wciśniętym klawiszu.
+   */
+   GLfloat MovementRate = 30.0f;
+   /*!
+      \var tmp_x
+      \brief Tymczasowe zmienne typu int.
+   */
+   /*!
+      \var tmp_y
+      \brief Tymczasowe zmienne typu int.
+   */
+   /*!
+      \var tmp_z
+      \brief Tymczasowe zmienne typu int.
+   */
+   int tmp_x, tmp_y, tmp_z;
+};
+
+/*!
+   \brief Wskaźnik na klasę typu \link Game \endlink służący to zatrzymania rozgrywki po otrzymaniu kodu przerwania aplikacji.
+*/
+Game * PointerGame = NULL;
+/*!
+   \brief Zatrzymanie gry przy pomocy wskaźnika \link PointerGame \endlink.
+*/
+void GlobalStop();
+
+/*!
+   \brief Główna funkcja uruchamiająca całą aplikację.
+*/
+int main( int argc, char* argv[] ){
+   #ifdef SIGTSTP
+   signal( SIGTSTP, CaughtSignal );
+   #endif
+   signal( SIGINT, CaughtSignal );
+   Game game( argc, argv );
+   PointerGame = &game;
+   game.Start();
+   PointerGame = NULL;
+   return game.ReturnResult();
+}
+
+void CaughtSignal( int signal ){
+   #ifdef SIGTSTP
+   //Linux:
+   //CTRL+Z
+   if( signal == SIGTSTP ){
+      cout<<"\n\nCaught signal SIGTSTP\n\n";
+      GlobalStop();
+   }
+   //CTRL+C
    else if( signal == SIGINT ){
       cout<<"\n\nCaught signal SIGINT\n\n";
       GlobalStop();
@@ -640,22 +1482,68 @@ void GlobalStop(){
    }
 }
 
-Game::Game(){
-   srand( time( 0 ) );
+Game::Game( int argc, char *argv[] ){
+   this->LoadSettings();
+   this->ParseArguments( argc, argv );
+   //Same pipeline for every golden image run, before map and renderer are created:
+   if( ! this->GoldenDirectory.empty() ){
+      this->SetGoldenOptions();
+   }
+   this->MapMaxHalf = this->MapMax / 2;
    this->Map.resize( this->MapMax, vector <int> ( this->MapMax, -1 ) );
    this->MapIndex.resize( this->MapMax, vector <int> ( this->MapMax, -1 ) );
-   this->LoadSettings();
+   MemoryTracker::Resize( MEMORY_WORLD, MEMORY_CPU, 0, this->ReturnMapMemory() );
+   //World and simulation from recording:
+   InputHeader header;
+   if( ! this->ReplayPath.empty() ){
+      if( this->Recorder.Open( this->ReplayPath, header ) ){
+         this->Seed = header.Seed;
+         this->RandomSeed = false;
+         this->KeepSetting( "simulationstep", this->SimulationStep );
+         this->KeepSetting( "width", this->WindowWidth );
+         this->KeepSetting( "height", this->WindowHeight );
+         this->SimulationStep = header.Step;
+         this->WindowWidth = header.Width;
+         this->WindowHeight = header.Height;
+         this->WindowWidthHalf = this->WindowWidth / 2;
+         this->WindowHeightHalf = this->WindowHeight / 2;
+      }
+      else{
+         this->CheckInit = false;
+      }
+   }
+   //Same world for every golden image run:
+   if( ! this->GoldenDirectory.empty() ){
+      this->Seed = GOLDEN_SEED;
+   }
+   else if( this->RandomSeed ){
+      this->Seed = this->BenchmarkPath.empty() ? time( 0 ) : GOLDEN_SEED;
+   }
+   srand( this->Seed );
+   SDL_Log( "Seed: %u\n", this->Seed );
+   if( ! this->RecordPath.empty() and ! this->Recorder.IsReplaying() ){
+      header.Seed = this->Seed;
+      header.Step = this->SimulationStep;
+      header.Width = this->WindowWidth;
+      header.Height = this->WindowHeight;
+      if( ! this->Recorder.Create( this->RecordPath, header ) ){
+         this->CheckInit = false;
+      }
+   }
    SDL_Log( "Constructor: INITIALIZE\n" );
    this->InitSDL();
-   this->InitOpenGL();
-   this->InitWindow();
-   this->SetIcon();
+   if( ! this->Headless ){
+      this->InitOpenGL();
+      this->InitWindow();
+      this->SetIcon();
+   }
    this->InitContent();
    this->InitDevIL();
    this->Exit = this->CheckInit;
 }
 
 Game::~Game(){
+   MemoryTracker::Resize( MEMORY_WORLD, MEMORY_CPU, this->ReturnMapMemory(), 0 );
    this->Map.clear();
    this->MapIndex.clear();
    SDL_Log( "Destructor: CLEANING\n" );
@@ -668,10 +1556,31 @@ Game::~Game(){
    Model::ShininessUniformId = NULL;
    Model::ModelUniformLight = NULL;
    Model::UniformColorLight = NULL;
+   Model::ModelUniformDepth = NULL;
+   Model::Jobs = NULL;
+   this->Jobs.Destroy();
    Light::ModelUniformLight = NULL;
    Light::UniformColorLight = NULL;
+   const GLuint programs[3] = { this->ProgramID, this->LightID, this->DepthID };
+   MemoryTracker::RemoveObject( MEMORY_OBJECT_PROGRAM, 3, programs );
    glDeleteProgram( this->ProgramID );
    glDeleteProgram( this->LightID );
+   glDeleteProgram( this->DepthID );
+   glDeleteQueries( 1, &this->OverdrawQuery );
+   this->FrameRing.Destroy();
+   this->StaticWorld.Destroy();
+   this->Impostors.Destroy();
+   this->Timers.Destroy();
+   this->Overlay.Destroy();
+   this->Deferred.Destroy();
+   this->Clusters.Destroy();
+   this->Shadow.Destroy();
+   if( this->Headless ){
+      this->HeadlessGL.Destroy();
+      SDL_Quit();
+      //Window settings may come from command line:
+      return;
+   }
    SDL_SetRelativeMouseMode( SDL_FALSE );
    SDL_GL_DeleteContext( this->WindowGLContext );
    SDL_DestroyWindow( this->Window );
@@ -680,8 +1589,8 @@ Game::~Game(){
    this->SettingsFile.open( "settings.init", ios::out );
    if( this->SettingsFile.good() ){
       this->SettingsFile<<"fullscreen "<<this->FullScreen
-      <<"\nwidth "<<this->WindowWidth
-      <<"\nheight "<<this->WindowHeight
+      <<"\nwidth "<<this->ReturnSetting( "width", this->WindowWidth )
+      <<"\nheight "<<this->ReturnSetting( "height", this->WindowHeight )
       <<"\npositionx ";
       if( this->WindowPositionX == SDL_WINDOWPOS_CENTERED ){
          this->SettingsFile<<-1;
@@ -697,7 +1606,29 @@ Game::~Game(){
          this->SettingsFile<<this->WindowPositionY;
       }
       this->SettingsFile<<"\nborderless "<<this->WindowBorderless
-      <<"\nresizable "<<this->WindowResizable;
+      <<"\nresizable "<<this->WindowResizable
+      <<"\nocclusion "<<this->OcclusionCulling
+      <<"\ndepthprepass "<<this->DepthPrePass
+      <<"\noverdraw "<<this->OverdrawCounter
+      <<"\nstaticbatch "<<this->StaticBatching
+      <<"\nimpostors "<<this->ImpostorRendering
+      <<"\nimpostordistance "<<(int)this->ImpostorDistance
+      <<"\ntimers "<<this->TimerLog
+      <<"\nsimulationstep "<<this->ReturnSetting( "simulationstep", this->SimulationStep )
+      <<"\nthreaded "<<this->Threaded
+      <<"\njobs "<<this->JobWorkers
+      <<"\npresentmode "<<this->PresentMode
+      <<"\nfpslimit "<<this->FrameLimit
+      <<"\nhud "<<this->ShowHud
+      <<"\ndeferred "<<this->DeferredShading
+      <<"\nclustered "<<this->ClusteredShading
+      <<"\nshadows "<<this->ShadowMapping
+      <<"\nshadowsize "<<this->ShadowSize
+      <<"\npointshadowsize "<<this->PointShadowSize
+      <<"\npointshadowrate "<<this->PointShadowRate
+      <<"\npointlights "<<this->PointLightCount
+      <<"\nheadless "<<this->Headless
+      <<"\nheadlessframes "<<this->ReturnSetting( "headlessframes", this->HeadlessFrames );
       this->SettingsFile.close();
    }
 }
@@ -729,298 +1660,1378 @@ void Game::LoadSettings(){
                this->WindowHeight = InputInt;
             }
          }
-         else if( InputString == "positionx" ){
-            if( InputInt < 0 ){
-               this->WindowPositionX = SDL_WINDOWPOS_CENTERED;
-            }
-            else{
-               this->WindowPositionX = InputInt;
-            }
+         else if( InputString == "positionx" ){
+            if( InputInt < 0 ){
+               this->WindowPositionX = SDL_WINDOWPOS_CENTERED;
+            }
+            else{
+               this->WindowPositionX = InputInt;
+            }
+         }
+         else if( InputString == "positiony" ){
+            if( InputInt < 0 ){
+               this->WindowPositionY = SDL_WINDOWPOS_CENTERED;
+            }
+            else{
+               this->WindowPositionY = InputInt;
+            }
+         }
+         else if( InputString == "borderless" ){
+            if( InputInt == 1 ){
+               this->WindowBorderless = true;
+               this->WindowFlag += SDL_WINDOW_BORDERLESS;
+            }
+            else{
+               this->WindowBorderless = false;
+            }
+         }
+         else if( InputString == "occlusion" ){
+            this->OcclusionCulling = InputInt == 1;
+         }
+         else if( InputString == "depthprepass" ){
+            this->DepthPrePass = InputInt == 1;
+         }
+         else if( InputString == "overdraw" ){
+            this->OverdrawCounter = InputInt == 1;
+         }
+         else if( InputString == "staticbatch" ){
+            this->StaticBatching = InputInt == 1;
+         }
+         else if( InputString == "impostors" ){
+            this->ImpostorRendering = InputInt == 1;
+         }
+         else if( InputString == "impostordistance" ){
+            if( InputInt > 0 ){
+               this->ImpostorDistance = InputInt;
+            }
+         }
+         else if( InputString == "deferred" ){
+            this->DeferredShading = InputInt == 1;
+         }
+         else if( InputString == "clustered" ){
+            this->ClusteredShading = InputInt == 1;
+         }
+         else if( InputString == "shadows" ){
+            this->ShadowMapping = InputInt == 1;
+         }
+         else if( InputString == "shadowsize" ){
+            if( InputInt >= 256 and InputInt <= 8192 ){
+               this->ShadowSize = InputInt;
+            }
+         }
+         else if( InputString == "pointshadowsize" ){
+            if( InputInt >= 0 and InputInt <= 4096 ){
+               this->PointShadowSize = InputInt;
+            }
+         }
+         else if( InputString == "pointshadowrate" ){
+            if( InputInt >= 0 ){
+               this->PointShadowRate = InputInt;
+            }
+         }
+         else if( InputString == "pointlights" ){
+            if( InputInt >= 0 ){
+               this->PointLightCount = InputInt;
+            }
+         }
+         else if( InputString == "simulationstep" ){
+            if( InputInt >= 1 and InputInt <= 100 ){
+               this->SimulationStep = InputInt;
+            }
+         }
+         else if( InputString == "presentmode" ){
+            if( InputInt >= PRESENT_UNCAPPED and InputInt <= PRESENT_ADAPTIVE ){
+               this->PresentMode = InputInt;
+            }
+         }
+         else if( InputString == "hud" ){
+            this->ShowHud = InputInt != 0;
+         }
+         else if( InputString == "fpslimit" ){
+            if( InputInt >= 0 ){
+               this->FrameLimit = InputInt;
+            }
+         }
+         else if( InputString == "jobs" ){
+            if( InputInt >= -1 and InputInt <= JOBS_MAX_WORKERS ){
+               this->JobWorkers = InputInt;
+            }
+         }
+         else if( InputString == "threaded" ){
+            this->Threaded = InputInt == 1;
+         }
+         else if( InputString == "timers" ){
+            this->TimerLog = InputInt == 1;
+         }
+         else if( InputString == "headless" ){
+            this->Headless = InputInt == 1;
+         }
+         else if( InputString == "headlessframes" ){
+            if( InputInt > 0 ){
+               this->HeadlessFrames = InputInt;
+            }
+         }
+         else if( InputString == "resizable" ){
+            if( InputInt == 1 ){
+               this->WindowResizable = true;
+               this->WindowFlag += SDL_WINDOW_RESIZABLE;
+            }
+            else{
+               this->WindowResizable = false;
+            }
+         }
+         else{
+            cout<<"Unknown input: \""<<InputString<<"\" from file: settings.init\n";
+         }
+      }
+      this->SettingsFile.close();
+   }
+   else{
+      cout<<"Can't find file: settings.init\n";
+   }
+}
+
+void Game::KeepSetting( const string &key, int value ){
+   //First value wins, later overrides don't replace value from file:
+   this->KeptSettings.insert( make_pair( key, value ) );
+}
+
+int Game::ReturnSetting( const string &key, int value ) const{
+   const map <string, int>::const_iterator it = this->KeptSettings.find( key );
+   return it != this->KeptSettings.end() ? it->second : value;
+}
+
+void Game::ParseArguments( int argc, char *argv[] ){
+   string argument;
+   for( int i = 1; i < argc; ++i ){
+      argument = argv[i];
+      if( argument == "--headless" ){
+         this->Headless = true;
+      }
+      else if( argument == "--frames" and i + 1 < argc ){
+         if( atoi( argv[++i] ) > 0 ){
+            this->KeepSetting( "headlessframes", this->HeadlessFrames );
+            this->HeadlessFrames = atoi( argv[i] );
+            this->BenchmarkFrames = atoi( argv[i] );
+         }
+      }
+      else if( argument == "--golden" and i + 1 < argc ){
+         this->GoldenDirectory = argv[++i];
+         this->Headless = true;
+      }
+      else if( argument == "--record" and i + 1 < argc ){
+         this->RecordPath = argv[++i];
+      }
+      else if( argument == "--replay" and i + 1 < argc ){
+         this->ReplayPath = argv[++i];
+      }
+      else if( argument == "--seed" and i + 1 < argc ){
+         this->Seed = strtoul( argv[++i], NULL, 10 );
+         this->RandomSeed = false;
+      }
+      else if( argument == "--profile" and i + 1 < argc ){
+         this->ProfilePath = argv[++i];
+      }
+      else if( argument == "--benchmark" ){
+         this->BenchmarkPath = BENCHMARK_FILE;
+         if( i + 1 < argc and argv[i + 1][0] != '-' ){
+            this->BenchmarkPath = argv[++i];
+         }
+      }
+      else if( argument == "--map" and i + 1 < argc ){
+         if( atoi( argv[++i] ) >= 4 ){
+            this->MapMax = atoi( argv[i] );
+         }
+      }
+      else if( argument == "--density" and i + 1 < argc ){
+         const float density = atof( argv[++i] );
+         if( density > 0.0f and density <= 0.5f ){
+            this->MapDensity = density;
+         }
+      }
+      else if( argument == "--golden-update" ){
+         this->GoldenUpdate = true;
+      }
+      else if( argument == "--width" and i + 1 < argc ){
+         if( atoi( argv[++i] ) > 0 ){
+            this->KeepSetting( "width", this->WindowWidth );
+            this->WindowWidth = atoi( argv[i] );
+         }
+      }
+      else if( argument == "--height" and i + 1 < argc ){
+         if( atoi( argv[++i] ) > 0 ){
+            this->KeepSetting( "height", this->WindowHeight );
+            this->WindowHeight = atoi( argv[i] );
+         }
+      }
+      else{
+         cout<<"Unknown argument: \""<<argument<<"\"\n";
+      }
+   }
+   this->WindowWidthHalf = this->WindowWidth / 2;
+   this->WindowHeightHalf = this->WindowHeight / 2;
+}
+
+void Game::Start(){
+   Profiler::SetThreadName( "main" );
+   if( this->Jobs.Create( this->JobWorkers ) ){
+      Model::Jobs = & this->Jobs;
+   }
+
+   this->InitShaders();
+
+   this->LoadData();
+   //Peak from loading (decoded images, shader sources, impostor baking) stays visible against steady state:
+   MemoryTracker::MarkSteady();
+   MemoryTracker::Log();
+
+   this->TimerBegin = SDL_GetTicks();
+   this->TimerEnd = this->TimerBegin + 1000;
+
+   this->Exit = this->CheckInit;
+
+   if( ! this->GoldenDirectory.empty() ){
+      this->RunGolden();
+   }
+   else if( ! this->BenchmarkPath.empty() ){
+      this->RunBenchmark();
+   }
+   else if( this->Recorder.IsReplaying() ){
+      this->LoopReplay();
+   }
+   else if( this->Headless ){
+      this->LoopHeadless();
+   }
+   else{
+      this->Loop();
+   }
+
+   SDL_Log( "\rYOUR SCORE: %i\n", this->Score );
+   MemoryTracker::Log();
+
+   if( ! this->ProfilePath.empty() ){
+      Profiler::Save( this->ProfilePath );
+   }
+}
+
+void Game::Loop(){
+   SDL_Log( "\n" );
+   SDL_Log( "Game: BEGIN\n" );
+   const Uint64 step = SDL_GetPerformanceFrequency() * this->SimulationStep / 1000;
+   const GLfloat dt = this->SimulationStep / 1000.0f;
+   Uint64 accumulator = 0;
+   Uint64 previous = SDL_GetPerformanceCounter();
+   Uint64 now;
+   unsigned int steps;
+   //GL context moves to the render thread:
+   SDL_Thread *thread = NULL;
+   if( this->Threaded and this->Snapshots.Create() ){
+      SDL_GL_MakeCurrent( this->Window, NULL );
+      thread = SDL_CreateThread( Game::RenderThread, "render", this );
+      if( thread == NULL ){
+         SDL_LogError( SDL_LOG_CATEGORY_SYSTEM, "SDL_CreateThread: %s\n", SDL_GetError() );
+         SDL_GL_MakeCurrent( this->Window, this->WindowGLContext );
+         this->Snapshots.Destroy();
+      }
+      else{
+         SDL_Log( "Render thread: BEGIN\n" );
+      }
+   }
+   while( this->Exit ){
+      const Uint64 input = SDL_GetPerformanceCounter();
+      while( SDL_PollEvent( &this->Event ) ){
+         if( this->Recorder.IsRecording() and InputRecorder::FromEvent( this->Event, this->Record ) ){
+            this->Recorder.Write( this->Record );
+         }
+         this->HandleEvent( this->Event );
+      }
+      //Fixed steps, simulation paused without focus:
+      now = SDL_GetPerformanceCounter();
+      if( this->Focus ){
+         accumulator += now - previous;
+      }
+      previous = now;
+      this->MoveKeys = this->ReturnMoveKeys();
+      for( steps = 0; accumulator >= step and steps < SIMULATION_MAX_STEPS; ++steps ){
+         this->Recorder.WriteStep( this->MoveKeys );
+         this->Simulate( dt );
+         accumulator -= step;
+      }
+      FrameSnapshot &snapshot = this->Snapshots.ReturnWrite();
+      this->Record.Type = INPUT_FRAME;
+      this->Record.Alpha = GLfloat( accumulator % step ) / GLfloat( step );
+      this->Recorder.Write( this->Record );
+      this->BuildSnapshot( snapshot, this->Record.Alpha );
+      snapshot.Steps = steps;
+      if( accumulator >= step ){
+         snapshot.Dropped = accumulator / step;
+         accumulator %= step;
+      }
+      snapshot.SimulationTime = SDL_GetPerformanceCounter() - previous;
+      snapshot.InputTime = input;
+      if( thread != NULL ){
+         this->Snapshots.Publish();
+      }
+      else{
+         this->Render( snapshot );
+         snapshot.Events.clear();
+      }
+   }
+   if( thread != NULL ){
+      this->Snapshots.Stop();
+      SDL_WaitThread( thread, NULL );
+      SDL_GL_MakeCurrent( this->Window, this->WindowGLContext );
+      SDL_Log( "\rRender thread: END, simulation waited for drawing %u times\n", this->Snapshots.ReturnWaits() );
+      this->Snapshots.Destroy();
+   }
+   if( this->Recorder.IsRecording() ){
+      this->WriteRecordEnd();
+      SDL_Log( "\rInputRecorder: %u records\n", this->Recorder.ReturnRecords() );
+      this->Recorder.Close();
+   }
+   SDL_Log( "Game: END\n" );
+}
+
+void Game::HandleEvent( const SDL_Event &event ){
+   switch( event.type ){
+      case SDL_QUIT:
+         this->Exit = false;
+         SDL_Log( "Window closed\n" );
+         break;
+      case SDL_MOUSEMOTION:
+         this->Mouse.x = -event.motion.xrel;
+         this->Mouse.y = -event.motion.yrel;
+         this->camera.MouseUpdate( this->Mouse );
+         if( ! this->Headless ){
+            SDL_WarpMouseInWindow( this->Window, this->WindowWidthHalf, this->WindowHeightHalf );
+         }
+         break;
+      case SDL_KEYDOWN:
+         switch( event.key.keysym.sym ){
+            case SDLK_ESCAPE:
+               this->Exit = false;
+               SDL_Log( "Window closed\n" );
+               break;
+            //Movement keys: Simulate()
+            case SDLK_BACKQUOTE:
+               this->camera.Log();
+               this->Snapshots.ReturnWrite().Events.push_back( event );
+               break;
+            //Coins: Simulate()
+            case SDLK_e:
+               this->CollectCoin = true;
+               break;
+            //Drawing options: Render()
+            case SDLK_F1:
+            case SDLK_F2:
+            case SDLK_F3:
+            case SDLK_F4:
+            case SDLK_F5:
+            case SDLK_F6:
+            case SDLK_F8:
+            case SDLK_F9:
+            case SDLK_F11:
+            case SDLK_h:
+               this->Snapshots.ReturnWrite().Events.push_back( event );
+               break;
+            //Numpad camera:
+            case SDLK_KP_8:
+               this->Mouse.x = 0;
+               this->Mouse.y = 10;
+               this->camera.MouseUpdate( this->Mouse );
+               break;
+            case SDLK_KP_2:
+               this->Mouse.x = 0;
+               this->Mouse.y = -10;
+               this->camera.MouseUpdate( this->Mouse );
+               break;
+            case SDLK_KP_4:
+               this->Mouse.x = 10;
+               this->Mouse.y = 0;
+               this->camera.MouseUpdate( this->Mouse );
+               break;
+            case SDLK_KP_6:
+               this->Mouse.x = -10;
+               this->Mouse.y = 0;
+               this->camera.MouseUpdate( this->Mouse );
+               break;
+            case SDLK_F7:
+               this->camera.TurnFreeCamera();
+               break;
+            case SDLK_F10:
+               this->camera.SetPositionDefault();
+               break;
+            case SDLK_p:
+               Profiler::Save( this->ProfilePath.empty() ? PROFILER_FILE : this->ProfilePath );
+               break;
+            case SDLK_F12:
+               if( this->FullScreen ){
+                  this->FullScreen = false;
+                  SDL_SetWindowFullscreen( this->Window, 0 );
+               }
+               else{
+                  this->FullScreen = true;
+                  SDL_SetWindowFullscreen( this->Window, SDL_WINDOW_FULLSCREEN );
+                  //SDL_SetWindowFullscreen( this->Window, SDL_WINDOW_FULLSCREEN_DESKTOP );
+               }
+               break;
+            default:
+               break;
+         }
+         break;
+      case SDL_MOUSEBUTTONDOWN:
+         switch( event.button.button ){
+            case SDL_BUTTON_LEFT:
+               this->CollectCoin = true;
+               break;
+            case SDL_BUTTON_RIGHT:
+               this->VOF.x = 30.0f;
+               this->camera.SetVOF( this->VOF );
+               break;
+            default:
+               break;
          }
-         else if( InputString == "positiony" ){
-            if( InputInt < 0 ){
-               this->WindowPositionY = SDL_WINDOWPOS_CENTERED;
-            }
-            else{
-               this->WindowPositionY = InputInt;
-            }
+         break;
+      case SDL_MOUSEBUTTONUP:
+         switch( event.button.button ){
+            case SDL_BUTTON_RIGHT:
+               this->VOF.x = 45.0f;
+               this->camera.SetVOF( this->VOF );
+               break;
+            default:
+               break;
          }
-         else if( InputString == "borderless" ){
-            if( InputInt == 1 ){
-               this->WindowBorderless = true;
-               this->WindowFlag += SDL_WINDOW_BORDERLESS;
-            }
-            else{
-               this->WindowBorderless = false;
-            }
+         break;
+      case SDL_MOUSEWHEEL:
+         this->MouseWheel.x = -event.wheel.y;
+         this->camera.ChangeVOF( this->MouseWheel );
+         break;
+      case SDL_WINDOWEVENT:
+         switch( event.window.event ){
+            case SDL_WINDOWEVENT_MOVED:
+               SDL_Log( "Window moved to %d;%d\n",
+                  event.window.data1,
+                  event.window.data2
+               );
+               break;
+            case SDL_WINDOWEVENT_RESIZED:
+               SDL_Log( "Window resized to %dx%d\n",
+                  event.window.data1,
+                  event.window.data2
+               );
+               this->WindowWidthHalf = event.window.data1 / 2;
+               this->WindowHeightHalf = event.window.data2 / 2;
+               this->Aspect = vec1( float( this->WindowWidthHalf ) / float( this->WindowHeightHalf ) );
+               camera.SetAspect( this->Aspect );
+               //Viewport and G-buffer: Render()
+               this->Snapshots.ReturnWrite().Events.push_back( event );
+               break;
+            case SDL_WINDOWEVENT_MINIMIZED:
+               SDL_Log( "Window minimized\n" );
+               break;
+            case SDL_WINDOWEVENT_MAXIMIZED:
+               SDL_Log( "Window maximized\n" );
+               break;
+            case SDL_WINDOWEVENT_RESTORED:
+               SDL_Log( "Window restored\n" );
+               break;
+            case SDL_WINDOWEVENT_FOCUS_GAINED:
+               SDL_Log( "Window %d gained keyboard focus\n", event.window.windowID );
+               if( ! this->Headless ){
+                  SDL_SetRelativeMouseMode( SDL_TRUE );
+               }
+               this->Focus = true;
+               break;
+            case SDL_WINDOWEVENT_FOCUS_LOST:
+               SDL_Log( "Window %d lost keyboard focus\n", event.window.windowID );
+               if( ! this->Headless ){
+                  SDL_SetRelativeMouseMode( SDL_FALSE );
+               }
+               this->Focus = false;
+               this->Snapshots.ReturnWrite().Events.push_back( event );
+               break;
+            default:
+               break;
          }
-         else if( InputString == "resizable" ){
-            if( InputInt == 1 ){
-               this->WindowResizable = true;
-               this->WindowFlag += SDL_WINDOW_RESIZABLE;
-            }
-            else{
-               this->WindowResizable = false;
+         break;
+      default:
+         break;
+   }
+}
+
+void Game::LoopReplay(){
+   SDL_Log( "\n" );
+   SDL_Log( "Game: BEGIN (replay%s, %i x %i)\n", this->Headless ? ", headless" : "", this->WindowWidth, this->WindowHeight );
+   if( ! this->Headless ){
+      SDL_GL_SetSwapInterval( 0 );
+      this->Pacer.SetLimit( 0 );
+   }
+   const Uint64 frequency = SDL_GetPerformanceFrequency();
+   const Uint64 begin = SDL_GetPerformanceCounter();
+   const GLfloat dt = this->SimulationStep / 1000.0f;
+   FrameSnapshot &snapshot = this->Snapshots.ReturnWrite();
+   SDL_Event event;
+   unsigned int frames = 0, steps = 0;
+   Uint32 recorded = 0;
+   bool end = false, abort = false;
+   while( ! abort and this->Recorder.Read( this->Record ) ){
+      recorded = this->Record.Time;
+      if( this->Record.Type == INPUT_EVENT ){
+         InputRecorder::ToEvent( this->Record, event );
+         this->HandleEvent( event );
+      }
+      else if( this->Record.Type == INPUT_STEP ){
+         this->MoveKeys = this->Record.Keys;
+         this->Simulate( dt );
+         ++steps;
+      }
+      else if( this->Record.Type == INPUT_FRAME ){
+         this->BuildSnapshot( snapshot, this->Record.Alpha );
+         snapshot.Steps = steps;
+         steps = 0;
+         this->Render( snapshot );
+         snapshot.Events.clear();
+         ++frames;
+         //Only closing the window stops replay:
+         while( ! this->Headless and SDL_PollEvent( &event ) ){
+            if( event.type == SDL_QUIT or ( event.type == SDL_KEYDOWN and event.key.keysym.sym == SDLK_ESCAPE ) ){
+               abort = true;
             }
          }
+      }
+      else if( this->Record.Type == INPUT_END ){
+         end = true;
+         const vec3 position = this->camera.ReturnPosition();
+         const bool match = this->Record.Code == this->Score
+            and this->Record.Position[0] == position.x
+            and this->Record.Position[1] == position.y
+            and this->Record.Position[2] == position.z;
+         if( match ){
+            SDL_Log( "\rReplay: MATCH, score %i\n", this->Score );
+         }
          else{
-            cout<<"Unknown input: \""<<InputString<<"\" from file: settings.init\n";
+            SDL_LogWarn( SDL_LOG_CATEGORY_APPLICATION, "\rReplay: MISMATCH, score %i (recorded %i), camera %.3f %.3f %.3f (recorded %.3f %.3f %.3f)\n",
+               this->Score, this->Record.Code,
+               position.x, position.y, position.z,
+               this->Record.Position[0], this->Record.Position[1], this->Record.Position[2]
+            );
+            this->Result = 1;
          }
       }
-      this->SettingsFile.close();
    }
-   else{
-      cout<<"Can't find file: settings.init\n";
+   if( ! end and ! abort ){
+      SDL_LogWarn( SDL_LOG_CATEGORY_APPLICATION, "\rReplay: recording has no end\n" );
    }
+   const double total = double( SDL_GetPerformanceCounter() - begin ) * 1000.0 / double( frequency );
+   if( frames > 0 ){
+      SDL_Log( "\rReplay: %u frames in %.3f ms (recorded %u ms), average %.3f ms (%.1f FPS)\n",
+         frames,
+         total,
+         recorded,
+         total / frames,
+         total > 0.0 ? frames * 1000.0 / total : 0.0
+      );
+      this->Timers.Log();
+   }
+   this->Recorder.Close();
+   SDL_Log( "Game: END\n" );
 }
 
-void Game::Start(){
-   this->InitShaders();
-
-   this->LoadData();
+Uint8 Game::ReturnMoveKeys() const{
+   if( this->Headless ){
+      return 0;
+   }
+   const Uint8 *keys = SDL_GetKeyboardState( NULL );
+   Uint8 move = 0;
+   if( keys[SDL_SCANCODE_W] or keys[SDL_SCANCODE_UP] ){
+      move |= INPUT_MOVE_FORWARD;
+   }
+   if( keys[SDL_SCANCODE_S] or keys[SDL_SCANCODE_DOWN] ){
+      move |= INPUT_MOVE_BACKWARD;
+   }
+   if( keys[SDL_SCANCODE_A] or keys[SDL_SCANCODE_LEFT] ){
+      move |= INPUT_MOVE_LEFT;
+   }
+   if( keys[SDL_SCANCODE_D] or keys[SDL_SCANCODE_RIGHT] ){
+      move |= INPUT_MOVE_RIGHT;
+   }
+   if( keys[SDL_SCANCODE_SPACE] ){
+      move |= INPUT_MOVE_UP;
+   }
+   if( keys[SDL_SCANCODE_C] or keys[SDL_SCANCODE_LCTRL] ){
+      move |= INPUT_MOVE_DOWN;
+   }
+   return move;
+}
 
-   this->TimerBegin = SDL_GetTicks();
-   this->TimerEnd = this->TimerBegin + 1000;
-   this->TimerUpdate = this->TimerBegin;
+void Game::WriteRecordEnd(){
+   const vec3 position = this->camera.ReturnPosition();
+   this->Record.Type = INPUT_END;
+   this->Record.Code = this->Score;
+   this->Record.Position[0] = position.x;
+   this->Record.Position[1] = position.y;
+   this->Record.Position[2] = position.z;
+   this->Recorder.Write( this->Record );
+}
 
-   this->Exit = this->CheckInit;
+int Game::RenderThread( void *game ){
+   static_cast <Game *>( game )->RenderLoop();
+   return 0;
+}
 
-   this->Loop();
+void Game::LoadModelJob( void *models, unsigned int begin, unsigned int end ){
+   PROFILE_SCOPE( "Game::LoadModelJob" );
+   vector <Model> &list = *static_cast <vector <Model> *>( models );
+   for( unsigned int i = begin; i < end; ++i ){
+      list[i].Load_OBJ();
+   }
+}
 
-   SDL_Log( "\rYOUR SCORE: %i\n", this->Score );
+void Game::RenderLoop(){
+   Profiler::SetThreadName( "render" );
+   if( SDL_GL_MakeCurrent( this->Window, this->WindowGLContext ) != 0 ){
+      SDL_LogCritical( SDL_LOG_CATEGORY_SYSTEM, "SDL_GL_MakeCurrent: %s\n", SDL_GetError() );
+      this->Exit = false;
+      this->Snapshots.Stop();
+      return;
+   }
+   while( this->Snapshots.Acquire() ){
+      this->Render( this->Snapshots.ReturnRead() );
+   }
+   SDL_GL_MakeCurrent( this->Window, NULL );
 }
 
-void Game::Loop(){
-   SDL_Log( "\n" );
-   SDL_Log( "Game: BEGIN\n" );
-   while( this->Exit ){
-      while( SDL_PollEvent( &this->Event ) ){
-         switch( this->Event.type ){
-            case SDL_QUIT:
-               this->Exit = false;
-               SDL_Log( "Window closed\n" );
+void Game::HandleRenderEvent( const SDL_Event &event ){
+   switch( event.type ){
+      case SDL_KEYDOWN:
+         switch( event.key.keysym.sym ){
+            case SDLK_BACKQUOTE:
+               this->Sun.Log();
+               this->SunMoving.Log();
                break;
-            case SDL_MOUSEMOTION:
-               this->Mouse.x = -this->Event.motion.xrel;
-               this->Mouse.y = -this->Event.motion.yrel;
-               this->camera.MouseUpdate( this->Mouse );
-               SDL_WarpMouseInWindow( this->Window, this->WindowWidthHalf, this->WindowHeightHalf );
+            case SDLK_F1:
+               if( this->Shadow.IsCreated() ){
+                  this->ShadowMapping = ! this->ShadowMapping;
+                  SDL_Log( "Shadows: %s\n", this->ShadowMapping ? "ON" : "OFF" );
+               }
                break;
-            case SDL_KEYDOWN:
-               switch( this->Event.key.keysym.sym ){
-                  case SDLK_ESCAPE:
-                     this->Exit = false;
-                     SDL_Log( "Window closed\n" );
-                     break;
-                  case SDLK_UP:
-                  case SDLK_w:
-                     this->camera.MoveForward();
-                     break;
-                  case SDLK_DOWN:
-                  case SDLK_s:
-                     this->camera.MoveBackward();
-                     break;
-                  case SDLK_LEFT:
-                  case SDLK_a:
-                     this->camera.MoveLeft();
-                     break;
-                  case SDLK_RIGHT:
-                  case SDLK_d:
-                     this->camera.MoveRight();
-                     break;
-                  case SDLK_e:
-                     this->CheckCoin();
-                     break;
-                  case SDLK_SPACE:
-                     this->camera.MoveUp();
-                     break;
-                  case SDLK_LCTRL:
-                  case SDLK_c:
-                     this->camera.MoveDown();
-                     break;
-                  case SDLK_BACKQUOTE:
-                     this->camera.Log();
-                     this->Sun.Log();
-                     this->SunMoving.Log();
-                     break;
-                  //Numpad camera:
-                  case SDLK_KP_8:
-                     this->Mouse.x = 0;
-                     this->Mouse.y = 10;
-                     this->camera.MouseUpdate( this->Mouse );
-                     break;
-                  case SDLK_KP_2:
-                     this->Mouse.x = 0;
-                     this->Mouse.y = -10;
-                     this->camera.MouseUpdate( this->Mouse );
-                     break;
-                  case SDLK_KP_4:
-                     this->Mouse.x = 10;
-                     this->Mouse.y = 0;
-                     this->camera.MouseUpdate( this->Mouse );
-                     break;
-                  case SDLK_KP_6:
-                     this->Mouse.x = -10;
-                     this->Mouse.y = 0;
-                     this->camera.MouseUpdate( this->Mouse );
-                     break;
-                  case SDLK_F7:
-                     this->camera.TurnFreeCamera();
-                     break;
-                  case SDLK_F10:
-                     this->camera.SetPositionDefault();
-                     break;
-                  case SDLK_F12:
-                     if( this->FullScreen ){
-                        this->FullScreen = false;
-                        SDL_SetWindowFullscreen( this->Window, 0 );
-                     }
-                     else{
-                        this->FullScreen = true;
-                        SDL_SetWindowFullscreen( this->Window, SDL_WINDOW_FULLSCREEN );
-                        //SDL_SetWindowFullscreen( this->Window, SDL_WINDOW_FULLSCREEN_DESKTOP );
-                     }
-                     break;
-                  default:
-                     break;
+            case SDLK_F2:
+               this->ImpostorRendering = ! this->ImpostorRendering;
+               SDL_Log( "Impostors: %s\n", this->ImpostorRendering ? "ON" : "OFF" );
+               break;
+            case SDLK_F3:
+               this->StaticBatching = ! this->StaticBatching;
+               SDL_Log( "Static batching: %s\n", this->StaticBatching ? "ON" : "OFF" );
+               break;
+            case SDLK_F4:
+               this->DepthPrePass = ! this->DepthPrePass;
+               SDL_Log( "Depth pre-pass: %s\n", this->DepthPrePass ? "ON" : "OFF" );
+               break;
+            case SDLK_F5:
+               this->OverdrawCounter = ! this->OverdrawCounter;
+               SDL_Log( "Overdraw counter: %s\n", this->OverdrawCounter ? "ON" : "OFF" );
+               break;
+            case SDLK_F6:
+               this->OcclusionCulling = ! this->OcclusionCulling;
+               SDL_Log( "Occlusion culling: %s\n", this->OcclusionCulling ? "ON" : "OFF" );
+               break;
+            case SDLK_F8:
+               this->TimerLog = ! this->TimerLog;
+               SDL_Log( "GPU timers: %s\n", this->TimerLog ? "ON" : "OFF" );
+               break;
+            case SDLK_F9:
+               if( this->Deferred.ReturnGBufferProgram() != 0 ){
+                  this->DeferredShading = ! this->DeferredShading;
+                  SDL_Log( "Deferred shading: %s\n", this->DeferredShading ? "ON" : "OFF" );
                }
                break;
-            case SDL_MOUSEBUTTONDOWN:
-               switch( this->Event.button.button ){
-                  case SDL_BUTTON_LEFT:
-                     this->CheckCoin();
-                     break;
-                  case SDL_BUTTON_RIGHT:
-                     this->VOF.x = 30.0f;
-                     this->camera.SetVOF( this->VOF );
-                     break;
-                  default:
-                     break;
+            case SDLK_F11:
+               if( this->Clusters.IsCreated() ){
+                  this->ClusteredShading = ! this->ClusteredShading;
+                  SDL_Log( "Clustered shading: %s\n", this->ClusteredShading ? "ON" : "OFF" );
                }
                break;
-            case SDL_MOUSEBUTTONUP:
-               switch( this->Event.button.button ){
-                  case SDL_BUTTON_RIGHT:
-                     this->VOF.x = 45.0f;
-                     this->camera.SetVOF( this->VOF );
-                     break;
-                  default:
-                     break;
+            case SDLK_h:
+               if( this->Overlay.IsCreated() ){
+                  this->ShowHud = ! this->ShowHud;
+                  this->HudMemory.clear();
+                  SDL_Log( "HUD: %s\n", this->ShowHud ? "ON" : "OFF" );
                }
                break;
-            case SDL_MOUSEWHEEL:
-               this->MouseWheel.x = -this->Event.wheel.y;
-               this->camera.ChangeVOF( this->MouseWheel );
+            default:
                break;
-            case SDL_WINDOWEVENT:
-               switch( this->Event.window.event ){
-                  case SDL_WINDOWEVENT_MOVED:
-                     SDL_Log( "Window moved to %d;%d\n",
-                        this->Event.window.data1,
-                        this->Event.window.data2
-                     );
-                     break;
-                  case SDL_WINDOWEVENT_RESIZED:
-                     SDL_Log( "Window resized to %dx%d\n",
-                        this->Event.window.data1,
-                        this->Event.window.data2
-                     );
-                     this->WindowWidth = this->Event.window.data1;
-                     this->WindowHeight = this->Event.window.data2;
-                     this->WindowWidthHalf = this->WindowWidth / 2;
-                     this->WindowHeightHalf = this->WindowHeight / 2;
-                     this->Aspect = vec1( float( this->WindowWidthHalf ) / float( this->WindowHeightHalf ) );
-                     glViewport( 0, 0, (GLsizei)this->WindowWidth, (GLsizei)this->WindowHeight );
-                     camera.SetAspect( this->Aspect );
-                     break;
-                  case SDL_WINDOWEVENT_MINIMIZED:
-                     SDL_Log( "Window minimized\n" );
-                     break;
-                  case SDL_WINDOWEVENT_MAXIMIZED:
-                     SDL_Log( "Window maximized\n" );
-                     break;
-                  case SDL_WINDOWEVENT_RESTORED:
-                     SDL_Log( "Window restored\n" );
-                     break;
-                  case SDL_WINDOWEVENT_FOCUS_GAINED:
-                     SDL_Log( "Window %d gained keyboard focus\n", this->Event.window.windowID );
-                     SDL_SetRelativeMouseMode( SDL_TRUE );
-                     this->Focus = true;
-                     break;
-                  case SDL_WINDOWEVENT_FOCUS_LOST:
-                     SDL_Log( "Window %d lost keyboard focus\n", this->Event.window.windowID );
-                     SDL_SetRelativeMouseMode( SDL_FALSE );
-                     glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
-                     SDL_GL_SwapWindow( this->Window );
-                     this->Focus = false;
-                     break;
-                  default:
-                     break;
+         }
+         break;
+      case SDL_WINDOWEVENT:
+         switch( event.window.event ){
+            case SDL_WINDOWEVENT_RESIZED:
+               this->WindowWidth = event.window.data1;
+               this->WindowHeight = event.window.data2;
+               glViewport( 0, 0, (GLsizei)this->WindowWidth, (GLsizei)this->WindowHeight );
+               if( ! this->Deferred.Resize( this->WindowWidth, this->WindowHeight ) ){
+                  this->DeferredShading = false;
                }
                break;
+            case SDL_WINDOWEVENT_FOCUS_LOST:
+               glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+               this->Present();
+               break;
             default:
                break;
          }
-      }
-      this->Update();
+         break;
+      default:
+         break;
+   }
+}
+
+void Game::LoopHeadless(){
+   SDL_Log( "\n" );
+   SDL_Log( "Game: BEGIN (headless, %u frames, %i x %i)\n", this->HeadlessFrames, this->WindowWidth, this->WindowHeight );
+   const Uint64 frequency = SDL_GetPerformanceFrequency();
+   const Uint64 begin = SDL_GetPerformanceCounter();
+   const GLfloat dt = this->SimulationStep / 1000.0f;
+   FrameSnapshot &snapshot = this->Snapshots.ReturnWrite();
+   unsigned int frame;
+   for( frame = 0; frame < this->HeadlessFrames and this->Exit; ++frame ){
+      //One step per frame, same result for each run:
+      this->SetHeadlessCamera( frame );
+      this->Simulate( dt );
+      this->BuildSnapshot( snapshot, 1.0f );
+      snapshot.Steps = 1;
+      this->Render( snapshot );
+   }
+   const double total = double( SDL_GetPerformanceCounter() - begin ) * 1000.0 / double( frequency );
+   if( frame > 0 ){
+      SDL_Log( "\rHeadless: %u frames in %.3f ms, average %.3f ms (%.1f FPS)\n",
+         frame,
+         total,
+         total / frame,
+         total > 0.0 ? frame * 1000.0 / total : 0.0
+      );
+      this->Timers.Log();
    }
    SDL_Log( "Game: END\n" );
 }
 
-void Game::Update(){
-   if( this->Focus ){
-      this->TimerBegin = SDL_GetTicks();
-      glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+void Game::SetGoldenOptions(){
+   this->WindowWidth = GOLDEN_WIDTH;
+   this->WindowHeight = GOLDEN_HEIGHT;
+   this->WindowWidthHalf = this->WindowWidth / 2;
+   this->WindowHeightHalf = this->WindowHeight / 2;
+   this->MapMax = MAP_SIZE;
+   this->MapDensity = MAP_DENSITY;
+   this->DeferredShading = false;
+   this->ClusteredShading = false;
+   this->ShadowMapping = true;
+   this->ShadowSize = SHADOW_SIZE;
+   this->PointShadowSize = SHADOW_POINT_SIZE;
+   this->PointShadowRate = SHADOW_POINT_RATE;
+   this->PointLightCount = 0;
+   this->StaticBatching = true;
+   this->ImpostorRendering = true;
+   this->ImpostorDistance = IMPOSTOR_DISTANCE;
+   this->OcclusionCulling = true;
+   this->DepthPrePass = false;
+   this->OverdrawCounter = false;
+   this->ShowHud = false;
+   SDL_Log( "Golden options: %s\n", this->ReturnGoldenOptions().c_str() );
+}
 
-      this->ProjectionMatrix = this->camera.getProjectionMatrix();
-      this->ViewMatrix = this->camera.getViewMatrix();
+string Game::ReturnGoldenOptions() const{
+   ostringstream options;
+   options<<"width "<<this->WindowWidth
+      <<" height "<<this->WindowHeight
+      <<" map "<<this->MapMax
+      <<" density "<<this->MapDensity
+      <<" deferred "<<this->DeferredShading
+      <<" clustered "<<this->ClusteredShading
+      <<" shadows "<<this->ShadowMapping
+      <<" shadowsize "<<this->ShadowSize
+      <<" pointshadowsize "<<this->PointShadowSize
+      <<" pointshadowrate "<<this->PointShadowRate
+      <<" pointlights "<<this->PointLightCount
+      <<" staticbatch "<<this->StaticBatching
+      <<" impostors "<<this->ImpostorRendering
+      <<" impostordistance "<<this->ImpostorDistance
+      <<" occlusion "<<this->OcclusionCulling
+      <<" depthprepass "<<this->DepthPrePass;
+   return options.str();
+}
 
-      //Draw all models:
-      glUseProgram( this->ProgramID );
+void Game::RunGolden(){
+   //Camera position (xyz) and view direction (xyz):
+   static const GLfloat scenes[][6] = {
+      { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f },
+      { -14.0f, 6.0f, -14.0f, 1.0f, -0.4f, 1.0f },
+      { 10.0f, 0.5f, 0.0f, -1.0f, 0.0f, 0.2f },
+      { 0.0f, 1.0f, 12.0f, 0.0f, 0.3f, -1.0f },
+      { -14.0f, 2.0f, 14.0f, 1.0f, -0.1f, -1.0f }
+   };
+   const unsigned int count = sizeof( scenes ) / sizeof( scenes[0] );
+   if( ! this->Exit ){
+      this->Result = 1;
+      return;
+   }
+   SDL_Log( "\n" );
+   SDL_Log( "Golden: %s %u scenes, %s\n", this->GoldenUpdate ? "updating" : "comparing", count, this->GoldenDirectory.c_str() );
+   this->Animation = false;
+   const string timing_path = this->GoldenDirectory + "/timing.txt";
+   vector <float> reference_time( count, 0.0f );
+   fstream timing_file;
+   if( ! this->GoldenUpdate ){
+      timing_file.open( timing_path.c_str(), ios::in );
+      string InputString;
+      float InputFloat;
+      unsigned int scene;
+      while( timing_file>>InputString>>InputFloat ){
+         if( sscanf( InputString.c_str(), "scene%u", &scene ) == 1 and scene < count ){
+            reference_time[scene] = InputFloat;
+         }
+      }
+      timing_file.close();
+   }
+   //References from other pipeline would always differ:
+   const string options_path = this->GoldenDirectory + "/" GOLDEN_OPTIONS_FILE;
+   const string options = this->ReturnGoldenOptions();
+   if( ! this->GoldenUpdate ){
+      fstream options_file( options_path.c_str(), ios::in );
+      string reference_options;
+      if( ! getline( options_file, reference_options ) ){
+         SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Golden: can't read %s, create references with --golden-update\n", options_path.c_str() );
+         this->Result = 1;
+         return;
+      }
+      if( reference_options != options ){
+         SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Golden: references made with \"%s\", current options \"%s\"\n", reference_options.c_str(), options.c_str() );
+         this->Result = 1;
+         return;
+      }
+   }
+   const Uint64 frequency = SDL_GetPerformanceFrequency();
+   vector <float> frame_time( count, 0.0f );
+   GoldenImage image, reference, diff;
+   FrameSnapshot &snapshot = this->Snapshots.ReturnWrite();
+   unsigned int failed = 0, slower = 0;
+   for( unsigned int scene = 0; scene < count and this->Exit; ++scene ){
+      this->camera.SetView( vec3( scenes[scene][0], scenes[scene][1], scenes[scene][2] ), vec3( scenes[scene][3], scenes[scene][4], scenes[scene][5] ) );
+      this->BuildSnapshot( snapshot, 1.0f );
+      //Warm up, first frame at new position rebuilds caches:
+      this->Render( snapshot );
+      const Uint64 begin = SDL_GetPerformanceCounter();
+      for( unsigned int frame = 0; frame < GOLDEN_FRAMES; ++frame ){
+         this->Render( snapshot );
+      }
+      frame_time[scene] = float( double( SDL_GetPerformanceCounter() - begin ) * 1000.0 / double( frequency ) / GOLDEN_FRAMES );
+      image.Capture( this->WindowWidth, this->WindowHeight );
+      ostringstream name;
+      name<<this->GoldenDirectory<<"/scene"<<scene;
+      if( this->GoldenUpdate ){
+         if( ! image.Save( name.str() + ".png" ) ){
+            ++failed;
+         }
+         SDL_Log( "\rGolden scene %u: saved, %.3f ms\n", scene, frame_time[scene] );
+         continue;
+      }
+      float different = 1.0f;
+      if( reference.Load( name.str() + ".png" ) ){
+         different = image.Compare( reference, GOLDEN_THRESHOLD, &diff );
+      }
+      if( different > GOLDEN_TOLERANCE ){
+         ++failed;
+         image.Save( name.str() + "_actual.png" );
+         if( diff.ReturnWidth() == image.ReturnWidth() and diff.ReturnHeight() == image.ReturnHeight() ){
+            diff.Save( name.str() + "_diff.png" );
+         }
+      }
+      if( reference_time[scene] > 0.0f and frame_time[scene] > reference_time[scene] * GOLDEN_TIME_TOLERANCE ){
+         ++slower;
+      }
+      SDL_Log( "\rGolden scene %u: %s, %.4f%% different, %.3f ms (reference %.3f ms)\n",
+         scene,
+         different > GOLDEN_TOLERANCE ? "FAILED" : "OK",
+         different * 100.0f,
+         frame_time[scene],
+         reference_time[scene]
+      );
+   }
+   if( this->GoldenUpdate and failed == 0 ){
+      timing_file.open( timing_path.c_str(), ios::out );
+      if( timing_file.good() ){
+         for( unsigned int scene = 0; scene < count; ++scene ){
+            timing_file<<"scene"<<scene<<" "<<frame_time[scene]<<"\n";
+         }
+         timing_file.close();
+      }
+      timing_file.open( options_path.c_str(), ios::out );
+      if( timing_file.good() ){
+         timing_file<<options<<"\n";
+         timing_file.close();
+      }
+      else{
+         SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Golden: can't write %s\n", options_path.c_str() );
+         ++failed;
+      }
+   }
+   if( slower > 0 ){
+      SDL_LogWarn( SDL_LOG_CATEGORY_APPLICATION, "Golden: %u scenes slower than %.0f%% of reference time\n", slower, GOLDEN_TIME_TOLERANCE * 100.0f );
+   }
+   if( failed > 0 ){
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Golden: %u of %u scenes FAILED\n", failed, count );
+      this->Result = 1;
+   }
+   else{
+      SDL_Log( "Golden: all %u scenes OK\n", count );
+   }
+}
+
+void Game::RunBenchmark(){
+   if( ! this->Exit ){
+      this->Result = 1;
+      return;
+   }
+   SDL_Log( "\n" );
+   SDL_Log( "Benchmark: %u frames, map %i x %i, %i items, seed %u, %i x %i%s\n",
+      this->BenchmarkFrames,
+      this->MapMax,
+      this->MapMax,
+      this->MapItems,
+      this->Seed,
+      this->WindowWidth,
+      this->WindowHeight,
+      this->Headless ? " (headless)" : ""
+   );
+   //Measured frames not limited by display:
+   const int present_mode = this->PresentMode;
+   const int frame_limit = this->FrameLimit;
+   if( ! this->Headless ){
+      this->PresentMode = PRESENT_UNCAPPED;
+      this->FrameLimit = 0;
+      this->SetPresentMode();
+   }
+   this->Bench.Clear();
+   this->Bench.AddInfo( "build", __DATE__ " " __TIME__ );
+   this->Bench.AddInfo( "renderer", (const char*)glGetString( GL_RENDERER ) );
+   this->Bench.AddInfo( "version", (const char*)glGetString( GL_VERSION ) );
+   this->Bench.AddSetting( "width", this->WindowWidth );
+   this->Bench.AddSetting( "height", this->WindowHeight );
+   this->Bench.AddSetting( "headless", this->Headless );
+   this->Bench.AddSetting( "map", this->MapMax );
+   this->Bench.AddSetting( "density", this->MapDensity );
+   this->Bench.AddSetting( "items", this->MapItems );
+   this->Bench.AddSetting( "seed", this->Seed );
+   this->Bench.AddSetting( "frames", this->BenchmarkFrames );
+   this->Bench.AddSetting( "warmup", BENCHMARK_WARMUP );
+   this->Bench.AddSetting( "threads", this->Jobs.ReturnThreads() );
+   this->Bench.AddSetting( "shadows", this->ShadowMapping );
+   this->Bench.AddSetting( "deferred", this->DeferredShading );
+   this->Bench.AddSetting( "clustered", this->ClusteredShading );
+   this->Bench.AddSetting( "pointlights", this->PointLights.size() );
+   this->Bench.AddSetting( "depthprepass", this->DepthPrePass );
+   this->Bench.AddSetting( "occlusion", this->OcclusionCulling );
+   this->Bench.AddSetting( "staticbatching", this->StaticBatching );
+   this->Bench.AddSetting( "impostors", this->ImpostorRendering );
+   const GLfloat dt = this->SimulationStep / 1000.0f;
+   const unsigned int frames = BENCHMARK_WARMUP + this->BenchmarkFrames;
+   FrameSnapshot &snapshot = this->Snapshots.ReturnWrite();
+   TimerStats cpu, gpu;
+   unsigned int cpu_count = 0, gpu_count = 0;
+   GLint memory_total = 0, memory_available = 0;
+   GLfloat t;
+   vec3 position;
+   SDL_Event event;
+   unsigned int frame;
+   for( frame = 0; frame < frames and this->Exit; ++frame ){
+      if( ! this->Headless ){
+         while( SDL_PollEvent( &event ) ){
+            if( event.type == SDL_QUIT or ( event.type == SDL_KEYDOWN and event.key.keysym.sym == SDLK_ESCAPE ) ){
+               this->Exit = false;
+            }
+         }
+      }
+      //Warm up frames on path before start:
+      t = ( GLfloat( frame ) - BENCHMARK_WARMUP ) / GLfloat( this->BenchmarkFrames );
+      position = Benchmark::ReturnPath( t, this->MapMaxHalf );
+      this->camera.SetView( position, Benchmark::ReturnPath( t + 0.01f, this->MapMaxHalf ) - position );
+      //One step per frame, same result for each run:
+      this->Simulate( dt );
+      this->BuildSnapshot( snapshot, 1.0f );
+      snapshot.Steps = 1;
+      this->Render( snapshot );
+      cpu = this->Timers.ReturnCpu( TIMER_FRAME );
+      gpu = this->Timers.ReturnGpu( TIMER_FRAME );
+      if( frame >= BENCHMARK_WARMUP ){
+         this->Bench.Add( BENCHMARK_FRAME, this->Pacer.ReturnLast() );
+         if( cpu.Count != cpu_count ){
+            this->Bench.Add( BENCHMARK_CPU, cpu.Last );
+         }
+         //GPU result of some earlier frame:
+         if( gpu.Count != gpu_count ){
+            this->Bench.Add( BENCHMARK_GPU, gpu.Last );
+         }
+         this->Bench.Add( BENCHMARK_DRAWS, this->FrameDrawCalls );
+         this->Bench.Add( BENCHMARK_TRIANGLES, this->FrameTriangles );
+         if( GLEW_NVX_gpu_memory_info ){
+            glGetIntegerv( GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &memory_total );
+            glGetIntegerv( GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &memory_available );
+            this->Bench.Add( BENCHMARK_MEMORY, ( memory_total - memory_available ) / 1024.0f );
+         }
+         this->Bench.Add( BENCHMARK_CPU_TRACKED, MemoryTracker::ReturnTotal( MEMORY_CPU ).Bytes / ( 1024.0f * 1024.0f ) );
+         this->Bench.Add( BENCHMARK_GPU_TRACKED, MemoryTracker::ReturnTotal( MEMORY_GPU ).Bytes / ( 1024.0f * 1024.0f ) );
+      }
+      cpu_count = cpu.Count;
+      gpu_count = gpu.Count;
+   }
+   this->PresentMode = present_mode;
+   this->FrameLimit = frame_limit;
+   if( frame < frames ){
+      SDL_LogWarn( SDL_LOG_CATEGORY_APPLICATION, "Benchmark: stopped after %u of %u frames\n", frame, frames );
+      this->Result = 1;
+      return;
+   }
+   for( unsigned int i = 0; i < MEMORY_TAGS; ++i ){
+      this->Bench.AddMemory( MemoryTracker::ReturnName( i ), MemoryTracker::ReturnStats( i, MEMORY_CPU ), MemoryTracker::ReturnStats( i, MEMORY_GPU ) );
+   }
+   this->Bench.AddMemory( "total", MemoryTracker::ReturnTotal( MEMORY_CPU ), MemoryTracker::ReturnTotal( MEMORY_GPU ) );
+   this->Bench.Log();
+   if( ! this->Bench.Save( this->BenchmarkPath ) ){
+      this->Result = 1;
+   }
+}
+
+void Game::SetHeadlessCamera( unsigned int frame ){
+   const GLfloat angle = 2.0f * M_PI * GLfloat( frame ) / GLfloat( this->HeadlessFrames );
+   const GLfloat radius = this->MapMaxHalf * 0.75f;
+   const vec3 position( radius * sin( angle ), 1.0f, radius * cos( angle ) );
+   this->camera.SetView( position, vec3( -position.x, -0.5f, -position.z ) );
+}
+
+void Game::Present(){
+   PROFILE_SCOPE( "Game::Present" );
+   if( this->Headless ){
+      this->HeadlessGL.Present();
+   }
+   else{
+      this->Pacer.Wait();
+      SDL_GL_SwapWindow( this->Window );
+   }
+   this->Pacer.EndFrame();
+}
+
+void Game::SetPresentMode(){
+   static const char *names[] = { "uncapped", "vsync", "adaptive vsync" };
+   static const int intervals[] = { 0, 1, -1 };
+   if( SDL_GL_SetSwapInterval( intervals[this->PresentMode] ) != 0 ){
+      SDL_LogWarn( SDL_LOG_CATEGORY_VIDEO, "SDL_GL_SetSwapInterval( %i ): %s\n", intervals[this->PresentMode], SDL_GetError() );
+      if( this->PresentMode == PRESENT_ADAPTIVE ){
+         this->PresentMode = PRESENT_VSYNC;
+         SDL_GL_SetSwapInterval( intervals[this->PresentMode] );
+      }
+   }
+   //Expected frame time, frames longer than refresh are late:
+   SDL_DisplayMode mode;
+   if( this->PresentMode != PRESENT_UNCAPPED and SDL_GetWindowDisplayMode( this->Window, &mode ) == 0 ){
+      this->Pacer.SetRefresh( mode.refresh_rate );
+   }
+   else{
+      this->Pacer.SetRefresh( 0 );
+   }
+   this->Pacer.SetLimit( this->FrameLimit );
+   SDL_Log( "Present mode: %s, frame limit: %i\n", names[this->PresentMode], this->FrameLimit );
+}
+
+void Game::DrawHud(){
+   PROFILE_SCOPE( "Game::DrawHud" );
+   const Uint64 begin = SDL_GetPerformanceCounter();
+   if( this->HudMemory.empty() ){
+      this->UpdateHudMemory();
+   }
+   const TimerStats cpu = this->Timers.ReturnCpu( TIMER_FRAME );
+   const TimerStats gpu = this->Timers.ReturnGpu( TIMER_FRAME );
+   char gpu_text[32] = "n/a";
+   if( gpu.Samples > 0 ){
+      snprintf( gpu_text, sizeof( gpu_text ), "%6.3f ms", gpu.Average );
+   }
+   const MemoryStats memory_cpu = MemoryTracker::ReturnTotal( MEMORY_CPU );
+   const MemoryStats memory_gpu = MemoryTracker::ReturnTotal( MEMORY_GPU );
+   const float megabyte = 1.0f / ( 1024.0f * 1024.0f );
+   char text[512];
+   snprintf( text, sizeof( text ),
+      "Frame %6.2f ms  max %6.2f ms  Score %i\n"
+      "CPU   %6.3f ms  GPU %s\n"
+      "Draws %u  Triangles %u  States %u\n"
+      "Visible %u  Culled %u  Occluded %u\n"
+      "Chunks %u  Batches %u  Impostors %u\n"
+      "%s\n"
+      "CPU mem %6.1f MB  peak %6.1f  steady %6.1f\n"
+      "GPU mem %6.1f MB  peak %6.1f  steady %6.1f\n"
+      "HUD   %6.3f ms  %u quads",
+      this->Pacer.ReturnLast(),
+      this->Overlay.ReturnMax(),
+      this->ScoreRendered,
+      cpu.Average,
+      gpu_text,
+      this->FrameDrawCalls,
+      this->FrameTriangles,
+      this->FrameStateChanges,
+      this->FrameVisible,
+      this->FrameCulled,
+      this->FrameOccluded,
+      this->Grid.ReturnChunksVisible(),
+      this->FrameBatches,
+      this->FrameImpostors,
+      this->HudMemory.c_str(),
+      memory_cpu.Bytes * megabyte,
+      memory_cpu.Peak * megabyte,
+      memory_cpu.Steady * megabyte,
+      memory_gpu.Bytes * megabyte,
+      memory_gpu.Peak * megabyte,
+      memory_gpu.Steady * megabyte,
+      this->HudTime,
+      this->Overlay.ReturnQuads()
+   );
+   //Graph below 9 lines of text, line = target frame time:
+   const GLfloat x = 8.0f, y = 8.0f, graph = 60.0f;
+   const GLfloat text_height = 9 * HUD_FONT_HEIGHT + 4;
+   const double target = this->Pacer.ReturnTarget();
+   this->Overlay.Begin( this->WindowWidth, this->WindowHeight );
+   this->Overlay.Rect( x - 4, y - 4, 46 * HUD_FONT_WIDTH + 8, text_height + graph + 8, HUD_BACKGROUND );
+   this->Overlay.Text( x, y, text );
+   this->Overlay.Graph( x, y + text_height, graph, target > 0.0 ? float( target ) : 1000.0f / 60.0f );
+   this->Overlay.Draw();
+   this->HudTime = float( double( SDL_GetPerformanceCounter() - begin ) * 1000.0 / double( SDL_GetPerformanceFrequency() ) );
+}
+
+void Game::UpdateHudMemory(){
+   GLint memory[4] = { 0, 0, 0, 0 };
+   char text[64];
+   if( GLEW_NVX_gpu_memory_info ){
+      GLint total = 0;
+      glGetIntegerv( GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &total );
+      glGetIntegerv( GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, memory );
+      snprintf( text, sizeof( text ), "VRAM  %i / %i MB used", ( total - memory[0] ) / 1024, total / 1024 );
+   }
+   else if( GLEW_ATI_meminfo ){
+      GLint buffers[4] = { 0, 0, 0, 0 };
+      glGetIntegerv( GL_TEXTURE_FREE_MEMORY_ATI, memory );
+      glGetIntegerv( GL_VBO_FREE_MEMORY_ATI, buffers );
+      snprintf( text, sizeof( text ), "Free  textures %i MB  buffers %i MB", memory[0] / 1024, buffers[0] / 1024 );
+   }
+   else{
+      snprintf( text, sizeof( text ), "VRAM  n/a" );
+   }
+   this->HudMemory = text;
+}
+
+Sint64 Game::ReturnMapMemory() const{
+   return 2 * Sint64( this->MapMax ) * ( sizeof( vector <int> ) + this->MapMax * sizeof( int ) );
+}
+
+void Game::SetModelUniforms( bool gbuffer ){
+   if( gbuffer ){
+      Model::ModelUniformId = & this->ModelUniformGBuffer;
+      Model::TextureUniformId = & this->TextureUniformGBuffer;
+      Model::TextureSpecularUniformId = & this->TextureSpecularUniformGBuffer;
+      Model::AmbientUniformId = & this->AmbientUniformGBuffer;
+      Model::DiffuseUniformId = & this->DiffuseUniformGBuffer;
+      Model::SpecularUniformId = & this->SpecularUniformGBuffer;
+      Model::ShininessUniformId = & this->ShininessUniformGBuffer;
+   }
+   else{
+      Model::ModelUniformId = & this->ModelUniformId;
+      Model::TextureUniformId = & this->TextureUniformId;
+      Model::TextureSpecularUniformId = & this->TextureSpecularUniformId;
+      Model::AmbientUniformId = & this->AmbientUniformId;
+      Model::DiffuseUniformId = & this->DiffuseUniformId;
+      Model::SpecularUniformId = & this->SpecularUniformId;
+      Model::ShininessUniformId = & this->ShininessUniformId;
+   }
+}
+
+void Game::ShadeDeferred(){
+   this->Timers.Begin( TIMER_DEFERRED );
+   this->Deferred.Shade( this->ProjectionMatrix * this->ViewMatrix, this->PointLights );
+   this->Timers.End( TIMER_DEFERRED );
+}
+
+void Game::UpdatePointLights(){
+   //Second light, same attenuation as PointAttenuation[0] in UploadFrameData():
+   PointLightData &light = this->PointLights[0];
+   light.PositionRadius = vec4( this->SunMoving.ReturnPosition(), DeferredRenderer::LightRadius( vec3( light.Attenuation ), vec3( light.Color ) ) );
+}
+
+void Game::UpdateClusters(){
+   PROFILE_SCOPE( "Game::UpdateClusters" );
+   glUseProgram( this->ProgramID );
+   glUniform1i( this->ClusteredUniform, this->ClusteredShading );
+   if( ! this->ClusteredShading ){
+      return;
+   }
+   this->Timers.Begin( TIMER_CLUSTERS );
+   this->Clusters.Bin( this->ViewMatrix, this->ProjectionMatrix, this->PointLights );
+   this->Clusters.Upload( this->PointLights );
+   this->Clusters.Bind();
+   glUniform4fv( this->ClusterParametersUniform, 1, value_ptr( this->Clusters.ReturnParameters( this->WindowWidth, this->WindowHeight ) ) );
+   this->Timers.End( TIMER_CLUSTERS );
+}
+
+void Game::Simulate( GLfloat dt ){
+   PROFILE_SCOPE( "Game::Simulate" );
+   //State before step for Render():
+   this->camera.BeginStep();
+   this->CoinAnglePrevious = this->CoinAngle;
+   this->SunMovingDegreesePrevious = this->SunMovingDegreese;
+
+   //Movement while key is held, not per key repeat:
+   if( this->MoveKeys ){
+      const GLfloat scale = this->MovementRate * dt;
+      if( this->MoveKeys & INPUT_MOVE_FORWARD ){
+         this->camera.MoveForward( scale );
+      }
+      if( this->MoveKeys & INPUT_MOVE_BACKWARD ){
+         this->camera.MoveBackward( scale );
+      }
+      if( this->MoveKeys & INPUT_MOVE_LEFT ){
+         this->camera.MoveLeft( scale );
+      }
+      if( this->MoveKeys & INPUT_MOVE_RIGHT ){
+         this->camera.MoveRight( scale );
+      }
+      if( this->MoveKeys & INPUT_MOVE_UP ){
+         this->camera.MoveUp( scale );
+      }
+      if( this->MoveKeys & INPUT_MOVE_DOWN ){
+         this->camera.MoveDown( scale );
+      }
+   }
+
+   if( this->CollectCoin ){
+      this->CollectCoin = false;
+      this->CheckCoin();
+   }
+
+   if( this->Animation ){
+      //Rotate coin:
+      this->CoinAngle += this->RotateFloat * dt;
+      if( this->CoinAngle >= 360.0f ){
+         this->CoinAngle -= 360.0f;
+         this->CoinAnglePrevious -= 360.0f;
+      }
+      //Move second light:
+      this->SunMovingDegreese += this->SunMovingSpeed * dt;
+      if( this->SunMovingDegreese >= 360.0f ){
+         this->SunMovingDegreese -= 360.0f;
+         this->SunMovingDegreesePrevious -= 360.0f;
+      }
+   }
+}
 
-      //Matrix:
-      glUniformMatrix4fv( this->ViewUniformId, 1, GL_FALSE, value_ptr( this->ViewMatrix ) );
-      glUniformMatrix4fv( this->ProjectionUniformId, 1, GL_FALSE, value_ptr( this->ProjectionMatrix  ) );
+void Game::BuildSnapshot( FrameSnapshot &snapshot, GLfloat alpha ){
+   //Between last two simulation steps:
+   this->camera.SetInterpolation( alpha );
+   snapshot.View = this->camera.getViewMatrix();
+   snapshot.Projection = this->camera.getProjectionMatrix();
+   snapshot.Position = this->camera.ReturnRenderPosition();
+   snapshot.Far = this->camera.ReturnFar().x;
+   snapshot.CoinAngle = this->CoinAnglePrevious + ( this->CoinAngle - this->CoinAnglePrevious ) * alpha;
+   snapshot.CoinX = this->CoinX;
+   snapshot.CoinZ = this->CoinZ;
+   snapshot.Score = this->Score;
+   this->SunMovingRadian = ( this->SunMovingDegreesePrevious + ( this->SunMovingDegreese - this->SunMovingDegreesePrevious ) * alpha ) * ( M_PI / 180 );
+   snapshot.SunMovingPosition = vec3( this->SunMovingRadius * sin( this->SunMovingRadian ), this->SunMovingPosition.y, this->SunMovingRadius * cos( this->SunMovingRadian ) );
+   snapshot.Focus = this->Focus;
+   snapshot.Steps = 0;
+   snapshot.Dropped = 0;
+   snapshot.SimulationTime = 0;
+   snapshot.InputTime = SDL_GetPerformanceCounter();
+}
 
-      //Directional light:
-      glUniform3fv( this->LightPositionUniformId, 1, value_ptr( this->Sun.ReturnPosition() ) );
-      glUniform3fv( this->LightAmbientUniformId , 1, value_ptr( this->Sun.ReturnAmbient() ) );
-      glUniform3fv( this->LightDiffuseUniformId , 1, value_ptr( this->Sun.ReturnDiffuse() ) );
-      glUniform3fv( this->LightSpecularUniformId , 1, value_ptr( this->Sun.ReturnSpecular() ) );
+void Game::Render( const FrameSnapshot &snapshot ){
+   PROFILE_SCOPE( "Game::Render" );
+   //State from simulation:
+   this->ViewMatrix = snapshot.View;
+   this->ProjectionMatrix = snapshot.Projection;
+   this->ViewPosition = snapshot.Position;
+   this->ViewFar = snapshot.Far;
+   vector <SDL_Event>::const_iterator event;
+   for( event = snapshot.Events.begin(); event != snapshot.Events.end(); ++event ){
+      this->HandleRenderEvent( *event );
+   }
+   this->SimulationSteps += snapshot.Steps;
+   this->SimulationDropped += snapshot.Dropped;
+   this->SimulationTime += snapshot.SimulationTime;
+   if( snapshot.CoinX != this->CoinRenderedX or snapshot.CoinZ != this->CoinRenderedZ ){
+      this->MoveCoin( snapshot.CoinX, snapshot.CoinZ );
+   }
+   this->ScoreRendered = snapshot.Score;
+   if( snapshot.Focus ){
+      this->TimerBegin = SDL_GetTicks();
 
-      //Camera position:
-      glUniform3fv( this->ViewPosUniformId, 1, value_ptr( this->camera.ReturnPosition() ) );
+      if( snapshot.CoinAngle != this->CoinAngleRendered ){
+         this->Models[1].Rotate( snapshot.CoinAngle - this->CoinAngleRendered, this->RotateVec );
+         this->CoinAngleRendered = snapshot.CoinAngle;
+      }
+      this->tmp_vector = snapshot.SunMovingPosition;
+      this->SunMoving.ChangePosition( this->tmp_vector );
 
-      //Point light:
-      glUniform3fv( PointLight_Position_Uniform[0], 1, value_ptr( this->SunMoving.ReturnPosition() ) );
-      /*
-      Distance     Constant     Linear     Quadratic
-      7            1.0          0.7        1.8
-      13           1.0          0.35       0.44
-      20           1.0          0.22       0.20
-      32           1.0          0.14       0.07
-      50           1.0          0.09       0.032
-      65           1.0          0.07       0.017
-      100          1.0          0.045      0.0075
-      160          1.0          0.027      0.0028
-      200          1.0          0.022      0.0019
-      325          1.0          0.014      0.0007
-      600          1.0          0.007      0.0002
-      3250         1.0          0.0014     0.000007
-      */
-      glUniform1f( PointLight_Constant_Uniform[0], 1.0f );
-      glUniform1f( PointLight_Linear_Uniform[0], 0.07f );
-      glUniform1f( PointLight_Quadratic_Uniform[0], 0.017f );
+      this->Timers.BeginFrame();
+      this->Timers.Begin( TIMER_FRAME );
+      glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+      this->FrameDrawCalls = 0;
+      this->FrameTriangles = 0;
 
-      //Draw all objects:
+      //Frustum culling:
+      this->ViewFrustum = Frustum( this->ProjectionMatrix * this->ViewMatrix );
+      this->FrameVisible = 0;
+      this->FrameCulled = 0;
       for( this->It = this->Models.begin();this->It != this->Models.end(); ++this->It ){
-         this->It->Draw();
+         if( ! this->Grid.Contains( this->It - this->Models.begin() ) ){
+            this->It->Cull( this->ViewFrustum );
+         }
+      }
+      //Objects placed on map, whole chunks first, merged static objects are culled as whole batches:
+      if( this->StaticBatching ){
+         this->Grid.Cull( this->ViewFrustum, this->Models, this->StaticWorld.ReturnStaticModels() );
+      }
+      else{
+         this->Grid.Cull( this->ViewFrustum, this->Models );
+      }
+      //Merged meshes of static objects:
+      this->FrameBatches = 0;
+      if( this->StaticBatching ){
+         this->StaticWorld.Update( this->Grid, this->Models );
+         this->StaticWorld.Cull( this->ViewFrustum );
+      }
+      //Frustum results, before occlusion (ReturnCulled() includes occluded objects later):
+      for( this->It = this->Models.begin();this->It != this->Models.end(); ++this->It ){
+         if( this->StaticBatching and this->StaticWorld.IsStatic( this->It - this->Models.begin() ) ){
+            continue;
+         }
+         this->FrameVisible += this->It->ReturnVisible();
+         this->FrameCulled += this->It->ReturnCulled();
       }
+      //Static objects counted as batches:
+      if( this->StaticBatching ){
+         this->FrameVisible += this->StaticWorld.ReturnVisibleIndex().size();
+         this->FrameCulled += this->StaticWorld.ReturnBatches() - this->StaticWorld.ReturnVisibleIndex().size();
+      }
+      //Objects hidden behind trees and rocks, counted only once:
+      this->FrameOccluded = 0;
+      if( this->OcclusionCulling ){
+         this->CullOccluded();
+         this->FrameVisible -= this->FrameOccluded;
+      }
+      if( this->StaticBatching ){
+         this->FrameBatches = this->StaticWorld.ReturnVisibleIndex().size();
+      }
+
+      //Sorted draw list:
+      this->FillQueue();
 
-      //Draw lights:
-      glUseProgram( this->LightID );
-      glUniformMatrix4fv( this->ViewUniformLight, 1, GL_FALSE, value_ptr( this->ViewMatrix ) );
-      glUniformMatrix4fv( this->ProjectionUniformLight, 1, GL_FALSE, value_ptr( this->ProjectionMatrix  ) );
+      //Camera, lights:
+      this->FrameRing.BeginFrame();
+      this->DrawShadows();
+      this->UploadFrameData( this->ViewMatrix, this->ProjectionMatrix );
 
       //Draw Collision Square:
       /*
@@ -1029,38 +3040,492 @@ void Game::Update(){
       }
       */
 
-      //Draw light 1:
-      this->Sun.Draw();
-      //Draw light 2:
-      this->SunMoving.Draw();
+      //Point lights for deferred or clustered shading:
+      if( this->DeferredShading or this->ClusteredShading ){
+         this->UpdatePointLights();
+      }
+      if( ! this->DeferredShading and this->Clusters.IsCreated() ){
+         this->UpdateClusters();
+      }
 
-      glUseProgram( 0 );
-      SDL_GL_SwapWindow( this->Window );
+      //G-buffer instead of window:
+      this->SetModelUniforms( this->DeferredShading );
+      if( this->DeferredShading ){
+         this->Deferred.BeginGeometry();
+      }
+
+      //Depth only:
+      if( this->DepthPrePass ){
+         this->Timers.Begin( TIMER_DEPTH );
+         glUseProgram( this->DepthID );
+         this->DrawDepthPrePass();
+         this->Timers.End( TIMER_DEPTH );
+      }
 
-      if( this->TimerBegin >= this->TimerUpdate ){
-         //Rotate coin:
-         this->Models[1].Rotate( this->RotateFloat, this->RotateVec );
-         this->TimerUpdate = this->TimerBegin + this->TimerUpdateTime;
+      //Draw all objects and lights:
+      this->DrawQueue();
+      this->FrameRing.EndFrame();
 
-         //Move second light:
-         this->SunMovingDegreese = fmod( this->SunMovingDegreese, 360.0f );
-         this->SunMovingRadian = this->SunMovingDegreese * ( M_PI / 180 );
-         this->SunMovingPosition.x =  this->SunMovingRadius * sin( this->SunMovingRadian );
-         this->SunMovingPosition.z = this->SunMovingRadius * cos( this->SunMovingRadian );
-         this->SunMoving.ChangePosition( this->SunMovingPosition );
-         this->SunMovingDegreese += 0.25f;
+      glUseProgram( 0 );
+      this->Timers.End( TIMER_FRAME );
+      if( this->ShowHud ){
+         this->DrawHud();
       }
+      this->Present();
+      this->Overlay.AddFrame( this->Pacer.ReturnLast() );
+      this->Latency += SDL_GetPerformanceCounter() - snapshot.InputTime;
+
       ++this->FPS;
       if( this->TimerBegin >= this->TimerEnd ){
-         SDL_Log( "\r[%i] FPS: %i", this->TimerBegin / 1000, this->FPS );
+         SDL_Log( "\r[%i] FPS: %i   Visible: %u   Culled: %u   Occluded: %u   Chunks: %u   Batches: %u   Impostors: %u   States: %u   Sort: %.3f ms",
+            this->TimerBegin / 1000,
+            this->FPS,
+            this->FrameVisible,
+            this->FrameCulled,
+            this->FrameOccluded,
+            this->Grid.ReturnChunksVisible(),
+            this->FrameBatches,
+            this->FrameImpostors,
+            this->FrameStateChanges,
+            this->FrameSortTime
+         );
+         if( this->SimulationSteps > 0 or this->SimulationDropped > 0 ){
+            SDL_Log( "\rSimulation: %u steps of %i ms, %u dropped, %.3f ms",
+               this->SimulationSteps,
+               this->SimulationStep,
+               this->SimulationDropped,
+               double( this->SimulationTime ) * 1000.0 / double( SDL_GetPerformanceFrequency() )
+            );
+            SDL_Log( "\rLatency: %.3f ms from input to present (%s)",
+               double( this->Latency ) * 1000.0 / double( SDL_GetPerformanceFrequency() ) / this->FPS,
+               this->Threaded ? "render thread" : "single thread"
+            );
+         }
+         if( this->Pacer.ReturnFrames() > 0 ){
+            SDL_Log( "\rFrame time: %.3f ms average, %.3f ms deviation, %.3f ms max, %u late (over %.3f ms)",
+               this->Pacer.ReturnAverage(),
+               this->Pacer.ReturnDeviation(),
+               this->Pacer.ReturnMax(),
+               this->Pacer.ReturnLate(),
+               this->Pacer.ReturnTarget() * PACER_LATE
+            );
+            this->Pacer.Reset();
+         }
+         if( this->OverdrawCounter ){
+            SDL_Log( "\rOverdraw: %.2f fragments per pixel%s", this->FrameOverdraw, this->DepthPrePass ? " (depth pre-pass)" : "" );
+         }
+         if( this->ShadowMapping and ! this->DeferredShading ){
+            SDL_Log( "\rShadows: static map drawn %u times", this->Shadow.ReturnStaticUpdates() );
+         }
+         if( this->DeferredShading ){
+            SDL_Log( "\rDeferred: %u point lights", this->Deferred.ReturnLights() );
+         }
+         else if( this->ClusteredShading ){
+            SDL_Log( "\rClusters: %u / %u point lights visible, %u light indices, %u dropped",
+               this->Clusters.ReturnVisible(),
+               (unsigned int)this->PointLights.size(),
+               (unsigned int)this->Clusters.ReturnIndices().size(),
+               this->Clusters.ReturnOverflow()
+            );
+         }
+         if( this->TimerLog ){
+            this->Timers.Log();
+         }
+         this->HudMemory.clear();
          this->FPS = 0;
+         this->SimulationSteps = 0;
+         this->SimulationDropped = 0;
+         this->SimulationTime = 0;
+         this->Latency = 0;
          this->TimerEnd  = this->TimerBegin + 1000;
       }
    }
 }
 
+void Game::UploadFrameData( const mat4 &view, const mat4 &projection ){
+   FrameData *data = NULL;
+   const GLintptr offset = this->FrameRing.Allocate( sizeof( FrameData ), this->UniformAlignment, (void **)&data );
+   if( offset < 0 ){
+      return;
+   }
+   data->View = view;
+   data->Projection = projection;
+   data->ViewPos = vec4( this->ViewPosition, 1.0f );
+   //Directional light:
+   data->SunPosition = vec4( this->Sun.ReturnPosition(), 1.0f );
+   data->SunAmbient = vec4( this->Sun.ReturnAmbient(), 0.0f );
+   data->SunDiffuse = vec4( this->Sun.ReturnDiffuse(), 0.0f );
+   data->SunSpecular = vec4( this->Sun.ReturnSpecular(), 0.0f );
+   //Point light:
+   data->PointPosition[0] = vec4( this->SunMoving.ReturnPosition(), 1.0f );
+   /*
+   Distance     Constant     Linear     Quadratic
+   7            1.0          0.7        1.8
+   13           1.0          0.35       0.44
+   20           1.0          0.22       0.20
+   32           1.0          0.14       0.07
+   50           1.0          0.09       0.032
+   65           1.0          0.07       0.017
+   100          1.0          0.045      0.0075
+   160          1.0          0.027      0.0028
+   200          1.0          0.022      0.0019
+   325          1.0          0.014      0.0007
+   600          1.0          0.007      0.0002
+   3250         1.0          0.0014     0.000007
+   */
+   data->PointAttenuation[0] = vec4( 1.0f, 0.07f, 0.017f, 0.0f );
+   this->FrameRing.Flush();
+   glBindBufferRange( GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, this->FrameRing.ReturnBuffer(), offset, sizeof( FrameData ) );
+}
+
+bool Game::BindFrameData( GLuint program ){
+   const GLuint index = glGetUniformBlockIndex( program, "FrameData" );
+   if( index == GL_INVALID_INDEX ){
+      return false;
+   }
+   glUniformBlockBinding( program, index, FRAME_DATA_BINDING );
+   return true;
+}
+
+void Game::FillQueue(){
+   PROFILE_SCOPE( "Game::FillQueue" );
+   this->Queue.Clear();
+   this->Impostors.Clear();
+   const bool impostors = this->ImpostorRendering and this->ImpostorDistance < this->ViewFar;
+   this->tmp_vector = this->ViewPosition;
+   this->tmp_float = this->ViewFar;
+   GLfloat depth;
+   unsigned int model;
+   vector <GLuint>::const_iterator it;
+   for( this->It = this->Models.begin(); this->It != this->Models.end(); ++this->It ){
+      model = this->It - this->Models.begin();
+      if( this->StaticBatching and this->StaticWorld.IsStatic( model ) ){
+         continue;
+      }
+      const vector <GLuint> &visible = this->It->ReturnVisibleIndex();
+      for( it = visible.begin(); it != visible.end(); ++it ){
+         depth = length( vec3( this->It->ReturnMatrix( *it )[3] ) - this->tmp_vector );
+         if( impostors and depth > this->ImpostorDistance and this->Impostors.Has( model ) ){
+            this->Impostors.Add( model, this->It->ReturnMatrix( *it ) );
+            continue;
+         }
+         depth /= this->tmp_float;
+         this->Command.Type = RENDER_MODEL;
+         this->Command.Object = model;
+         this->Command.Instance = *it;
+         this->Queue.Push( RenderQueue::MakeKey( RENDER_PASS_OPAQUE, RENDER_PROGRAM_MODEL, this->It->ReturnTexture(), model, depth ), this->Command );
+      }
+   }
+   //Merged static meshes:
+   if( this->StaticBatching ){
+      const vector <GLuint> &batches = this->StaticWorld.ReturnVisibleIndex();
+      for( it = batches.begin(); it != batches.end(); ++it ){
+         const BatchMesh &batch = this->StaticWorld.ReturnBatch( *it );
+         //Whole chunk far away, every object as impostor:
+         if( impostors and this->Impostors.Has( batch.Model ) and
+             length( clamp( this->tmp_vector, batch.Min, batch.Max ) - this->tmp_vector ) > this->ImpostorDistance
+         ){
+            const vector <GridItem> &items = this->Grid.ReturnChunk( batch.ChunkX, batch.ChunkZ ).Items[batch.Model];
+            vector <GridItem>::const_iterator it_item;
+            for( it_item = items.begin(); it_item != items.end(); ++it_item ){
+               if( this->ViewFrustum.TestBox( it_item->Min, it_item->Max ) != FRUSTUM_OUTSIDE ){
+                  this->Impostors.Add( batch.Model, this->Models[batch.Model].ReturnMatrix( it_item->Index ) );
+               }
+            }
+            continue;
+         }
+         depth = length( ( batch.Min + batch.Max ) * 0.5f - this->tmp_vector ) / this->tmp_float;
+         this->Command.Type = RENDER_BATCH;
+         this->Command.Object = *it;
+         this->Command.Instance = 0;
+         this->Queue.Push( RenderQueue::MakeKey( RENDER_PASS_OPAQUE, RENDER_PROGRAM_MODEL, this->Models[batch.Model].ReturnTexture(), STATICBATCH_MESH, depth ), this->Command );
+      }
+   }
+   //All impostors in one instanced draw:
+   this->FrameImpostors = this->Impostors.ReturnCount();
+   if( this->FrameImpostors > 0 ){
+      this->Command.Type = RENDER_IMPOSTOR;
+      this->Command.Object = 0;
+      this->Command.Instance = 0;
+      this->Queue.Push( RenderQueue::MakeKey( RENDER_PASS_IMPOSTOR, RENDER_PROGRAM_IMPOSTOR, 0, 0, 0.0f ), this->Command );
+   }
+   //Lights, 0 = Sun, 1 = SunMoving:
+   this->Command.Type = RENDER_LIGHT;
+   this->Command.Instance = 0;
+   this->Command.Object = 0;
+   depth = length( this->Sun.ReturnPosition() - this->tmp_vector ) / this->tmp_float;
+   this->Queue.Push( RenderQueue::MakeKey( RENDER_PASS_LIGHT, RENDER_PROGRAM_LIGHT, 0, 0, depth ), this->Command );
+   this->Command.Object = 1;
+   depth = length( this->SunMoving.ReturnPosition() - this->tmp_vector ) / this->tmp_float;
+   this->Queue.Push( RenderQueue::MakeKey( RENDER_PASS_LIGHT, RENDER_PROGRAM_LIGHT, 0, 1, depth ), this->Command );
+   this->Queue.Sort();
+   this->FrameSortTime = this->Queue.ReturnSortTime();
+}
+
+void Game::DrawQueue(){
+   PROFILE_SCOPE( "Game::DrawQueue" );
+   this->FrameStateChanges = 0;
+   GLuint pass = 0xFFFFFFFF, program = 0xFFFFFFFF, material = 0xFFFFFFFF, mesh = 0xFFFFFFFF;
+   GLuint64 key;
+   bool shaded = ! this->DeferredShading;
+   for( unsigned int i = 0; i < this->Queue.ReturnSize(); ++i ){
+      key = this->Queue.ReturnKey( i );
+      const RenderCommand &command = this->Queue.ReturnCommand( i );
+      if( RenderQueue::KeyPass( key ) != pass ){
+         if( pass != 0xFFFFFFFF ){
+            this->Timers.End( TIMER_PASS + pass );
+         }
+         pass = RenderQueue::KeyPass( key );
+         //Lighting after G-buffer, next passes are drawn into light buffer:
+         if( ! shaded and pass != RENDER_PASS_OPAQUE ){
+            this->ShadeDeferred();
+            shaded = true;
+            program = material = mesh = 0xFFFFFFFF;
+         }
+         this->Timers.Begin( TIMER_PASS + pass );
+         this->BeginPass( pass );
+      }
+      if( RenderQueue::KeyProgram( key ) != program ){
+         program = RenderQueue::KeyProgram( key );
+         if( program == RENDER_PROGRAM_LIGHT ){
+            glUseProgram( this->LightID );
+         }
+         else if( program == RENDER_PROGRAM_MODEL and this->DeferredShading ){
+            glUseProgram( this->Deferred.ReturnGBufferProgram() );
+         }
+         else if( program == RENDER_PROGRAM_IMPOSTOR ){
+            glUseProgram( this->Impostors.ReturnProgram() );
+         }
+         else{
+            glUseProgram( this->ProgramID );
+         }
+         material = mesh = 0xFFFFFFFF;
+         ++this->FrameStateChanges;
+      }
+      if( command.Type == RENDER_MODEL ){
+         Model &model = this->Models[command.Object];
+         if( RenderQueue::KeyMaterial( key ) != material ){
+            material = RenderQueue::KeyMaterial( key );
+            model.BindTexture();
+            ++this->FrameStateChanges;
+         }
+         if( RenderQueue::KeyMesh( key ) != mesh ){
+            mesh = RenderQueue::KeyMesh( key );
+            model.BindMesh();
+            ++this->FrameStateChanges;
+         }
+         model.DrawInstance( command.Instance );
+         ++this->FrameDrawCalls;
+         this->FrameTriangles += model.ReturnIndices().size() / 3;
+      }
+      else if( command.Type == RENDER_BATCH ){
+         if( RenderQueue::KeyMaterial( key ) != material ){
+            material = RenderQueue::KeyMaterial( key );
+            this->Models[this->StaticWorld.ReturnBatch( command.Object ).Model].BindTexture();
+            ++this->FrameStateChanges;
+         }
+         //Every merged mesh has its own VAO:
+         mesh = 0xFFFFFFFF;
+         ++this->FrameStateChanges;
+         this->StaticWorld.Draw( command.Object );
+         ++this->FrameDrawCalls;
+         this->FrameTriangles += this->StaticWorld.ReturnBatch( command.Object ).Count / 3;
+      }
+      else if( command.Type == RENDER_IMPOSTOR ){
+         //Binds own VAO and texture arrays:
+         material = mesh = 0xFFFFFFFF;
+         ++this->FrameStateChanges;
+         this->Impostors.Draw();
+         ++this->FrameDrawCalls;
+         this->FrameTriangles += this->FrameImpostors * 2;
+      }
+      else if( command.Type == RENDER_LIGHT ){
+         //Light::Draw() binds its own VAO:
+         mesh = 0xFFFFFFFF;
+         ++this->FrameStateChanges;
+         if( command.Object == 0 ){
+            this->Sun.Draw();
+         }
+         else{
+            this->SunMoving.Draw();
+         }
+         ++this->FrameDrawCalls;
+      }
+   }
+   if( pass != 0xFFFFFFFF ){
+      this->Timers.End( TIMER_PASS + pass );
+   }
+   glBindVertexArray( 0 );
+   if( ! this->Models.empty() ){
+      this->Models[0].UnbindTexture();
+   }
+   this->BeginPass( RENDER_PASS_LIGHT );
+   if( this->DeferredShading ){
+      if( ! shaded ){
+         this->ShadeDeferred();
+      }
+      this->Deferred.Compose();
+   }
+}
+
+void Game::DrawDepthPrePass(){
+   glColorMask( GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE );
+   GLuint mesh = 0xFFFFFFFF;
+   GLuint64 key;
+   for( unsigned int i = 0; i < this->Queue.ReturnSize(); ++i ){
+      key = this->Queue.ReturnKey( i );
+      if( RenderQueue::KeyPass( key ) != RENDER_PASS_OPAQUE ){
+         break;
+      }
+      const RenderCommand &command = this->Queue.ReturnCommand( i );
+      if( command.Type == RENDER_BATCH ){
+         mesh = 0xFFFFFFFF;
+         this->StaticWorld.DrawDepth( command.Object );
+         ++this->FrameDrawCalls;
+         this->FrameTriangles += this->StaticWorld.ReturnBatch( command.Object ).Count / 3;
+         continue;
+      }
+      Model &model = this->Models[command.Object];
+      if( RenderQueue::KeyMesh( key ) != mesh ){
+         mesh = RenderQueue::KeyMesh( key );
+         model.BindMesh();
+      }
+      model.DrawDepth( command.Instance );
+      ++this->FrameDrawCalls;
+      this->FrameTriangles += model.ReturnIndices().size() / 3;
+   }
+   glBindVertexArray( 0 );
+   glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
+}
+
+void Game::DrawShadows(){
+   PROFILE_SCOPE( "Game::DrawShadows" );
+   const bool shadows = this->ShadowMapping and ! this->DeferredShading and this->Shadow.IsCreated();
+   glUseProgram( this->ProgramID );
+   glUniform1i( this->SunShadowsUniform, shadows );
+   glUniform1i( this->PointShadowsUniform, shadows and this->Shadow.ReturnPointSize() > 0 and this->PointShadowRate > 0 );
+   if( ! shadows ){
+      return;
+   }
+   this->Timers.Begin( TIMER_SHADOWS );
+   glUseProgram( this->DepthID );
+   //Trees and rocks, only after change of world:
+   if( this->Shadow.BeginStatic() ){
+      this->UploadFrameData( this->Shadow.ReturnSunView(), this->Shadow.ReturnSunProjection() );
+      this->DrawShadowCasters( true, false );
+      this->Shadow.End();
+   }
+   //Copy of cached map + coins:
+   this->Shadow.BeginDynamic();
+   this->UploadFrameData( this->Shadow.ReturnSunView(), this->Shadow.ReturnSunProjection() );
+   this->DrawShadowCasters( false, true );
+   this->Shadow.End();
+   //Second light, whole map is in range:
+   if( this->Shadow.BeginPoint( this->SunMoving.ReturnPosition(), this->MapMax * 2.0f, this->PointShadowRate ) ){
+      for( unsigned int face = 0; face < 6; ++face ){
+         this->Shadow.BeginPointFace( face );
+         this->UploadFrameData( this->Shadow.ReturnPointView( face ), this->Shadow.ReturnPointProjection() );
+         this->DrawShadowCasters( true, true );
+      }
+      this->Shadow.End();
+   }
+   glUseProgram( this->ProgramID );
+   glUniformMatrix4fv( this->SunShadowMatrixUniform, 1, GL_FALSE, value_ptr( this->Shadow.ReturnSunMatrix() ) );
+   glUniform4fv( this->PointShadowPositionUniform, 1, value_ptr( this->Shadow.ReturnPointPosition() ) );
+   glUniform2fv( this->PointShadowDepthUniform, 1, value_ptr( this->Shadow.ReturnPointDepth() ) );
+   this->Shadow.Bind();
+   this->Timers.End( TIMER_SHADOWS );
+}
+
+void Game::DrawShadowCasters( bool static_models, bool dynamic_models ){
+   unsigned int model, i;
+   //0 = grass, only receives shadows:
+   for( this->It = this->Models.begin() + 1; this->It < this->Models.end(); ++this->It ){
+      model = this->It - this->Models.begin();
+      if( this->StaticWorld.IsStatic( model ) ? ! static_models : ! dynamic_models ){
+         continue;
+      }
+      this->It->BindMesh();
+      for( i = 0; i < this->It->ReturnInstances(); ++i ){
+         this->It->DrawDepth( i );
+      }
+      this->FrameDrawCalls += this->It->ReturnInstances();
+      this->FrameTriangles += this->It->ReturnInstances() * ( this->It->ReturnIndices().size() / 3 );
+   }
+   glBindVertexArray( 0 );
+}
+
+void Game::BeginPass( GLuint pass ){
+   GLuint samples;
+   //Finish counting of opaque pass:
+   if( this->OverdrawQueryPending ){
+      glGetQueryObjectuiv( this->OverdrawQuery, GL_QUERY_RESULT_AVAILABLE, &samples );
+      if( samples == GL_TRUE ){
+         glGetQueryObjectuiv( this->OverdrawQuery, GL_QUERY_RESULT, &samples );
+         this->FrameOverdraw = float( samples ) / ( float( this->WindowWidth ) * this->WindowHeight * this->Samples );
+         this->OverdrawQueryPending = false;
+      }
+   }
+   if( pass == RENDER_PASS_OPAQUE ){
+      if( this->DepthPrePass ){
+         glDepthFunc( GL_EQUAL );
+         glDepthMask( GL_FALSE );
+      }
+      if( this->OverdrawCounter and ! this->OverdrawQueryPending ){
+         glBeginQuery( GL_SAMPLES_PASSED, this->OverdrawQuery );
+         this->OverdrawQueryPending = true;
+      }
+   }
+   else{
+      GLint active = 0;
+      glGetQueryiv( GL_SAMPLES_PASSED, GL_CURRENT_QUERY, &active );
+      if( active != 0 ){
+         glEndQuery( GL_SAMPLES_PASSED );
+      }
+      glDepthFunc( GL_LESS );
+      glDepthMask( GL_TRUE );
+   }
+}
+
+void Game::CullOccluded(){
+   this->Occlusion.Begin( this->ProjectionMatrix * this->ViewMatrix );
+   //Nearest trees and rocks as occluders:
+   this->tmp_vector = this->ViewPosition;
+   this->GridItems.clear();
+   this->Grid.Query( this->tmp_vector - vec3( this->OcclusionDistance ), this->tmp_vector + vec3( this->OcclusionDistance ), this->GridItems );
+   this->Occluders.clear();
+   for( unsigned int i = 0; i < this->GridItems.size(); ++i ){
+      if( this->GridItems[i].Model >= 2 and
+          this->ViewFrustum.TestBox( this->GridItems[i].Min, this->GridItems[i].Max ) != FRUSTUM_OUTSIDE
+      ){
+         this->tmp_float = length( ( this->GridItems[i].Min + this->GridItems[i].Max ) * 0.5f - this->tmp_vector );
+         this->Occluders.push_back( pair <GLfloat, unsigned int> ( this->tmp_float, i ) );
+      }
+   }
+   sort( this->Occluders.begin(), this->Occluders.end() );
+   for( unsigned int i = 0; i < this->Occluders.size() and this->Occlusion.ReturnOccluders() < this->OcclusionMaxOccluders; ++i ){
+      const GridItem &item = this->GridItems[this->Occluders[i].second];
+      const Model &model = this->Models[item.Model];
+      this->Occlusion.DrawOccluder( model.ReturnMatrix( item.Index ), model.ReturnCollisionMin(), model.ReturnCollisionMax() );
+   }
+   //Test visible objects:
+   for( this->It = this->Models.begin(); this->It != this->Models.end(); ++this->It ){
+      if( this->StaticBatching and this->StaticWorld.IsStatic( this->It - this->Models.begin() ) ){
+         continue;
+      }
+      if( this->Grid.Contains( this->It - this->Models.begin() ) ){
+         this->FrameOccluded += this->Occlusion.Cull( *this->It );
+      }
+   }
+   //Whole merged meshes:
+   if( this->StaticBatching ){
+      this->FrameOccluded += this->StaticWorld.Cull( this->Occlusion );
+   }
+}
+
 void Game::InitSDL(){
-   if( SDL_Init( SDL_INIT_EVERYTHING ) < 0 ){
+   //Headless mode needs only timers, without video subsystem:
+   if( SDL_Init( this->Headless ? SDL_INIT_TIMER : SDL_INIT_EVERYTHING ) < 0 ){
       SDL_LogCritical( SDL_LOG_CATEGORY_SYSTEM, "SDL_Init: %s\n", SDL_GetError() );
       this->CheckInit = false;
    }
@@ -1104,6 +3569,9 @@ void Game::InitSDL(){
             break;
       }
 
+      if( this->Headless ){
+         return;
+      }
       //Check max resolution:
       SDL_Log( "Video and Mode Display info:\n" );
       SDL_Log( "SDL_GetCurrentVideoDriver: %s\n", SDL_GetCurrentVideoDriver() );
@@ -1140,6 +3608,10 @@ void Game::InitSDL(){
    }
 }
 
+int Game::ReturnResult() const{
+   return this->Result;
+}
+
 void Game::Stop(){
    this->Exit = false;
    this->CheckInit = false;
@@ -1300,14 +3772,31 @@ void Game::SetIcon(){
 
 void Game::InitContent(){
    if( this->CheckInit ){
-      this->WindowGLContext = SDL_GL_CreateContext( this->Window );
-      if( this->WindowGLContext == NULL ){
-         SDL_LogCritical( SDL_LOG_CATEGORY_SYSTEM, "SDL_GL_CreateContext: %s\n", SDL_GetError() );
-         this->CheckInit = false;
-         return;
+      if( this->Headless ){
+         if( ! this->HeadlessGL.Create() ){
+            SDL_LogCritical( SDL_LOG_CATEGORY_SYSTEM, "Headless: can't create OpenGL context\n" );
+            this->CheckInit = false;
+            return;
+         }
+         glewExperimental = true;
+      }
+      else{
+         this->WindowGLContext = SDL_GL_CreateContext( this->Window );
+         if( this->WindowGLContext == NULL ){
+            SDL_LogCritical( SDL_LOG_CATEGORY_SYSTEM, "SDL_GL_CreateContext: %s\n", SDL_GetError() );
+            this->CheckInit = false;
+            return;
+         }
+         SDL_Log( "SDL_GL_CreateContext: SUCCESS\n" );
+         this->SetPresentMode();
       }
-      SDL_Log( "SDL_GL_CreateContext: SUCCESS\n" );
       this->GL_Error = glewInit();
+      #ifdef GLEW_ERROR_NO_GLX_DISPLAY
+      //OpenGL functions are loaded before GLX check, EGL context has no X display:
+      if( this->Headless and this->GL_Error == GLEW_ERROR_NO_GLX_DISPLAY ){
+         this->GL_Error = GLEW_OK;
+      }
+      #endif
       if( this->GL_Error != GLEW_OK ){
          SDL_LogCritical( SDL_LOG_CATEGORY_SYSTEM, "glewInit: %s\n", glewGetErrorString( this->GL_Error ) );
          this->CheckInit = false;
@@ -1316,14 +3805,22 @@ void Game::InitContent(){
       else{
          SDL_Log( "glewInit: SUCCESS\n");
       }
-      //glViewport is in SDL2 loaded
+      //glViewport is in SDL2 loaded, in headless mode it is set for framebuffer
+      if( this->Headless ){
+         if( ! this->HeadlessGL.CreateFramebuffer( this->WindowWidth, this->WindowHeight ) ){
+            this->CheckInit = false;
+            return;
+         }
+         this->Aspect = vec1( float( this->WindowWidth ) / float( this->WindowHeight ) );
+         this->camera.SetAspect( this->Aspect );
+      }
       glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
       glClear( GL_COLOR_BUFFER_BIT );
       glEnable( GL_DEPTH_TEST );
       glDepthFunc( GL_LESS );
       // glEnable( GL_CULL_FACE );
       // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-      SDL_GL_SwapWindow( this->Window );
+      this->Present();
       SDL_Log( "OpenGL version: %s", glGetString( GL_VERSION ) );
       SDL_Log( "GLSL   version: %s\n", glGetString( GL_SHADING_LANGUAGE_VERSION ) );
       SDL_Log( "Drivers       : %s\n", glGetString( GL_VENDOR ) );
@@ -1373,9 +3870,15 @@ void Game::InitShaders(){
          return;
       }
 
+      SDL_Log( "\n" );
+      this->DepthID = LoadShader( "./data/Depth.vert", "./data/Depth.frag" );
+      if( this->DepthID == 0 ){
+         SDL_LogCritical( SDL_LOG_CATEGORY_INPUT, "Something wrong with depth shaders!\n" );
+         this->CheckInit = false;
+         return;
+      }
+
       //Uniforms:
-      this->ViewUniformId = glGetUniformLocation( this->ProgramID, "view" );
-      this->ProjectionUniformId = glGetUniformLocation( this->ProgramID, "projection" );
       this->ModelUniformId = glGetUniformLocation( this->ProgramID, "model" );
 
       //Single object:
@@ -1386,55 +3889,108 @@ void Game::InitShaders(){
       this->SpecularUniformId = glGetUniformLocation( this->ProgramID, "Material.Specular" );
       this->ShininessUniformId = glGetUniformLocation( this->ProgramID, "Material.Shininess" );
 
-      //Directional Light:
-      this->LightPositionUniformId = glGetUniformLocation( this->ProgramID, "DirectionalLight.Position" );
-      this->LightAmbientUniformId = glGetUniformLocation( this->ProgramID, "DirectionalLight.Ambient" );
-      this->LightDiffuseUniformId = glGetUniformLocation( this->ProgramID, "DirectionalLight.Diffuse" );
-      this->LightSpecularUniformId = glGetUniformLocation( this->ProgramID, "DirectionalLight.Specular" );
+      //Shadows, samplers always set (different sampler types can't share unit 0):
+      this->SunShadowsUniform = glGetUniformLocation( this->ProgramID, "SunShadows" );
+      this->SunShadowMatrixUniform = glGetUniformLocation( this->ProgramID, "SunShadowMatrix" );
+      this->PointShadowsUniform = glGetUniformLocation( this->ProgramID, "PointShadows" );
+      this->PointShadowPositionUniform = glGetUniformLocation( this->ProgramID, "PointShadowPosition" );
+      this->PointShadowDepthUniform = glGetUniformLocation( this->ProgramID, "PointShadowDepth" );
+      glUseProgram( this->ProgramID );
+      glUniform1i( glGetUniformLocation( this->ProgramID, "SunShadow" ), SHADOW_TEXTURE_UNIT );
+      glUniform1i( glGetUniformLocation( this->ProgramID, "PointShadow" ), SHADOW_TEXTURE_UNIT + 1 );
+      glUseProgram( 0 );
+      if( ! this->Shadow.Create( this->ShadowSize, this->PointShadowSize ) ){
+         this->ShadowMapping = false;
+      }
 
-      //Camera position:
-      this->ViewPosUniformId = glGetUniformLocation( this->ProgramID, "ViewPos" );
+      //Clustered point lights:
+      this->ClusteredUniform = glGetUniformLocation( this->ProgramID, "Clustered" );
+      this->ClusterParametersUniform = glGetUniformLocation( this->ProgramID, "ClusterParameters" );
+      glUseProgram( this->ProgramID );
+      glUniform1i( glGetUniformLocation( this->ProgramID, "ClusterGrid" ), CLUSTER_TEXTURE_UNIT );
+      glUniform1i( glGetUniformLocation( this->ProgramID, "ClusterIndices" ), CLUSTER_TEXTURE_UNIT + 1 );
+      glUniform1i( glGetUniformLocation( this->ProgramID, "ClusterLights" ), CLUSTER_TEXTURE_UNIT + 2 );
+      glUseProgram( 0 );
+      if( ! this->Clusters.Create() ){
+         this->ClusteredShading = false;
+      }
 
-      //Point Light
-      string i_to_string, uniform_string;
-      #if defined( _WIN32 ) || defined( __MINGW32__ )
-      stringstream a;
-      #endif
-      for( int i = 0; i < Max_Point_Light; ++i ){
-         #if defined( _WIN32 ) || defined( __MINGW32__ )
-         a.str( "" );
-         a.clear();
-         a<<i;
-         i_to_string = a.str();
-         #else
-         i_to_string = to_string( i );
-         #endif
-         uniform_string = "PointLight[" + i_to_string + "].Position";
-         PointLight_Position_Uniform[i] = glGetUniformLocation( this->ProgramID, uniform_string.c_str() );
-         uniform_string = "PointLight[" + i_to_string + "].Constant";
-         PointLight_Constant_Uniform[i] = glGetUniformLocation( this->ProgramID, uniform_string.c_str() );
-         uniform_string = "PointLight[" + i_to_string + "].Linear";
-         PointLight_Linear_Uniform[i] = glGetUniformLocation( this->ProgramID, uniform_string.c_str() );
-         uniform_string = "PointLight[" + i_to_string + "].Quadratic";
-         PointLight_Quadratic_Uniform[i] = glGetUniformLocation( this->ProgramID, uniform_string.c_str() );
-      }
-
-      this->ViewUniformLight = glGetUniformLocation( this->LightID, "view" );
-      this->ProjectionUniformLight = glGetUniformLocation( this->LightID, "projection" );
       this->ModelUniformLight = glGetUniformLocation( this->LightID, "model" );
       this->UniformColorLight = glGetUniformLocation( this->LightID, "Color" );
 
+      this->ModelUniformDepth = glGetUniformLocation( this->DepthID, "model" );
+
+      //Per-frame data (camera, lights):
+      if( ! this->BindFrameData( this->ProgramID ) or ! this->BindFrameData( this->LightID ) or ! this->BindFrameData( this->DepthID ) ){
+         SDL_LogCritical( SDL_LOG_CATEGORY_INPUT, "Can't find uniform block FrameData in shaders!\n" );
+         this->CheckInit = false;
+         return;
+      }
+      glGetIntegerv( GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &this->UniformAlignment );
+      if( this->UniformAlignment < 1 ){
+         this->UniformAlignment = 1;
+      }
+      //Camera and up to 8 shadow passes ( DrawShadows() ) per frame:
+      if( ! this->FrameRing.Create( GL_UNIFORM_BUFFER, ( sizeof( FrameData ) / this->UniformAlignment + 1 ) * this->UniformAlignment * 16 ) ){
+         SDL_LogCritical( SDL_LOG_CATEGORY_INPUT, "Can't create ring buffer for per-frame data!\n" );
+         this->CheckInit = false;
+         return;
+      }
+
+      //Deferred shading, G-buffer with the same uniforms as main shader:
+      if( this->Deferred.Create( this->WindowWidth, this->WindowHeight ) and
+          this->BindFrameData( this->Deferred.ReturnGBufferProgram() ) and
+          this->BindFrameData( this->Deferred.ReturnSunProgram() ) and
+          this->BindFrameData( this->Deferred.ReturnPointProgram() )
+      ){
+         const GLuint gbuffer = this->Deferred.ReturnGBufferProgram();
+         this->ModelUniformGBuffer = glGetUniformLocation( gbuffer, "model" );
+         this->TextureUniformGBuffer = glGetUniformLocation( gbuffer, "Material.Texture" );
+         this->TextureSpecularUniformGBuffer = glGetUniformLocation( gbuffer, "Material.Texture_specular" );
+         this->AmbientUniformGBuffer = glGetUniformLocation( gbuffer, "Material.Ambient" );
+         this->DiffuseUniformGBuffer = glGetUniformLocation( gbuffer, "Material.Diffuse" );
+         this->SpecularUniformGBuffer = glGetUniformLocation( gbuffer, "Material.Specular" );
+         this->ShininessUniformGBuffer = glGetUniformLocation( gbuffer, "Material.Shininess" );
+      }
+      else{
+         SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Can't create deferred renderer, using forward shading\n" );
+         this->Deferred.Destroy();
+         this->DeferredShading = false;
+      }
+
+      //GPU timers, names in order of TIMER_*:
+      vector <string> timer_names;
+      timer_names.push_back( "frame" );
+      timer_names.push_back( "depth" );
+      timer_names.push_back( "deferred" );
+      timer_names.push_back( "clusters" );
+      timer_names.push_back( "shadows" );
+      timer_names.push_back( "opaque" );
+      timer_names.push_back( "impostor" );
+      timer_names.push_back( "light" );
+      if( ! this->Timers.Create( timer_names ) ){
+         SDL_LogError( SDL_LOG_CATEGORY_RENDER, "GPU timers disabled\n" );
+      }
+
+      //HUD:
+      if( ! this->Overlay.Create() ){
+         this->ShowHud = false;
+         SDL_LogError( SDL_LOG_CATEGORY_RENDER, "HUD disabled\n" );
+      }
+
+      //Overdraw counter:
+      glGenQueries( 1, &this->OverdrawQuery );
+      glGetIntegerv( GL_SAMPLES, &this->Samples );
+      if( this->Samples < 1 ){
+         this->Samples = 1;
+      }
+
 
       //Set pointer for Model:
-      Model::ModelUniformId = & this->ModelUniformId;
-      Model::TextureUniformId = & this->TextureUniformId;
-      Model::TextureSpecularUniformId = & this->TextureSpecularUniformId;
-      Model::AmbientUniformId = & this->AmbientUniformId;
-      Model::DiffuseUniformId = & this->DiffuseUniformId;
-      Model::SpecularUniformId = & this->SpecularUniformId;
-      Model::ShininessUniformId = & this->ShininessUniformId;
+      this->SetModelUniforms( false );
       Model::ModelUniformLight = &this->ModelUniformLight;
       Model::UniformColorLight = & this->UniformColorLight;
+      Model::ModelUniformDepth = & this->ModelUniformDepth;
 
       Light::ModelUniformLight = & this->ModelUniformLight;
       Light::UniformColorLight = & this->UniformColorLight;
@@ -1443,6 +3999,7 @@ void Game::InitShaders(){
 }
 
 void Game::LoadData(){
+   PROFILE_SCOPE( "Game::LoadData" );
    SDL_Log( "\n" );
    if( this->CheckInit ){
       //Load other models from ./data/data.init:
@@ -1506,25 +4063,25 @@ void Game::LoadData(){
       vector <int> CouterType( CounterTypeMax, 0 );
       int tmp;
       vec3 VecRand;
-      while( ( CounterMax * 2 ) < ( this->MapMax * this->MapMaxHalf * 0.25 ) ){
-         CounterMax *= 2;
-      }
-      SDL_Log( "Items on map: %i\n", CounterMax );
+      //Exact density, one field stays free for coin:
+      CounterMax = std::min( int( std::floor( this->MapMax * this->MapMax * this->MapDensity + 0.5f ) ), this->MapMax * this->MapMax - 1 );
+      this->MapItems = CounterMax;
+      SDL_Log( "Items on map: %i (map %i x %i)\n", CounterMax, this->MapMax, this->MapMax );
+      //Model types in turn:
       while( Counter < CounterMax ){
-         for( tmp = 0; tmp < CounterTypeMax; ++tmp ){
-            do{
-               X = rand() % this->MapMax;
-               Y = rand() % this->MapMax;
-            }while( this->Map[Y][X] != -1 );
-            this->Map[Y][X] = tmp + 2;
-            this->MapIndex[Y][X] = CouterType[tmp];
-            X -= this->MapMaxHalf;
-            Y -= this->MapMaxHalf;
-            ++CouterType[tmp];
-            VecRand = vec3( X, 0, Y );
-            this->Models[tmp+2].AddMatrix( VecRand );
-            ++Counter;
-         }
+         tmp = Counter % CounterTypeMax;
+         do{
+            X = rand() % this->MapMax;
+            Y = rand() % this->MapMax;
+         }while( this->Map[Y][X] != -1 );
+         this->Map[Y][X] = tmp + 2;
+         this->MapIndex[Y][X] = CouterType[tmp];
+         X -= this->MapMaxHalf;
+         Y -= this->MapMaxHalf;
+         ++CouterType[tmp];
+         VecRand = vec3( X, 0, Y );
+         this->Models[tmp+2].AddMatrix( VecRand );
+         ++Counter;
       }
       SDL_Log( "Created world\n" );
 
@@ -1536,6 +4093,8 @@ void Game::LoadData(){
       //Coin number in memory is 1 and index 0 (first coin):
       this->Map[Y][X] = 1;
       this->MapIndex[Y][X] = 0;
+      this->CoinX = this->CoinRenderedX = X;
+      this->CoinZ = this->CoinRenderedZ = Y;
       X -= this->MapMaxHalf;
       Y -= this->MapMaxHalf;
       VecRand = vec3( X, 0.25f, Y );
@@ -1543,10 +4102,49 @@ void Game::LoadData(){
       VecRand = vec3( 0.5f );
       this->Models[1].Scale( VecRand );
 
-      //Load into memory:
+      //Load into memory, files on all threads, textures and buffers need OpenGL context:
+      const Uint64 load_begin = SDL_GetPerformanceCounter();
+      this->Jobs.ParallelFor( Game::LoadModelJob, &this->Models, this->Models.size(), 1 );
       for( this->It = this->Models.begin();this->It != this->Models.end(); ++this->It ){
          this->It->Load();
       }
+      //Grass covers default map size:
+      if( this->MapMax != MAP_SIZE ){
+         VecRand = vec3( GLfloat( this->MapMax ) / MAP_SIZE, 1.0f, GLfloat( this->MapMax ) / MAP_SIZE );
+         this->Models[0].Scale( VecRand );
+      }
+      SDL_Log( "Loaded %u models in %.3f ms, %u threads\n",
+         (unsigned int)this->Models.size(),
+         double( SDL_GetPerformanceCounter() - load_begin ) * 1000.0 / double( SDL_GetPerformanceFrequency() ),
+         this->Jobs.ReturnThreads()
+      );
+
+      //Split map into chunks:
+      this->Grid.Create( this->MapMax, this->Models.size() );
+      for( Y = 0; Y < this->MapMax; ++Y ){
+         for( X = 0; X < this->MapMax; ++X ){
+            if( this->Map[Y][X] >= 0 ){
+               this->Grid.Insert( X, Y, this->Map[Y][X], this->MapIndex[Y][X], this->Models[this->Map[Y][X]] );
+            }
+         }
+      }
+
+      //Merge trees and rocks, they never move (0 = grass, 1 = coin):
+      vector <bool> StaticModels( this->Models.size(), true );
+      StaticModels[0] = false;
+      if( StaticModels.size() > 1 ){
+         StaticModels[1] = false;
+      }
+      this->StaticWorld.Create( this->Grid, this->Models, StaticModels );
+
+      //Impostors of the same trees and rocks:
+      if( this->Impostors.Create( this->Models, StaticModels, this->MapMax * this->MapMax ) ){
+         this->BindFrameData( this->Impostors.ReturnProgram() );
+      }
+      else{
+         SDL_LogError( SDL_LOG_CATEGORY_RENDER, "Can't create impostors, drawing full models\n" );
+         this->ImpostorRendering = false;
+      }
 
       //Set and load main light:
       this->Sun.SetPath( "./data/sun.obj" );
@@ -1559,6 +4157,8 @@ void Game::LoadData(){
       this->Sun.SetDiffuse( this->tmp_vector );
       this->tmp_vector = vec3( 0.25f );
       this->Sun.SetSpecular( this->tmp_vector );
+      //Shadows of whole map, trees and rocks drawn again only after change of world:
+      this->Shadow.SetSun( this->Sun.ReturnPosition(), vec3( 0.0f ), this->MapMaxHalf + 1.0f );
 
       //Second light:
       this->SunMoving.SetPath( "./data/sun.obj" );
@@ -1572,9 +4172,29 @@ void Game::LoadData(){
       this->SunMovingPosition.y = 10.0f;
       this->SunMovingPosition.z = this->SunMovingRadius * cos( this->SunMovingRadian );
       this->SunMoving.ChangePosition( this->SunMovingPosition );
-      this->SunMovingDegreese += 0.25f;
+      this->SunMovingDegreesePrevious = this->SunMovingDegreese;
       this->SunMoving.Load();
 
+      //Point lights for deferred shading, 0 = second light (white):
+      PointLightData point_light;
+      point_light.PositionRadius = vec4( this->SunMovingPosition, 0.0f );
+      point_light.Color = vec4( 1.0f );
+      point_light.Attenuation = vec4( 1.0f, 0.07f, 0.017f, 0.0f );
+      this->PointLights.assign( 1, point_light );
+      //Small coloured lights above the map:
+      point_light.Attenuation = vec4( 1.0f, 0.7f, 1.8f, 0.0f );
+      for( int i = 0; i < this->PointLightCount and this->PointLights.size() < CLUSTER_MAX_LIGHTS; ++i ){
+         point_light.Color = vec4( rand() % 256, rand() % 256, rand() % 256, 0.0f ) / 255.0f;
+         point_light.Color /= std::max( std::max( point_light.Color.x, point_light.Color.y ), std::max( point_light.Color.z, 0.01f ) );
+         point_light.PositionRadius = vec4(
+            ( rand() % ( this->MapMax * 10 ) ) / 10.0f - this->MapMaxHalf,
+            0.3f + ( rand() % 12 ) / 10.0f,
+            ( rand() % ( this->MapMax * 10 ) ) / 10.0f - this->MapMaxHalf,
+            DeferredRenderer::LightRadius( vec3( point_light.Attenuation ), vec3( point_light.Color ) )
+         );
+         this->PointLights.push_back( point_light );
+      }
+
       //Set min/max movement:
       this->tmp_vector = vec3( -this->MapMaxHalf, -5.0f, -this->MapMaxHalf );
       this->camera.SetPositionMin( this->tmp_vector );
@@ -1583,195 +4203,48 @@ void Game::LoadData(){
    }
 }
 
+void Game::InvalidateStatic( int x, int z, GLuint model ){
+   if( ! this->StaticWorld.IsStatic( model ) ){
+      return;
+   }
+   this->StaticWorld.Invalidate( x, z, model );
+   this->Shadow.Invalidate();
+}
+
 void Game::RandNewCoin(){
-   this->Map[this->tmp_z][this->tmp_x] = -1;
-   this->MapIndex[this->tmp_z][this->tmp_x] = -1;
+   //Simulation thread: only map and score, tmp_* belong to Render():
+   this->Map[this->CoinZ][this->CoinX] = -1;
+   this->MapIndex[this->CoinZ][this->CoinX] = -1;
+   int x, z;
    do{
-      this->tmp_x = rand() % this->MapMax;
-      this->tmp_z = rand() % this->MapMax;
-   }while( this->Map[this->tmp_z][this->tmp_x] != -1 );
-   this->Map[this->tmp_z][this->tmp_x] = 1;
-   this->MapIndex[this->tmp_z][this->tmp_x] = 0;
-   this->tmp_x -= this->MapMaxHalf;
-   this->tmp_z -= this->MapMaxHalf;
-   this->tmp_vector = vec3( this->tmp_x, 0.0f, this->tmp_z );
-   this->Models[1].ChangeMatrix( 0, this->tmp_vector );
+      x = rand() % this->MapMax;
+      z = rand() % this->MapMax;
+   }while( this->Map[z][x] != -1 );
+   this->Map[z][x] = 1;
+   this->MapIndex[z][x] = 0;
+   this->CoinX = x;
+   this->CoinZ = z;
    ++this->Score;
 }
 
+void Game::MoveCoin( int x, int z ){
+   //Coin is dynamic, InvalidateStatic() not needed:
+   this->Grid.Remove( this->CoinRenderedX, this->CoinRenderedZ, 1, 0 );
+   this->tmp_vector = vec3( x - this->MapMaxHalf, 0.0f, z - this->MapMaxHalf );
+   this->Models[1].ChangeMatrix( 0, this->tmp_vector );
+   this->CoinAngleRendered = 0.0f;
+   this->Grid.Insert( x, z, 1, 0, this->Models[1] );
+   this->CoinRenderedX = x;
+   this->CoinRenderedZ = z;
+}
+
 void Game::CheckCoin(){
-   this->tmp_vector = camera.ReturnPosition();
-   this->tmp_x = (int)( this->tmp_vector.x + this->MapMaxHalf );
-   this->tmp_z = (int)( this->tmp_vector.z + this->MapMaxHalf );
-   if( ( this->tmp_x > 0 ) and ( this->tmp_x < this->MapMax - 1 ) ){
-      if( ( this->tmp_z > 0 ) and ( this->tmp_z < this->MapMax - 1 ) ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-      else if( this->tmp_z == 0 ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-      else if( this->tmp_z == ( this->MapMax - 1 ) ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-   }
-   else if( this->tmp_x == 0 ){
-      if( ( this->tmp_z > 0 ) and ( this->tmp_z < this->MapMax - 1 ) ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-      else if( this->tmp_z == 0 ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-      else if( this->tmp_z == ( this->MapMax - 1 ) ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x+1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-   }
-   else if( this->tmp_x == ( this->MapMax - 1 ) ){
-      if( ( this->tmp_z > 0 ) and ( this->tmp_z < this->MapMax - 1 ) ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-      else if( this->tmp_z == 0 ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z+1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
-      else if( this->tmp_z == ( this->MapMax - 1 ) ){
-         if( this->Map[this->tmp_z][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x] == 1 ){
-            this->RandNewCoin();
-         }
-         else if( this->Map[this->tmp_z-1][this->tmp_x-1] == 1 ){
-            this->RandNewCoin();
-         }
-      }
+   //Position after simulation step, not interpolated one from Render():
+   const vec3 position = this->camera.ReturnPosition();
+   const int x = (int)( position.x + this->MapMaxHalf );
+   const int z = (int)( position.z + this->MapMaxHalf );
+   //Current and all neighbouring cells:
+   if( abs( x - this->CoinX ) <= 1 and abs( z - this->CoinZ ) <= 1 ){
+      this->RandNewCoin();
    }
 }
@@ -0,0 +1,221 @@
+/*!
+   \file memorytracker.cpp
+   \brief Plik źródłowy dla memorytracker.hpp.
+*/
+#include "memorytracker.hpp"
+#include "profiler.hpp"
+#include <map>
+
+/*!
+   \brief Nazwy podsystemów.
+*/
+static const char *MemoryNames[MEMORY_TAGS] = { "loader", "model", "texture", "shader", "world", "render" };
+/*!
+   \brief Nazwy liczników w \link Profiler \endlink (stałe napisy).
+*/
+static const char *MemoryCounters[2][MEMORY_TAGS] = {
+   { "memory cpu loader", "memory cpu model", "memory cpu texture", "memory cpu shader", "memory cpu world", "memory cpu render" },
+   { "memory gpu loader", "memory gpu model", "memory gpu texture", "memory gpu shader", "memory gpu world", "memory gpu render" }
+};
+/*!
+   \brief Pamięć podsystemów, [strona][podsystem].
+*/
+static MemoryStats MemoryTags[2][MEMORY_TAGS] = {};
+/*!
+   \brief Największa suma pamięci wszystkich podsystemów, [strona].
+*/
+static Sint64 MemoryPeaks[2] = {};
+/*!
+   \brief Obiekt OpenGL: podsystem i wielkość.
+*/
+struct MemoryObject{
+   /*!
+      \brief Podsystem.
+   */
+   unsigned int Tag;
+   /*!
+      \brief Wielkość w bajtach.
+   */
+   Sint64 Bytes;
+};
+/*!
+   \brief Obiekty OpenGL, klucz = rodzaj << 32 | identyfikator.
+*/
+static std::map <Uint64, MemoryObject> MemoryObjects;
+/*!
+   \brief Blokada wszystkich danych, pamięć zmieniana jest też przez wątki \link JobSystem \endlink.
+*/
+static SDL_SpinLock MemoryLock = 0;
+
+/*!
+   \brief Zmienia pamięć podsystemu, wymaga \link MemoryLock \endlink.
+
+   \param allocation - TRUE = zmiana jest przydziałem ( \link MemoryStats::Allocations \endlink )
+*/
+static Sint64 MemoryChange( unsigned int tag, unsigned int side, Sint64 before, Sint64 after, bool allocation ){
+   MemoryStats &stats = MemoryTags[side][tag];
+   stats.Bytes += after - before;
+   if( allocation ){
+      ++stats.Allocations;
+   }
+   if( before == 0 and after > 0 ){
+      ++stats.Blocks;
+      ++stats.TotalBlocks;
+   }
+   else if( before > 0 and after == 0 ){
+      --stats.Blocks;
+   }
+   if( stats.Bytes > stats.Peak ){
+      stats.Peak = stats.Bytes;
+   }
+   Sint64 total = 0;
+   for( unsigned int i = 0; i < MEMORY_TAGS; ++i ){
+      total += MemoryTags[side][i].Bytes;
+   }
+   if( total > MemoryPeaks[side] ){
+      MemoryPeaks[side] = total;
+   }
+   return stats.Bytes;
+}
+
+void MemoryTracker::Resize( unsigned int tag, unsigned int side, Sint64 before, Sint64 after ){
+   if( tag >= MEMORY_TAGS or side > MEMORY_GPU or before == after ){
+      return;
+   }
+   SDL_AtomicLock( &MemoryLock );
+   //Growth means new or reallocated storage:
+   const Sint64 bytes = MemoryChange( tag, side, before, after, after > before );
+   SDL_AtomicUnlock( &MemoryLock );
+#ifndef PROFILER_DISABLED
+   Profiler::Counter( MemoryCounters[side][tag], bytes );
+#else
+   (void)bytes;
+#endif
+}
+
+void MemoryTracker::AddObject( unsigned int tag, unsigned int type, GLuint id, Sint64 bytes ){
+   if( id == 0 or tag >= MEMORY_TAGS ){
+      return;
+   }
+   const Uint64 key = ( Uint64( type ) << 32 ) | id;
+   Sint64 before = 0;
+   SDL_AtomicLock( &MemoryLock );
+   std::map <Uint64, MemoryObject>::iterator object = MemoryObjects.find( key );
+   if( object != MemoryObjects.end() ){
+      //Storage redefined (glBufferData, glTexImage*) or id reused, old size replaced:
+      if( object->second.Tag == tag ){
+         before = object->second.Bytes;
+      }
+      else{
+         const Sint64 old = MemoryChange( object->second.Tag, MEMORY_GPU, object->second.Bytes, 0, false );
+#ifndef PROFILER_DISABLED
+         Profiler::Counter( MemoryCounters[MEMORY_GPU][object->second.Tag], old );
+#else
+         (void)old;
+#endif
+      }
+   }
+   MemoryObject &value = MemoryObjects[key];
+   value.Tag = tag;
+   value.Bytes = bytes;
+   //Every storage definition allocates, also with unchanged size:
+   const Sint64 total = MemoryChange( tag, MEMORY_GPU, before, bytes, bytes > 0 );
+   SDL_AtomicUnlock( &MemoryLock );
+#ifndef PROFILER_DISABLED
+   Profiler::Counter( MemoryCounters[MEMORY_GPU][tag], total );
+#else
+   (void)total;
+#endif
+}
+
+void MemoryTracker::RemoveObject( unsigned int type, GLsizei count, const GLuint *ids ){
+   for( GLsizei i = 0; i < count; ++i ){
+      if( ids[i] == 0 ){
+         continue;
+      }
+      SDL_AtomicLock( &MemoryLock );
+      std::map <Uint64, MemoryObject>::iterator object = MemoryObjects.find( ( Uint64( type ) << 32 ) | ids[i] );
+      if( object == MemoryObjects.end() ){
+         SDL_AtomicUnlock( &MemoryLock );
+         continue;
+      }
+      const unsigned int tag = object->second.Tag;
+      const Sint64 total = MemoryChange( tag, MEMORY_GPU, object->second.Bytes, 0, false );
+      MemoryObjects.erase( object );
+      SDL_AtomicUnlock( &MemoryLock );
+#ifndef PROFILER_DISABLED
+      Profiler::Counter( MemoryCounters[MEMORY_GPU][tag], total );
+#else
+      (void)total;
+#endif
+   }
+}
+
+void MemoryTracker::MarkSteady(){
+   SDL_AtomicLock( &MemoryLock );
+   for( unsigned int side = 0; side < 2; ++side ){
+      for( unsigned int i = 0; i < MEMORY_TAGS; ++i ){
+         MemoryTags[side][i].Steady = MemoryTags[side][i].Bytes;
+         MemoryTags[side][i].SteadyAllocations = MemoryTags[side][i].Allocations;
+      }
+   }
+   SDL_AtomicUnlock( &MemoryLock );
+}
+
+MemoryStats MemoryTracker::ReturnStats( unsigned int tag, unsigned int side ){
+   MemoryStats stats = {};
+   if( tag >= MEMORY_TAGS or side > MEMORY_GPU ){
+      return stats;
+   }
+   SDL_AtomicLock( &MemoryLock );
+   stats = MemoryTags[side][tag];
+   SDL_AtomicUnlock( &MemoryLock );
+   return stats;
+}
+
+MemoryStats MemoryTracker::ReturnTotal( unsigned int side ){
+   MemoryStats stats = {};
+   if( side > MEMORY_GPU ){
+      return stats;
+   }
+   SDL_AtomicLock( &MemoryLock );
+   for( unsigned int i = 0; i < MEMORY_TAGS; ++i ){
+      stats.Bytes += MemoryTags[side][i].Bytes;
+      stats.Steady += MemoryTags[side][i].Steady;
+      stats.Blocks += MemoryTags[side][i].Blocks;
+      stats.TotalBlocks += MemoryTags[side][i].TotalBlocks;
+      stats.Allocations += MemoryTags[side][i].Allocations;
+      stats.SteadyAllocations += MemoryTags[side][i].SteadyAllocations;
+   }
+   stats.Peak = MemoryPeaks[side];
+   SDL_AtomicUnlock( &MemoryLock );
+   return stats;
+}
+
+const char * MemoryTracker::ReturnName( unsigned int tag ){
+   return tag < MEMORY_TAGS ? MemoryNames[tag] : "unknown";
+}
+
+void MemoryTracker::Log(){
+   const double megabyte = 1.0 / ( 1024.0 * 1024.0 );
+   MemoryStats cpu, gpu;
+   SDL_Log( "\rMemory:          CPU MB   peak  steady  blocks  allocs      GPU MB   peak  steady  objects  allocs" );
+   for( unsigned int i = 0; i <= MEMORY_TAGS; ++i ){
+      cpu = i < MEMORY_TAGS ? MemoryTracker::ReturnStats( i, MEMORY_CPU ) : MemoryTracker::ReturnTotal( MEMORY_CPU );
+      gpu = i < MEMORY_TAGS ? MemoryTracker::ReturnStats( i, MEMORY_GPU ) : MemoryTracker::ReturnTotal( MEMORY_GPU );
+      SDL_Log( "\r  %-10s %10.2f %7.2f %7.2f %7lld %7lld  %10.2f %7.2f %7.2f %8lld %7lld",
+         i < MEMORY_TAGS ? MemoryNames[i] : "total",
+         cpu.Bytes * megabyte, cpu.Peak * megabyte, cpu.Steady * megabyte, (long long)cpu.Blocks, (long long)cpu.Allocations,
+         gpu.Bytes * megabyte, gpu.Peak * megabyte, gpu.Steady * megabyte, (long long)gpu.Blocks, (long long)gpu.Allocations
+      );
+   }
+}
+
+Sint64 MemoryTracker::TextureBytes( GLsizei width, GLsizei height, GLsizei depth, unsigned int bytes_per_pixel, bool mipmaps ){
+   Sint64 bytes = Sint64( width ) * height * depth * bytes_per_pixel;
+   if( mipmaps ){
+      //Full chain: 1 + 1/4 + 1/16 + ... ≈ 4/3:
+      bytes += bytes / 3;
+   }
+   return bytes;
+}
@@ -0,0 +1,213 @@
+/*!
+   \file memorytracker.hpp
+   \brief Plik odpowiedzialny za liczenie pamięci CPU i GPU zajętej przez podsystemy gry.
+*/
+#ifndef memorytracker_hpp
+#define memorytracker_hpp
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Podsystem: dane tymczasowe wczytywania plików (obrazy przed wysłaniem do GPU).
+*/
+#define MEMORY_LOADER 0
+/*!
+   \brief Podsystem: modele i światła (wierzchołki, indeksy, macierze, bufory wierzchołków).
+*/
+#define MEMORY_MODEL 1
+/*!
+   \brief Podsystem: tekstury modeli.
+*/
+#define MEMORY_TEXTURE 2
+/*!
+   \brief Podsystem: kod źródłowy shaderów i programy.
+*/
+#define MEMORY_SHADER 3
+/*!
+   \brief Podsystem: mapa świata, połączone modele statyczne i impostory.
+*/
+#define MEMORY_WORLD 4
+/*!
+   \brief Podsystem: bufory rysowania (cienie, G-buffer, bufory pierścieniowe, klastry świateł, nakładka).
+*/
+#define MEMORY_RENDER 5
+/*!
+   \brief Ilość podsystemów.
+*/
+#define MEMORY_TAGS 6
+/*!
+   \brief Pamięć operacyjna (CPU).
+*/
+#define MEMORY_CPU 0
+/*!
+   \brief Pamięć karty graficznej (GPU), wielkości liczone z formatów tekstur i wielkości buforów.
+*/
+#define MEMORY_GPU 1
+/*!
+   \brief Obiekt OpenGL: tekstura.
+*/
+#define MEMORY_OBJECT_TEXTURE 0
+/*!
+   \brief Obiekt OpenGL: bufor.
+*/
+#define MEMORY_OBJECT_BUFFER 1
+/*!
+   \brief Obiekt OpenGL: bufor renderowania (renderbuffer).
+*/
+#define MEMORY_OBJECT_RENDERBUFFER 2
+/*!
+   \brief Obiekt OpenGL: program shaderów.
+*/
+#define MEMORY_OBJECT_PROGRAM 3
+
+/*!
+   \brief Pamięć jednego podsystemu po jednej stronie (CPU lub GPU).
+*/
+struct MemoryStats{
+   /*!
+      \brief Aktualna ilość bajtów.
+   */
+   Sint64 Bytes;
+   /*!
+      \brief Największa ilość bajtów od uruchomienia.
+   */
+   Sint64 Peak;
+   /*!
+      \brief Ilość bajtów w stanie ustalonym ( \link MemoryTracker::MarkSteady() \endlink ).
+   */
+   Sint64 Steady;
+   /*!
+      \brief Aktualna ilość niepustych bloków CPU (właścicieli danych) lub obiektów OpenGL, nie ilość przydziałów.
+   */
+   Sint64 Blocks;
+   /*!
+      \brief Ilość bloków lub obiektów, które stały się niepuste od uruchomienia.
+   */
+   Sint64 TotalBlocks;
+   /*!
+      \brief Ilość przydziałów od uruchomienia: każdy wzrost pamięci CPU (np. większa pojemność wektora)
+      i każde zdefiniowanie pamięci obiektu OpenGL (glBufferData, glTexImage*, także ponowne).
+   */
+   Sint64 Allocations;
+   /*!
+      \brief Ilość przydziałów w chwili zapisu stanu ustalonego ( \link MemoryTracker::MarkSteady() \endlink ),
+      różnica z \link Allocations \endlink pokazuje przydziały w trakcie działania.
+   */
+   Sint64 SteadyAllocations;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za liczenie pamięci CPU i GPU każdego podsystemu ( MEMORY_* ).
+
+   Pamięć CPU zgłaszana jest przez właściciela danych przy każdej zmianie wielkości ( \link Resize() \endlink ),
+   pamięć GPU przy tworzeniu i usuwaniu obiektów OpenGL ( \link AddObject() \endlink, \link RemoveObject() \endlink ),
+   wielkość obiektu zapamiętywana jest do jego usunięcia.\n
+   Po wczytaniu świata \link MarkSteady() \endlink zapisuje stan ustalony, porównywany później z największym użyciem.\n
+   Każda zmiana zapisywana jest też jako licznik w \link Profiler \endlink.\n
+*/
+class MemoryTracker{
+public:
+   /*!
+      \brief Zmienia ilość pamięci podsystemu.
+
+      Przejście z 0 na więcej bajtów dodaje blok ( \link MemoryStats::Blocks \endlink ), a z więcej na 0 go usuwa,
+      każdy wzrost wielkości liczony jest jako przydział ( \link MemoryStats::Allocations \endlink ).\n
+
+      \param tag - podsystem ( MEMORY_* )
+      \param side - \link MEMORY_CPU \endlink lub \link MEMORY_GPU \endlink
+      \param before - poprzednia wielkość w bajtach
+      \param after - nowa wielkość w bajtach
+   */
+   static void Resize( unsigned int tag, unsigned int side, Sint64 before, Sint64 after );
+   /*!
+      \brief Dodaje obiekt OpenGL, ponowne dodanie tego samego obiektu zmienia jego wielkość.
+
+      Każde wywołanie z niezerową wielkością liczone jest jako przydział ( \link MemoryStats::Allocations \endlink ).
+
+      \param tag - podsystem ( MEMORY_* )
+      \param type - rodzaj obiektu ( MEMORY_OBJECT_* )
+      \param id - identyfikator obiektu, 0 = pomijany
+      \param bytes - wielkość w bajtach
+   */
+   static void AddObject( unsigned int tag, unsigned int type, GLuint id, Sint64 bytes );
+   /*!
+      \brief Usuwa obiekty OpenGL, nieznane obiekty są pomijane.
+
+      \param type - rodzaj obiektów ( MEMORY_OBJECT_* )
+      \param count - ilość obiektów
+      \param ids - identyfikatory obiektów
+   */
+   static void RemoveObject( unsigned int type, GLsizei count, const GLuint *ids );
+   /*!
+      \brief Zapisuje aktualną pamięć wszystkich podsystemów jako stan ustalony.
+   */
+   static void MarkSteady();
+   /*!
+      \brief Zwraca pamięć podsystemu.
+
+      \param tag - podsystem ( MEMORY_* )
+      \param side - \link MEMORY_CPU \endlink lub \link MEMORY_GPU \endlink
+   */
+   static MemoryStats ReturnStats( unsigned int tag, unsigned int side );
+   /*!
+      \brief Zwraca pamięć wszystkich podsystemów, Peak = największa suma.
+
+      \param side - \link MEMORY_CPU \endlink lub \link MEMORY_GPU \endlink
+   */
+   static MemoryStats ReturnTotal( unsigned int side );
+   /*!
+      \brief Zwraca nazwę podsystemu.
+
+      \param tag - podsystem ( MEMORY_* )
+   */
+   static const char * ReturnName( unsigned int tag );
+   /*!
+      \brief Wypisuje pamięć wszystkich podsystemów.
+   */
+   static void Log();
+   /*!
+      \brief Zwraca wielkość tekstury w bajtach.
+
+      \param width - szerokość
+      \param height - wysokość
+      \param depth - ilość warstw (ścian mapy sześciennej)
+      \param bytes_per_pixel - ilość bajtów na piksel
+      \param mipmaps - TRUE = z pełnym łańcuchem mipmap (+1/3)
+   */
+   static Sint64 TextureBytes( GLsizei width, GLsizei height, GLsizei depth, unsigned int bytes_per_pixel, bool mipmaps = false );
+};
+
+/*!
+   \brief Pamięć CPU zajęta od utworzenia do usunięcia obiektu, np. dane tymczasowe funkcji z wieloma wyjściami.
+*/
+class MemoryScope{
+public:
+   /*!
+      \brief Konstruktor, dodanie pamięci.
+
+      \param tag - podsystem ( MEMORY_* )
+      \param bytes - wielkość w bajtach
+   */
+   MemoryScope( unsigned int tag, Sint64 bytes ){
+      this->Tag = tag;
+      this->Bytes = bytes;
+      MemoryTracker::Resize( this->Tag, MEMORY_CPU, 0, this->Bytes );
+   }
+   /*!
+      \brief Destruktor, zwolnienie pamięci.
+   */
+   ~MemoryScope(){
+      MemoryTracker::Resize( this->Tag, MEMORY_CPU, this->Bytes, 0 );
+   }
+private:
+   /*!
+      \brief Podsystem.
+   */
+   unsigned int Tag;
+   /*!
+      \brief Wielkość w bajtach.
+   */
+   Sint64 Bytes;
+};
+
+#endif
@@ -3,7 +3,10 @@
    \brief Plik źródłowy dla model.hpp.
 */
 #include "model.hpp"
+#include <cstddef>
 #include <SDL2/SDL.h>
+#include "profiler.hpp"
+#include "memorytracker.hpp"
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/euler_angles.hpp>
@@ -22,11 +25,13 @@ GLuint * Model::ShininessUniformId = NULL;
 GLuint * Model::ModelUniformLight = NULL;
 GLuint * Model::UniformColorLight = NULL;
 
+GLuint * Model::ModelUniformDepth = NULL;
+
+JobSystem * Model::Jobs = NULL;
+
 Model::Model(){
    this->VAO = 0;
    this->VertexBuffer = 0;
-   this->UvBuffer = 0;
-   this->NormalBuffer = 0;
    this->IndicesBuffer = 0;
    this->Texture = 0;
    this->TextureSpecular = 0;
@@ -38,8 +43,6 @@ Model::Model(){
 Model::Model( std::string path_obj, std::string path_img ){
    this->VAO = 0;
    this->VertexBuffer = 0;
-   this->UvBuffer = 0;
-   this->NormalBuffer = 0;
    this->IndicesBuffer = 0;
    this->Texture = 0;
    this->TextureSpecular = 0;
@@ -59,13 +62,9 @@ Model::Model( const Model &model ){
    this->VAO = model.VAO;
 
    this->Vertices = model.Vertices;
-   this->Uvs = model.Uvs;
-   this->Normals = model.Normals;
    this->Indices = model.Indices;
 
    this->VertexBuffer = model.VertexBuffer;
-   this->UvBuffer = model.UvBuffer;
-   this->NormalBuffer = model.NormalBuffer;
    this->IndicesBuffer = model.IndicesBuffer;
 
    this->Texture = model.Texture;
@@ -82,6 +81,7 @@ Model::Model( const Model &model ){
    this->Shininess = model.Shininess;
 
    this->ModelMatrix = model.ModelMatrix;
+   this->VisibleIndex = model.VisibleIndex;
 
    this->CollisionMin = model.CollisionMin;
    this->CollisionMax = model.CollisionMax;
@@ -91,6 +91,9 @@ Model::Model( const Model &model ){
    this->CollisionColor = model.CollisionColor;
 
    this->Init = model.Init;
+
+   this->CpuMemory = 0;
+   this->UpdateMemory();
 }
 
 Model & Model::operator=( const Model &model ){
@@ -99,13 +102,9 @@ Model & Model::operator=( const Model &model ){
    this->VAO = model.VAO;
 
    this->Vertices = model.Vertices;
-   this->Uvs = model.Uvs;
-   this->Normals = model.Normals;
    this->Indices = model.Indices;
 
    this->VertexBuffer = model.VertexBuffer;
-   this->UvBuffer = model.UvBuffer;
-   this->NormalBuffer = model.NormalBuffer;
    this->IndicesBuffer = model.IndicesBuffer;
 
    this->Texture = model.Texture;
@@ -122,6 +121,7 @@ Model & Model::operator=( const Model &model ){
    this->Shininess = model.Shininess;
 
    this->ModelMatrix = model.ModelMatrix;
+   this->VisibleIndex = model.VisibleIndex;
 
    this->CollisionMin = model.CollisionMin;
    this->CollisionMax = model.CollisionMax;
@@ -132,20 +132,33 @@ Model & Model::operator=( const Model &model ){
 
    this->Init = model.Init;
 
+   this->UpdateMemory();
+
    return *this;
 }
 
 Model::~Model(){
-   glDeleteTextures( 1, &this->Texture );
-   glDeleteTextures( 1, &this->TextureSpecular );
-   glDeleteBuffers( 1, &this->VertexBuffer );
-   glDeleteBuffers( 1, &this->UvBuffer );
-   glDeleteBuffers( 1, &this->NormalBuffer );
-   glDeleteBuffers( 1, &this->IndicesBuffer );
-   glDeleteVertexArrays( 1, &this->VAO );
+   MemoryTracker::Resize( MEMORY_MODEL, MEMORY_CPU, this->CpuMemory, 0 );
+   //Only data from Load_OBJ() without OpenGL objects, e.g. without context:
+   if( this->Texture != 0 or this->TextureSpecular != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 1, &this->Texture );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 1, &this->TextureSpecular );
+      glDeleteTextures( 1, &this->Texture );
+      glDeleteTextures( 1, &this->TextureSpecular );
+   }
+   if( this->VAO != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &this->VertexBuffer );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &this->IndicesBuffer );
+      glDeleteBuffers( 1, &this->VertexBuffer );
+      glDeleteBuffers( 1, &this->IndicesBuffer );
+      glDeleteVertexArrays( 1, &this->VAO );
+   }
 
-   glDeleteBuffers( 1, &this->CollisionSquareVertexBuffer );
-   glDeleteVertexArrays( 1, &this->CollisionSquareVao );
+   if( this->CollisionSquareVao != 0 ){
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &this->CollisionSquareVertexBuffer );
+      glDeleteBuffers( 1, &this->CollisionSquareVertexBuffer );
+      glDeleteVertexArrays( 1, &this->CollisionSquareVao );
+   }
 }
 
 void Model::SetName( std::string &in ){
@@ -217,23 +230,21 @@ void Model::Load_OBJ(){
    SDL_Log( "%s:", this->Name.c_str() );
    /*
    //With LoadOBJ( ):
-   this->Init = LoadOBJ( this->OBJPathFile.c_str(), this->Vertices, this->Uvs, this->Normals );
    std::vector <glm::vec3> Vertices_tmp;
    std::vector <glm::vec2> Uvs_tmp;
    std::vector <glm::vec3> Normals_tmp;
-   IndexVBO( this->Vertices, this->Uvs, this->Normals, this->Indices, Vertices_tmp, Uvs_tmp, Normals_tmp );
-   this->Vertices = Vertices_tmp;
-   this->Uvs = Uvs_tmp;
-   this->Normals = Normals_tmp;
+   this->Init = LoadOBJ( this->OBJPathFile.c_str(), Vertices_tmp, Uvs_tmp, Normals_tmp );
+   IndexVBO( Vertices_tmp, Uvs_tmp, Normals_tmp, this->Indices, this->Vertices );
    */
    //faster
    //with Assimp:
-   this->Init = LoadAssimp( this->OBJPathFile.c_str(), this->Vertices, this->Uvs, this->Normals, this->Indices );
+   this->Init = LoadAssimp( this->OBJPathFile.c_str(), this->Vertices, this->Indices );
    this->SetCollision();
    LoadMTL( this->MTLPathFile.c_str(), this->Ambient, this->Diffuse, this->Specular, this->Shininess );
    if( this->Ambient.x == 0.0f and this->Ambient.y == 0.0f and this->Ambient.z == 0.0f ){
       this->Ambient = glm::vec3( 0.2f );
    }
+   this->UpdateMemory();
 }
 
 void Model::Load_Img(){
@@ -242,12 +253,16 @@ void Model::Load_Img(){
 }
 
 void Model::Load(){
-   this->Load_OBJ();
+   if( ! this->Init ){
+      this->Load_OBJ();
+   }
    this->Load_Img();
+   this->BindCollisionSquare();
    this->BindVAO();
    if( this->Init and this->ModelMatrix.empty() ){
       this->ModelMatrix.push_back( glm::mat4( 1.0f ) );
    }
+   this->SetAllVisible();
 }
 
 void Model::BindVAO(){
@@ -255,38 +270,28 @@ void Model::BindVAO(){
       SDL_Log( "Binding %s into VAO\n", this->OBJPathFile.c_str() );
       glGenVertexArrays( 1, &this->VAO );
       glGenBuffers( 1, &this->VertexBuffer );
-      glGenBuffers( 1, &this->UvBuffer );
-      glGenBuffers( 1, &this->NormalBuffer );
       glGenBuffers( 1, &this->IndicesBuffer );
 
-      //Vertex:
-      glBindBuffer( GL_ARRAY_BUFFER, this->VertexBuffer );
-      glBufferData( GL_ARRAY_BUFFER, this->Vertices.size() * sizeof( glm::vec3 ), &this->Vertices[0], GL_STATIC_DRAW );
-      //Uv:
-      glBindBuffer( GL_ARRAY_BUFFER, this->UvBuffer );
-      glBufferData( GL_ARRAY_BUFFER, this->Uvs.size() * sizeof( glm::vec2 ), &this->Uvs[0], GL_STATIC_DRAW );
-      //Normal:
-      glBindBuffer( GL_ARRAY_BUFFER, this->NormalBuffer );
-      glBufferData( GL_ARRAY_BUFFER, this->Normals.size() * sizeof( glm::vec3 ), &this->Normals[0], GL_STATIC_DRAW );
-
       //VAO:
       glBindVertexArray( this->VAO );
 
-      //Vertex:
+      //Vertex, Uv and Normal in one buffer:
       glBindBuffer( GL_ARRAY_BUFFER, this->VertexBuffer );
-      glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0 );
+      BufferStaticData( GL_ARRAY_BUFFER, this->Vertices.size() * sizeof( Packe ), &this->Vertices[0] );
+      MemoryTracker::AddObject( MEMORY_MODEL, MEMORY_OBJECT_BUFFER, this->VertexBuffer, this->Vertices.size() * sizeof( Packe ) );
+      //Vertex:
+      glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( Packe ), (GLvoid *)offsetof( Packe, position ) );
       glEnableVertexAttribArray( 0 );
       //Uv:
-      glBindBuffer( GL_ARRAY_BUFFER, this->UvBuffer );
-      glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0 );
+      glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, sizeof( Packe ), (GLvoid *)offsetof( Packe, uv ) );
       glEnableVertexAttribArray( 1 );
       //Normal:
-      glBindBuffer( GL_ARRAY_BUFFER, this->NormalBuffer );
-      glVertexAttribPointer( 2, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0 );
+      glVertexAttribPointer( 2, 3, GL_FLOAT, GL_FALSE, sizeof( Packe ), (GLvoid *)offsetof( Packe, normal ) );
       glEnableVertexAttribArray( 2 );
       //Indicies:
       glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, this->IndicesBuffer );
-      glBufferData( GL_ELEMENT_ARRAY_BUFFER, this->Indices.size() * sizeof(GLuint), &this->Indices[0], GL_STATIC_DRAW );
+      BufferStaticData( GL_ELEMENT_ARRAY_BUFFER, this->Indices.size() * sizeof(GLuint), &this->Indices[0] );
+      MemoryTracker::AddObject( MEMORY_MODEL, MEMORY_OBJECT_BUFFER, this->IndicesBuffer, this->Indices.size() * sizeof(GLuint) );
 
       glBindVertexArray( 0 );
 
@@ -320,7 +325,28 @@ void Model::UnbindTexture(){
    glBindTexture( GL_TEXTURE_2D, 0 );
 }
 
+void Model::BindMesh(){
+   glBindVertexArray( this->VAO );
+}
+
+void Model::DrawInstance( GLuint i ){
+   if( i >= this->ModelMatrix.size() ){
+      return;
+   }
+   glUniformMatrix4fv( *Model::ModelUniformId, 1, GL_FALSE, glm::value_ptr( this->ModelMatrix[i] ) );
+   glDrawElements( GL_TRIANGLES, this->Indices.size(), GL_UNSIGNED_INT, (GLvoid *)0 );
+}
+
+void Model::DrawDepth( GLuint i ){
+   if( i >= this->ModelMatrix.size() ){
+      return;
+   }
+   glUniformMatrix4fv( *Model::ModelUniformDepth, 1, GL_FALSE, glm::value_ptr( this->ModelMatrix[i] ) );
+   glDrawElements( GL_TRIANGLES, this->Indices.size(), GL_UNSIGNED_INT, (GLvoid *)0 );
+}
+
 void Model::Draw(){
+   PROFILE_SCOPE( "Model::Draw" );
    //Bind Texture into Uniform:
    glUniform3fv( *Model::AmbientUniformId, 1, glm::value_ptr( this->Ambient ) );
    glUniform3fv( *Model::DiffuseUniformId, 1, glm::value_ptr( this->Diffuse ) );
@@ -339,9 +365,13 @@ void Model::Draw(){
    //Bind VAO:
    glBindVertexArray( this->VAO );
 
-   for( this->It = this->ModelMatrix.begin(); this->It != this->ModelMatrix.end(); ++this->It ){
-      //Bind all ModelMatrix into Uniform:
-      glUniformMatrix4fv( *Model::ModelUniformId, 1, GL_FALSE, glm::value_ptr( *this->It ) );
+   std::vector <GLuint>::iterator it;
+   for( it = this->VisibleIndex.begin(); it != this->VisibleIndex.end(); ++it ){
+      if( *it >= this->ModelMatrix.size() ){
+         continue;
+      }
+      //Bind visible ModelMatrix into Uniform:
+      glUniformMatrix4fv( *Model::ModelUniformId, 1, GL_FALSE, glm::value_ptr( this->ModelMatrix[*it] ) );
       //Draw:
       glDrawElements( GL_TRIANGLES, this->Indices.size(), GL_UNSIGNED_INT, (GLvoid *)0 );
    }
@@ -356,6 +386,68 @@ void Model::Draw(){
    glBindTexture( GL_TEXTURE_2D, 0 );
 }
 
+void Model::Cull( const Frustum &frustum ){
+   this->VisibleIndex.clear();
+   if( this->Init ){
+      frustum.TestBoxes( this->ModelMatrix, this->CollisionMin, this->CollisionMax, this->VisibleIndex );
+   }
+   this->UpdateMemory();
+}
+
+void Model::SetAllVisible(){
+   this->VisibleIndex.resize( this->ModelMatrix.size() );
+   for( unsigned int i = 0; i < this->VisibleIndex.size(); ++i ){
+      this->VisibleIndex[i] = i;
+   }
+   this->UpdateMemory();
+}
+
+unsigned int Model::ReturnVisible() const{
+   return this->VisibleIndex.size();
+}
+
+unsigned int Model::ReturnCulled() const{
+   return this->ModelMatrix.size() - this->VisibleIndex.size();
+}
+
+void Model::ClearVisible(){
+   //Growth from previous AddVisible() calls:
+   this->UpdateMemory();
+   this->VisibleIndex.clear();
+}
+
+void Model::AddVisible( GLuint i ){
+   this->VisibleIndex.push_back( i );
+}
+
+const std::vector <GLuint> & Model::ReturnVisibleIndex() const{
+   return this->VisibleIndex;
+}
+
+unsigned int Model::ReturnInstances() const{
+   return this->ModelMatrix.size();
+}
+
+const glm::mat4 & Model::ReturnMatrix( unsigned int i ) const{
+   return this->ModelMatrix.at( i );
+}
+
+glm::vec3 Model::ReturnCollisionMin() const{
+   return this->CollisionMin;
+}
+
+glm::vec3 Model::ReturnCollisionMax() const{
+   return this->CollisionMax;
+}
+
+const std::vector <Packe> & Model::ReturnVertices() const{
+   return this->Vertices;
+}
+
+const std::vector <GLuint> & Model::ReturnIndices() const{
+   return this->Indices;
+}
+
 void Model::DrawNoTexture(){
    glBindVertexArray( this->VAO );
    for( this->It = this->ModelMatrix.begin(); this->It != this->ModelMatrix.end(); ++this->It ){
@@ -374,9 +466,7 @@ GLuint Model::ReturnTextureSpecular(){
 }
 
 void Model::Translate( glm::vec3 &in ){
-   for( this->It = this->ModelMatrix.begin(); this->It != this->ModelMatrix.end(); ++this->It ){
-      *this->It =  glm::translate( *this->It, in );
-   }
+   this->Transform( glm::translate( glm::mat4( 1.0f ), in ) );
 }
 
 void Model::Translate( unsigned int i, glm::vec3 &in ){
@@ -384,9 +474,7 @@ void Model::Translate( unsigned int i, glm::vec3 &in ){
 }
 
 void Model::Rotate( GLfloat angle, glm::vec3 &in ){
-   for( this->It = this->ModelMatrix.begin(); this->It != this->ModelMatrix.end(); ++this->It ){
-      *this->It =  glm::rotate( *this->It, glm::radians( angle ), in );
-   }
+   this->Transform( glm::rotate( glm::mat4( 1.0f ), glm::radians( angle ), in ) );
 }
 
 void Model::Rotate( unsigned int i, GLfloat angle, glm::vec3 &in ){
@@ -394,9 +482,7 @@ void Model::Rotate( unsigned int i, GLfloat angle, glm::vec3 &in ){
 }
 
 void Model::Scale( glm::vec3 &in ){
-   for( this->It = this->ModelMatrix.begin(); this->It != this->ModelMatrix.end(); ++this->It ){
-      *this->It =  glm::scale( *this->It, in );
-   }
+   this->Transform( glm::scale( glm::mat4( 1.0f ), in ) );
 }
 
 void Model::Scale( unsigned int i, glm::vec3 &in ){
@@ -405,14 +491,17 @@ void Model::Scale( unsigned int i, glm::vec3 &in ){
 
 void Model::AddMatrix( glm::mat4 &in ){
    this->ModelMatrix.push_back( in );
+   this->UpdateMemory();
 }
 
 void Model::AddMatrix( glm::vec3 &in ){
    this->ModelMatrix.push_back( glm::translate( glm::mat4( 1.0f ), in ) );
+   this->UpdateMemory();
 }
 
 void Model::AddMatrix(){
    this->ModelMatrix.push_back( glm::mat4( 1.0f ) );
+   this->UpdateMemory();
 }
 
 void Model::ChangeMatrix( unsigned int i, glm::vec3 &in ){
@@ -423,11 +512,14 @@ void Model::ChangeMatrix( unsigned int i, glm::mat4 &in ){
 }
 
 void Model::SetCollision(){
+   this->CollisionSquare.clear();
    if( this->Init ){
-      this->CollisionMin = this->Vertices[0];
-      this->CollisionMax = this->Vertices[0];
-      std::vector <glm::vec3>::iterator it;
-      for( it = this->Vertices.begin(); it != this->Vertices.end(); ++it ){
+      this->CollisionMin = this->Vertices[0].position;
+      this->CollisionMax = this->Vertices[0].position;
+      std::vector <Packe>::iterator it_vertex;
+      glm::vec3 *it;
+      for( it_vertex = this->Vertices.begin(); it_vertex != this->Vertices.end(); ++it_vertex ){
+         it = &it_vertex->position;
          // CollisionMin:
          if( it->x < this->CollisionMin.x ){
             this->CollisionMin.x = it->x;
@@ -488,12 +580,18 @@ void Model::SetCollision(){
       this->CollisionSquare.push_back( glm::vec3( this->CollisionMin.x, this->CollisionMin.y, this->CollisionMax.z ) );
       this->CollisionSquare.push_back( glm::vec3( this->CollisionMin.x, this->CollisionMax.y, this->CollisionMax.z ) );
 //end edges;
+   }
+   this->UpdateMemory();
+}
 
+void Model::BindCollisionSquare(){
+   if( this->Init and this->CollisionSquareVao == 0 ){
       glGenVertexArrays( 1, &this->CollisionSquareVao );
 
       glGenBuffers( 1, &this->CollisionSquareVertexBuffer );
       glBindBuffer( GL_ARRAY_BUFFER, this->CollisionSquareVertexBuffer );
       glBufferData( GL_ARRAY_BUFFER, this->CollisionSquare.size() * sizeof( glm::vec3 ), &this->CollisionSquare[0], GL_STATIC_DRAW );
+      MemoryTracker::AddObject( MEMORY_MODEL, MEMORY_OBJECT_BUFFER, this->CollisionSquareVertexBuffer, this->CollisionSquare.size() * sizeof( glm::vec3 ) );
 
       glBindVertexArray( this->CollisionSquareVao );
 
@@ -517,3 +615,33 @@ void Model::DrawCollisionSquare(){
 
    glBindVertexArray( 0 );
 }
+
+void Model::Transform( const glm::mat4 &transform ){
+   TransformData data;
+   data.Matrices = this->ModelMatrix.empty() ? NULL : &this->ModelMatrix[0];
+   data.Transform = transform;
+   if( Model::Jobs != NULL and this->ModelMatrix.size() >= MODEL_PARALLEL_MATRICES ){
+      Model::Jobs->ParallelFor( Model::TransformJob, &data, this->ModelMatrix.size() );
+   }
+   else{
+      Model::TransformJob( &data, 0, this->ModelMatrix.size() );
+   }
+}
+
+void Model::TransformJob( void *data, unsigned int begin, unsigned int end ){
+   TransformData *transform = static_cast <TransformData *>( data );
+   for( unsigned int i = begin; i < end; ++i ){
+      transform->Matrices[i] = transform->Matrices[i] * transform->Transform;
+   }
+}
+
+void Model::UpdateMemory(){
+   const Sint64 bytes =
+      this->Vertices.capacity() * sizeof( Packe ) +
+      this->Indices.capacity() * sizeof( GLuint ) +
+      this->ModelMatrix.capacity() * sizeof( glm::mat4 ) +
+      this->VisibleIndex.capacity() * sizeof( GLuint ) +
+      this->CollisionSquare.capacity() * sizeof( glm::vec3 );
+   MemoryTracker::Resize( MEMORY_MODEL, MEMORY_CPU, this->CpuMemory, bytes );
+   this->CpuMemory = bytes;
+}
@@ -8,6 +8,29 @@
 #include <vector>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <SDL2/SDL.h>
+#include "frustum.hpp"
+#include "objloader.hpp"
+#include "jobsystem.hpp"
+
+/*!
+   \brief Ilość macierzy modelu, od której \link Model::Translate() \endlink, \link Model::Rotate() \endlink i \link Model::Scale() \endlink używają wielu wątków.
+*/
+#define MODEL_PARALLEL_MATRICES 4096
+
+/*!
+   \brief Dane zadania \link Model::TransformJob() \endlink.
+*/
+struct TransformData{
+   /*!
+      \brief Pierwsza macierz modelu.
+   */
+   glm::mat4 *Matrices;
+   /*!
+      \brief Macierz przekształcenia.
+   */
+   glm::mat4 Transform;
+};
 
 /*!
    \brief Klasa odpowiedzialna za zarządzaniem modelem obiektu.
@@ -145,8 +168,15 @@ public:
       \brief Wczytuje dane obiektu z pliku .obj oraz .mtl. Ustala granice/kolizje obiektu.
 
       W razie błędu \link Init \endlink = FALSE.\n
+      Nie wywołuje funkcji OpenGL, różne obiekty mogą być wczytywane w osobnych wątkach.\n
    */
    void Load_OBJ();
+   /*!
+      \brief Ustala granice obiektu dla wszystkich obiektów ( \link CollisionMin \endlink, \link CollisionMax \endlink, \link CollisionSquare \endlink ) z wierzchołków.
+
+      Wywoływana przez \link Load_OBJ() \endlink, ponowne wywołanie liczy granice od nowa.\n
+   */
+   void SetCollision();
    /*!
       \brief Wczytuje teksturę główną i spektralną dla obiektu.
    */
@@ -155,6 +185,7 @@ public:
       \brief Wczytuje dane obiektu z pliku .obj, .mtl oraz teksturę główną i spektralną. Ustala granice/kolizje obiektu. Tworzy VAO (Vertex Array Object).
 
       W razie błędu \link Init \endlink = FALSE.\n
+      Plik .obj nie jest wczytywany ponownie, jeśli wcześniej wywołano \link Load_OBJ() \endlink.\n
    */
    void Load();
    /*!
@@ -170,9 +201,29 @@ public:
    */
    void UnbindTexture();
    /*!
-      \brief Rysuje wszystkie obiekty.
+      \brief Aktywuje VAO obiektu.
+   */
+   void BindMesh();
+   /*!
+      \brief Rysuje jeden obiekt.
+
+      \param i - numer macierzy modelu
+
+      Przed rysowaniem należy aktywować teksturę ( \link BindTexture() \endlink ) i VAO ( \link BindMesh() \endlink ).
+   */
+   void DrawInstance( GLuint i );
+   /*!
+      \brief Rysuje jeden obiekt shaderem głębokości (bez tekstur).
+
+      \param i - numer macierzy modelu
 
-      Przekazuje informacje do shaderów, aktywuje teksturę główną i spektralną oraz rysuje wszystkie obiekty.
+      Przed rysowaniem należy aktywować VAO ( \link BindMesh() \endlink ).
+   */
+   void DrawDepth( GLuint i );
+   /*!
+      \brief Rysuje wszystkie widoczne obiekty.
+
+      Przekazuje informacje do shaderów, aktywuje teksturę główną i spektralną oraz rysuje obiekty z \link VisibleIndex \endlink.
    */
    void Draw();
    /*!
@@ -187,6 +238,66 @@ public:
       Przekazuje informacje do shaderów oraz rysuje granice/kolizje wszystkich obiektów.
    */
    void DrawCollisionSquare();
+   /*!
+      \brief Odrzuca obiekty znajdujące się poza bryłą widzenia.
+
+      \param frustum - bryła widzenia kamery
+
+      Wypełnia \link VisibleIndex \endlink numerami widocznych macierzy modelu.
+   */
+   void Cull( const Frustum &frustum );
+   /*!
+      \brief Oznacza wszystkie obiekty jako widoczne.
+   */
+   void SetAllVisible();
+   /*!
+      \brief Zwraca ilość widocznych obiektów z ostatniego \link Cull() \endlink.
+   */
+   unsigned int ReturnVisible() const;
+   /*!
+      \brief Zwraca ilość odrzuconych obiektów z ostatniego \link Cull() \endlink.
+   */
+   unsigned int ReturnCulled() const;
+   /*!
+      \brief Usuwa wszystkie obiekty z \link VisibleIndex \endlink.
+   */
+   void ClearVisible();
+   /*!
+      \brief Dodaje obiekt do \link VisibleIndex \endlink.
+
+      \param i - numer macierzy modelu
+   */
+   void AddVisible( GLuint i );
+   /*!
+      \brief Zwraca numery widocznych macierzy modelu ( \link VisibleIndex \endlink ).
+   */
+   const std::vector <GLuint> & ReturnVisibleIndex() const;
+   /*!
+      \brief Zwraca ilość macierzy modelu (obiektów).
+   */
+   unsigned int ReturnInstances() const;
+   /*!
+      \brief Zwraca i-tą macierz modelu ( \link ModelMatrix \endlink ).
+
+      \param i - numer macierzy
+   */
+   const glm::mat4 & ReturnMatrix( unsigned int i ) const;
+   /*!
+      \brief Zwraca minimalną granicę/kolizję obiektu ( \link CollisionMin \endlink ).
+   */
+   glm::vec3 ReturnCollisionMin() const;
+   /*!
+      \brief Zwraca maksymalną granicę/kolizję obiektu ( \link CollisionMax \endlink ).
+   */
+   glm::vec3 ReturnCollisionMax() const;
+   /*!
+      \brief Zwraca wierzchołki obiektu w przestrzeni modelu ( \link Vertices \endlink ).
+   */
+   const std::vector <Packe> & ReturnVertices() const;
+   /*!
+      \brief Zwraca indeksy wierzchołków obiektu ( \link Indices \endlink ).
+   */
+   const std::vector <GLuint> & ReturnIndices() const;
    /*!
       \brief Zwraca identyfikator głównej tekstury ( \link Texture \endlink ).
    */
@@ -304,7 +415,42 @@ public:
       \brief Wskaźnik do uniformu koloru granicy/kolizji.
    */
    static GLuint * UniformColorLight;
+   //for depth pre-pass:
+   /*!
+      \brief Wskaźnik do uniformu macierzy modelu w shaderze głębokości.
+   */
+   static GLuint * ModelUniformDepth;
+   /*!
+      \brief Wskaźnik na system zadań dla zmian wszystkich macierzy modelu, NULL = w jednym wątku.
+   */
+   static JobSystem * Jobs;
 private:
+   /*!
+      \brief Mnoży wszystkie macierze modelu przez \p transform (z prawej strony).
+
+      Od \link MODEL_PARALLEL_MATRICES \endlink macierzy praca dzielona jest pomiędzy wątki \link Jobs \endlink.\n
+
+      \param transform - macierz przekształcenia
+   */
+   void Transform( const glm::mat4 &transform );
+   /*!
+      \brief Zadanie dla \link Transform() \endlink.
+
+      \param data - wskaźnik na \link TransformData \endlink
+      \param begin - pierwsza macierz
+      \param end - koniec przedziału macierzy
+   */
+   static void TransformJob( void *data, unsigned int begin, unsigned int end );
+   /*!
+      \brief Tworzy VAO granicy/kolizji obiektu ( \link CollisionSquare \endlink ).
+   */
+   void BindCollisionSquare();
+   /*!
+      \brief Zgłasza zmianę pamięci CPU wierzchołków, indeksów, macierzy i kolizji ( \link MemoryTracker \endlink ).
+
+      Liczona jest pojemność wektorów, więc zgłoszenie następuje tylko przy przydziale nowego bloku.\n
+   */
+   void UpdateMemory();
    /*!
       \brief Nazwa obiektu.
    */
@@ -316,34 +462,18 @@ private:
    GLuint VAO;
    //Data file:
    /*!
-      \brief Wektor Wierzchołków.
+      \brief Wektor Wierzchołków (pozycja, UV Mapa i Normalna przeplecione w jednym buforze).
    */
-   std::vector <glm::vec3> Vertices;
-   /*!
-      \brief Wektor UV Map.
-   */
-   std::vector <glm::vec2> Uvs;
-   /*!
-      \brief Wektor Normalnych.
-   */
-   std::vector <glm::vec3> Normals;
+   std::vector <Packe> Vertices;
    /*!
       \brief Wektor Indeksów Wierzchołków.
    */
    std::vector <GLuint> Indices;
    //Buffer:
    /*!
-      \brief Identyfikator Wierzchołków.
+      \brief Identyfikator Wierzchołków ( \link Packe \endlink ).
    */
    GLuint VertexBuffer;
-   /*!
-      \brief Identyfikator UV Map.
-   */
-   GLuint UvBuffer;
-   /*!
-      \brief Identyfikator Normalnych.
-   */
-   GLuint NormalBuffer;
    /*!
       \brief Identyfikator Indeksów Wierzchołków.
    */
@@ -383,6 +513,10 @@ private:
       \brief Iterator dla macierzy modelu.
    */
    std::vector <glm::mat4>::iterator It;
+   /*!
+      \brief Numery macierzy modelu, które zostaną narysowane ( \link Cull() \endlink ).
+   */
+   std::vector <GLuint> VisibleIndex;
    //for light:
    /*!
       \brief Wartość Ambient.
@@ -401,10 +535,6 @@ private:
    */
    GLfloat Shininess = 32.0f;
    //Collision:
-   /*!
-      \brief Ustala granice obiektu dla wszystkich obiektów.
-   */
-   void SetCollision();
    /*!
       \var CollisionMin
       \brief Minimalna granica/kolizja obiektu.
@@ -436,6 +566,11 @@ private:
       \brief Poprawność zainicjalizowanych wszystkich elementów. FALSE = Błąd.
    */
    bool Init = false;
+   //Memory:
+   /*!
+      \brief Pamięć CPU zgłoszona do \link MemoryTracker \endlink w bajtach.
+   */
+   Sint64 CpuMemory = 0;
 };
 
 #endif
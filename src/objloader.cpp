@@ -9,6 +9,7 @@
 #include <map>
 #include <cstring>
 #include <SDL2/SDL.h>
+#include "profiler.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -162,15 +163,6 @@ bool LoadOBJ( const char* obj_path_file,
    return true;
 }
 
-struct Packe{
-   glm::vec3 position;
-   glm::vec2 uv;
-   glm::vec3 normal;
-   bool operator<(const Packe that) const{
-      return memcmp( (void*)this, (void*)&that, sizeof( Packe ) ) > 0;
-   };
-};
-
 bool GetSimilarVertexIndex(
    Packe &packed,
    std::map <Packe, GLuint> &VertexToOutIndex,
@@ -228,6 +220,7 @@ bool LoadAssimp( const char *path_file,
    uvs.clear();
    normals.clear();
    indices.clear();
+   PROFILE_SCOPE( "LoadAssimp" );
    SDL_Log( "Loading file: %s\n", path_file );
    Assimp::Importer importer;
    const aiScene* scene = importer.ReadFile( path_file, 0 );
@@ -271,6 +264,122 @@ bool LoadAssimp( const char *path_file,
    return true;
 }
 
+void IndexVBO( std::vector <glm::vec3> &in_vertices,
+   std::vector <glm::vec2> &in_uvs,
+   std::vector <glm::vec3> &in_normals,
+   std::vector <GLuint> &out_indices,
+   std::vector <Packe> &out_vertices
+){
+   std::map <Packe, GLuint> VertexToOutIndex;
+   unsigned int i = 0;
+   GLuint index, newindex;
+   for ( i = 0; i < in_vertices.size(); ++i ){
+      Packe packed = {
+         in_vertices[i],
+         in_uvs[i],
+         in_normals[i]
+      };
+      bool found = GetSimilarVertexIndex( packed, VertexToOutIndex, index );
+      if ( found ){
+         out_indices.push_back( index );
+      }
+      else{
+         out_vertices.push_back( packed );
+         newindex = (GLuint)out_vertices.size() - 1;
+         out_indices.push_back( newindex );
+         VertexToOutIndex[packed] = newindex;
+      }
+   }
+}
+
+bool LoadAssimp( const char *path_file,
+   std::vector <Packe> &vertices,
+   std::vector <GLuint> &indices
+){
+   vertices.clear();
+   indices.clear();
+   PROFILE_SCOPE( "LoadAssimp" );
+   SDL_Log( "Loading file: %s\n", path_file );
+   Assimp::Importer importer;
+   const aiScene* scene = importer.ReadFile( path_file, 0 );
+   if( !scene ){
+      SDL_LogError( SDL_LOG_CATEGORY_INPUT, "importer.ReadFile: %s\n", importer.GetErrorString() );
+      return false;
+   }
+   const aiMesh* mesh = scene->mMeshes[0];
+   unsigned int i = 0;
+   //interleaved vertices, written in place:
+   vertices.resize( mesh->mNumVertices );
+   for( i = 0; i < mesh->mNumVertices; ++i ){
+      Packe &vertex = vertices[i];
+      vertex.position.x = mesh->mVertices[i].x;
+      vertex.position.y = mesh->mVertices[i].y;
+      vertex.position.z = mesh->mVertices[i].z;
+      //important!
+      //This is done because most images have the top y-axis inversed with OpenGL's top y-axis.
+      //or conver in shader
+      vertex.uv.x = mesh->mTextureCoords[0][i].x;
+      vertex.uv.y = 1.0 - mesh->mTextureCoords[0][i].y;
+      vertex.normal.x = mesh->mNormals[i].x;
+      vertex.normal.y = mesh->mNormals[i].y;
+      vertex.normal.z = mesh->mNormals[i].z;
+   }
+   //indices:
+   indices.resize( 3*mesh->mNumFaces );
+   for( i = 0; i < mesh->mNumFaces; ++i ){
+      indices[3*i] = mesh->mFaces[i].mIndices[0];
+      indices[3*i+1] = mesh->mFaces[i].mIndices[1];
+      indices[3*i+2] = mesh->mFaces[i].mIndices[2];
+   }
+   SDL_Log( "vertex:%u   indices:%u\n", (unsigned int)vertices.size(), (unsigned int)indices.size() );
+   SDL_Log( "Loaded file: %s\n", path_file );
+   return true;
+}
+
+bool LoadAssimp( const char *path_file,
+   std::vector <glm::vec3> &positions,
+   std::vector <GLuint> &indices
+){
+   positions.clear();
+   indices.clear();
+   PROFILE_SCOPE( "LoadAssimp" );
+   SDL_Log( "Loading file: %s\n", path_file );
+   Assimp::Importer importer;
+   const aiScene* scene = importer.ReadFile( path_file, 0 );
+   if( !scene ){
+      SDL_LogError( SDL_LOG_CATEGORY_INPUT, "importer.ReadFile: %s\n", importer.GetErrorString() );
+      return false;
+   }
+   const aiMesh* mesh = scene->mMeshes[0];
+   unsigned int i = 0;
+   //positions:
+   positions.resize( mesh->mNumVertices );
+   for( i = 0; i < mesh->mNumVertices; ++i ){
+      positions[i].x = mesh->mVertices[i].x;
+      positions[i].y = mesh->mVertices[i].y;
+      positions[i].z = mesh->mVertices[i].z;
+   }
+   //indices:
+   indices.resize( 3*mesh->mNumFaces );
+   for( i = 0; i < mesh->mNumFaces; ++i ){
+      indices[3*i] = mesh->mFaces[i].mIndices[0];
+      indices[3*i+1] = mesh->mFaces[i].mIndices[1];
+      indices[3*i+2] = mesh->mFaces[i].mIndices[2];
+   }
+   SDL_Log( "vertex:%u   indices:%u\n", (unsigned int)positions.size(), (unsigned int)indices.size() );
+   SDL_Log( "Loaded file: %s\n", path_file );
+   return true;
+}
+
+void BufferStaticData( GLenum target, GLsizeiptr size, const GLvoid *data ){
+   if( GLEW_VERSION_4_4 or GLEW_ARB_buffer_storage ){
+      glBufferStorage( target, size, data, 0 );
+   }
+   else{
+      glBufferData( target, size, data, GL_STATIC_DRAW );
+   }
+}
+
 void LoadMTL( const char *path_file,
    glm::vec3 &ambient,
    glm::vec3 &diffuse,
@@ -4,8 +4,34 @@
 */
 #ifndef objloader_hpp
 #define objloader_hpp
+#include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <vector>
+#include <cstring>
+
+/*!
+   \brief Wierzchołek z przeplecionymi danymi (pozycja, UV, normalna), układ bufora wierzchołków.
+*/
+struct Packe{
+   /*!
+      \brief Pozycja wierzchołka.
+   */
+   glm::vec3 position;
+   /*!
+      \brief UV Mapa wierzchołka.
+   */
+   glm::vec2 uv;
+   /*!
+      \brief Normalna wierzchołka.
+   */
+   glm::vec3 normal;
+   /*!
+      \brief Porównanie bajtowe, potrzebne dla std::map w \link IndexVBO() \endlink.
+   */
+   bool operator<(const Packe that) const{
+      return memcmp( (void*)this, (void*)&that, sizeof( Packe ) ) > 0;
+   };
+};
 
 /*!
    \brief Ładuje plik .obj do pamięci.
@@ -43,6 +69,37 @@ bool LoadAssimp( const char *path_file,
    std::vector <GLuint> &indices
 );
 
+/*!
+   \brief Ładuje plik .obj do pamięci jako przeplecione wierzchołki.
+
+   \param path_file - ścieżka do pliku .obj
+   \param vertices - wektor Wierzchołków ( \link Packe \endlink )
+   \param indices - wektor Indeksów Wierzchołków
+   \return - wartość logiczną dla ładowania pliku .obj, FALSE = błąd
+
+   Wykorzystuje bibliotekę assimp.\n
+   Dane zapisywane są bezpośrednio w układzie bufora wierzchołków.\n
+*/
+bool LoadAssimp( const char *path_file,
+   std::vector <Packe> &vertices,
+   std::vector <GLuint> &indices
+);
+
+/*!
+   \brief Ładuje z pliku .obj tylko pozycje wierzchołków.
+
+   \param path_file - ścieżka do pliku .obj
+   \param positions - wektor pozycji Wierzchołków
+   \param indices - wektor Indeksów Wierzchołków
+   \return - wartość logiczną dla ładowania pliku .obj, FALSE = błąd
+
+   Wykorzystuje bibliotekę assimp.
+*/
+bool LoadAssimp( const char *path_file,
+   std::vector <glm::vec3> &positions,
+   std::vector <GLuint> &indices
+);
+
 /*!
    \brief Tworzy Indeks Wierzchołków
 
@@ -66,6 +123,37 @@ void IndexVBO( std::vector <glm::vec3> &in_vertices,
    std::vector <glm::vec3> &out_normals
 );
 
+/*!
+   \brief Tworzy Indeks Wierzchołków z przeplecionymi danymi.
+
+   \param in_vertices - wektor Wierzchołków wejściowych
+   \param in_uvs - wektor UV Map wejściowych
+   \param in_normals - wektor Normalnych wejściowych
+   \param out_indices - wektor Indeksów Wierzchołków wyjściowy
+   \param out_vertices - wektor Wierzchołków wyjściowy ( \link Packe \endlink )
+
+   Nie wykorzystuje zewnętrznych bibliotek.\n
+*/
+void IndexVBO( std::vector <glm::vec3> &in_vertices,
+   std::vector <glm::vec2> &in_uvs,
+   std::vector <glm::vec3> &in_normals,
+   std::vector <GLuint> &out_indices,
+   std::vector <Packe> &out_vertices
+);
+
+/*!
+   \brief Tworzy bufor OpenGL o stałej zawartości.
+
+   \param target - typ bufora (np. GL_ARRAY_BUFFER)
+   \param size - wielkość danych w bajtach
+   \param data - dane
+
+   Bufor musi być wcześniej aktywowany ( glBindBuffer ).\n
+   Wykorzystuje niezmienny bufor ( glBufferStorage ), jeśli jest dostępny ( OpenGL 4.4 lub ARB_buffer_storage ),
+   w przeciwnym przypadku glBufferData z GL_STATIC_DRAW.\n
+*/
+void BufferStaticData( GLenum target, GLsizeiptr size, const GLvoid *data );
+
 /*!
    \brief Ładuje plik .mtl do pamięci.
 
@@ -0,0 +1,250 @@
+/*!
+   \file occlusion.cpp
+   \brief Plik źródłowy dla occlusion.hpp.
+*/
+#include "occlusion.hpp"
+#include <cmath>
+#include <algorithm>
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define OCCLUSION_SSE
+#include <xmmintrin.h>
+#endif
+
+/*!
+   \brief Trójkąty ścian prostopadłościanu (numer wierzchołka: bit 0 = x, bit 1 = y, bit 2 = z).
+*/
+static const int BoxTriangles[36] = {
+   0, 2, 6,  0, 6, 4, //-x
+   1, 3, 7,  1, 7, 5, //+x
+   0, 1, 5,  0, 5, 4, //-y
+   2, 3, 7,  2, 7, 6, //+y
+   0, 1, 3,  0, 3, 2, //-z
+   4, 5, 7,  4, 7, 6  //+z
+};
+
+OcclusionCuller::OcclusionCuller(){
+   this->OccluderScale = OCCLUSION_OCCLUDER_SCALE;
+   this->Occluders = 0;
+   this->Occluded = 0;
+   this->Create( OCCLUSION_WIDTH, OCCLUSION_HEIGHT );
+}
+
+void OcclusionCuller::Create( int width, int height ){
+   this->Width = width < 4 ? 4 : ( width + 3 ) & ~3;
+   this->Height = height < 1 ? 1 : height;
+   this->Depth.assign( this->Width * this->Height, 1.0f );
+}
+
+void OcclusionCuller::Begin( const glm::mat4 &matrix ){
+   this->ViewProjection = matrix;
+   std::fill( this->Depth.begin(), this->Depth.end(), 1.0f );
+   this->Occluders = 0;
+   this->Occluded = 0;
+}
+
+bool OcclusionCuller::Project( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max, glm::vec3 *out ) const{
+   const glm::mat4 mvp = this->ViewProjection * matrix;
+   glm::vec4 clip;
+   for( int i = 0; i < 8; ++i ){
+      clip = mvp * glm::vec4( i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0f );
+      //Behind near plane:
+      if( clip.w <= 0.0f or clip.z < -clip.w ){
+         return false;
+      }
+      out[i].x = ( clip.x / clip.w * 0.5f + 0.5f ) * this->Width;
+      out[i].y = ( clip.y / clip.w * 0.5f + 0.5f ) * this->Height;
+      out[i].z = clip.z / clip.w * 0.5f + 0.5f;
+   }
+   return true;
+}
+
+bool OcclusionCuller::DrawOccluder( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max ){
+   const glm::vec3 center = ( min + max ) * 0.5f;
+   const glm::vec3 extent = ( max - min ) * ( 0.5f * this->OccluderScale );
+   glm::vec3 vertex[8];
+   if( ! this->Project( matrix, center - extent, center + extent, vertex ) ){
+      return false;
+   }
+   for( int i = 0; i < 36; i += 3 ){
+      this->DrawTriangle( vertex[BoxTriangles[i]], vertex[BoxTriangles[i + 1]], vertex[BoxTriangles[i + 2]] );
+   }
+   ++this->Occluders;
+   return true;
+}
+
+void OcclusionCuller::DrawTriangle( const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2 ){
+   float area = ( v1.x - v0.x ) * ( v2.y - v0.y ) - ( v1.y - v0.y ) * ( v2.x - v0.x );
+   if( std::fabs( area ) < 1e-6f ){
+      return;
+   }
+   //Counter-clockwise order:
+   const glm::vec3 &t0 = v0;
+   const glm::vec3 &t1 = area > 0.0f ? v1 : v2;
+   const glm::vec3 &t2 = area > 0.0f ? v2 : v1;
+   area = std::fabs( area );
+   //Pixels with center inside bounding rectangle:
+   int x0 = (int)std::ceil( std::min( t0.x, std::min( t1.x, t2.x ) ) - 0.5f );
+   int x1 = (int)std::floor( std::max( t0.x, std::max( t1.x, t2.x ) ) - 0.5f );
+   int y0 = (int)std::ceil( std::min( t0.y, std::min( t1.y, t2.y ) ) - 0.5f );
+   int y1 = (int)std::floor( std::max( t0.y, std::max( t1.y, t2.y ) ) - 0.5f );
+   x0 = std::max( x0, 0 ) & ~3;
+   y0 = std::max( y0, 0 );
+   x1 = std::min( x1, this->Width - 1 );
+   y1 = std::min( y1, this->Height - 1 );
+   if( x0 > x1 or y0 > y1 ){
+      return;
+   }
+   //Edge functions ( A * x + B * y + C >= 0 inside ):
+   const glm::vec3 *v[3] = { &t0, &t1, &t2 };
+   float A[3], B[3], C[3];
+   for( int i = 0; i < 3; ++i ){
+      const glm::vec3 &a = *v[i];
+      const glm::vec3 &b = *v[( i + 1 ) % 3];
+      A[i] = a.y - b.y;
+      B[i] = b.x - a.x;
+      C[i] = ( b.y - a.y ) * a.x - ( b.x - a.x ) * a.y;
+   }
+   //Depth plane:
+   const float dzdx = ( ( t1.z - t0.z ) * ( t2.y - t0.y ) - ( t2.z - t0.z ) * ( t1.y - t0.y ) ) / area;
+   const float dzdy = ( ( t1.x - t0.x ) * ( t2.z - t0.z ) - ( t2.x - t0.x ) * ( t1.z - t0.z ) ) / area;
+   const float dz = t0.z - dzdx * t0.x - dzdy * t0.y;
+   float py;
+   int x, y;
+#ifdef OCCLUSION_SSE
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 lane = _mm_set_ps( 3.5f, 2.5f, 1.5f, 0.5f );
+   const __m128 a0 = _mm_set1_ps( A[0] ), a1 = _mm_set1_ps( A[1] ), a2 = _mm_set1_ps( A[2] );
+   const __m128 zx = _mm_set1_ps( dzdx );
+   __m128 px, row0, row1, row2, rowz, mask, depth, buffer;
+   float *line;
+   for( y = y0; y <= y1; ++y ){
+      py = y + 0.5f;
+      row0 = _mm_set1_ps( B[0] * py + C[0] );
+      row1 = _mm_set1_ps( B[1] * py + C[1] );
+      row2 = _mm_set1_ps( B[2] * py + C[2] );
+      rowz = _mm_set1_ps( dzdy * py + dz );
+      line = &this->Depth[y * this->Width];
+      for( x = x0; x <= x1; x += 4 ){
+         px = _mm_add_ps( _mm_set1_ps( (float)x ), lane );
+         mask = _mm_and_ps( _mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( a0, px ), row0 ), zero ),
+                _mm_and_ps( _mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( a1, px ), row1 ), zero ),
+                            _mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( a2, px ), row2 ), zero ) ) );
+         if( _mm_movemask_ps( mask ) == 0 ){
+            continue;
+         }
+         buffer = _mm_loadu_ps( line + x );
+         depth = _mm_min_ps( buffer, _mm_add_ps( _mm_mul_ps( zx, px ), rowz ) );
+         _mm_storeu_ps( line + x, _mm_or_ps( _mm_and_ps( mask, depth ), _mm_andnot_ps( mask, buffer ) ) );
+      }
+   }
+#else
+   float px, depth;
+   for( y = y0; y <= y1; ++y ){
+      py = y + 0.5f;
+      for( x = x0; x <= x1; ++x ){
+         px = x + 0.5f;
+         if( A[0] * px + B[0] * py + C[0] >= 0.0f and
+             A[1] * px + B[1] * py + C[1] >= 0.0f and
+             A[2] * px + B[2] * py + C[2] >= 0.0f
+         ){
+            depth = dzdx * px + dzdy * py + dz;
+            if( depth < this->Depth[y * this->Width + x] ){
+               this->Depth[y * this->Width + x] = depth;
+            }
+         }
+      }
+   }
+#endif
+}
+
+bool OcclusionCuller::TestBox( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max ) const{
+   glm::vec3 vertex[8];
+   if( ! this->Project( matrix, min, max, vertex ) ){
+      return true;
+   }
+   glm::vec3 rect_min = vertex[0], rect_max = vertex[0];
+   for( int i = 1; i < 8; ++i ){
+      rect_min = glm::min( rect_min, vertex[i] );
+      rect_max = glm::max( rect_max, vertex[i] );
+   }
+   //Every pixel touched by screen rectangle:
+   const int x0 = std::max( (int)std::floor( rect_min.x ), 0 );
+   const int x1 = std::min( (int)std::floor( rect_max.x ), this->Width - 1 );
+   const int y0 = std::max( (int)std::floor( rect_min.y ), 0 );
+   const int y1 = std::min( (int)std::floor( rect_max.y ), this->Height - 1 );
+   if( x0 > x1 or y0 > y1 ){
+      return false;
+   }
+   int x, y;
+   const float *line;
+#ifdef OCCLUSION_SSE
+   const __m128 lane = _mm_set_ps( 3.0f, 2.0f, 1.0f, 0.0f );
+   const __m128 nearest = _mm_set1_ps( rect_min.z );
+   const __m128 left = _mm_set1_ps( (float)x0 ), right = _mm_set1_ps( (float)x1 );
+   __m128 px, mask;
+   for( y = y0; y <= y1; ++y ){
+      line = &this->Depth[y * this->Width];
+      for( x = x0 & ~3; x <= x1; x += 4 ){
+         px = _mm_add_ps( _mm_set1_ps( (float)x ), lane );
+         mask = _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( px, left ), _mm_cmple_ps( px, right ) ),
+                            _mm_cmplt_ps( nearest, _mm_loadu_ps( line + x ) ) );
+         if( _mm_movemask_ps( mask ) != 0 ){
+            return true;
+         }
+      }
+   }
+#else
+   for( y = y0; y <= y1; ++y ){
+      line = &this->Depth[y * this->Width];
+      for( x = x0; x <= x1; ++x ){
+         if( rect_min.z < line[x] ){
+            return true;
+         }
+      }
+   }
+#endif
+   return false;
+}
+
+unsigned int OcclusionCuller::Cull( Model &model ){
+   this->Visible = model.ReturnVisibleIndex();
+   model.ClearVisible();
+   unsigned int counter = 0;
+   std::vector <GLuint>::iterator it;
+   for( it = this->Visible.begin(); it != this->Visible.end(); ++it ){
+      if( *it < model.ReturnInstances() and
+          ! this->TestBox( model.ReturnMatrix( *it ), model.ReturnCollisionMin(), model.ReturnCollisionMax() )
+      ){
+         ++counter;
+      }
+      else{
+         model.AddVisible( *it );
+      }
+   }
+   this->Occluded += counter;
+   return counter;
+}
+
+void OcclusionCuller::SetOccluderScale( float scale ){
+   this->OccluderScale = scale;
+}
+
+float OcclusionCuller::ReturnDepth( int x, int y ) const{
+   return this->Depth.at( y * this->Width + x );
+}
+
+int OcclusionCuller::ReturnWidth() const{
+   return this->Width;
+}
+
+int OcclusionCuller::ReturnHeight() const{
+   return this->Height;
+}
+
+unsigned int OcclusionCuller::ReturnOccluders() const{
+   return this->Occluders;
+}
+
+unsigned int OcclusionCuller::ReturnOccluded() const{
+   return this->Occluded;
+}
@@ -0,0 +1,165 @@
+/*!
+   \file occlusion.hpp
+   \brief Plik odpowiedzialny za programowe odrzucanie obiektów zasłoniętych przez inne obiekty (occlusion culling).
+*/
+#ifndef occlusion_hpp
+#define occlusion_hpp
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "model.hpp"
+
+/*!
+   \brief Domyślna szerokość bufora głębokości (wielokrotność 4).
+*/
+#define OCCLUSION_WIDTH 256
+/*!
+   \brief Domyślna wysokość bufora głębokości.
+*/
+#define OCCLUSION_HEIGHT 128
+/*!
+   \brief Domyślna skala prostopadłościanu zasłaniającego obiektu względem jego granic/kolizji.
+
+   Granice obiektów (np. korona drzewa) nie są wypełnione w całości, dlatego zasłaniający prostopadłościan jest pomniejszany.
+*/
+#define OCCLUSION_OCCLUDER_SCALE 0.5f
+
+/*!
+   \brief Klasa odpowiedzialna za programowe odrzucanie zasłoniętych obiektów.
+
+   Prostopadłościany kilku dużych obiektów (zasłaniających) są rasteryzowane do bufora głębokości o niskiej rozdzielczości.\n
+   Następnie prostokąt na ekranie każdego widocznego obiektu porównywany jest z buforem.\n
+   Rasteryzacja i test wykorzystują instrukcje SSE (4 piksele naraz, jeśli są dostępne).\n
+   Klasa nie korzysta z OpenGL.\n
+*/
+class OcclusionCuller{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+
+      Tworzy bufor o wielkości \link OCCLUSION_WIDTH \endlink x \link OCCLUSION_HEIGHT \endlink.
+   */
+   OcclusionCuller();
+   /*!
+      \brief Tworzy bufor głębokości.
+
+      \param width - szerokość bufora (zaokrąglana w górę do wielokrotności 4)
+      \param height - wysokość bufora
+   */
+   void Create( int width, int height );
+   /*!
+      \brief Czyści bufor głębokości oraz statystyki i ustala macierz projekcji * widoku.
+
+      \param matrix - macierz projekcji * widoku
+   */
+   void Begin( const glm::mat4 &matrix );
+   /*!
+      \brief Rasteryzuje prostopadłościan obiektu zasłaniającego.
+
+      \param matrix - macierz modelu
+      \param min - minimalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \param max - maksymalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \return - wartość logiczna, FALSE = obiekt przecina bliską płaszczyznę i nie został narysowany
+
+      Prostopadłościan jest pomniejszany o \link OccluderScale \endlink.
+   */
+   bool DrawOccluder( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max );
+   /*!
+      \brief Sprawdza czy prostopadłościan obiektu nie jest zasłonięty.
+
+      \param matrix - macierz modelu
+      \param min - minimalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \param max - maksymalny punkt prostopadłościanu (w przestrzeni obiektu)
+      \return - wartość logiczna, FALSE = obiekt całkowicie zasłonięty
+   */
+   bool TestBox( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max ) const;
+   /*!
+      \brief Usuwa zasłonięte obiekty z listy widocznych obiektów modelu.
+
+      \param model - model
+      \return - ilość zasłoniętych obiektów
+   */
+   unsigned int Cull( Model &model );
+   /*!
+      \brief Ustala skalę prostopadłościanu zasłaniającego.
+
+      \param scale - nowa wartość dla \link OccluderScale \endlink
+   */
+   void SetOccluderScale( float scale );
+   /*!
+      \brief Zwraca głębokość (0.0 - 1.0) zapisaną w buforze.
+
+      \param x - pozycja x piksela
+      \param y - pozycja y piksela (0 = dół ekranu)
+   */
+   float ReturnDepth( int x, int y ) const;
+   /*!
+      \brief Zwraca szerokość bufora głębokości.
+   */
+   int ReturnWidth() const;
+   /*!
+      \brief Zwraca wysokość bufora głębokości.
+   */
+   int ReturnHeight() const;
+   /*!
+      \brief Zwraca ilość narysowanych obiektów zasłaniających od ostatniego \link Begin() \endlink.
+   */
+   unsigned int ReturnOccluders() const;
+   /*!
+      \brief Zwraca ilość obiektów zasłoniętych od ostatniego \link Begin() \endlink.
+   */
+   unsigned int ReturnOccluded() const;
+private:
+   /*!
+      \brief Rzutuje 8 wierzchołków prostopadłościanu na bufor.
+
+      \param matrix - macierz modelu
+      \param min - minimalny punkt prostopadłościanu
+      \param max - maksymalny punkt prostopadłościanu
+      \param out - wierzchołki ( x, y w pikselach, z = głębokość 0.0 - 1.0 )
+      \return - wartość logiczna, FALSE = wierzchołek znajduje się za bliską płaszczyzną
+   */
+   bool Project( const glm::mat4 &matrix, const glm::vec3 &min, const glm::vec3 &max, glm::vec3 *out ) const;
+   /*!
+      \brief Rasteryzuje trójkąt do bufora głębokości.
+
+      \param v0 - pierwszy wierzchołek
+      \param v1 - drugi wierzchołek
+      \param v2 - trzeci wierzchołek
+   */
+   void DrawTriangle( const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2 );
+   /*!
+      \brief Szerokość bufora.
+   */
+   int Width;
+   /*!
+      \brief Wysokość bufora.
+   */
+   int Height;
+   /*!
+      \brief Bufor głębokości, wiersz po wierszu od dołu ekranu.
+   */
+   std::vector <float> Depth;
+   /*!
+      \brief Macierz projekcji * widoku.
+   */
+   glm::mat4 ViewProjection;
+   /*!
+      \brief Skala prostopadłościanu zasłaniającego, domyślnie \link OCCLUSION_OCCLUDER_SCALE \endlink.
+   */
+   float OccluderScale;
+   /*!
+      \brief Ilość narysowanych obiektów zasłaniających.
+   */
+   unsigned int Occluders;
+   /*!
+      \brief Ilość zasłoniętych obiektów.
+   */
+   unsigned int Occluded;
+   /*!
+      \brief Tymczasowy wektor dla \link Cull() \endlink.
+   */
+   std::vector <GLuint> Visible;
+};
+
+#endif
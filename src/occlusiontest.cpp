@@ -0,0 +1,89 @@
+/*!
+   \file occlusiontest.cpp
+   \brief Testy \link OcclusionCuller \endlink bez kontekstu OpenGL (make test).
+
+   Kamera w punkcie ( 0, 0, 0 ) patrzy wzdłuż -z, obiekty są prostopadłościanami 1 x 1 x 1 przesuniętymi macierzą modelu.\n
+   Każdy test wypisuje wynik, program zwraca 1, jeśli któryś test się nie powiódł.\n
+   Użycie: test.app\n
+*/
+#include <cstdio>
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "occlusion.hpp"
+
+/*!
+   \brief Ilość nieudanych testów.
+*/
+static unsigned int TestFailures = 0;
+
+/*!
+   \brief Wypisuje wynik testu.
+
+   \param passed - wartość logiczna, TRUE = test udany
+   \param name - nazwa testu
+*/
+void Check( bool passed, const char *name ){
+   printf( "%-60s %s\n", name, passed ? "ok" : "FAILED" );
+   if( ! passed ){
+      ++TestFailures;
+   }
+}
+
+/*!
+   \brief Zwraca macierz modelu przesuniętą do punktu ( x, y, z ).
+
+   \param x - pozycja x środka prostopadłościanu
+   \param y - pozycja y środka prostopadłościanu
+   \param z - pozycja z środka prostopadłościanu
+*/
+glm::mat4 At( float x, float y, float z ){
+   return glm::translate( glm::mat4( 1.0f ), glm::vec3( x, y, z ) );
+}
+
+int main(){
+   const glm::vec3 min( -0.5f ), max( 0.5f );
+   const glm::mat4 view = glm::lookAt( glm::vec3( 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+   const glm::mat4 projection = glm::perspective( glm::radians( 60.0f ), 2.0f, 0.1f, 100.0f );
+   OcclusionCuller culler;
+   culler.SetOccluderScale( 1.0f );
+
+   //Empty buffer hides nothing:
+   culler.Begin( projection * view );
+   Check( culler.TestBox( At( 0.0f, 0.0f, -10.0f ), min, max ), "empty buffer keeps box" );
+
+   //Wall of 6 x 6 at distance 5:
+   const glm::mat4 wall = glm::scale( At( 0.0f, 0.0f, -5.0f ), glm::vec3( 6.0f, 6.0f, 1.0f ) );
+   culler.Begin( projection * view );
+   Check( culler.DrawOccluder( wall, min, max ), "occluder drawn" );
+   Check( culler.ReturnOccluders() == 1, "occluder counted" );
+   Check( culler.ReturnDepth( culler.ReturnWidth() / 2, culler.ReturnHeight() / 2 ) < 1.0f, "occluder written to depth buffer" );
+   Check( ! culler.TestBox( At( 0.0f, 0.0f, -10.0f ), min, max ), "box behind near occluder rejected" );
+   Check( culler.TestBox( At( 0.0f, 0.0f, -3.0f ), min, max ), "box in front of occluder kept" );
+   Check( culler.TestBox( At( 6.0f, 0.0f, -10.0f ), min, max ), "box partly beside occluder kept" );
+   Check( culler.TestBox( At( 20.0f, 0.0f, -30.0f ), min, max ), "box beside occluder kept" );
+   Check( culler.TestBox( At( 0.0f, 0.0f, -0.3f ), min, max ), "box crossing near plane kept" );
+
+   //Occluder filling whole screen, boxes on screen edges and outside of screen:
+   const glm::mat4 screen = glm::scale( At( 0.0f, 0.0f, -2.0f ), glm::vec3( 20.0f, 20.0f, 0.5f ) );
+   culler.Begin( projection * view );
+   culler.DrawOccluder( screen, min, max );
+   Check( culler.ReturnDepth( 0, 0 ) < 1.0f, "corner pixel covered" );
+   Check( culler.ReturnDepth( culler.ReturnWidth() - 1, culler.ReturnHeight() - 1 ) < 1.0f, "opposite corner pixel covered" );
+   //Half width of view at distance 10 = 10 * tan( 30 ) * 2 = 11.5:
+   Check( ! culler.TestBox( At( -11.5f, 0.0f, -10.0f ), min, max ), "box on left edge behind occluder rejected" );
+   Check( ! culler.TestBox( At( 11.5f, 0.0f, -10.0f ), min, max ), "box on right edge behind occluder rejected" );
+   Check( ! culler.TestBox( At( 0.0f, 5.8f, -10.0f ), min, max ), "box on top edge behind occluder rejected" );
+   Check( ! culler.TestBox( At( 40.0f, 0.0f, -10.0f ), min, max ), "box outside screen rejected (left to frustum culling)" );
+
+   //Buffer width rounded up to multiple of 4, right edge column still tested:
+   culler.Create( 250, 100 );
+   Check( culler.ReturnWidth() == 252, "width rounded to multiple of 4" );
+   culler.Begin( projection * view );
+   Check( culler.TestBox( At( 11.5f, 0.0f, -10.0f ), min, max ), "box on right edge of empty odd buffer kept" );
+   culler.DrawOccluder( screen, min, max );
+   Check( ! culler.TestBox( At( 11.5f, 0.0f, -10.0f ), min, max ), "box on right edge of odd buffer rejected" );
+
+   printf( "%u test(s) failed\n", TestFailures );
+   return TestFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/*!
+   \file profiler.cpp
+   \brief Plik źródłowy dla profiler.hpp.
+*/
+#include "profiler.hpp"
+#include <cstdio>
+#include <vector>
+
+/*!
+   \brief Bufor wątku, NULL = wątek nie zapisał jeszcze zdarzenia.
+*/
+static thread_local ProfileBuffer *ProfileThreadBuffer = NULL;
+/*!
+   \brief Bufory wszystkich wątków, nie są zwalniane, bo zdarzenia zakończonych wątków też są zapisywane.
+*/
+static std::vector <ProfileBuffer *> ProfileBuffers;
+/*!
+   \brief Blokada \link ProfileBuffers \endlink.
+*/
+static SDL_SpinLock ProfileBuffersLock = 0;
+
+void Profiler::Record( const char *name, Uint64 begin, Uint64 end ){
+   ProfileBuffer *buffer = Profiler::ReturnBuffer();
+   const unsigned int count = SDL_AtomicGet( &buffer->Count );
+   ProfileEvent &event = buffer->Events[count % PROFILER_EVENTS];
+   event.Name = name;
+   event.Begin = begin;
+   event.End = end;
+   event.Value = 0;
+   event.IsCounter = false;
+   //Event written before it becomes visible to Save():
+   SDL_AtomicSet( &buffer->Count, int( count + 1 ) );
+}
+
+void Profiler::Counter( const char *name, Sint64 value ){
+   ProfileBuffer *buffer = Profiler::ReturnBuffer();
+   const unsigned int count = SDL_AtomicGet( &buffer->Count );
+   ProfileEvent &event = buffer->Events[count % PROFILER_EVENTS];
+   event.Name = name;
+   event.Begin = event.End = SDL_GetPerformanceCounter();
+   event.Value = value;
+   event.IsCounter = true;
+   SDL_AtomicSet( &buffer->Count, int( count + 1 ) );
+}
+
+void Profiler::SetThreadName( const char *name ){
+   Profiler::ReturnBuffer()->Name = name;
+}
+
+bool Profiler::Save( const std::string &path ){
+   FILE *file = fopen( path.c_str(), "w" );
+   if( file == NULL ){
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Profiler: can not open %s\n", path.c_str() );
+      return false;
+   }
+   SDL_AtomicLock( &ProfileBuffersLock );
+   const std::vector <ProfileBuffer *> buffers = ProfileBuffers;
+   SDL_AtomicUnlock( &ProfileBuffersLock );
+   //Microseconds from the oldest event:
+   const double scale = 1000000.0 / double( SDL_GetPerformanceFrequency() );
+   Uint64 origin = 0;
+   unsigned int begin, end;
+   for( unsigned int i = 0; i < buffers.size(); ++i ){
+      end = SDL_AtomicGet( &buffers[i]->Count );
+      begin = end > PROFILER_EVENTS ? end - PROFILER_EVENTS : 0;
+      //Outer scopes are recorded after inner ones, but begin earlier:
+      for( unsigned int j = begin; j < end; ++j ){
+         const Uint64 first = buffers[i]->Events[j % PROFILER_EVENTS].Begin;
+         if( origin == 0 or first < origin ){
+            origin = first;
+         }
+      }
+   }
+   unsigned int events = 0;
+   fprintf( file, "{\"traceEvents\":[\n" );
+   for( unsigned int i = 0; i < buffers.size(); ++i ){
+      fprintf( file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+         i > 0 ? ",\n" : "",
+         buffers[i]->Thread,
+         buffers[i]->Name
+      );
+      end = SDL_AtomicGet( &buffers[i]->Count );
+      begin = end > PROFILER_EVENTS ? end - PROFILER_EVENTS : 0;
+      for( unsigned int j = begin; j < end; ++j ){
+         const ProfileEvent &event = buffers[i]->Events[j % PROFILER_EVENTS];
+         if( event.Begin < origin or event.End < event.Begin ){
+            //Overwritten while saving:
+            continue;
+         }
+         if( event.IsCounter ){
+            fprintf( file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"bytes\":%lld}}",
+               event.Name,
+               buffers[i]->Thread,
+               double( event.Begin - origin ) * scale,
+               (long long)event.Value
+            );
+            ++events;
+            continue;
+         }
+         fprintf( file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            event.Name,
+            buffers[i]->Thread,
+            double( event.Begin - origin ) * scale,
+            double( event.End - event.Begin ) * scale
+         );
+         ++events;
+      }
+   }
+   fprintf( file, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+   const bool result = ferror( file ) == 0;
+   fclose( file );
+   if( result ){
+      SDL_Log( "\rProfiler: %u events from %u threads saved to %s\n", events, (unsigned int)buffers.size(), path.c_str() );
+   }
+   else{
+      SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Profiler: can not write %s\n", path.c_str() );
+   }
+   return result;
+}
+
+ProfileBuffer * Profiler::ReturnBuffer(){
+   if( ProfileThreadBuffer == NULL ){
+      ProfileBuffer *buffer = new ProfileBuffer;
+      SDL_AtomicSet( &buffer->Count, 0 );
+      buffer->Name = "thread";
+      SDL_AtomicLock( &ProfileBuffersLock );
+      buffer->Thread = ProfileBuffers.size() + 1;
+      ProfileBuffers.push_back( buffer );
+      SDL_AtomicUnlock( &ProfileBuffersLock );
+      ProfileThreadBuffer = buffer;
+   }
+   return ProfileThreadBuffer;
+}
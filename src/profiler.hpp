@@ -0,0 +1,156 @@
+/*!
+   \file profiler.hpp
+   \brief Plik odpowiedzialny za pomiar czasu CPU fragmentów kodu i zapis w formacie Chrome trace_event.
+*/
+#ifndef profiler_hpp
+#define profiler_hpp
+#include <string>
+#include <SDL2/SDL.h>
+
+/*!
+   \brief Ilość zdarzeń w buforze jednego wątku, starsze zdarzenia są nadpisywane.
+*/
+#define PROFILER_EVENTS 32768
+/*!
+   \brief Domyślny plik zapisu pomiarów.
+*/
+#define PROFILER_FILE "./profile.json"
+
+/*!
+   \brief Pomiar czasu fragmentu kodu do końca bloku, nazwa musi być stałym napisem.
+
+   Z -DPROFILER_DISABLED makro jest puste i pomiar nie jest kompilowany.
+*/
+#ifndef PROFILER_DISABLED
+   #define PROFILE_JOIN_LINE( name, line ) name##line
+   #define PROFILE_JOIN( name, line ) PROFILE_JOIN_LINE( name, line )
+   #define PROFILE_SCOPE( name ) ProfileScope PROFILE_JOIN( profile_scope_, __LINE__ )( name )
+#else
+   #define PROFILE_SCOPE( name )
+#endif
+
+/*!
+   \brief Zmierzony fragment kodu.
+*/
+struct ProfileEvent{
+   /*!
+      \brief Nazwa fragmentu (stały napis).
+   */
+   const char *Name;
+   /*!
+      \brief Początek (SDL_GetPerformanceCounter()).
+   */
+   Uint64 Begin;
+   /*!
+      \brief Koniec (SDL_GetPerformanceCounter()).
+   */
+   Uint64 End;
+   /*!
+      \brief Wartość licznika ( \link Profiler::Counter() \endlink ).
+   */
+   Sint64 Value;
+   /*!
+      \brief TRUE = licznik zapisany w chwili Begin, FALSE = fragment kodu.
+   */
+   bool IsCounter;
+};
+
+/*!
+   \brief Bufor zdarzeń jednego wątku.
+*/
+struct ProfileBuffer{
+   /*!
+      \brief Zdarzenia, pierścień \link PROFILER_EVENTS \endlink.
+   */
+   ProfileEvent Events[PROFILER_EVENTS];
+   /*!
+      \brief Ilość zapisanych zdarzeń, zwiększana po zapisaniu zdarzenia.
+   */
+   SDL_atomic_t Count;
+   /*!
+      \brief Numer wątku w pliku (tid).
+   */
+   unsigned int Thread;
+   /*!
+      \brief Nazwa wątku.
+   */
+   const char *Name;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za zbieranie zdarzeń ze wszystkich wątków i zapis do pliku.
+
+   Każdy wątek zapisuje zdarzenia do własnego bufora ( \link ProfileBuffer \endlink ), tworzonego przy pierwszym zdarzeniu,
+   więc zapis nie wymaga blokady, a blokowana jest tylko lista buforów przy dodaniu nowego wątku.\n
+   \link Save() \endlink zapisuje ostatnie \link PROFILER_EVENTS \endlink zdarzeń każdego wątku w formacie JSON trace_event
+   (chrome://tracing, Perfetto), zdarzenia zapisywane w czasie zapisu do pliku mogą nadpisać najstarsze zdarzenia.\n
+*/
+class Profiler{
+public:
+   /*!
+      \brief Zapisuje zdarzenie w buforze wątku.
+
+      \param name - nazwa fragmentu (stały napis)
+      \param begin - początek (SDL_GetPerformanceCounter())
+      \param end - koniec (SDL_GetPerformanceCounter())
+   */
+   static void Record( const char *name, Uint64 begin, Uint64 end );
+   /*!
+      \brief Zapisuje wartość licznika w buforze wątku, wyświetlaną jako wykres (np. zajęta pamięć).
+
+      \param name - nazwa licznika (stały napis)
+      \param value - wartość
+   */
+   static void Counter( const char *name, Sint64 value );
+   /*!
+      \brief Ustala nazwę wątku wyświetlaną w pliku.
+
+      \param name - nazwa wątku (stały napis)
+   */
+   static void SetThreadName( const char *name );
+   /*!
+      \brief Zapisuje zdarzenia wszystkich wątków w formacie JSON trace_event.
+
+      \param path - ścieżka do pliku
+      \return - wartość logiczna, FALSE = błąd zapisu
+   */
+   static bool Save( const std::string &path );
+private:
+   /*!
+      \brief Zwraca bufor wątku, tworzy go przy pierwszym wywołaniu w wątku.
+   */
+   static ProfileBuffer * ReturnBuffer();
+};
+
+/*!
+   \brief Pomiar czasu od utworzenia do usunięcia obiektu ( \link PROFILE_SCOPE \endlink ).
+*/
+class ProfileScope{
+public:
+   /*!
+      \brief Konstruktor, początek pomiaru.
+
+      \param name - nazwa fragmentu (stały napis)
+   */
+   ProfileScope( const char *name ){
+      this->Name = name;
+      this->Begin = SDL_GetPerformanceCounter();
+   }
+   /*!
+      \brief Destruktor, koniec pomiaru ( \link Profiler::Record() \endlink ).
+   */
+   ~ProfileScope(){
+      Profiler::Record( this->Name, this->Begin, SDL_GetPerformanceCounter() );
+   }
+private:
+   /*!
+      \brief Nazwa fragmentu.
+   */
+   const char *Name;
+   /*!
+      \brief Początek pomiaru.
+   */
+   Uint64 Begin;
+};
+
+#endif
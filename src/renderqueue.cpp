@@ -0,0 +1,101 @@
+/*!
+   \file renderqueue.cpp
+   \brief Plik źródłowy dla renderqueue.hpp.
+*/
+#include "renderqueue.hpp"
+#include <SDL2/SDL.h>
+
+RenderQueue::RenderQueue(){
+   this->SortTime = 0.0f;
+}
+
+GLuint64 RenderQueue::MakeKey( GLuint pass, GLuint program, GLuint material, GLuint mesh, GLfloat depth ){
+   if( depth < 0.0f ){
+      depth = 0.0f;
+   }
+   else if( depth > 1.0f ){
+      depth = 1.0f;
+   }
+   return ( (GLuint64)( pass & 0xF ) << 60 ) |
+          ( (GLuint64)( program & 0xFF ) << 52 ) |
+          ( (GLuint64)( material & 0xFFFF ) << 36 ) |
+          ( (GLuint64)( mesh & 0xFFF ) << 24 ) |
+          (GLuint64)( depth * 0xFFFFFF );
+}
+
+GLuint RenderQueue::KeyPass( GLuint64 key ){
+   return ( key >> 60 ) & 0xF;
+}
+
+GLuint RenderQueue::KeyProgram( GLuint64 key ){
+   return ( key >> 52 ) & 0xFF;
+}
+
+GLuint RenderQueue::KeyMaterial( GLuint64 key ){
+   return ( key >> 36 ) & 0xFFFF;
+}
+
+GLuint RenderQueue::KeyMesh( GLuint64 key ){
+   return ( key >> 24 ) & 0xFFF;
+}
+
+void RenderQueue::Clear(){
+   this->Commands.clear();
+   this->Items.clear();
+}
+
+void RenderQueue::Push( GLuint64 key, const RenderCommand &command ){
+   SortItem item;
+   item.Key = key;
+   item.Command = this->Commands.size();
+   this->Commands.push_back( command );
+   this->Items.push_back( item );
+}
+
+void RenderQueue::Sort(){
+   const Uint64 begin = SDL_GetPerformanceCounter();
+   const unsigned int size = this->Items.size();
+   this->Buffer.resize( size );
+   //Histograms of all 8 bytes in one pass:
+   unsigned int count[8][256] = {};
+   unsigned int i, byte;
+   for( i = 0; i < size; ++i ){
+      for( byte = 0; byte < 8; ++byte ){
+         ++count[byte][( this->Items[i].Key >> ( byte * 8 ) ) & 0xFF];
+      }
+   }
+   unsigned int offset, tmp, bucket;
+   for( byte = 0; byte < 8; ++byte ){
+      //Skip byte equal in all keys:
+      if( count[byte][this->Items.empty() ? 0 : ( this->Items[0].Key >> ( byte * 8 ) ) & 0xFF] == size ){
+         continue;
+      }
+      offset = 0;
+      for( bucket = 0; bucket < 256; ++bucket ){
+         tmp = count[byte][bucket];
+         count[byte][bucket] = offset;
+         offset += tmp;
+      }
+      for( i = 0; i < size; ++i ){
+         this->Buffer[count[byte][( this->Items[i].Key >> ( byte * 8 ) ) & 0xFF]++] = this->Items[i];
+      }
+      this->Items.swap( this->Buffer );
+   }
+   this->SortTime = ( SDL_GetPerformanceCounter() - begin ) * 1000.0f / SDL_GetPerformanceFrequency();
+}
+
+unsigned int RenderQueue::ReturnSize() const{
+   return this->Items.size();
+}
+
+GLuint64 RenderQueue::ReturnKey( unsigned int i ) const{
+   return this->Items[i].Key;
+}
+
+const RenderCommand & RenderQueue::ReturnCommand( unsigned int i ) const{
+   return this->Commands[this->Items[i].Command];
+}
+
+float RenderQueue::ReturnSortTime() const{
+   return this->SortTime;
+}
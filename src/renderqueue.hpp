@@ -0,0 +1,182 @@
+/*!
+   \file renderqueue.hpp
+   \brief Plik odpowiedzialny za kolejkę rysowania sortowaną według 64-bitowych kluczy.
+*/
+#ifndef renderqueue_hpp
+#define renderqueue_hpp
+#include <vector>
+#include <GL/glew.h>
+
+/*!
+   \brief Przebieg rysowania: obiekty nieprzezroczyste.
+*/
+#define RENDER_PASS_OPAQUE 0
+/*!
+   \brief Przebieg rysowania: impostory odległych obiektów (zapisują własną głębokość).
+*/
+#define RENDER_PASS_IMPOSTOR 1
+/*!
+   \brief Przebieg rysowania: obiekty świateł.
+*/
+#define RENDER_PASS_LIGHT 2
+/*!
+   \brief Numer shadera: główny shader ( \link Game::ProgramID \endlink ).
+*/
+#define RENDER_PROGRAM_MODEL 0
+/*!
+   \brief Numer shadera: shader światła ( \link Game::LightID \endlink ).
+*/
+#define RENDER_PROGRAM_LIGHT 1
+/*!
+   \brief Numer shadera: shader impostorów ( \link Impostor::ReturnProgram() \endlink ).
+*/
+#define RENDER_PROGRAM_IMPOSTOR 2
+/*!
+   \brief Typ polecenia: obiekt modelu ( \link Model \endlink ).
+*/
+#define RENDER_MODEL 0
+/*!
+   \brief Typ polecenia: obiekt światła ( \link Light \endlink ).
+*/
+#define RENDER_LIGHT 1
+/*!
+   \brief Typ polecenia: połączona siatka nieruchomych obiektów ( \link StaticBatch \endlink ).
+*/
+#define RENDER_BATCH 2
+/*!
+   \brief Typ polecenia: wszystkie impostory klatki ( \link Impostor \endlink ).
+*/
+#define RENDER_IMPOSTOR 3
+
+/*!
+   \brief Pojedyncze polecenie rysowania.
+*/
+struct RenderCommand{
+   /*!
+      \brief Typ polecenia ( \link RENDER_MODEL \endlink, \link RENDER_LIGHT \endlink, \link RENDER_BATCH \endlink lub \link RENDER_IMPOSTOR \endlink ).
+   */
+   GLuint Type;
+   /*!
+      \brief Numer modelu, światła lub połączonej siatki.
+   */
+   GLuint Object;
+   /*!
+      \brief Numer macierzy modelu (instancji).
+   */
+   GLuint Instance;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za kolejkę rysowania.
+
+   Każde polecenie posiada 64-bitowy klucz (od najstarszych bitów):\n
+   <ul>
+   <li>4 bity - przebieg rysowania</li>
+   <li>8 bitów - numer shadera</li>
+   <li>16 bitów - materiał (tekstura)</li>
+   <li>12 bitów - siatka (VAO)</li>
+   <li>24 bity - odległość od kamery</li>
+   </ul>
+   Kolejka sortowana jest pozycyjnie (radix sort, 8 bitów na przebieg).\n
+   Polecenia o tym samym stanie OpenGL są obok siebie, a w obrębie tego samego stanu rysowane są od najbliższych.\n
+*/
+class RenderQueue{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   RenderQueue();
+   /*!
+      \brief Tworzy klucz dla polecenia.
+
+      \param pass - przebieg rysowania
+      \param program - numer shadera
+      \param material - materiał (tekstura)
+      \param mesh - siatka (VAO)
+      \param depth - odległość od kamery (0.0 - 1.0)
+   */
+   static GLuint64 MakeKey( GLuint pass, GLuint program, GLuint material, GLuint mesh, GLfloat depth );
+   /*!
+      \brief Zwraca przebieg rysowania z klucza.
+   */
+   static GLuint KeyPass( GLuint64 key );
+   /*!
+      \brief Zwraca numer shadera z klucza.
+   */
+   static GLuint KeyProgram( GLuint64 key );
+   /*!
+      \brief Zwraca materiał z klucza.
+   */
+   static GLuint KeyMaterial( GLuint64 key );
+   /*!
+      \brief Zwraca siatkę z klucza.
+   */
+   static GLuint KeyMesh( GLuint64 key );
+   /*!
+      \brief Usuwa wszystkie polecenia.
+   */
+   void Clear();
+   /*!
+      \brief Dodaje polecenie do kolejki.
+
+      \param key - klucz ( \link MakeKey() \endlink )
+      \param command - polecenie
+   */
+   void Push( GLuint64 key, const RenderCommand &command );
+   /*!
+      \brief Sortuje kolejkę według kluczy i mierzy czas sortowania.
+   */
+   void Sort();
+   /*!
+      \brief Zwraca ilość poleceń.
+   */
+   unsigned int ReturnSize() const;
+   /*!
+      \brief Zwraca klucz i-tego polecenia (po sortowaniu).
+
+      \param i - numer polecenia
+   */
+   GLuint64 ReturnKey( unsigned int i ) const;
+   /*!
+      \brief Zwraca i-te polecenie (po sortowaniu).
+
+      \param i - numer polecenia
+   */
+   const RenderCommand & ReturnCommand( unsigned int i ) const;
+   /*!
+      \brief Zwraca czas ostatniego sortowania w milisekundach.
+   */
+   float ReturnSortTime() const;
+private:
+   /*!
+      \brief Element sortowania: klucz i numer polecenia w \link Commands \endlink.
+   */
+   struct SortItem{
+      /*!
+         \brief Klucz.
+      */
+      GLuint64 Key;
+      /*!
+         \brief Numer polecenia.
+      */
+      GLuint Command;
+   };
+   /*!
+      \brief Polecenia w kolejności dodania.
+   */
+   std::vector <RenderCommand> Commands;
+   /*!
+      \brief Posortowane klucze.
+   */
+   std::vector <SortItem> Items;
+   /*!
+      \brief Bufor pomocniczy dla sortowania.
+   */
+   std::vector <SortItem> Buffer;
+   /*!
+      \brief Czas ostatniego sortowania w milisekundach.
+   */
+   float SortTime;
+};
+
+#endif
@@ -0,0 +1,168 @@
+/*!
+   \file ringbuffer.cpp
+   \brief Plik źródłowy dla ringbuffer.hpp.
+*/
+#include "ringbuffer.hpp"
+#include <SDL2/SDL.h>
+#include "memorytracker.hpp"
+
+RingBuffer::RingBuffer(){
+   this->Target = GL_UNIFORM_BUFFER;
+   this->Buffer = 0;
+   this->FrameSize = 0;
+   this->Frames = 0;
+   this->Frame = 0;
+   this->Used = 0;
+   this->Pointer = NULL;
+   this->Persistent = false;
+   this->Flushed = 0;
+   this->Waits = 0;
+   this->Overflow = false;
+}
+
+RingBuffer::~RingBuffer(){
+   this->Destroy();
+}
+
+bool RingBuffer::Create( GLenum target, GLsizeiptr frame_size, unsigned int frames ){
+   this->Destroy();
+   this->Target = target;
+   this->FrameSize = frame_size;
+   this->Frames = frames > 0 ? frames : RINGBUFFER_FRAMES;
+   this->Frame = this->Frames - 1;
+   this->Used = 0;
+   this->Flushed = 0;
+   this->Fences.assign( this->Frames, (GLsync)0 );
+   const GLsizeiptr size = this->FrameSize * this->Frames;
+   glGenBuffers( 1, &this->Buffer );
+   glBindBuffer( this->Target, this->Buffer );
+   if( GLEW_VERSION_4_4 or GLEW_ARB_buffer_storage ){
+      const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+      glBufferStorage( this->Target, size, NULL, flags );
+      this->Pointer = (char *)glMapBufferRange( this->Target, 0, size, flags );
+      this->Persistent = true;
+   }
+   else{
+      glBufferData( this->Target, size, NULL, GL_STREAM_DRAW );
+      this->Staging.assign( this->FrameSize, 0 );
+      this->Pointer = &this->Staging[0];
+      MemoryTracker::Resize( MEMORY_RENDER, MEMORY_CPU, 0, this->Staging.size() );
+   }
+   glBindBuffer( this->Target, 0 );
+   if( this->Buffer == 0 or ( this->Persistent and this->Pointer == NULL ) ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "RingBuffer: can't create buffer\n" );
+      this->Destroy();
+      return false;
+   }
+   MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_BUFFER, this->Buffer, size );
+   SDL_Log( "RingBuffer: %i x %i bytes, %s\n", (int)this->Frames, (int)this->FrameSize, this->Persistent ? "persistent" : "staged, glBufferSubData" );
+   return true;
+}
+
+void RingBuffer::Destroy(){
+   std::vector <GLsync>::iterator it;
+   for( it = this->Fences.begin(); it != this->Fences.end(); ++it ){
+      if( *it != 0 ){
+         glDeleteSync( *it );
+      }
+   }
+   this->Fences.clear();
+   if( this->Buffer != 0 ){
+      if( this->Persistent ){
+         glBindBuffer( this->Target, this->Buffer );
+         glUnmapBuffer( this->Target );
+         glBindBuffer( this->Target, 0 );
+      }
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &this->Buffer );
+      glDeleteBuffers( 1, &this->Buffer );
+   }
+   this->Buffer = 0;
+   this->Pointer = NULL;
+   this->Persistent = false;
+   MemoryTracker::Resize( MEMORY_RENDER, MEMORY_CPU, this->Staging.size(), 0 );
+   this->Staging.clear();
+   this->Flushed = 0;
+}
+
+void RingBuffer::BeginFrame(){
+   if( this->Buffer == 0 ){
+      return;
+   }
+   this->Frame = ( this->Frame + 1 ) % this->Frames;
+   this->Used = 0;
+   this->Flushed = 0;
+   this->Overflow = false;
+   //Wait until GPU finished reading this region:
+   GLsync &fence = this->Fences[this->Frame];
+   if( fence != 0 ){
+      GLenum result = glClientWaitSync( fence, 0, 0 );
+      if( result == GL_TIMEOUT_EXPIRED ){
+         ++this->Waits;
+         do{
+            result = glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000 );
+         }while( result == GL_TIMEOUT_EXPIRED );
+      }
+      glDeleteSync( fence );
+      fence = 0;
+   }
+}
+
+GLintptr RingBuffer::Allocate( GLsizeiptr size, GLsizeiptr align, void **pointer ){
+   if( this->Pointer == NULL ){
+      return -1;
+   }
+   GLsizeiptr offset = this->Used;
+   if( align > 1 ){
+      offset = ( offset + align - 1 ) / align * align;
+   }
+   if( offset + size > this->FrameSize ){
+      if( ! this->Overflow ){
+         SDL_LogError( SDL_LOG_CATEGORY_RENDER, "RingBuffer: frame region is full (%i bytes)\n", (int)this->FrameSize );
+         this->Overflow = true;
+      }
+      return -1;
+   }
+   this->Used = offset + size;
+   if( this->Persistent ){
+      *pointer = this->Pointer + this->Frame * this->FrameSize + offset;
+   }
+   else{
+      *pointer = this->Pointer + offset;
+   }
+   return this->Frame * this->FrameSize + offset;
+}
+
+void RingBuffer::Flush(){
+   if( this->Buffer == 0 or this->Persistent or this->Flushed >= this->Used ){
+      return;
+   }
+   //Region is not read by GPU any more (fence in BeginFrame()):
+   glBindBuffer( this->Target, this->Buffer );
+   glBufferSubData( this->Target, this->Frame * this->FrameSize + this->Flushed, this->Used - this->Flushed, &this->Staging[this->Flushed] );
+   glBindBuffer( this->Target, 0 );
+   this->Flushed = this->Used;
+}
+
+void RingBuffer::EndFrame(){
+   if( this->Buffer == 0 ){
+      return;
+   }
+   this->Flush();
+   this->Fences[this->Frame] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+}
+
+GLuint RingBuffer::ReturnBuffer() const{
+   return this->Buffer;
+}
+
+GLsizeiptr RingBuffer::ReturnUsed() const{
+   return this->Used;
+}
+
+unsigned int RingBuffer::ReturnWaits() const{
+   return this->Waits;
+}
+
+bool RingBuffer::IsPersistent() const{
+   return this->Persistent;
+}
@@ -0,0 +1,146 @@
+/*!
+   \file ringbuffer.hpp
+   \brief Plik odpowiedzialny za bufor pierścieniowy dla danych zmieniających się co klatkę.
+*/
+#ifndef ringbuffer_hpp
+#define ringbuffer_hpp
+#include <vector>
+#include <GL/glew.h>
+
+/*!
+   \brief Domyślna ilość klatek (obszarów) w buforze pierścieniowym.
+*/
+#define RINGBUFFER_FRAMES 3
+
+/*!
+   \brief Klasa odpowiedzialna za bufor pierścieniowy dla danych zmieniających się co klatkę.
+
+   Bufor podzielony jest na \link RINGBUFFER_FRAMES \endlink obszary, każda klatka zapisuje do kolejnego obszaru.\n
+   Przed ponownym użyciem obszaru oczekuje na zakończenie jego odczytu przez GPU (fence).\n
+   Jeśli dostępny jest glBufferStorage ( OpenGL 4.4 lub ARB_buffer_storage ), bufor mapowany jest na stałe (persistent, coherent),
+   w przeciwnym przypadku dane zapisywane są do kopii obszaru w pamięci CPU i wysyłane glBufferSubData w \link Flush() \endlink,
+   bo rysowanie z bufora zmapowanego bez GL_MAP_PERSISTENT_BIT jest błędem.\n
+   Po zapisaniu danych z \link Allocate() \endlink, a przed związaniem bufora lub rysowaniem, należy wywołać \link Flush() \endlink.\n
+*/
+class RingBuffer{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   RingBuffer();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia bufor i obiekty synchronizacji ( \link Destroy() \endlink ).
+   */
+   ~RingBuffer();
+   /*!
+      \brief Tworzy bufor.
+
+      \param target - typ bufora (np. GL_UNIFORM_BUFFER)
+      \param frame_size - wielkość obszaru jednej klatki w bajtach
+      \param frames - ilość obszarów (klatek)
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create( GLenum target, GLsizeiptr frame_size, unsigned int frames = RINGBUFFER_FRAMES );
+   /*!
+      \brief Zwalnia bufor i obiekty synchronizacji.
+   */
+   void Destroy();
+   /*!
+      \brief Rozpoczyna klatkę: przechodzi do kolejnego obszaru i czeka, aż GPU skończy go używać.
+   */
+   void BeginFrame();
+   /*!
+      \brief Rezerwuje miejsce w obszarze aktualnej klatki.
+
+      \param size - wielkość danych w bajtach
+      \param align - wyrównanie przesunięcia (np. GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+      \param pointer - wskaźnik, pod którym należy zapisać dane
+      \return - przesunięcie od początku bufora (dla glBindBufferRange), -1 = brak miejsca
+   */
+   GLintptr Allocate( GLsizeiptr size, GLsizeiptr align, void **pointer );
+   /*!
+      \brief Wysyła do GPU dane zapisane od poprzedniego wywołania (tylko bez mapowania stałego, w przeciwnym przypadku nic nie robi).
+
+      Wywołać po zapisaniu danych, przed glBindBufferRange lub poleceniem rysowania korzystającym z tych danych.
+   */
+   void Flush();
+   /*!
+      \brief Kończy klatkę: wstawia obiekt synchronizacji dla obszaru aktualnej klatki.
+
+      Wywołać po ostatnim poleceniu rysowania korzystającym z danych klatki.
+   */
+   void EndFrame();
+   /*!
+      \brief Zwraca identyfikator bufora.
+   */
+   GLuint ReturnBuffer() const;
+   /*!
+      \brief Zwraca ilość zajętych bajtów w aktualnej klatce.
+   */
+   GLsizeiptr ReturnUsed() const;
+   /*!
+      \brief Zwraca ilość klatek, w których trzeba było czekać na GPU.
+   */
+   unsigned int ReturnWaits() const;
+   /*!
+      \brief Sprawdza czy bufor jest mapowany na stałe.
+   */
+   bool IsPersistent() const;
+private:
+   /*!
+      \brief Typ bufora.
+   */
+   GLenum Target;
+   /*!
+      \brief Identyfikator bufora.
+   */
+   GLuint Buffer;
+   /*!
+      \brief Wielkość obszaru jednej klatki.
+   */
+   GLsizeiptr FrameSize;
+   /*!
+      \brief Ilość obszarów.
+   */
+   unsigned int Frames;
+   /*!
+      \brief Numer obszaru aktualnej klatki.
+   */
+   unsigned int Frame;
+   /*!
+      \brief Zajęte bajty w obszarze aktualnej klatki.
+   */
+   GLsizeiptr Used;
+   /*!
+      \brief Wskaźnik na zmapowany bufor (cały bufor dla mapowania stałego, \link Staging \endlink w przeciwnym przypadku).
+   */
+   char *Pointer;
+   /*!
+      \brief Obiekty synchronizacji dla każdego obszaru.
+   */
+   std::vector <GLsync> Fences;
+   /*!
+      \brief Bufor mapowany na stałe. TRUE = glBufferStorage.
+   */
+   bool Persistent;
+   /*!
+      \brief Kopia obszaru aktualnej klatki w pamięci CPU (tylko bez mapowania stałego).
+   */
+   std::vector <char> Staging;
+   /*!
+      \brief Bajty obszaru aktualnej klatki wysłane już do GPU ( \link Flush() \endlink ).
+   */
+   GLsizeiptr Flushed;
+   /*!
+      \brief Ilość klatek, w których trzeba było czekać na GPU.
+   */
+   unsigned int Waits;
+   /*!
+      \brief Zgłoszono brak miejsca w aktualnej klatce.
+   */
+   bool Overflow;
+};
+
+#endif
@@ -8,10 +8,13 @@
 #include <fstream>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
+#include "profiler.hpp"
+#include "memorytracker.hpp"
 
 GLuint LoadShader( const char* vertex_shader_path_file,
    const char* fragment_shader_path_file
 ){
+   PROFILE_SCOPE( "LoadShader" );
    SDL_Log( "Creating shaders\n" );
    GLuint VertexShaderID = glCreateShader( GL_VERTEX_SHADER );
    GLuint FragmentShaderID = glCreateShader( GL_FRAGMENT_SHADER );
@@ -52,6 +55,7 @@ GLuint LoadShader( const char* vertex_shader_path_file,
       return 0;
    }
    SDL_Log( "Loaded: %s\n", fragment_shader_path_file );
+   MemoryScope sources( MEMORY_SHADER, VertexShaderCode.capacity() + FragmentShaderCode.capacity() );
 
    GLint Result;
    GLint InfoLogLength;
@@ -132,5 +136,15 @@ GLuint LoadShader( const char* vertex_shader_path_file,
    glDeleteShader( VertexShaderID );
    glDeleteShader( FragmentShaderID );
 
+   //Driver binary size when queryable, otherwise source size as estimate:
+   GLint binary_length = 0;
+   if( GLEW_VERSION_4_1 or GLEW_ARB_get_program_binary ){
+      glGetProgramiv( ProgramID, GL_PROGRAM_BINARY_LENGTH, &binary_length );
+   }
+   if( binary_length <= 0 ){
+      binary_length = VertexShaderCode.size() + FragmentShaderCode.size();
+   }
+   MemoryTracker::AddObject( MEMORY_SHADER, MEMORY_OBJECT_PROGRAM, ProgramID, binary_length );
+
    return ProgramID;
 }
@@ -0,0 +1,269 @@
+/*!
+   \file shadowmap.cpp
+   \brief Plik źródłowy dla shadowmap.hpp.
+*/
+#include "shadowmap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <SDL2/SDL.h>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp>
+#include "memorytracker.hpp"
+
+ShadowMap::ShadowMap(){
+   this->Size = 0;
+   this->PointSize = 0;
+   this->StaticDepth = 0;
+   this->DynamicDepth = 0;
+   this->PointDepth = 0;
+   for( unsigned int i = 0; i < 3; ++i ){
+      this->Framebuffers[i] = 0;
+   }
+   this->PreviousFramebuffer = 0;
+   for( unsigned int i = 0; i < 4; ++i ){
+      this->PreviousViewport[i] = 0;
+   }
+   this->Cached = false;
+   this->StaticUpdates = 0;
+   this->PointFrames = 0;
+   this->SunView = glm::mat4( 1.0f );
+   this->SunProjection = glm::mat4( 1.0f );
+   this->PointPosition = glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
+}
+
+ShadowMap::~ShadowMap(){
+   this->Destroy();
+}
+
+bool ShadowMap::Create( GLsizei size, GLsizei point_size ){
+   this->Destroy();
+   this->Size = size > 0 ? size : SHADOW_SIZE;
+   this->PointSize = point_size > 0 ? point_size : 0;
+   GLint previous_framebuffer;
+   glGetIntegerv( GL_FRAMEBUFFER_BINDING, &previous_framebuffer );
+   this->StaticDepth = ShadowMap::CreateDepth( GL_TEXTURE_2D, this->Size );
+   this->DynamicDepth = ShadowMap::CreateDepth( GL_TEXTURE_2D, this->Size );
+   glGenFramebuffers( 3, this->Framebuffers );
+   bool result = true;
+   const GLuint textures[2] = { this->StaticDepth, this->DynamicDepth };
+   for( unsigned int i = 0; i < 2; ++i ){
+      glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffers[i] );
+      glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, textures[i], 0 );
+      glDrawBuffer( GL_NONE );
+      glReadBuffer( GL_NONE );
+      result = result and glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE;
+   }
+   if( this->PointSize > 0 ){
+      this->PointDepth = ShadowMap::CreateDepth( GL_TEXTURE_CUBE_MAP, this->PointSize );
+      glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffers[2] );
+      glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X, this->PointDepth, 0 );
+      glDrawBuffer( GL_NONE );
+      glReadBuffer( GL_NONE );
+      result = result and glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE;
+   }
+   glBindFramebuffer( GL_FRAMEBUFFER, previous_framebuffer );
+   if( ! result ){
+      SDL_LogError( SDL_LOG_CATEGORY_RENDER, "ShadowMap: incomplete framebuffer\n" );
+      this->Destroy();
+      return false;
+   }
+   this->Cached = false;
+   this->PointFrames = 0;
+   SDL_Log( "ShadowMap: %i x %i, point light cube map %i x %i\n", (int)this->Size, (int)this->Size, (int)this->PointSize, (int)this->PointSize );
+   return true;
+}
+
+void ShadowMap::Destroy(){
+   if( this->Framebuffers[0] != 0 ){
+      glDeleteFramebuffers( 3, this->Framebuffers );
+   }
+   const GLuint textures[3] = { this->StaticDepth, this->DynamicDepth, this->PointDepth };
+   MemoryTracker::RemoveObject( MEMORY_OBJECT_TEXTURE, 3, textures );
+   if( this->StaticDepth != 0 ){
+      glDeleteTextures( 1, &this->StaticDepth );
+   }
+   if( this->DynamicDepth != 0 ){
+      glDeleteTextures( 1, &this->DynamicDepth );
+   }
+   if( this->PointDepth != 0 ){
+      glDeleteTextures( 1, &this->PointDepth );
+   }
+   for( unsigned int i = 0; i < 3; ++i ){
+      this->Framebuffers[i] = 0;
+   }
+   this->StaticDepth = 0;
+   this->DynamicDepth = 0;
+   this->PointDepth = 0;
+   this->PointSize = 0;
+   this->Cached = false;
+}
+
+bool ShadowMap::IsCreated() const{
+   return this->Framebuffers[0] != 0;
+}
+
+void ShadowMap::SetSun( const glm::vec3 &position, const glm::vec3 &target, GLfloat extent ){
+   const glm::vec3 dir = target - position;
+   const GLfloat distance = glm::length( dir );
+   //Same basis as in Impostor::Bake() for light straight above:
+   const glm::vec3 up = std::fabs( dir.y ) > 0.999f * distance ? glm::vec3( 0.0f, 0.0f, 1.0f ) : glm::vec3( 0.0f, 1.0f, 0.0f );
+   this->SunView = glm::lookAt( position, target, up );
+   //Square around target, objects up to extent above it:
+   this->SunProjection = glm::perspective( 2.0f * std::atan( extent / distance ), 1.0f, std::max( distance - extent, 0.1f ), distance + extent );
+   this->Cached = false;
+}
+
+void ShadowMap::Invalidate(){
+   this->Cached = false;
+}
+
+bool ShadowMap::BeginStatic(){
+   if( this->Cached or this->Framebuffers[0] == 0 ){
+      return false;
+   }
+   this->Save();
+   glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffers[0] );
+   glViewport( 0, 0, this->Size, this->Size );
+   glClear( GL_DEPTH_BUFFER_BIT );
+   this->Cached = true;
+   ++this->StaticUpdates;
+   return true;
+}
+
+void ShadowMap::BeginDynamic(){
+   if( this->Framebuffers[1] == 0 ){
+      return;
+   }
+   this->Save();
+   glBindFramebuffer( GL_READ_FRAMEBUFFER, this->Framebuffers[0] );
+   glBindFramebuffer( GL_DRAW_FRAMEBUFFER, this->Framebuffers[1] );
+   glBlitFramebuffer( 0, 0, this->Size, this->Size, 0, 0, this->Size, this->Size, GL_DEPTH_BUFFER_BIT, GL_NEAREST );
+   glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffers[1] );
+   glViewport( 0, 0, this->Size, this->Size );
+}
+
+bool ShadowMap::BeginPoint( const glm::vec3 &position, GLfloat far, unsigned int rate ){
+   if( this->PointDepth == 0 or rate == 0 ){
+      return false;
+   }
+   if( this->PointFrames > 0 ){
+      this->PointFrames = ( this->PointFrames + 1 ) % rate;
+      return false;
+   }
+   this->PointFrames = 1 % rate;
+   this->PointPosition = glm::vec4( position, far );
+   this->Save();
+   glBindFramebuffer( GL_FRAMEBUFFER, this->Framebuffers[2] );
+   glViewport( 0, 0, this->PointSize, this->PointSize );
+   return true;
+}
+
+void ShadowMap::BeginPointFace( unsigned int face ){
+   glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, this->PointDepth, 0 );
+   glClear( GL_DEPTH_BUFFER_BIT );
+}
+
+void ShadowMap::End(){
+   glDisable( GL_POLYGON_OFFSET_FILL );
+   glBindFramebuffer( GL_FRAMEBUFFER, this->PreviousFramebuffer );
+   glViewport( this->PreviousViewport[0], this->PreviousViewport[1], this->PreviousViewport[2], this->PreviousViewport[3] );
+}
+
+void ShadowMap::Bind() const{
+   glActiveTexture( GL_TEXTURE0 + SHADOW_TEXTURE_UNIT );
+   glBindTexture( GL_TEXTURE_2D, this->DynamicDepth );
+   glActiveTexture( GL_TEXTURE0 + SHADOW_TEXTURE_UNIT + 1 );
+   glBindTexture( GL_TEXTURE_CUBE_MAP, this->PointDepth );
+   glActiveTexture( GL_TEXTURE0 );
+}
+
+const glm::mat4 & ShadowMap::ReturnSunView() const{
+   return this->SunView;
+}
+
+const glm::mat4 & ShadowMap::ReturnSunProjection() const{
+   return this->SunProjection;
+}
+
+glm::mat4 ShadowMap::ReturnSunMatrix() const{
+   //NDC -1 - 1 to texture 0 - 1:
+   glm::mat4 bias( 0.5f );
+   bias[3] = glm::vec4( 0.5f, 0.5f, 0.5f, 1.0f );
+   return bias * this->SunProjection * this->SunView;
+}
+
+glm::mat4 ShadowMap::ReturnPointView( unsigned int face ) const{
+   //Cube map face orientation, GL_TEXTURE_CUBE_MAP_POSITIVE_X ... NEGATIVE_Z:
+   static const glm::vec3 dirs[6] = {
+      glm::vec3( 1.0f, 0.0f, 0.0f ), glm::vec3( -1.0f, 0.0f, 0.0f ),
+      glm::vec3( 0.0f, 1.0f, 0.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ),
+      glm::vec3( 0.0f, 0.0f, 1.0f ), glm::vec3( 0.0f, 0.0f, -1.0f )
+   };
+   static const glm::vec3 ups[6] = {
+      glm::vec3( 0.0f, -1.0f, 0.0f ), glm::vec3( 0.0f, -1.0f, 0.0f ),
+      glm::vec3( 0.0f, 0.0f, 1.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ),
+      glm::vec3( 0.0f, -1.0f, 0.0f ), glm::vec3( 0.0f, -1.0f, 0.0f )
+   };
+   const glm::vec3 position( this->PointPosition );
+   return glm::lookAt( position, position + dirs[face % 6], ups[face % 6] );
+}
+
+glm::mat4 ShadowMap::ReturnPointProjection() const{
+   return glm::perspective( float( M_PI ) / 2.0f, 1.0f, SHADOW_POINT_NEAR, this->PointPosition.w );
+}
+
+const glm::vec4 & ShadowMap::ReturnPointPosition() const{
+   return this->PointPosition;
+}
+
+glm::vec2 ShadowMap::ReturnPointDepth() const{
+   const GLfloat near = SHADOW_POINT_NEAR;
+   const GLfloat far = this->PointPosition.w;
+   return glm::vec2( ( far + near ) / ( far - near ), 2.0f * far * near / ( far - near ) );
+}
+
+GLsizei ShadowMap::ReturnPointSize() const{
+   return this->PointSize;
+}
+
+unsigned int ShadowMap::ReturnStaticUpdates() const{
+   return this->StaticUpdates;
+}
+
+GLuint ShadowMap::CreateDepth( GLenum target, GLsizei size ){
+   GLuint texture;
+   glGenTextures( 1, &texture );
+   glBindTexture( target, texture );
+   if( target == GL_TEXTURE_CUBE_MAP ){
+      for( GLenum face = 0; face < 6; ++face ){
+         glTexImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL );
+      }
+      glTexParameteri( target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      glTexParameteri( target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+      MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_TEXTURE, texture, MemoryTracker::TextureBytes( size, size, 6, 4 ) );
+   }
+   else{
+      glTexImage2D( target, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL );
+      //Outside of map = lit:
+      const GLfloat border[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+      glTexParameteri( target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER );
+      glTexParameteri( target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER );
+      glTexParameterfv( target, GL_TEXTURE_BORDER_COLOR, border );
+      MemoryTracker::AddObject( MEMORY_RENDER, MEMORY_OBJECT_TEXTURE, texture, MemoryTracker::TextureBytes( size, size, 1, 4 ) );
+   }
+   //Hardware 2x2 comparison filtering:
+   glTexParameteri( target, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( target, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( target, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE );
+   glTexParameteri( target, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL );
+   glBindTexture( target, 0 );
+   return texture;
+}
+
+void ShadowMap::Save(){
+   glGetIntegerv( GL_FRAMEBUFFER_BINDING, &this->PreviousFramebuffer );
+   glGetIntegerv( GL_VIEWPORT, this->PreviousViewport );
+   glEnable( GL_POLYGON_OFFSET_FILL );
+   glPolygonOffset( 2.0f, 4.0f );
+}
@@ -0,0 +1,235 @@
+/*!
+   \file shadowmap.hpp
+   \brief Plik odpowiedzialny za mapy cieni: zapamiętaną mapę głównego światła i mapę sześcienną światła punktowego.
+*/
+#ifndef shadowmap_hpp
+#define shadowmap_hpp
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/*!
+   \brief Domyślna wielkość mapy cieni głównego światła.
+*/
+#define SHADOW_SIZE 2048
+/*!
+   \brief Domyślna wielkość ściany mapy sześciennej światła punktowego (0 = brak).
+*/
+#define SHADOW_POINT_SIZE 256
+/*!
+   \brief Domyślna ilość klatek między aktualizacjami mapy sześciennej.
+*/
+#define SHADOW_POINT_RATE 4
+/*!
+   \brief Bliska płaszczyzna projekcji mapy sześciennej.
+*/
+#define SHADOW_POINT_NEAR 0.1f
+/*!
+   \brief Jednostka tekstury mapy cieni głównego światła, kolejna jednostka = mapa sześcienna.
+*/
+#define SHADOW_TEXTURE_UNIT 2
+
+/*!
+   \brief Klasa odpowiedzialna za mapy cieni.
+
+   Główne światło ( \link SetSun() \endlink ) ma dwie mapy głębokości:\n
+   <ul>
+   <li>statyczną: drzewa i kamienie, rysowane tylko po zmianie świata lub światła ( \link BeginStatic() \endlink, \link Invalidate() \endlink )</li>
+   <li>dynamiczną: kopia mapy statycznej (glBlitFramebuffer) z obiektami ruchomymi rysowanymi co klatkę ( \link BeginDynamic() \endlink )</li>
+   </ul>
+   Światło punktowe ma mapę sześcienną o mniejszej rozdzielczości, rysowaną co kilka klatek ( \link BeginPoint() \endlink ).\n
+   Obie mapy używają porównania głębokości (sampler2DShadow, samplerCubeShadow) i przesunięcia wielokątów przeciw artefaktom.\n
+*/
+class ShadowMap{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   ShadowMap();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia tekstury i bufory ramki ( \link Destroy() \endlink ).
+   */
+   ~ShadowMap();
+   /*!
+      \brief Tworzy mapy cieni.
+
+      \param size - wielkość mapy głównego światła
+      \param point_size - wielkość ściany mapy sześciennej, 0 = brak cieni światła punktowego
+      \return - wartość logiczna, FALSE = niekompletny bufor ramki
+   */
+   bool Create( GLsizei size = SHADOW_SIZE, GLsizei point_size = SHADOW_POINT_SIZE );
+   /*!
+      \brief Zwalnia tekstury i bufory ramki.
+   */
+   void Destroy();
+   /*!
+      \brief Zwraca TRUE, jeśli mapy cieni zostały utworzone.
+   */
+   bool IsCreated() const;
+   /*!
+      \brief Ustala projekcję głównego światła (perspektywa z pozycji światła na kwadrat wokół celu).
+
+      \param position - pozycja światła
+      \param target - środek oświetlanego obszaru
+      \param extent - połowa boku oświetlanego kwadratu
+
+      Zmiana projekcji unieważnia mapę statyczną.
+   */
+   void SetSun( const glm::vec3 &position, const glm::vec3 &target, GLfloat extent );
+   /*!
+      \brief Unieważnia mapę statyczną, np. po zmianie świata.
+
+      Wywoływana przez Game::InvalidateStatic() razem z \link StaticBatch::Invalidate() \endlink.
+   */
+   void Invalidate();
+   /*!
+      \brief Aktywuje i czyści mapę statyczną, jeśli jest nieaktualna.
+
+      \return - wartość logiczna, FALSE = mapa aktualna, nic nie trzeba rysować
+
+      Po narysowaniu obiektów statycznych należy wywołać \link End() \endlink.
+   */
+   bool BeginStatic();
+   /*!
+      \brief Kopiuje mapę statyczną do mapy dynamicznej i ją aktywuje.
+
+      Po narysowaniu obiektów ruchomych należy wywołać \link End() \endlink.
+   */
+   void BeginDynamic();
+   /*!
+      \brief Rozpoczyna aktualizację mapy sześciennej, jeśli minęło \p rate klatek.
+
+      \param position - pozycja światła punktowego
+      \param far - zasięg cieni
+      \param rate - ilość klatek między aktualizacjami, 0 = nigdy
+      \return - wartość logiczna, FALSE = brak aktualizacji w tej klatce
+
+      Następnie dla każdej ściany \link BeginPointFace() \endlink i rysowanie, na końcu \link End() \endlink.
+   */
+   bool BeginPoint( const glm::vec3 &position, GLfloat far, unsigned int rate );
+   /*!
+      \brief Aktywuje i czyści ścianę mapy sześciennej.
+
+      \param face - numer ściany, 0 - 5 (kolejność GL_TEXTURE_CUBE_MAP_POSITIVE_X ...)
+   */
+   void BeginPointFace( unsigned int face );
+   /*!
+      \brief Przywraca bufor ramki i obszar widoku sprzed Begin*().
+   */
+   void End();
+   /*!
+      \brief Przypina mapę dynamiczną i mapę sześcienną do jednostek od \link SHADOW_TEXTURE_UNIT \endlink.
+
+      Po powrocie aktywna jest jednostka GL_TEXTURE0.
+   */
+   void Bind() const;
+   /*!
+      \brief Zwraca macierz widoku głównego światła.
+   */
+   const glm::mat4 & ReturnSunView() const;
+   /*!
+      \brief Zwraca macierz projekcji głównego światła.
+   */
+   const glm::mat4 & ReturnSunProjection() const;
+   /*!
+      \brief Zwraca macierz z przestrzeni świata do współrzędnych mapy cieni (0 - 1).
+   */
+   glm::mat4 ReturnSunMatrix() const;
+   /*!
+      \brief Zwraca macierz widoku ściany mapy sześciennej.
+
+      \param face - numer ściany, 0 - 5
+   */
+   glm::mat4 ReturnPointView( unsigned int face ) const;
+   /*!
+      \brief Zwraca macierz projekcji ścian mapy sześciennej (90 stopni).
+   */
+   glm::mat4 ReturnPointProjection() const;
+   /*!
+      \brief Zwraca pozycję światła z ostatniej aktualizacji mapy sześciennej (xyz) i zasięg cieni (w).
+   */
+   const glm::vec4 & ReturnPointPosition() const;
+   /*!
+      \brief Zwraca współczynniki głębokości mapy sześciennej: głębokość NDC = x - y / odległość wzdłuż osi ściany.
+   */
+   glm::vec2 ReturnPointDepth() const;
+   /*!
+      \brief Zwraca wielkość ściany mapy sześciennej, 0 = brak.
+   */
+   GLsizei ReturnPointSize() const;
+   /*!
+      \brief Zwraca ilość narysowań mapy statycznej.
+   */
+   unsigned int ReturnStaticUpdates() const;
+private:
+   /*!
+      \brief Tworzy teksturę głębokości z porównaniem.
+
+      \param target - GL_TEXTURE_2D lub GL_TEXTURE_CUBE_MAP
+      \param size - wielkość tekstury (ściany)
+   */
+   static GLuint CreateDepth( GLenum target, GLsizei size );
+   /*!
+      \brief Zapamiętuje bufor ramki i obszar widoku, włącza przesunięcie wielokątów.
+   */
+   void Save();
+   /*!
+      \brief Wielkość mapy głównego światła.
+   */
+   GLsizei Size;
+   /*!
+      \brief Wielkość ściany mapy sześciennej.
+   */
+   GLsizei PointSize;
+   /*!
+      \brief Mapa statyczna głównego światła.
+   */
+   GLuint StaticDepth;
+   /*!
+      \brief Mapa dynamiczna głównego światła (statyczna + obiekty ruchome).
+   */
+   GLuint DynamicDepth;
+   /*!
+      \brief Mapa sześcienna światła punktowego.
+   */
+   GLuint PointDepth;
+   /*!
+      \brief Bufory ramki: mapa statyczna, mapa dynamiczna, mapa sześcienna.
+   */
+   GLuint Framebuffers[3];
+   /*!
+      \brief Bufor ramki aktywny przed Begin*().
+   */
+   GLint PreviousFramebuffer;
+   /*!
+      \brief Obszar widoku przed Begin*().
+   */
+   GLint PreviousViewport[4];
+   /*!
+      \brief Mapa statyczna jest aktualna.
+   */
+   bool Cached;
+   /*!
+      \brief Ilość narysowań mapy statycznej.
+   */
+   unsigned int StaticUpdates;
+   /*!
+      \brief Ilość klatek od ostatniej aktualizacji mapy sześciennej.
+   */
+   unsigned int PointFrames;
+   /*!
+      \brief Macierz widoku głównego światła.
+   */
+   glm::mat4 SunView;
+   /*!
+      \brief Macierz projekcji głównego światła.
+   */
+   glm::mat4 SunProjection;
+   /*!
+      \brief Pozycja światła punktowego (xyz) i zasięg cieni (w).
+   */
+   glm::vec4 PointPosition;
+};
+
+#endif
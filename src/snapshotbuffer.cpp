@@ -0,0 +1,106 @@
+/*!
+   \file snapshotbuffer.cpp
+   \brief Plik źródłowy dla snapshotbuffer.hpp.
+*/
+#include "snapshotbuffer.hpp"
+
+SnapshotBuffer::SnapshotBuffer(){
+   this->Write = 0;
+   this->Ready = 1;
+   this->Read = 2;
+   this->Fresh = false;
+   this->Running = false;
+   this->Waits = 0;
+   this->Mutex = NULL;
+   this->Changed = NULL;
+}
+
+SnapshotBuffer::~SnapshotBuffer(){
+   this->Destroy();
+}
+
+bool SnapshotBuffer::Create(){
+   this->Destroy();
+   this->Mutex = SDL_CreateMutex();
+   this->Changed = SDL_CreateCond();
+   if( this->Mutex == NULL or this->Changed == NULL ){
+      SDL_LogError( SDL_LOG_CATEGORY_SYSTEM, "SnapshotBuffer: %s\n", SDL_GetError() );
+      this->Destroy();
+      return false;
+   }
+   this->Write = 0;
+   this->Ready = 1;
+   this->Read = 2;
+   this->Fresh = false;
+   this->Running = true;
+   this->Waits = 0;
+   for( unsigned int i = 0; i < SNAPSHOT_SLOTS; ++i ){
+      this->Slots[i].Events.clear();
+   }
+   return true;
+}
+
+void SnapshotBuffer::Destroy(){
+   if( this->Changed != NULL ){
+      SDL_DestroyCond( this->Changed );
+      this->Changed = NULL;
+   }
+   if( this->Mutex != NULL ){
+      SDL_DestroyMutex( this->Mutex );
+      this->Mutex = NULL;
+   }
+   this->Running = false;
+}
+
+FrameSnapshot & SnapshotBuffer::ReturnWrite(){
+   return this->Slots[this->Write];
+}
+
+void SnapshotBuffer::Publish(){
+   SDL_LockMutex( this->Mutex );
+   if( this->Fresh and this->Running ){
+      ++this->Waits;
+      while( this->Fresh and this->Running ){
+         SDL_CondWait( this->Changed, this->Mutex );
+      }
+   }
+   const unsigned int ready = this->Ready;
+   this->Ready = this->Write;
+   this->Write = ready;
+   this->Fresh = true;
+   SDL_CondBroadcast( this->Changed );
+   SDL_UnlockMutex( this->Mutex );
+   this->Slots[this->Write].Events.clear();
+}
+
+bool SnapshotBuffer::Acquire(){
+   SDL_LockMutex( this->Mutex );
+   while( not this->Fresh and this->Running ){
+      SDL_CondWait( this->Changed, this->Mutex );
+   }
+   const bool fresh = this->Fresh;
+   if( fresh ){
+      const unsigned int ready = this->Ready;
+      this->Ready = this->Read;
+      this->Read = ready;
+      this->Fresh = false;
+      SDL_CondBroadcast( this->Changed );
+   }
+   SDL_UnlockMutex( this->Mutex );
+   return fresh;
+}
+
+const FrameSnapshot & SnapshotBuffer::ReturnRead() const{
+   return this->Slots[this->Read];
+}
+
+void SnapshotBuffer::Stop(){
+   SDL_LockMutex( this->Mutex );
+   this->Running = false;
+   SDL_CondBroadcast( this->Changed );
+   SDL_UnlockMutex( this->Mutex );
+}
+
+unsigned int SnapshotBuffer::ReturnWaits() const{
+   return this->Waits;
+}
@@ -0,0 +1,182 @@
+/*!
+   \file snapshotbuffer.hpp
+   \brief Plik odpowiedzialny za przekazywanie stanu klatki z wątku symulacji do wątku rysowania.
+*/
+#ifndef snapshotbuffer_hpp
+#define snapshotbuffer_hpp
+#include <vector>
+#include <SDL2/SDL.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/*!
+   \brief Ilość stanów klatki w \link SnapshotBuffer \endlink: zapisywany, gotowy, rysowany.
+*/
+#define SNAPSHOT_SLOTS 3
+
+/*!
+   \brief Niezmienny stan jednej klatki, wszystko czego potrzebuje rysowanie z symulacji.
+*/
+struct FrameSnapshot{
+   /*!
+      \brief Macierz widoku kamery.
+   */
+   glm::mat4 View;
+   /*!
+      \brief Macierz projekcji kamery.
+   */
+   glm::mat4 Projection;
+   /*!
+      \brief Pozycja kamery (pomiędzy dwoma ostatnimi krokami symulacji).
+   */
+   glm::vec3 Position;
+   /*!
+      \brief Odległość, do jakiej rysowane są obiekty.
+   */
+   GLfloat Far;
+   /*!
+      \brief Kąt obrotu monety w stopniach.
+   */
+   GLfloat CoinAngle;
+   /*!
+      \brief Pozycja x monety na mapie, \link Game::Render() \endlink przenosi monetę, gdy się zmieni.
+   */
+   int CoinX;
+   /*!
+      \brief Pozycja z monety na mapie.
+   */
+   int CoinZ;
+   /*!
+      \brief Ilość zebranych monet.
+   */
+   int Score;
+   /*!
+      \brief Pozycja drugiego światła.
+   */
+   glm::vec3 SunMovingPosition;
+   /*!
+      \brief Okno jest aktywne. FALSE = nic nie jest rysowane.
+   */
+   bool Focus;
+   /*!
+      \brief Zdarzenia obsługiwane przez wątek rysowania (przełączniki, zmiana wielkości okna).
+   */
+   std::vector <SDL_Event> Events;
+   /*!
+      \brief Ilość kroków symulacji wykonanych dla tej klatki.
+   */
+   unsigned int Steps;
+   /*!
+      \brief Ilość pominiętych kroków symulacji.
+   */
+   unsigned int Dropped;
+   /*!
+      \brief Czas symulacji tej klatki (w jednostkach SDL_GetPerformanceCounter()).
+   */
+   Uint64 SimulationTime;
+   /*!
+      \brief Chwila odczytu wejścia dla tej klatki (SDL_GetPerformanceCounter()), do pomiaru opóźnienia.
+   */
+   Uint64 InputTime;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za potrójne buforowanie stanów klatki pomiędzy dwoma wątkami.
+
+   Wątek symulacji zapisuje stan do \link ReturnWrite() \endlink i oddaje go przez \link Publish() \endlink,
+   wątek rysowania odbiera go przez \link Acquire() \endlink i czyta \link ReturnRead() \endlink.\n
+   Stan zapisywany i rysowany nigdy nie są tym samym obszarem, więc oba wątki pracują jednocześnie bez kopiowania.\n
+   Najwyżej jeden stan czeka na narysowanie: \link Publish() \endlink czeka, aż poprzedni zostanie odebrany,
+   dzięki czemu symulacja nie wyprzedza rysowania o więcej niż jedną klatkę.\n
+*/
+class SnapshotBuffer{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   SnapshotBuffer();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia obiekty synchronizacji ( \link Destroy() \endlink ).
+   */
+   ~SnapshotBuffer();
+   /*!
+      \brief Tworzy obiekty synchronizacji.
+
+      \return - wartość logiczna, FALSE = błąd
+   */
+   bool Create();
+   /*!
+      \brief Zwalnia obiekty synchronizacji.
+   */
+   void Destroy();
+   /*!
+      \brief Zwraca stan zapisywany przez wątek symulacji.
+   */
+   FrameSnapshot & ReturnWrite();
+   /*!
+      \brief Oddaje zapisany stan wątkowi rysowania.
+
+      Czeka, jeśli poprzedni stan nie został jeszcze odebrany.\n
+      Nowy stan do zapisu ma pustą listę zdarzeń.\n
+   */
+   void Publish();
+   /*!
+      \brief Odbiera najnowszy stan, czeka na niego, jeśli nie jest gotowy.
+
+      \return - wartość logiczna, FALSE = zatrzymano ( \link Stop() \endlink ) i brak stanu do narysowania
+   */
+   bool Acquire();
+   /*!
+      \brief Zwraca stan odebrany przez wątek rysowania.
+   */
+   const FrameSnapshot & ReturnRead() const;
+   /*!
+      \brief Budzi oba wątki, \link Acquire() \endlink zwraca FALSE po odebraniu ostatniego stanu.
+   */
+   void Stop();
+   /*!
+      \brief Zwraca ilość wywołań \link Publish() \endlink, które musiały czekać na wątek rysowania.
+   */
+   unsigned int ReturnWaits() const;
+private:
+   /*!
+      \brief Stany klatek.
+   */
+   FrameSnapshot Slots[SNAPSHOT_SLOTS];
+   /*!
+      \brief Numer stanu zapisywanego.
+   */
+   unsigned int Write;
+   /*!
+      \brief Numer stanu gotowego do odebrania.
+   */
+   unsigned int Ready;
+   /*!
+      \brief Numer stanu rysowanego.
+   */
+   unsigned int Read;
+   /*!
+      \brief Stan \link Ready \endlink nie został jeszcze odebrany.
+   */
+   bool Fresh;
+   /*!
+      \brief FALSE = zatrzymano ( \link Stop() \endlink ).
+   */
+   bool Running;
+   /*!
+      \brief Ilość oczekiwań w \link Publish() \endlink.
+   */
+   unsigned int Waits;
+   /*!
+      \brief Blokada dla \link Ready \endlink, \link Fresh \endlink i \link Running \endlink.
+   */
+   SDL_mutex *Mutex;
+   /*!
+      \brief Zmiana \link Fresh \endlink lub \link Running \endlink.
+   */
+   SDL_cond *Changed;
+};
+
+#endif
@@ -0,0 +1,228 @@
+/*!
+   \file staticbatch.cpp
+   \brief Plik źródłowy dla staticbatch.hpp.
+*/
+#include "staticbatch.hpp"
+#include <cstddef>
+#include <SDL2/SDL.h>
+#include <glm/gtc/type_ptr.hpp>
+#include "memorytracker.hpp"
+
+StaticBatch::StaticBatch(){
+   this->ModelCount = 0;
+   this->Chunks = 0;
+   this->ChunkSize = WORLDGRID_CHUNK;
+}
+
+StaticBatch::~StaticBatch(){
+   this->Destroy();
+}
+
+void StaticBatch::Create( const WorldGrid &grid, const std::vector <Model> &models, const std::vector <bool> &static_models ){
+   this->Destroy();
+   this->ModelCount = models.size();
+   this->Chunks = grid.ReturnChunks();
+   this->ChunkSize = grid.ReturnChunkSize();
+   this->Static = static_models;
+   this->Static.resize( this->ModelCount, false );
+   BatchMesh empty;
+   empty.Model = 0;
+   empty.ChunkX = 0;
+   empty.ChunkZ = 0;
+   empty.Min = glm::vec3( 0.0f );
+   empty.Max = glm::vec3( 0.0f );
+   empty.VAO = 0;
+   empty.VertexBuffer = 0;
+   empty.IndicesBuffer = 0;
+   empty.Count = 0;
+   empty.Instances = 0;
+   this->Batches.assign( this->Chunks * this->Chunks * this->ModelCount, empty );
+   this->Dirty.assign( this->Chunks * this->Chunks, true );
+   const unsigned int rebuilt = this->Update( grid, models );
+   SDL_Log( "Static batches: %u in %u chunks\n", this->ReturnBatches(), rebuilt );
+}
+
+void StaticBatch::Destroy(){
+   std::vector <BatchMesh>::iterator it;
+   for( it = this->Batches.begin(); it != this->Batches.end(); ++it ){
+      this->Release( *it );
+   }
+   this->Batches.clear();
+   this->Dirty.clear();
+   this->VisibleIndex.clear();
+}
+
+void StaticBatch::Invalidate( int x, int z, GLuint model ){
+   if( ! this->IsStatic( model ) or x < 0 or z < 0 ){
+      return;
+   }
+   const int chunk_x = x / this->ChunkSize;
+   const int chunk_z = z / this->ChunkSize;
+   if( chunk_x < this->Chunks and chunk_z < this->Chunks ){
+      this->Dirty[chunk_z * this->Chunks + chunk_x] = true;
+   }
+}
+
+unsigned int StaticBatch::Update( const WorldGrid &grid, const std::vector <Model> &models ){
+   unsigned int rebuilt = 0;
+   for( unsigned int i = 0; i < this->Dirty.size(); ++i ){
+      if( this->Dirty[i] ){
+         this->BuildChunk( i % this->Chunks, i / this->Chunks, grid, models );
+         this->Dirty[i] = false;
+         ++rebuilt;
+      }
+   }
+   return rebuilt;
+}
+
+void StaticBatch::BuildChunk( int chunk_x, int chunk_z, const WorldGrid &grid, const std::vector <Model> &models ){
+   const GridChunk &chunk = grid.ReturnChunk( chunk_x, chunk_z );
+   const unsigned int first = ( chunk_z * this->Chunks + chunk_x ) * this->ModelCount;
+   glm::vec3 position;
+   unsigned int model, base;
+   std::vector <GridItem>::const_iterator it_item;
+   std::vector <Packe>::const_iterator it_vertex;
+   std::vector <GLuint>::const_iterator it_index;
+   for( model = 0; model < this->ModelCount; ++model ){
+      BatchMesh &batch = this->Batches[first + model];
+      this->Release( batch );
+      if( ! this->Static[model] or model >= chunk.Items.size() or chunk.Items[model].empty() ){
+         continue;
+      }
+      const std::vector <Packe> &vertices = models[model].ReturnVertices();
+      const std::vector <GLuint> &indices = models[model].ReturnIndices();
+      if( vertices.empty() or indices.empty() ){
+         continue;
+      }
+      this->Vertices.clear();
+      this->Indices.clear();
+      this->Vertices.reserve( vertices.size() * chunk.Items[model].size() );
+      this->Indices.reserve( indices.size() * chunk.Items[model].size() );
+      //Transform every object into world space:
+      for( it_item = chunk.Items[model].begin(); it_item != chunk.Items[model].end(); ++it_item ){
+         const glm::mat4 &matrix = models[model].ReturnMatrix( it_item->Index );
+         const glm::mat3 normal_matrix = glm::transpose( glm::inverse( glm::mat3( matrix ) ) );
+         base = this->Vertices.size();
+         for( it_vertex = vertices.begin(); it_vertex != vertices.end(); ++it_vertex ){
+            Packe vertex;
+            vertex.position = glm::vec3( matrix * glm::vec4( it_vertex->position, 1.0f ) );
+            vertex.uv = it_vertex->uv;
+            vertex.normal = normal_matrix * it_vertex->normal;
+            this->Vertices.push_back( vertex );
+         }
+         for( it_index = indices.begin(); it_index != indices.end(); ++it_index ){
+            this->Indices.push_back( base + *it_index );
+         }
+      }
+      batch.Model = model;
+      batch.ChunkX = chunk_x;
+      batch.ChunkZ = chunk_z;
+      batch.Count = this->Indices.size();
+      batch.Instances = chunk.Items[model].size();
+      batch.Min = batch.Max = this->Vertices[0].position;
+      for( it_vertex = this->Vertices.begin(); it_vertex != this->Vertices.end(); ++it_vertex ){
+         position = it_vertex->position;
+         batch.Min = glm::min( batch.Min, position );
+         batch.Max = glm::max( batch.Max, position );
+      }
+      //VAO, same layout as Model::BindVAO():
+      glGenVertexArrays( 1, &batch.VAO );
+      glGenBuffers( 1, &batch.VertexBuffer );
+      glGenBuffers( 1, &batch.IndicesBuffer );
+      glBindVertexArray( batch.VAO );
+      glBindBuffer( GL_ARRAY_BUFFER, batch.VertexBuffer );
+      BufferStaticData( GL_ARRAY_BUFFER, this->Vertices.size() * sizeof( Packe ), &this->Vertices[0] );
+      MemoryTracker::AddObject( MEMORY_WORLD, MEMORY_OBJECT_BUFFER, batch.VertexBuffer, this->Vertices.size() * sizeof( Packe ) );
+      glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( Packe ), (GLvoid *)offsetof( Packe, position ) );
+      glEnableVertexAttribArray( 0 );
+      glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, sizeof( Packe ), (GLvoid *)offsetof( Packe, uv ) );
+      glEnableVertexAttribArray( 1 );
+      glVertexAttribPointer( 2, 3, GL_FLOAT, GL_FALSE, sizeof( Packe ), (GLvoid *)offsetof( Packe, normal ) );
+      glEnableVertexAttribArray( 2 );
+      glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, batch.IndicesBuffer );
+      BufferStaticData( GL_ELEMENT_ARRAY_BUFFER, this->Indices.size() * sizeof( GLuint ), &this->Indices[0] );
+      MemoryTracker::AddObject( MEMORY_WORLD, MEMORY_OBJECT_BUFFER, batch.IndicesBuffer, this->Indices.size() * sizeof( GLuint ) );
+      glBindVertexArray( 0 );
+   }
+}
+
+void StaticBatch::Release( BatchMesh &batch ){
+   if( batch.VAO != 0 ){
+      glDeleteVertexArrays( 1, &batch.VAO );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &batch.VertexBuffer );
+      MemoryTracker::RemoveObject( MEMORY_OBJECT_BUFFER, 1, &batch.IndicesBuffer );
+      glDeleteBuffers( 1, &batch.VertexBuffer );
+      glDeleteBuffers( 1, &batch.IndicesBuffer );
+   }
+   batch.VAO = 0;
+   batch.VertexBuffer = 0;
+   batch.IndicesBuffer = 0;
+   batch.Count = 0;
+   batch.Instances = 0;
+}
+
+void StaticBatch::Cull( const Frustum &frustum ){
+   this->VisibleIndex.clear();
+   for( unsigned int i = 0; i < this->Batches.size(); ++i ){
+      if( this->Batches[i].Count > 0 and frustum.TestBox( this->Batches[i].Min, this->Batches[i].Max ) != FRUSTUM_OUTSIDE ){
+         this->VisibleIndex.push_back( i );
+      }
+   }
+}
+
+unsigned int StaticBatch::Cull( const OcclusionCuller &occlusion ){
+   static const glm::mat4 identity( 1.0f );
+   unsigned int visible = 0;
+   for( unsigned int i = 0; i < this->VisibleIndex.size(); ++i ){
+      const BatchMesh &batch = this->Batches[this->VisibleIndex[i]];
+      if( occlusion.TestBox( identity, batch.Min, batch.Max ) ){
+         this->VisibleIndex[visible++] = this->VisibleIndex[i];
+      }
+   }
+   const unsigned int occluded = this->VisibleIndex.size() - visible;
+   this->VisibleIndex.resize( visible );
+   return occluded;
+}
+
+bool StaticBatch::IsStatic( GLuint model ) const{
+   return model < this->Static.size() and this->Static[model];
+}
+
+const std::vector <bool> & StaticBatch::ReturnStaticModels() const{
+   return this->Static;
+}
+
+const std::vector <GLuint> & StaticBatch::ReturnVisibleIndex() const{
+   return this->VisibleIndex;
+}
+
+const BatchMesh & StaticBatch::ReturnBatch( GLuint i ) const{
+   return this->Batches.at( i );
+}
+
+unsigned int StaticBatch::ReturnBatches() const{
+   unsigned int count = 0;
+   std::vector <BatchMesh>::const_iterator it;
+   for( it = this->Batches.begin(); it != this->Batches.end(); ++it ){
+      if( it->Count > 0 ){
+         ++count;
+      }
+   }
+   return count;
+}
+
+void StaticBatch::Draw( GLuint i ){
+   static const glm::mat4 identity( 1.0f );
+   const BatchMesh &batch = this->Batches[i];
+   glBindVertexArray( batch.VAO );
+   glUniformMatrix4fv( *Model::ModelUniformId, 1, GL_FALSE, glm::value_ptr( identity ) );
+   glDrawElements( GL_TRIANGLES, batch.Count, GL_UNSIGNED_INT, (GLvoid *)0 );
+}
+
+void StaticBatch::DrawDepth( GLuint i ){
+   static const glm::mat4 identity( 1.0f );
+   const BatchMesh &batch = this->Batches[i];
+   glBindVertexArray( batch.VAO );
+   glUniformMatrix4fv( *Model::ModelUniformDepth, 1, GL_FALSE, glm::value_ptr( identity ) );
+   glDrawElements( GL_TRIANGLES, batch.Count, GL_UNSIGNED_INT, (GLvoid *)0 );
+}
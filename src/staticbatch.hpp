@@ -0,0 +1,223 @@
+/*!
+   \file staticbatch.hpp
+   \brief Plik odpowiedzialny za łączenie nieruchomych obiektów mapy w jedną siatkę na blok (chunk) i model.
+*/
+#ifndef staticbatch_hpp
+#define staticbatch_hpp
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "frustum.hpp"
+#include "model.hpp"
+#include "worldgrid.hpp"
+#include "occlusion.hpp"
+
+/*!
+   \brief Numer siatki w kluczu kolejki rysowania ( \link RenderQueue::MakeKey() \endlink ) dla wszystkich połączonych siatek.
+*/
+#define STATICBATCH_MESH 0xFFF
+
+/*!
+   \brief Połączona siatka wszystkich obiektów jednego modelu w jednym bloku.
+*/
+struct BatchMesh{
+   /*!
+      \brief Numer modelu w \link Game::Models \endlink (materiał).
+   */
+   GLuint Model;
+   /*!
+      \brief Numer bloku w osi x ( \link WorldGrid::ReturnChunk() \endlink ).
+   */
+   int ChunkX;
+   /*!
+      \brief Numer bloku w osi z ( \link WorldGrid::ReturnChunk() \endlink ).
+   */
+   int ChunkZ;
+   /*!
+      \brief Minimalny punkt prostopadłościanu siatki w przestrzeni świata.
+   */
+   glm::vec3 Min;
+   /*!
+      \brief Maksymalny punkt prostopadłościanu siatki w przestrzeni świata.
+   */
+   glm::vec3 Max;
+   /*!
+      \brief Identyfikator VAO (Vertex Array Object).
+   */
+   GLuint VAO;
+   /*!
+      \brief Identyfikator Wierzchołków ( \link Packe \endlink, przestrzeń świata ).
+   */
+   GLuint VertexBuffer;
+   /*!
+      \brief Identyfikator Indeksów Wierzchołków.
+   */
+   GLuint IndicesBuffer;
+   /*!
+      \brief Ilość indeksów.
+   */
+   GLsizei Count;
+   /*!
+      \brief Ilość połączonych obiektów.
+   */
+   unsigned int Instances;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za łączenie nieruchomych obiektów mapy.
+
+   Wierzchołki obiektów modeli oznaczonych jako nieruchome są przekształcane do przestrzeni świata
+   i łączone w jeden bufor wierzchołków i indeksów dla każdego bloku \link WorldGrid \endlink i modelu.\n
+   Ilość wywołań rysowania nieruchomego świata nie zależy od ilości obiektów.\n
+   Po zmianie mapy przebudowywane są tylko zmienione bloki ( \link Invalidate() \endlink, \link Update() \endlink ).\n
+*/
+class StaticBatch{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   StaticBatch();
+   /*!
+      \brief Destruktor.
+
+      Zwalnia wszystkie bufory ( \link Destroy() \endlink ).
+   */
+   ~StaticBatch();
+   /*!
+      \brief Tworzy połączone siatki dla wszystkich bloków.
+
+      \param grid - podział mapy na bloki
+      \param models - wektor wszystkich modeli
+      \param static_models - TRUE dla modeli, których obiekty nie poruszają się
+   */
+   void Create( const WorldGrid &grid, const std::vector <Model> &models, const std::vector <bool> &static_models );
+   /*!
+      \brief Zwalnia wszystkie bufory.
+   */
+   void Destroy();
+   /*!
+      \brief Oznacza blok zawierający pole mapy do przebudowania.
+
+      \param x - pozycja x na mapie
+      \param z - pozycja z na mapie
+      \param model - numer modelu dodanego lub usuniętego obiektu
+
+      Nie robi nic dla modeli, które nie są nieruchome.\n
+      Wywoływana przez Game::InvalidateStatic() po każdej zmianie obiektu nieruchomego modelu na mapie (drzewa, kamienie),
+      blok przebudowywany jest w następnej klatce przez \link Update() \endlink w Game::Render().
+   */
+   void Invalidate( int x, int z, GLuint model );
+   /*!
+      \brief Przebudowuje oznaczone bloki.
+
+      \param grid - podział mapy na bloki
+      \param models - wektor wszystkich modeli
+      \return - ilość przebudowanych bloków
+   */
+   unsigned int Update( const WorldGrid &grid, const std::vector <Model> &models );
+   /*!
+      \brief Odrzuca połączone siatki znajdujące się poza bryłą widzenia.
+
+      \param frustum - bryła widzenia kamery
+   */
+   void Cull( const Frustum &frustum );
+   /*!
+      \brief Odrzuca widoczne połączone siatki zasłonięte w programowym buforze głębokości.
+
+      \param occlusion - bufor głębokości z narysowanymi obiektami zasłaniającymi
+      \return - ilość odrzuconych siatek
+   */
+   unsigned int Cull( const OcclusionCuller &occlusion );
+   /*!
+      \brief Sprawdza czy model jest łączony.
+
+      \param model - numer modelu
+   */
+   bool IsStatic( GLuint model ) const;
+   /*!
+      \brief Zwraca modele, których obiekty są łączone (maska pomijanych modeli dla \link WorldGrid::Cull() \endlink ).
+   */
+   const std::vector <bool> & ReturnStaticModels() const;
+   /*!
+      \brief Zwraca numery widocznych siatek z ostatniego \link Cull() \endlink.
+   */
+   const std::vector <GLuint> & ReturnVisibleIndex() const;
+   /*!
+      \brief Zwraca i-tą połączoną siatkę.
+
+      \param i - numer siatki
+   */
+   const BatchMesh & ReturnBatch( GLuint i ) const;
+   /*!
+      \brief Zwraca ilość niepustych połączonych siatek.
+   */
+   unsigned int ReturnBatches() const;
+   /*!
+      \brief Rysuje połączoną siatkę głównym shaderem.
+
+      \param i - numer siatki
+
+      Przed rysowaniem należy aktywować teksturę modelu ( \link Model::BindTexture() \endlink ).
+   */
+   void Draw( GLuint i );
+   /*!
+      \brief Rysuje połączoną siatkę shaderem głębokości.
+
+      \param i - numer siatki
+   */
+   void DrawDepth( GLuint i );
+private:
+   /*!
+      \brief Buduje siatki wszystkich modeli jednego bloku.
+
+      \param chunk_x - numer bloku w osi x
+      \param chunk_z - numer bloku w osi z
+      \param grid - podział mapy na bloki
+      \param models - wektor wszystkich modeli
+   */
+   void BuildChunk( int chunk_x, int chunk_z, const WorldGrid &grid, const std::vector <Model> &models );
+   /*!
+      \brief Zwalnia bufory siatki.
+
+      \param batch - siatka
+   */
+   void Release( BatchMesh &batch );
+   /*!
+      \brief Połączone siatki, numer siatki = ( numer bloku * \link ModelCount \endlink ) + numer modelu.
+   */
+   std::vector <BatchMesh> Batches;
+   /*!
+      \brief Modele, których obiekty są łączone.
+   */
+   std::vector <bool> Static;
+   /*!
+      \brief Bloki do przebudowania.
+   */
+   std::vector <bool> Dirty;
+   /*!
+      \brief Numery widocznych siatek.
+   */
+   std::vector <GLuint> VisibleIndex;
+   /*!
+      \brief Tymczasowe wierzchołki budowanej siatki.
+   */
+   std::vector <Packe> Vertices;
+   /*!
+      \brief Tymczasowe indeksy budowanej siatki.
+   */
+   std::vector <GLuint> Indices;
+   /*!
+      \brief Ilość modeli.
+   */
+   unsigned int ModelCount;
+   /*!
+      \brief Ilość bloków w jednym wymiarze.
+   */
+   int Chunks;
+   /*!
+      \brief Wielkość bloku (ilość pól mapy).
+   */
+   int ChunkSize;
+};
+
+#endif
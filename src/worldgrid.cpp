@@ -0,0 +1,212 @@
+/*!
+   \file worldgrid.cpp
+   \brief Plik źródłowy dla worldgrid.hpp.
+*/
+#include "worldgrid.hpp"
+#include <cmath>
+
+WorldGrid::WorldGrid(){
+   this->MapMax = 0;
+   this->MapMaxHalf = 0;
+   this->ChunkSize = WORLDGRID_CHUNK;
+   this->Chunks = 0;
+   this->ChunksVisible = 0;
+}
+
+void WorldGrid::Create( int map_max, unsigned int models, int chunk_size ){
+   this->MapMax = map_max;
+   this->MapMaxHalf = map_max / 2;
+   this->ChunkSize = chunk_size > 0 ? chunk_size : WORLDGRID_CHUNK;
+   this->Chunks = ( map_max + this->ChunkSize - 1 ) / this->ChunkSize;
+   this->Grid.clear();
+   this->Grid.resize( this->Chunks * this->Chunks );
+   std::vector <GridChunk>::iterator it;
+   for( it = this->Grid.begin(); it != this->Grid.end(); ++it ){
+      it->Min = glm::vec3( 0.0f );
+      it->Max = glm::vec3( 0.0f );
+      it->Count = 0;
+      it->Items.resize( models );
+   }
+   this->ModelCount.assign( models, 0 );
+   this->ChunksVisible = 0;
+}
+
+void WorldGrid::Insert( int x, int z, GLuint model, GLuint index, const Model &model_object ){
+   if( x < 0 or z < 0 or x >= this->MapMax or z >= this->MapMax or model >= this->ModelCount.size() ){
+      return;
+   }
+   GridChunk &chunk = this->Grid[( z / this->ChunkSize ) * this->Chunks + ( x / this->ChunkSize )];
+   GridItem item;
+   item.Model = model;
+   item.Index = index;
+   item.X = x;
+   item.Z = z;
+   //Box of bounding sphere, stays valid when object rotates in place:
+   const glm::mat4 &matrix = model_object.ReturnMatrix( index );
+   const glm::vec3 center = ( model_object.ReturnCollisionMin() + model_object.ReturnCollisionMax() ) * 0.5f;
+   const glm::vec3 extent = ( model_object.ReturnCollisionMax() - model_object.ReturnCollisionMin() ) * 0.5f;
+   const glm::vec3 world_center = glm::vec3( matrix * glm::vec4( center, 1.0f ) );
+   glm::vec3 world_extent;
+   for( int i = 0; i < 3; ++i ){
+      world_extent[i] = std::fabs( matrix[0][i] ) * extent.x + std::fabs( matrix[1][i] ) * extent.y + std::fabs( matrix[2][i] ) * extent.z;
+   }
+   const float radius = glm::length( world_extent );
+   item.Min = world_center - glm::vec3( radius );
+   item.Max = world_center + glm::vec3( radius );
+   if( chunk.Count == 0 ){
+      chunk.Min = item.Min;
+      chunk.Max = item.Max;
+   }
+   else{
+      chunk.Min = glm::min( chunk.Min, item.Min );
+      chunk.Max = glm::max( chunk.Max, item.Max );
+   }
+   chunk.Items[model].push_back( item );
+   ++chunk.Count;
+   ++this->ModelCount[model];
+}
+
+bool WorldGrid::Remove( int x, int z, GLuint model, GLuint index ){
+   if( x < 0 or z < 0 or x >= this->MapMax or z >= this->MapMax or model >= this->ModelCount.size() ){
+      return false;
+   }
+   GridChunk &chunk = this->Grid[( z / this->ChunkSize ) * this->Chunks + ( x / this->ChunkSize )];
+   std::vector <GridItem> &items = chunk.Items[model];
+   for( unsigned int i = 0; i < items.size(); ++i ){
+      if( items[i].Index == index and items[i].X == x and items[i].Z == z ){
+         items[i] = items.back();
+         items.pop_back();
+         --chunk.Count;
+         --this->ModelCount[model];
+         this->UpdateBounds( chunk );
+         return true;
+      }
+   }
+   return false;
+}
+
+void WorldGrid::UpdateBounds( GridChunk &chunk ){
+   bool first = true;
+   std::vector < std::vector <GridItem> >::iterator it_model;
+   std::vector <GridItem>::iterator it;
+   for( it_model = chunk.Items.begin(); it_model != chunk.Items.end(); ++it_model ){
+      for( it = it_model->begin(); it != it_model->end(); ++it ){
+         if( first ){
+            chunk.Min = it->Min;
+            chunk.Max = it->Max;
+            first = false;
+         }
+         else{
+            chunk.Min = glm::min( chunk.Min, it->Min );
+            chunk.Max = glm::max( chunk.Max, it->Max );
+         }
+      }
+   }
+}
+
+void WorldGrid::Cull( const Frustum &frustum, std::vector <Model> &models, const std::vector <bool> &skip ){
+   unsigned int i, j;
+   for( i = 0; i < models.size() and i < this->ModelCount.size(); ++i ){
+      if( this->ModelCount[i] > 0 ){
+         models[i].ClearVisible();
+      }
+   }
+   this->ChunksVisible = 0;
+   int result;
+   std::vector <GridChunk>::iterator it;
+   std::vector <GridItem>::const_iterator it_item;
+   for( it = this->Grid.begin(); it != this->Grid.end(); ++it ){
+      if( it->Count == 0 ){
+         continue;
+      }
+      result = frustum.TestBox( it->Min, it->Max );
+      if( result == FRUSTUM_OUTSIDE ){
+         continue;
+      }
+      ++this->ChunksVisible;
+      for( j = 0; j < it->Items.size() and j < models.size(); ++j ){
+         if( j < skip.size() and skip[j] ){
+            continue;
+         }
+         Model &model = models[j];
+         for( it_item = it->Items[j].begin(); it_item != it->Items[j].end(); ++it_item ){
+            if( result == FRUSTUM_INSIDE or
+                frustum.TestBox( model.ReturnMatrix( it_item->Index ), model.ReturnCollisionMin(), model.ReturnCollisionMax() )
+            ){
+               model.AddVisible( it_item->Index );
+            }
+         }
+      }
+   }
+}
+
+void WorldGrid::QueryCells( int x0, int z0, int x1, int z1, std::vector <GridItem> &out ) const{
+   if( this->Chunks == 0 ){
+      return;
+   }
+   x0 = x0 < 0 ? 0 : x0;
+   z0 = z0 < 0 ? 0 : z0;
+   x1 = x1 >= this->MapMax ? this->MapMax - 1 : x1;
+   z1 = z1 >= this->MapMax ? this->MapMax - 1 : z1;
+   if( x0 > x1 or z0 > z1 ){
+      return;
+   }
+   int cx, cz;
+   std::vector < std::vector <GridItem> >::const_iterator it_model;
+   std::vector <GridItem>::const_iterator it;
+   for( cz = z0 / this->ChunkSize; cz <= z1 / this->ChunkSize; ++cz ){
+      for( cx = x0 / this->ChunkSize; cx <= x1 / this->ChunkSize; ++cx ){
+         const GridChunk &chunk = this->Grid[cz * this->Chunks + cx];
+         if( chunk.Count == 0 ){
+            continue;
+         }
+         for( it_model = chunk.Items.begin(); it_model != chunk.Items.end(); ++it_model ){
+            for( it = it_model->begin(); it != it_model->end(); ++it ){
+               if( it->X >= x0 and it->X <= x1 and it->Z >= z0 and it->Z <= z1 ){
+                  out.push_back( *it );
+               }
+            }
+         }
+      }
+   }
+}
+
+void WorldGrid::Query( const glm::vec3 &min, const glm::vec3 &max, std::vector <GridItem> &out ) const{
+   std::vector <GridItem> cells;
+   //Objects may overhang their cell, search one more cell around:
+   this->QueryCells( (int)std::floor( min.x ) + this->MapMaxHalf - 1,
+      (int)std::floor( min.z ) + this->MapMaxHalf - 1,
+      (int)std::floor( max.x ) + this->MapMaxHalf + 1,
+      (int)std::floor( max.z ) + this->MapMaxHalf + 1,
+      cells
+   );
+   std::vector <GridItem>::iterator it;
+   for( it = cells.begin(); it != cells.end(); ++it ){
+      if( it->Min.x <= max.x and it->Max.x >= min.x and
+          it->Min.y <= max.y and it->Max.y >= min.y and
+          it->Min.z <= max.z and it->Max.z >= min.z
+      ){
+         out.push_back( *it );
+      }
+   }
+}
+
+bool WorldGrid::Contains( GLuint model ) const{
+   return model < this->ModelCount.size() and this->ModelCount[model] > 0;
+}
+
+int WorldGrid::ReturnChunks() const{
+   return this->Chunks;
+}
+
+int WorldGrid::ReturnChunkSize() const{
+   return this->ChunkSize;
+}
+
+const GridChunk & WorldGrid::ReturnChunk( int x, int z ) const{
+   return this->Grid.at( z * this->Chunks + x );
+}
+
+unsigned int WorldGrid::ReturnChunksVisible() const{
+   return this->ChunksVisible;
+}
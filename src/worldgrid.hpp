@@ -0,0 +1,200 @@
+/*!
+   \file worldgrid.hpp
+   \brief Plik odpowiedzialny za podział świata na bloki (chunki) do odrzucania obiektów i zapytań o obszar.
+*/
+#ifndef worldgrid_hpp
+#define worldgrid_hpp
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "frustum.hpp"
+#include "model.hpp"
+
+/*!
+   \brief Domyślna wielkość bloku (ilość pól mapy w szerokości i długości).
+*/
+#define WORLDGRID_CHUNK 8
+
+/*!
+   \brief Pojedynczy obiekt umieszczony na mapie.
+*/
+struct GridItem{
+   /*!
+      \brief Numer modelu w \link Game::Models \endlink.
+   */
+   GLuint Model;
+   /*!
+      \brief Numer macierzy modelu (instancji).
+   */
+   GLuint Index;
+   /*!
+      \brief Pozycja x na mapie ( \link Game::Map \endlink ).
+   */
+   int X;
+   /*!
+      \brief Pozycja z na mapie ( \link Game::Map \endlink ).
+   */
+   int Z;
+   /*!
+      \brief Minimalny punkt prostopadłościanu obiektu w przestrzeni świata.
+   */
+   glm::vec3 Min;
+   /*!
+      \brief Maksymalny punkt prostopadłościanu obiektu w przestrzeni świata.
+   */
+   glm::vec3 Max;
+};
+
+/*!
+   \brief Blok mapy o stałej wielkości.
+*/
+struct GridChunk{
+   /*!
+      \brief Minimalny punkt prostopadłościanu wszystkich obiektów bloku.
+   */
+   glm::vec3 Min;
+   /*!
+      \brief Maksymalny punkt prostopadłościanu wszystkich obiektów bloku.
+   */
+   glm::vec3 Max;
+   /*!
+      \brief Ilość obiektów w bloku.
+   */
+   unsigned int Count;
+   /*!
+      \brief Obiekty bloku, osobny wektor dla każdego modelu.
+   */
+   std::vector < std::vector <GridItem> > Items;
+};
+
+/*!
+   \brief Klasa odpowiedzialna za podział mapy na bloki.
+
+   Każdy blok posiada prostopadłościan obejmujący wszystkie jego obiekty.\n
+   Odrzucanie obiektów sprawdza najpierw cały blok, a dopiero potem obiekty widocznych bloków.\n
+*/
+class WorldGrid{
+public:
+   /*!
+      \brief Konstruktor domyślny.
+   */
+   WorldGrid();
+   /*!
+      \brief Tworzy pustą siatkę bloków.
+
+      \param map_max - wielkość mapy ( \link Game::MapMax \endlink )
+      \param models - ilość modeli
+      \param chunk_size - wielkość bloku (ilość pól mapy)
+   */
+   void Create( int map_max, unsigned int models, int chunk_size = WORLDGRID_CHUNK );
+   /*!
+      \brief Dodaje obiekt do bloku.
+
+      \param x - pozycja x na mapie
+      \param z - pozycja z na mapie
+      \param model - numer modelu
+      \param index - numer macierzy modelu
+      \param model_object - model, z którego zostanie wyznaczony prostopadłościan obiektu
+   */
+   void Insert( int x, int z, GLuint model, GLuint index, const Model &model_object );
+   /*!
+      \brief Usuwa obiekt z bloku.
+
+      \param x - pozycja x na mapie
+      \param z - pozycja z na mapie
+      \param model - numer modelu
+      \param index - numer macierzy modelu
+      \return - wartość logiczna, FALSE = nie znaleziono obiektu
+   */
+   bool Remove( int x, int z, GLuint model, GLuint index );
+   /*!
+      \brief Odrzuca obiekty poza bryłą widzenia.
+
+      \param frustum - bryła widzenia kamery
+      \param models - wektor wszystkich modeli
+      \param skip - TRUE dla modeli pomijanych (np. rysowanych jako połączone siatki \link StaticBatch \endlink ), ich lista widocznych obiektów jest pusta
+
+      Ustala widoczne obiekty dla modeli umieszczonych na mapie ( \link Contains() \endlink ).
+   */
+   void Cull( const Frustum &frustum, std::vector <Model> &models, const std::vector <bool> &skip = std::vector <bool>() );
+   /*!
+      \brief Zwraca obiekty znajdujące się w prostokącie pól mapy (włącznie z krawędziami).
+
+      \param x0 - minimalna pozycja x
+      \param z0 - minimalna pozycja z
+      \param x1 - maksymalna pozycja x
+      \param z1 - maksymalna pozycja z
+      \param out - wektor, do którego zostaną dodane znalezione obiekty
+   */
+   void QueryCells( int x0, int z0, int x1, int z1, std::vector <GridItem> &out ) const;
+   /*!
+      \brief Zwraca obiekty, których prostopadłościan przecina podany prostopadłościan (przestrzeń świata).
+
+      \param min - minimalny punkt prostopadłościanu
+      \param max - maksymalny punkt prostopadłościanu
+      \param out - wektor, do którego zostaną dodane znalezione obiekty
+   */
+   void Query( const glm::vec3 &min, const glm::vec3 &max, std::vector <GridItem> &out ) const;
+   /*!
+      \brief Sprawdza czy model posiada obiekty na mapie.
+
+      \param model - numer modelu
+   */
+   bool Contains( GLuint model ) const;
+   /*!
+      \brief Zwraca ilość bloków w jednym wymiarze.
+   */
+   int ReturnChunks() const;
+   /*!
+      \brief Zwraca wielkość bloku (ilość pól mapy).
+   */
+   int ReturnChunkSize() const;
+   /*!
+      \brief Zwraca blok o podanym numerze.
+
+      \param x - numer bloku w osi x
+      \param z - numer bloku w osi z
+   */
+   const GridChunk & ReturnChunk( int x, int z ) const;
+   /*!
+      \brief Zwraca ilość widocznych bloków z ostatniego \link Cull() \endlink.
+   */
+   unsigned int ReturnChunksVisible() const;
+private:
+   /*!
+      \brief Przelicza prostopadłościan bloku.
+
+      \param chunk - blok
+   */
+   void UpdateBounds( GridChunk &chunk );
+   /*!
+      \brief Wielkość mapy.
+   */
+   int MapMax;
+   /*!
+      \brief Połowa wielkości mapy.
+   */
+   int MapMaxHalf;
+   /*!
+      \brief Wielkość bloku (ilość pól mapy).
+   */
+   int ChunkSize;
+   /*!
+      \brief Ilość bloków w jednym wymiarze.
+   */
+   int Chunks;
+   /*!
+      \brief Wszystkie bloki, numer bloku = z * \link Chunks \endlink + x.
+   */
+   std::vector <GridChunk> Grid;
+   /*!
+      \brief Ilość obiektów na mapie dla każdego modelu.
+   */
+   std::vector <unsigned int> ModelCount;
+   /*!
+      \brief Ilość widocznych bloków z ostatniego \link Cull() \endlink.
+   */
+   unsigned int ChunksVisible;
+};
+
+#endif